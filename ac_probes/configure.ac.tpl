@@ -279,6 +279,14 @@ AC_ARG_ENABLE([probes-independent],
        *) AC_MSG_ERROR([bad value ${enableval} for --enable-probes-independent]) ;;
      esac],[probes_independent=yes])
 
+AC_ARG_ENABLE([probe-modules],
+     [AC_HELP_STRING([--enable-probe-modules], [build selected probes also as modules which can run inside the scanner process (default=no)])],
+     [case "${enableval}" in
+       yes) probe_modules=yes ;;
+       no)  probe_modules=no  ;;
+       *) AC_MSG_ERROR([bad value ${enableval} for --enable-probe-modules]) ;;
+     esac],[probe_modules=no])
+
 AC_ARG_ENABLE([probes-unix],
      [AC_HELP_STRING([--enable-probes-unix], [enable compilation of probes for UNIX based systems (default=yes)])],
      [case "${enableval}" in
@@ -536,6 +544,7 @@ fi
 AM_CONDITIONAL([WANT_CCE],  test "$cce"  = yes)
 
 AM_CONDITIONAL([WANT_PROBES_INDEPENDENT], test "$probes_independent" = yes)
+AM_CONDITIONAL([WANT_PROBE_MODULES], test "$probe_modules" = yes)
 AM_CONDITIONAL([WANT_PROBES_UNIX], test "$probes_unix" = yes)
 AM_CONDITIONAL([WANT_PROBES_LINUX], test "$probes_linux" = yes)
 AM_CONDITIONAL([WANT_PROBES_SOLARIS], test "$probes_solaris" = yes)
@@ -581,6 +590,7 @@ AC_CONFIG_FILES([Makefile
                  tests/API/OVAL/unittests/Makefile
 		 tests/API/OVAL/validate/Makefile
 		 tests/API/OVAL/report_variable_values/Makefile
+		 tests/API/OVAL/profile_report/Makefile
                  tests/mitre/Makefile
 
                  src/OVAL/probes/Makefile
@@ -592,6 +602,7 @@ AC_CONFIG_FILES([Makefile
                  tests/API/crypt/Makefile
                  tests/API/SEAP/Makefile
                  tests/API/probes/Makefile
+                 tests/bench/Makefile
                  tests/probes/file/Makefile
                  tests/probes/fileextendedattribute/Makefile
                  tests/probes/uname/Makefile
@@ -53,6 +53,7 @@ struct cpe_session *cpe_session_new(void)
 	cpe->lang_models = oscap_list_new();
 	cpe->oval_sessions = oscap_htable_new();
 	cpe->applicable_platforms = oscap_htable_new();
+	cpe->platform_verdicts = oscap_htable_new();
 	if (!cpe_session_add_default_cpe(cpe)) {
 		oscap_seterr(OSCAP_EFAMILY_XCCDF, "Failed to add default CPE to newly created CPE Session.");
 	}
@@ -74,6 +75,7 @@ void cpe_session_free(struct cpe_session *session)
 		oscap_list_free(session->lang_models, (oscap_destruct_func) cpe_lang_model_free);
 		oscap_htable_free(session->oval_sessions, (oscap_destruct_func) _xccdf_policy_destroy_cpe_oval_session);
 		oscap_htable_free(session->applicable_platforms, NULL);
+		oscap_htable_free(session->platform_verdicts, NULL);
 		oscap_free(session);
 	}
 }
@@ -118,15 +120,24 @@ struct oval_agent_session *cpe_session_lookup_oval_session(struct cpe_session *c
 	return session;
 }
 
+/* A new dictionary or lang model can make more platforms applicable */
+static inline void _cpe_session_forget_verdicts(struct cpe_session *session)
+{
+	oscap_htable_free(session->platform_verdicts, NULL);
+	session->platform_verdicts = oscap_htable_new();
+}
+
 bool cpe_session_add_cpe_lang_model_source(struct cpe_session *session, struct oscap_source *source)
 {
 	struct cpe_lang_model *lang_model = cpe_lang_model_import_source(source);
+	_cpe_session_forget_verdicts(session);
 	return oscap_list_add(session->lang_models, lang_model);
 }
 
 bool cpe_session_add_cpe_dict_source(struct cpe_session *session, struct oscap_source *source)
 {
 	struct cpe_dict_model *dict = cpe_dict_model_import_source(source);
+	_cpe_session_forget_verdicts(session);
 	return oscap_list_add(session->dicts, dict);
 }
 
@@ -144,6 +155,15 @@ bool cpe_session_add_cpe_autodetect_source(struct cpe_session *session, struct o
 	}
 }
 
+void cpe_session_reset_checks(struct cpe_session *session)
+{
+	oscap_htable_free(session->oval_sessions, (oscap_destruct_func) _xccdf_policy_destroy_cpe_oval_session);
+	session->oval_sessions = oscap_htable_new();
+	oscap_htable_free(session->applicable_platforms, NULL);
+	session->applicable_platforms = oscap_htable_new();
+	_cpe_session_forget_verdicts(session);
+}
+
 void cpe_session_set_cache(struct cpe_session *session, struct oscap_htable *sources_cache)
 {
 	session->sources_cache = sources_cache;
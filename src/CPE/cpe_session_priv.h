@@ -37,6 +37,7 @@ struct cpe_session {
 	struct oscap_list *lang_models;                 ///< All CPE lang models except the one embedded in XCCDF
 	struct oscap_htable *oval_sessions;             ///< Caches CPE OVAL check results
 	struct oscap_htable *applicable_platforms;
+	struct oscap_htable *platform_verdicts;         ///< Applicability of every platform evaluated so far [platform -> bool*], values not owned
 	struct oscap_htable *sources_cache;             ///< Not owned cache [path -> oscap_source]
 };
 
@@ -46,6 +47,11 @@ struct oval_agent_session *cpe_session_lookup_oval_session(struct cpe_session *c
 bool cpe_session_add_cpe_lang_model_source(struct cpe_session *session, struct oscap_source *source);
 bool cpe_session_add_cpe_dict_source(struct cpe_session *session, struct oscap_source *source);
 bool cpe_session_add_cpe_autodetect_source(struct cpe_session *session, struct oscap_source *source);
+/**
+ * Drop the CPE OVAL sessions and the platform verdicts, the platforms are
+ * evaluated again by new probes on next use.
+ */
+void cpe_session_reset_checks(struct cpe_session *session);
 void cpe_session_set_cache(struct cpe_session *session, struct oscap_htable *sources_cache);
 
 OSCAP_HIDDEN_END;
@@ -40,6 +40,10 @@
 
 #include "common/util.h"
 #include "common/list.h"
+#include "common/xmltext_priv.h"
+
+#include "source/oscap_source_priv.h"
+#include "source/public/oscap_source.h"
 
 #define CVE_SUPPORTED "2.0"
 
@@ -62,6 +66,38 @@ struct cve_model *cve_model_import(const char *file)
 	return cve;
 }
 
+/**
+ * Public function to process CVE feed one entry at a time.
+ * Unlike cve_model_import() no CVE model is built, each entry is passed
+ * to the consumer as soon as it is parsed.
+ */
+int cve_model_import_stream(const char *file, cve_entry_consumer consumer, void *user)
+{
+	__attribute__nonnull__(file);
+	__attribute__nonnull__(consumer);
+
+	if (file == NULL || consumer == NULL)
+		return -1;
+
+	struct oscap_source *source = oscap_source_new_from_file(file);
+	xmlTextReader *reader = oscap_source_get_streaming_xmlTextReader(source);
+	int ret;
+
+	if (reader == NULL) {
+		oscap_source_free(source);
+		return -1;
+	}
+
+	if (xmlTextReaderNextNode(reader) == -1)
+		ret = -1;
+	else
+		ret = cve_model_parse_stream(reader, consumer, user);
+
+	xmlFreeTextReader(reader);
+	oscap_source_free(source);
+	return ret;
+}
+
 /**
  * Public function to export CVE model to OSCAP export target.
  * Function fill the structure _target_ with model that is represented by structure
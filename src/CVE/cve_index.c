@@ -0,0 +1,531 @@
+/*! \file cve_index.c
+ *  \brief On-disk index of CVE NVD feeds
+ *
+ *  The index maps CVE IDs to byte offsets of their entries in an
+ *  uncompressed feed and CPE products to the IDs of CVE entries which
+ *  list them as vulnerable software. It is built in one streaming pass
+ *  over the feed and lets lookups parse a single entry instead of the
+ *  whole feed.
+ */
+
+/*
+ * Copyright 2026 Red Hat Inc., Durham, North Carolina.
+ * All Rights Reserved.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+
+#include <libxml/xmlreader.h>
+
+#include "public/cve_nvd.h"
+#include "cve_priv.h"
+
+#include "common/alloc.h"
+#include "common/list.h"
+#include "common/util.h"
+#include "common/_error.h"
+#include "common/xmltext_priv.h"
+#include "common/public/oscap_text.h"
+
+#define CVE_INDEX_MAGIC "oscap-cve-index"
+#define CVE_INDEX_VERSION 1
+#define CVE_INDEX_HSIZE 65521
+
+/*
+ * Raw byte scanner.
+ *
+ * The scanner sees every block of the feed before it is handed to the XML
+ * parser and records the offset of each "<entry" (or "<prefix:entry") start
+ * tag, skipping comments, CDATA sections and processing instructions.
+ * Offsets are queued in document order, so the n-th entry returned by the
+ * parser corresponds to the n-th queued offset.
+ */
+enum {
+	SCAN_TEXT,
+	SCAN_TAG,
+	SCAN_BANG,
+	SCAN_COMMENT,
+	SCAN_CDATA,
+	SCAN_PI
+};
+
+struct cve_index_scanner {
+	FILE *fp;
+	off_t offset;		/* number of bytes read from the feed */
+	int state;
+	char name[32];		/* tag name or declaration being read */
+	size_t name_len;
+	int tail;		/* progress in matching a terminator */
+	off_t tag_start;
+	off_t *queue;		/* offsets of entries not yet parsed */
+	size_t queue_head;
+	size_t queue_len;
+	size_t queue_size;
+};
+
+static void _cve_index_queue_push(struct cve_index_scanner *sc, off_t offset)
+{
+	if (sc->queue_head > 0 && sc->queue_len == sc->queue_size) {
+		memmove(sc->queue, sc->queue + sc->queue_head,
+			(sc->queue_len - sc->queue_head) * sizeof(off_t));
+		sc->queue_len -= sc->queue_head;
+		sc->queue_head = 0;
+	}
+	if (sc->queue_len == sc->queue_size) {
+		sc->queue_size = sc->queue_size ? 2 * sc->queue_size : 64;
+		sc->queue = oscap_realloc(sc->queue, sc->queue_size * sizeof(off_t));
+	}
+	sc->queue[sc->queue_len++] = offset;
+}
+
+static off_t _cve_index_queue_pop(struct cve_index_scanner *sc)
+{
+	if (sc->queue_head == sc->queue_len)
+		return -1;
+	return sc->queue[sc->queue_head++];
+}
+
+static void _cve_index_scan_tag_name(struct cve_index_scanner *sc)
+{
+	const char *local;
+
+	sc->name[sc->name_len] = '\0';
+	local = strrchr(sc->name, ':');
+	local = local ? local + 1 : sc->name;
+
+	if (strcmp(local, "entry") == 0)
+		_cve_index_queue_push(sc, sc->tag_start);
+}
+
+static void _cve_index_scan(struct cve_index_scanner *sc, const char *buf, size_t len)
+{
+	for (size_t i = 0; i < len; ++i, ++sc->offset) {
+		char c = buf[i];
+
+		switch (sc->state) {
+		case SCAN_TEXT:
+			if (c == '<') {
+				sc->state = SCAN_TAG;
+				sc->tag_start = sc->offset;
+				sc->name_len = 0;
+			}
+			break;
+		case SCAN_TAG:
+			if (sc->name_len == 0 && c == '!') {
+				sc->state = SCAN_BANG;
+			} else if (sc->name_len == 0 && c == '?') {
+				sc->state = SCAN_PI;
+				sc->tail = 0;
+			} else if (sc->name_len == 0 && c == '/') {
+				sc->state = SCAN_TEXT;
+			} else if (c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '>' || c == '/') {
+				_cve_index_scan_tag_name(sc);
+				sc->state = SCAN_TEXT;
+			} else if (sc->name_len < sizeof(sc->name) - 1) {
+				sc->name[sc->name_len++] = c;
+			} else {
+				/* too long to be an entry */
+				sc->state = SCAN_TEXT;
+			}
+			break;
+		case SCAN_BANG:
+			sc->name[sc->name_len++] = c;
+			sc->name[sc->name_len] = '\0';
+			if (strcmp(sc->name, "--") == 0) {
+				sc->state = SCAN_COMMENT;
+				sc->tail = 0;
+			} else if (strcmp(sc->name, "[CDATA[") == 0) {
+				sc->state = SCAN_CDATA;
+				sc->tail = 0;
+			} else if (strncmp(sc->name, "--", sc->name_len) != 0 &&
+				   strncmp(sc->name, "[CDATA[", sc->name_len) != 0) {
+				/* <!DOCTYPE ...> and friends */
+				sc->state = SCAN_TEXT;
+			}
+			break;
+		case SCAN_COMMENT:
+		case SCAN_CDATA:
+			if (c == (sc->state == SCAN_COMMENT ? '-' : ']')) {
+				if (sc->tail < 2)
+					++sc->tail;
+			} else if (c == '>' && sc->tail == 2) {
+				sc->state = SCAN_TEXT;
+			} else {
+				sc->tail = 0;
+			}
+			break;
+		case SCAN_PI:
+			if (c == '>' && sc->tail)
+				sc->state = SCAN_TEXT;
+			else
+				sc->tail = (c == '?');
+			break;
+		}
+	}
+}
+
+static int _cve_index_scanner_read(void *context, char *buffer, int len)
+{
+	struct cve_index_scanner *sc = (struct cve_index_scanner *) context;
+	size_t n;
+
+	n = fread(buffer, 1, len, sc->fp);
+	if (n == 0 && ferror(sc->fp))
+		return -1;
+
+	_cve_index_scan(sc, buffer, n);
+	return (int) n;
+}
+
+/*
+ * Spliced feed reader.
+ *
+ * Serves bytes [0, header) of the feed, i.e. everything up to the first
+ * entry including the root start tag with its namespace declarations,
+ * followed by bytes [offset, EOF). The result is a well-formed feed which
+ * starts with the looked up entry.
+ */
+struct cve_index_splice {
+	FILE *fp;
+	off_t header;
+	off_t offset;
+	off_t pos;
+	bool seeked;
+};
+
+static int _cve_index_splice_read(void *context, char *buffer, int len)
+{
+	struct cve_index_splice *sp = (struct cve_index_splice *) context;
+	size_t n;
+
+	if (!sp->seeked && sp->pos >= sp->header) {
+		if (fseeko(sp->fp, sp->offset, SEEK_SET) != 0)
+			return -1;
+		sp->seeked = true;
+	}
+
+	if (!sp->seeked && sp->pos + len > sp->header)
+		len = (int) (sp->header - sp->pos);
+
+	n = fread(buffer, 1, len, sp->fp);
+	if (n == 0 && ferror(sp->fp))
+		return -1;
+
+	sp->pos += n;
+	return (int) n;
+}
+
+static int _cve_index_io_close(void *context)
+{
+	/* the FILE is owned by the caller */
+	return 0;
+}
+
+/***************************************************************************/
+
+struct cve_index_record {
+	off_t offset;
+};
+
+/**
+ * @struct cve_index
+ * Loaded index of a CVE feed
+ */
+struct cve_index {
+	char *feed;
+	off_t header;
+	struct oscap_htable *entries;	/* CVE ID -> struct cve_index_record */
+	struct oscap_htable *products;	/* CPE -> struct oscap_stringlist of CVE IDs */
+};
+
+int cve_index_build(const char *feed, const char *index_file)
+{
+	__attribute__nonnull__(feed);
+	__attribute__nonnull__(index_file);
+
+	struct cve_index_scanner sc;
+	struct cve_entry *entry;
+	struct cve_product_iterator *prod_it;
+	struct stat st;
+	xmlTextReaderPtr reader = NULL;
+	FILE *out = NULL;
+	off_t offset;
+	bool header_written = false;
+	int ret = -1;
+
+	memset(&sc, 0, sizeof(sc));
+	sc.state = SCAN_TEXT;
+
+	sc.fp = fopen(feed, "rb");
+	if (sc.fp == NULL || fstat(fileno(sc.fp), &st) != 0) {
+		oscap_seterr(OSCAP_EFAMILY_GLIBC, "Unable to open CVE feed '%s': %s", feed, strerror(errno));
+		goto cleanup;
+	}
+
+	out = fopen(index_file, "w");
+	if (out == NULL) {
+		oscap_seterr(OSCAP_EFAMILY_GLIBC, "Unable to create CVE index '%s': %s", index_file, strerror(errno));
+		goto cleanup;
+	}
+
+	reader = xmlReaderForIO(_cve_index_scanner_read, _cve_index_io_close, &sc, feed, NULL, 0);
+	if (reader == NULL || xmlTextReaderNextNode(reader) == -1) {
+		oscap_seterr(OSCAP_EFAMILY_XML, "Unable to parse CVE feed '%s'. Only uncompressed feeds can be indexed.", feed);
+		goto cleanup;
+	}
+
+	if (xmlStrcmp(xmlTextReaderConstLocalName(reader), BAD_CAST "nvd") != 0) {
+		oscap_seterr(OSCAP_EFAMILY_OSCAP, "File '%s' is not a CVE NVD feed.", feed);
+		goto cleanup;
+	}
+
+	fprintf(out, "%s %d\n", CVE_INDEX_MAGIC, CVE_INDEX_VERSION);
+	fprintf(out, "feed %lld %lld\n", (long long) st.st_size, (long long) st.st_mtime);
+
+	xmlTextReaderNextElement(reader);
+	while (xmlStrcmp(xmlTextReaderConstLocalName(reader), BAD_CAST "entry") == 0) {
+		/* pop before parsing, the parser reads ahead of this entry */
+		offset = _cve_index_queue_pop(&sc);
+		if (!header_written && offset >= 0) {
+			fprintf(out, "header %lld\n", (long long) offset);
+			header_written = true;
+		}
+
+		entry = cve_entry_parse(reader);
+		if (entry != NULL) {
+			const char *id = cve_entry_get_id(entry);
+
+			fprintf(out, "entry %s %lld\n", id, (long long) offset);
+			prod_it = cve_entry_get_products(entry);
+			while (cve_product_iterator_has_more(prod_it)) {
+				const char *value = cve_product_get_value(cve_product_iterator_next(prod_it));
+				if (value != NULL)
+					fprintf(out, "product %s %s\n", value, id);
+			}
+			cve_product_iterator_free(prod_it);
+			cve_entry_free(entry);
+		}
+		xmlTextReaderNextElement(reader);
+	}
+
+	if (ferror(out)) {
+		oscap_seterr(OSCAP_EFAMILY_GLIBC, "Unable to write CVE index '%s'.", index_file);
+		goto cleanup;
+	}
+
+	ret = 0;
+cleanup:
+	if (reader != NULL)
+		xmlFreeTextReader(reader);
+	if (out != NULL && fclose(out) != 0)
+		ret = -1;
+	if (sc.fp != NULL)
+		fclose(sc.fp);
+	oscap_free(sc.queue);
+	return ret;
+}
+
+static void _cve_index_stringlist_free(void *list)
+{
+	oscap_stringlist_free((struct oscap_stringlist *) list);
+}
+
+void cve_index_free(struct cve_index *index)
+{
+	if (index == NULL)
+		return;
+
+	oscap_htable_free(index->entries, oscap_free);
+	oscap_htable_free(index->products, _cve_index_stringlist_free);
+	oscap_free(index->feed);
+	oscap_free(index);
+}
+
+struct cve_index *cve_index_load(const char *index_file, const char *feed)
+{
+	__attribute__nonnull__(index_file);
+	__attribute__nonnull__(feed);
+
+	struct cve_index *index = NULL;
+	struct stat st;
+	FILE *fp;
+	char *line = NULL;
+	size_t line_size = 0;
+	long long size = -1, mtime = -1;
+	int version = 0;
+	char *saveptr, *kind, *key, *value;
+
+	if (stat(feed, &st) != 0) {
+		oscap_seterr(OSCAP_EFAMILY_GLIBC, "Unable to stat CVE feed '%s': %s", feed, strerror(errno));
+		return NULL;
+	}
+
+	fp = fopen(index_file, "r");
+	if (fp == NULL) {
+		oscap_seterr(OSCAP_EFAMILY_GLIBC, "Unable to open CVE index '%s': %s", index_file, strerror(errno));
+		return NULL;
+	}
+
+	if (getline(&line, &line_size, fp) == -1 ||
+	    sscanf(line, CVE_INDEX_MAGIC " %d", &version) != 1 || version != CVE_INDEX_VERSION) {
+		oscap_seterr(OSCAP_EFAMILY_OSCAP, "File '%s' is not a CVE index of a supported version.", index_file);
+		goto fail;
+	}
+
+	index = oscap_calloc(1, sizeof(struct cve_index));
+	index->feed = oscap_strdup(feed);
+	index->entries = oscap_htable_new1(strcmp, CVE_INDEX_HSIZE);
+	index->products = oscap_htable_new1(strcmp, CVE_INDEX_HSIZE);
+
+	while (getline(&line, &line_size, fp) != -1) {
+		kind = strtok_r(line, " \n", &saveptr);
+		key = strtok_r(NULL, " \n", &saveptr);
+		value = strtok_r(NULL, " \n", &saveptr);
+		if (kind == NULL || key == NULL)
+			continue;
+
+		if (strcmp(kind, "header") == 0) {
+			index->header = (off_t) strtoll(key, NULL, 10);
+			continue;
+		}
+
+		if (value == NULL)
+			continue;
+
+		if (strcmp(kind, "entry") == 0) {
+			struct cve_index_record *record = oscap_alloc(sizeof(struct cve_index_record));
+			record->offset = (off_t) strtoll(value, NULL, 10);
+			if (!oscap_htable_add(index->entries, key, record))
+				oscap_free(record);
+		} else if (strcmp(kind, "product") == 0) {
+			struct oscap_stringlist *ids = oscap_htable_get(index->products, key);
+			if (ids == NULL) {
+				ids = oscap_stringlist_new();
+				oscap_htable_add(index->products, key, ids);
+			}
+			oscap_stringlist_add_string(ids, value);
+		} else if (strcmp(kind, "feed") == 0) {
+			size = strtoll(key, NULL, 10);
+			mtime = strtoll(value, NULL, 10);
+		}
+	}
+
+	if (size != (long long) st.st_size || mtime != (long long) st.st_mtime) {
+		oscap_seterr(OSCAP_EFAMILY_OSCAP, "CVE index '%s' is out of date with feed '%s'.", index_file, feed);
+		goto fail;
+	}
+
+	free(line);
+	fclose(fp);
+	return index;
+fail:
+	cve_index_free(index);
+	free(line);
+	fclose(fp);
+	return NULL;
+}
+
+struct cve_entry_lookup {
+	const char *id;
+	struct cve_entry *entry;
+};
+
+static int _cve_index_lookup_cb(struct cve_entry *entry, void *user)
+{
+	struct cve_entry_lookup *lookup = (struct cve_entry_lookup *) user;
+
+	if (oscap_strcmp(cve_entry_get_id(entry), lookup->id) != 0) {
+		cve_entry_free(entry);
+		return 0;
+	}
+
+	lookup->entry = entry;
+	return 1;
+}
+
+static struct cve_entry *_cve_index_lookup_from(const struct cve_index *index, FILE *fp, off_t offset, const char *id)
+{
+	struct cve_index_splice sp = { .fp = fp, .header = index->header, .offset = offset };
+	struct cve_entry_lookup lookup = { .id = id, .entry = NULL };
+	xmlTextReaderPtr reader;
+
+	if (fseeko(fp, 0, SEEK_SET) != 0)
+		return NULL;
+
+	reader = xmlReaderForIO(_cve_index_splice_read, _cve_index_io_close, &sp, index->feed, NULL, 0);
+	if (reader == NULL)
+		return NULL;
+
+	if (xmlTextReaderNextNode(reader) != -1)
+		cve_model_parse_stream(reader, _cve_index_lookup_cb, &lookup);
+
+	xmlFreeTextReader(reader);
+	return lookup.entry;
+}
+
+struct cve_entry *cve_index_find_entry(const struct cve_index *index, const char *cve_id)
+{
+	__attribute__nonnull__(index);
+	__attribute__nonnull__(cve_id);
+
+	struct cve_index_record *record;
+	struct cve_entry *entry = NULL;
+	FILE *fp;
+
+	record = oscap_htable_get((struct oscap_htable *) index->entries, cve_id);
+	if (record == NULL)
+		return NULL;
+
+	fp = fopen(index->feed, "rb");
+	if (fp == NULL) {
+		oscap_seterr(OSCAP_EFAMILY_GLIBC, "Unable to open CVE feed '%s': %s", index->feed, strerror(errno));
+		return NULL;
+	}
+
+	if (record->offset >= index->header)
+		entry = _cve_index_lookup_from(index, fp, record->offset, cve_id);
+
+	/* The recorded offset did not lead to the entry; parse the feed
+	 * from the first entry on rather than giving up. */
+	if (entry == NULL && record->offset != index->header)
+		entry = _cve_index_lookup_from(index, fp, index->header, cve_id);
+
+	fclose(fp);
+	return entry;
+}
+
+struct oscap_string_iterator *cve_index_get_entries_by_product(const struct cve_index *index, const char *product)
+{
+	__attribute__nonnull__(index);
+	__attribute__nonnull__(product);
+
+	struct oscap_stringlist *ids = oscap_htable_get((struct oscap_htable *) index->products, product);
+
+	if (ids == NULL)
+		return NULL;
+
+	return oscap_stringlist_get_strings(ids);
+}
@@ -455,6 +455,41 @@ struct cve_model *cve_model_parse(xmlTextReaderPtr reader)
 	return ret;
 }
 
+int cve_model_parse_stream(xmlTextReaderPtr reader, cve_entry_consumer consumer, void *user)
+{
+
+	__attribute__nonnull__(reader);
+	__attribute__nonnull__(consumer);
+
+	struct cve_entry *entry = NULL;
+	int ret = 0;
+
+	if (xmlStrcmp(xmlTextReaderConstLocalName(reader), TAG_NVD_STR) != 0 ||
+	    xmlTextReaderNodeType(reader) != XML_READER_TYPE_ELEMENT) {
+		oscap_seterr(OSCAP_EFAMILY_OSCAP, "Expected '%s' root element in CVE feed, got '%s'.",
+			(const char *) TAG_NVD_STR, (const char *) xmlTextReaderConstLocalName(reader));
+		return -1;
+	}
+
+	/* skip nodes until new element */
+	xmlTextReaderNextElement(reader);
+
+	/* CVE-specification: entry; nodes of processed entries are released by
+	 * the reader as it moves on, so only one entry is held at a time */
+	while (xmlStrcmp(xmlTextReaderConstLocalName(reader), TAG_CVE_STR) == 0) {
+
+		entry = cve_entry_parse(reader);
+		if (entry) {
+			ret = consumer(entry, user);
+			if (ret != 0)
+				return ret;
+		}
+		xmlTextReaderNextElement(reader);
+	}
+
+	return 0;
+}
+
 struct cve_entry *cve_entry_parse(xmlTextReaderPtr reader)
 {
 
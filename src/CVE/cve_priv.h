@@ -38,6 +38,7 @@
 
 #include "../common/list.h"
 #include "../common/elements.h"
+#include "public/cve_nvd.h"
 
 /** 
  * @cond INTERNAL
@@ -95,6 +96,15 @@ struct cve_model *cve_model_parse_xml(const char *file);
  */
 struct cve_model *cve_model_parse(xmlTextReaderPtr reader);
 
+/**
+ * Parse CVE feed entry by entry and pass each parsed entry to the consumer
+ * @param reader XML Text Reader positioned at the root element of the feed
+ * @param consumer callback invoked for each entry, it takes ownership of the entry
+ * @param user user data passed to the consumer
+ * @return 0 on success, -1 on error, or the non-zero value returned by the consumer
+ */
+int cve_model_parse_stream(xmlTextReaderPtr reader, cve_entry_consumer consumer, void *user);
+
 /**
  * Parse CVE entry
  * @param reader XML Text Reader representing XML model
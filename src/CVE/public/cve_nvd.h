@@ -75,8 +75,15 @@ struct cwe_entry;
  */
 struct cve_reference;
 
+/**
+ * @struct cve_index
+ * Structure holding an on-disk index of CVE feed
+ */
+struct cve_index;
+
 // fwd
 struct cvss_impact;
+struct oscap_string_iterator;
 
 /************************************************************/
 /**
@@ -672,6 +679,77 @@ void cve_model_export(struct cve_model *cve, const char *file);
  */
 struct cve_model *cve_model_import(const char *file);
 
+/**
+ * Callback used by cve_model_import_stream() to pass parsed CVE entries.
+ * The callback takes ownership of the entry and is supposed to free it
+ * by cve_entry_free() when it is no longer needed.
+ * @param entry parsed CVE entry
+ * @param user user data passed to cve_model_import_stream()
+ * @return zero to continue with the next entry, non-zero to stop
+ */
+typedef int (*cve_entry_consumer) (struct cve_entry *entry, void *user);
+
+/**
+ * Parse the specified XML file one CVE entry at a time. Entries are passed
+ * to the consumer as soon as they are parsed and no CVE model is built.
+ * The feed (also a bzip2 compressed one) is read as the parsing advances,
+ * so the memory used doesn't depend on the size of the feed.
+ * Use cve_index_build() and cve_index_find_entry() to look up single entries
+ * of large feeds.
+ * @memberof cve_model
+ * @param file filename
+ * @param consumer callback invoked for each CVE entry
+ * @param user user data passed to the consumer
+ * @return 0 on success, -1 on error, or the non-zero value the consumer stopped with
+ */
+int cve_model_import_stream(const char *file, cve_entry_consumer consumer, void *user);
+
+/**
+ * Build an index of the specified CVE feed in one pass over the feed.
+ * The index maps CVE IDs to positions of their entries in the feed and
+ * CPE products to IDs of CVE entries listing them as vulnerable software.
+ * Only uncompressed feeds can be indexed.
+ * @memberof cve_index
+ * @param feed filename of CVE feed
+ * @param index_file filename of the index to create
+ * @return 0 on success, -1 on error
+ */
+int cve_index_build(const char *feed, const char *index_file);
+
+/**
+ * Load index of CVE feed created by cve_index_build().
+ * @memberof cve_index
+ * @param index_file filename of the index
+ * @param feed filename of the indexed feed
+ * @return loaded index or NULL if the index cannot be read or the feed
+ * has changed since the index was built
+ */
+struct cve_index *cve_index_load(const char *index_file, const char *feed);
+
+/**
+ * Find CVE entry in the indexed feed. Only the entry itself is parsed.
+ * @memberof cve_index
+ * @param index CVE index
+ * @param cve_id ID of the CVE entry
+ * @return new CVE entry (free it with cve_entry_free()) or NULL if not found
+ */
+struct cve_entry *cve_index_find_entry(const struct cve_index *index, const char *cve_id);
+
+/**
+ * Get IDs of CVE entries listing the given product as vulnerable software.
+ * @memberof cve_index
+ * @param index CVE index
+ * @param product CPE name of the product
+ * @return iterator over CVE IDs or NULL if the product is not listed
+ */
+struct oscap_string_iterator *cve_index_get_entries_by_product(const struct cve_index *index, const char *product);
+
+/**
+ * Free CVE index
+ * @memberof cve_index
+ */
+void cve_index_free(struct cve_index *index);
+
 /// @memberof cve_model
 const char *cve_model_get_nvd_xml_version(const struct cve_model *item);
 /// @memberof cve_model
@@ -0,0 +1,433 @@
+/*
+ * Copyright 2026 Red Hat Inc., Durham, North Carolina.
+ * All Rights Reserved.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <libxml/tree.h>
+
+#include "common/alloc.h"
+#include "common/_error.h"
+#include "common/list.h"
+#include "common/public/oscap.h"
+#include "common/util.h"
+#include "ds_image_priv.h"
+#include "ds_sds_session_priv.h"
+#include "sds_index_priv.h"
+#include "source/oscap_source_priv.h"
+
+#define DS_IMAGE_ALIGN(n) (((n) + 7) & ~(uint64_t)7)
+
+struct ds_image {
+	char *filepath;                         ///< Path of the image file
+	const char *map;                        ///< Mapped image
+	size_t size;                            ///< Size of the mapping
+	const struct ds_image_entry *entries;   ///< Entry table within the mapping
+	uint32_t entry_count;
+	const char *datastream_id;              ///< Selected datastream (points to the mapping)
+	const char *checklist_id;               ///< Selected checklist (points to the mapping)
+	const char *benchmark_id;               ///< ID of the Benchmark in the checklist
+	struct oscap_stringlist *dictionaries;  ///< Hrefs of CPE dictionaries
+};
+
+/*
+ * Checksum of everything that follows the header: the entry table, the
+ * names and all the data.
+ */
+static uint64_t ds_image_checksum(const char *image, size_t size)
+{
+	const char *data = image + sizeof(struct ds_image_header);
+	uint64_t h = 14695981039346656037ULL;
+
+	size -= sizeof(struct ds_image_header);
+	while (size-- > 0) {
+		h ^= (unsigned char)*data++;
+		h *= 1099511628211ULL;
+	}
+	return h;
+}
+
+/*
+ * Writing
+ */
+
+struct ds_image_builder {
+	struct ds_image_entry *entries;
+	size_t entry_count;
+	char *data;                             ///< names and data, appended after the entry table
+	size_t data_size;
+};
+
+static uint64_t ds_image_builder_append(struct ds_image_builder *b, const char *data, size_t size)
+{
+	uint64_t offset = b->data_size;
+	size_t padded = DS_IMAGE_ALIGN(size + 1);
+
+	b->data = oscap_realloc(b->data, b->data_size + padded);
+	memcpy(b->data + b->data_size, data, size);
+	// The terminating zero makes names and meta values usable as C strings
+	memset(b->data + b->data_size + size, 0, padded - size);
+	b->data_size += padded;
+
+	return offset;
+}
+
+static void ds_image_builder_add(struct ds_image_builder *b, ds_image_entry_type_t type,
+		const char *name, const char *data, size_t data_size)
+{
+	struct ds_image_entry *e;
+
+	b->entries = oscap_realloc(b->entries, (b->entry_count + 1) * sizeof(struct ds_image_entry));
+	e = b->entries + b->entry_count++;
+
+	e->type = type;
+	e->name_size = strlen(name);
+	e->name_offset = ds_image_builder_append(b, name, e->name_size);
+	e->data_size = data_size;
+	e->data_offset = data != NULL ? ds_image_builder_append(b, data, data_size) : 0;
+}
+
+static int ds_image_builder_add_source(struct ds_image_builder *b, ds_image_entry_type_t type,
+		const char *name, struct oscap_source *source)
+{
+	char *buffer = NULL;
+	size_t size = 0;
+
+	if (oscap_source_get_raw_memory(source, &buffer, &size) != 0)
+		return -1;
+
+	ds_image_builder_add(b, type, name, buffer, size);
+	free(buffer);
+	return 0;
+}
+
+static int ds_image_builder_save(struct ds_image_builder *b, const char *target_file)
+{
+	struct ds_image_header header;
+	size_t table_size = DS_IMAGE_ALIGN(b->entry_count * sizeof(struct ds_image_entry));
+	uint64_t base = sizeof(struct ds_image_header) + table_size;
+	char *image;
+	size_t image_size = base + b->data_size;
+	int ret = -1;
+
+	// Offsets are relative to the start of the image
+	for (size_t i = 0; i < b->entry_count; ++i) {
+		b->entries[i].name_offset += base;
+		if (b->entries[i].data_offset != 0 || b->entries[i].data_size != 0)
+			b->entries[i].data_offset += base;
+	}
+
+	image = oscap_calloc(1, image_size);
+	memcpy(image + sizeof header, b->entries, b->entry_count * sizeof(struct ds_image_entry));
+	memcpy(image + base, b->data, b->data_size);
+
+	memset(&header, 0, sizeof header);
+	memcpy(header.magic, DS_IMAGE_MAGIC, sizeof header.magic);
+	header.version = DS_IMAGE_VERSION;
+	header.byte_order = DS_IMAGE_BYTE_ORDER;
+	header.entry_count = b->entry_count;
+	header.size = image_size;
+	header.checksum = ds_image_checksum(image, image_size);
+	memcpy(image, &header, sizeof header);
+
+	FILE *fp = fopen(target_file, "wb");
+	if (fp == NULL) {
+		oscap_seterr(OSCAP_EFAMILY_GLIBC, "Could not open '%s' for writing: %s", target_file, strerror(errno));
+	} else {
+		if (fwrite(image, 1, image_size, fp) != image_size)
+			oscap_seterr(OSCAP_EFAMILY_GLIBC, "Could not write '%s': %s", target_file, strerror(errno));
+		else
+			ret = 0;
+		if (fclose(fp) != 0 && ret == 0) {
+			oscap_seterr(OSCAP_EFAMILY_GLIBC, "Could not write '%s': %s", target_file, strerror(errno));
+			ret = -1;
+		}
+	}
+
+	oscap_free(image);
+	return ret;
+}
+
+static char *ds_image_get_benchmark_id_from_source(struct oscap_source *xccdf)
+{
+	xmlDoc *doc = oscap_source_get_xmlDoc(xccdf);
+	xmlNode *root = doc != NULL ? xmlDocGetRootElement(doc) : NULL;
+
+	return root != NULL ? (char *) xmlGetProp(root, BAD_CAST "id") : NULL;
+}
+
+int ds_image_write(struct ds_sds_session *session, const char *target_file)
+{
+	struct ds_image_builder b;
+	struct oscap_htable_iterator *hit;
+	struct oscap_string_iterator *cpe_it;
+	struct ds_stream_index *stream_idx;
+	struct oscap_source *xccdf;
+	char *benchmark_id;
+	int ret = -1;
+
+	xccdf = ds_sds_session_get_component_by_href(session, "xccdf.xml");
+	if (xccdf == NULL) {
+		oscap_seterr(OSCAP_EFAMILY_OSCAP, "Internal error: No checklist has been selected, nothing to write.");
+		return -1;
+	}
+	stream_idx = ds_sds_index_get_stream(ds_sds_session_get_sds_idx(session), ds_sds_session_get_datastream_id(session));
+	if (stream_idx == NULL) {
+		oscap_seterr(OSCAP_EFAMILY_OSCAP, "Could not find datastream '%s' in the index.", ds_sds_session_get_datastream_id(session));
+		return -1;
+	}
+
+	memset(&b, 0, sizeof b);
+
+	benchmark_id = ds_image_get_benchmark_id_from_source(xccdf);
+	ds_image_builder_add(&b, DS_IMAGE_META, "generator", oscap_get_version(), strlen(oscap_get_version()));
+	ds_image_builder_add(&b, DS_IMAGE_META, "datastream-id", ds_sds_session_get_datastream_id(session),
+			strlen(ds_sds_session_get_datastream_id(session)));
+	ds_image_builder_add(&b, DS_IMAGE_META, "checklist-id", ds_sds_session_get_checklist_id(session),
+			strlen(ds_sds_session_get_checklist_id(session)));
+	if (benchmark_id != NULL)
+		ds_image_builder_add(&b, DS_IMAGE_META, "benchmark-id", benchmark_id, strlen(benchmark_id));
+	xmlFree(benchmark_id);
+
+	cpe_it = ds_stream_index_get_dictionaries(stream_idx);
+	while (oscap_string_iterator_has_more(cpe_it)) {
+		ds_image_builder_add(&b, DS_IMAGE_DICTIONARY, oscap_string_iterator_next(cpe_it), NULL, 0);
+	}
+	oscap_string_iterator_free(cpe_it);
+
+	hit = oscap_htable_iterator_new(ds_sds_session_get_component_sources(session));
+	while (oscap_htable_iterator_has_more(hit)) {
+		const char *href;
+		void *source;
+
+		oscap_htable_iterator_next_kv(hit, &href, &source);
+		if (ds_image_builder_add_source(&b, DS_IMAGE_COMPONENT, href, source) != 0) {
+			oscap_htable_iterator_free(hit);
+			goto cleanup;
+		}
+	}
+	oscap_htable_iterator_free(hit);
+
+	if (ds_image_builder_add_source(&b, DS_IMAGE_COLLECTION, oscap_source_readable_origin(ds_sds_session_get_source(session)),
+			ds_sds_session_get_source(session)) != 0)
+		goto cleanup;
+
+	ret = ds_image_builder_save(&b, target_file);
+cleanup:
+	oscap_free(b.entries);
+	oscap_free(b.data);
+	return ret;
+}
+
+/*
+ * Loading
+ */
+
+bool ds_image_detect(const char *filepath)
+{
+	char magic[sizeof(((struct ds_image_header *)0)->magic)];
+	bool ret = false;
+	int fd;
+
+	if ((fd = open(filepath, O_RDONLY)) < 0)
+		return false;
+	if (read(fd, magic, sizeof magic) == sizeof magic)
+		ret = memcmp(magic, DS_IMAGE_MAGIC, sizeof magic) == 0;
+	close(fd);
+
+	return ret;
+}
+
+static bool ds_image_range_valid(const struct ds_image *image, uint64_t offset, uint64_t size)
+{
+	return offset <= image->size && size <= image->size - offset;
+}
+
+static int ds_image_verify(struct ds_image *image)
+{
+	const struct ds_image_header *header = (const struct ds_image_header *) image->map;
+
+	if (image->size < sizeof(struct ds_image_header) || memcmp(header->magic, DS_IMAGE_MAGIC, sizeof header->magic) != 0) {
+		oscap_seterr(OSCAP_EFAMILY_OSCAP, "'%s' is not a content image.", image->filepath);
+		return -1;
+	}
+	if (header->version != DS_IMAGE_VERSION || header->byte_order != DS_IMAGE_BYTE_ORDER) {
+		oscap_seterr(OSCAP_EFAMILY_OSCAP, "Content image '%s' has unsupported version %u, "
+				"write the image again.", image->filepath, header->version);
+		return -1;
+	}
+	if (header->size != image->size ||
+			header->checksum != ds_image_checksum(image->map, image->size) ||
+			!ds_image_range_valid(image, sizeof *header, (uint64_t) header->entry_count * sizeof(struct ds_image_entry))) {
+		oscap_seterr(OSCAP_EFAMILY_OSCAP, "Content image '%s' is corrupted.", image->filepath);
+		return -1;
+	}
+
+	image->entries = (const struct ds_image_entry *) (image->map + sizeof *header);
+	image->entry_count = header->entry_count;
+
+	// Names and meta values are used as C strings right from the mapping
+	for (uint32_t i = 0; i < image->entry_count; ++i) {
+		const struct ds_image_entry *e = image->entries + i;
+
+		if (!ds_image_range_valid(image, e->name_offset, (uint64_t) e->name_size + 1) ||
+				image->map[e->name_offset + e->name_size] != '\0' ||
+				!ds_image_range_valid(image, e->data_offset, e->data_size) ||
+				(e->type == DS_IMAGE_META && (!ds_image_range_valid(image, e->data_offset, e->data_size + 1) ||
+				 image->map[e->data_offset + e->data_size] != '\0'))) {
+			oscap_seterr(OSCAP_EFAMILY_OSCAP, "Content image '%s' is corrupted.", image->filepath);
+			return -1;
+		}
+	}
+	return 0;
+}
+
+struct ds_image *ds_image_open(const char *filepath)
+{
+	struct ds_image *image;
+	struct stat st;
+	void *map;
+	int fd;
+
+	if ((fd = open(filepath, O_RDONLY)) < 0) {
+		oscap_seterr(OSCAP_EFAMILY_GLIBC, "Could not open '%s': %s", filepath, strerror(errno));
+		return NULL;
+	}
+	if (fstat(fd, &st) != 0) {
+		oscap_seterr(OSCAP_EFAMILY_GLIBC, "Could not stat '%s': %s", filepath, strerror(errno));
+		close(fd);
+		return NULL;
+	}
+	map = st.st_size > 0 ? mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0) : MAP_FAILED;
+	close(fd);
+	if (map == MAP_FAILED) {
+		oscap_seterr(OSCAP_EFAMILY_GLIBC, "Could not map '%s': %s", filepath, strerror(errno));
+		return NULL;
+	}
+
+	image = oscap_calloc(1, sizeof(struct ds_image));
+	image->filepath = oscap_strdup(filepath);
+	image->map = map;
+	image->size = st.st_size;
+	image->dictionaries = oscap_stringlist_new();
+
+	if (ds_image_verify(image) != 0) {
+		ds_image_free(image);
+		return NULL;
+	}
+
+	for (uint32_t i = 0; i < image->entry_count; ++i) {
+		const struct ds_image_entry *e = image->entries + i;
+		const char *name = image->map + e->name_offset;
+
+		switch (e->type) {
+		case DS_IMAGE_META:
+			if (oscap_streq(name, "datastream-id"))
+				image->datastream_id = image->map + e->data_offset;
+			else if (oscap_streq(name, "checklist-id"))
+				image->checklist_id = image->map + e->data_offset;
+			else if (oscap_streq(name, "benchmark-id"))
+				image->benchmark_id = image->map + e->data_offset;
+			break;
+		case DS_IMAGE_DICTIONARY:
+			oscap_stringlist_add_string(image->dictionaries, name);
+			break;
+		}
+	}
+
+	if (image->datastream_id == NULL || image->checklist_id == NULL) {
+		oscap_seterr(OSCAP_EFAMILY_OSCAP, "Content image '%s' doesn't select any checklist.", filepath);
+		ds_image_free(image);
+		return NULL;
+	}
+	return image;
+}
+
+void ds_image_free(struct ds_image *image)
+{
+	if (image != NULL) {
+		munmap((void *) image->map, image->size);
+		oscap_stringlist_free(image->dictionaries);
+		oscap_free(image->filepath);
+		oscap_free(image);
+	}
+}
+
+const char *ds_image_get_datastream_id(const struct ds_image *image)
+{
+	return image->datastream_id;
+}
+
+const char *ds_image_get_checklist_id(const struct ds_image *image)
+{
+	return image->checklist_id;
+}
+
+const char *ds_image_get_benchmark_id(const struct ds_image *image)
+{
+	return image->benchmark_id;
+}
+
+struct oscap_string_iterator *ds_image_get_dictionaries(const struct ds_image *image)
+{
+	return oscap_stringlist_get_strings(image->dictionaries);
+}
+
+struct oscap_source *ds_image_get_collection_source(const struct ds_image *image)
+{
+	for (uint32_t i = 0; i < image->entry_count; ++i) {
+		const struct ds_image_entry *e = image->entries + i;
+
+		if (e->type == DS_IMAGE_COLLECTION)
+			return oscap_source_new_from_memory(image->map + e->data_offset, e->data_size, image->filepath);
+	}
+
+	oscap_seterr(OSCAP_EFAMILY_OSCAP, "Content image '%s' doesn't contain the source DataStream.", image->filepath);
+	return NULL;
+}
+
+int ds_image_load_session(const struct ds_image *image, struct ds_sds_session *session)
+{
+	for (uint32_t i = 0; i < image->entry_count; ++i) {
+		const struct ds_image_entry *e = image->entries + i;
+		const char *href = image->map + e->name_offset;
+
+		if (e->type != DS_IMAGE_COMPONENT)
+			continue;
+
+		struct oscap_source *component = oscap_source_new_from_memory(image->map + e->data_offset, e->data_size, href);
+		if (ds_sds_session_register_component_source(session, href, component) != 0) {
+			oscap_source_free(component);
+			return -1;
+		}
+	}
+
+	ds_sds_session_set_image_checklist(session, image->datastream_id, image->checklist_id, image->benchmark_id);
+	return 0;
+}
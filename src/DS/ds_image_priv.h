@@ -0,0 +1,125 @@
+/*
+ * Copyright 2026 Red Hat Inc., Durham, North Carolina.
+ * All Rights Reserved.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+#ifndef OSCAP_DS_IMAGE_PRIV_H
+#define OSCAP_DS_IMAGE_PRIV_H
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "common/util.h"
+#include "common/public/oscap_text.h"
+#include "source/public/oscap_source.h"
+#include "DS/public/ds_sds_session.h"
+
+OSCAP_HIDDEN_START;
+
+/*
+ * Content image.
+ *
+ * The image holds the components of one checklist selected from a source
+ * DataStream, already extracted from the collection, together with the
+ * CPE dictionaries of the datastream and the original collection. The
+ * components are stored as XML, they are parsed by the XCCDF, OVAL and
+ * CPE parsers on every load. What the image saves is the DOM of the whole
+ * collection, the extraction of the components and their validation; the
+ * DOM is built only if something outside of the selection is requested
+ * (tailoring component, ARF export).
+ *
+ * Layout: struct ds_image_header, entry table (struct ds_image_entry),
+ * then names and data referenced by offsets from the start of the image.
+ * Integers are in host byte order, the checksum (64-bit FNV-1a) covers
+ * everything that follows the header.
+ */
+#define DS_IMAGE_MAGIC      "OSCAPIMG"
+#define DS_IMAGE_VERSION    3
+#define DS_IMAGE_BYTE_ORDER 0x01020304
+
+typedef enum {
+	DS_IMAGE_META = 1,       ///< name is a key, data is the value
+	DS_IMAGE_COMPONENT,      ///< name is the href of the component, data is the XML
+	DS_IMAGE_DICTIONARY,     ///< name is the href of a CPE dictionary, no data
+	DS_IMAGE_COLLECTION      ///< name is the original file name, data is the collection
+} ds_image_entry_type_t;
+
+struct ds_image_header {
+	char     magic[8];
+	uint32_t version;
+	uint32_t byte_order;
+	uint32_t entry_count;
+	uint32_t reserved;
+	uint64_t size;
+	uint64_t checksum;
+};
+
+struct ds_image_entry {
+	uint32_t type;
+	uint32_t name_size;
+	uint64_t name_offset;
+	uint64_t data_offset;
+	uint64_t data_size;
+};
+
+struct ds_image;
+
+/**
+ * Check whether the file is a content image.
+ */
+bool ds_image_detect(const char *filepath);
+
+/**
+ * Map the image and verify its version and checksum.
+ * @returns the image or NULL with oscap error set
+ */
+struct ds_image *ds_image_open(const char *filepath);
+
+void ds_image_free(struct ds_image *image);
+
+const char *ds_image_get_datastream_id(const struct ds_image *image);
+const char *ds_image_get_checklist_id(const struct ds_image *image);
+const char *ds_image_get_benchmark_id(const struct ds_image *image);
+
+/**
+ * Get the hrefs of the CPE dictionaries, in the order of the datastream.
+ */
+struct oscap_string_iterator *ds_image_get_dictionaries(const struct ds_image *image);
+
+/**
+ * Create a new oscap_source of the original collection, owned by caller.
+ */
+struct oscap_source *ds_image_get_collection_source(const struct ds_image *image);
+
+/**
+ * Register all the components stored in the image with the session and
+ * select the datastream and checklist the image was written for.
+ */
+int ds_image_load_session(const struct ds_image *image, struct ds_sds_session *session);
+
+/**
+ * Write the collection, the selected checklist with its dependencies and
+ * the CPE dictionaries cached by the session into an image file.
+ */
+int ds_image_write(struct ds_sds_session *session, const char *target_file);
+
+OSCAP_HIDDEN_END;
+
+#endif
@@ -0,0 +1,1169 @@
+/*
+ * Copyright 2026 Red Hat Inc., Durham, North Carolina.
+ * All Rights Reserved.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <errno.h>
+#include <fcntl.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <libxml/parser.h>
+#include <libxml/SAX2.h>
+
+#include "common/alloc.h"
+#include "common/_error.h"
+#include "common/list.h"
+#include "common/strpool_priv.h"
+#include "common/util.h"
+#include "ds_rds_store.h"
+
+/*
+ * Layout of the store:
+ *
+ *   blobs/XX/NAME   content of the blob, XX are the first two characters
+ *                   of its name
+ *   index           text records of the imported ARFs, one per line,
+ *                   fields separated by tabs:
+ *                     arf ID SIZE STORED
+ *                     host ID HOSTNAME
+ *                     profile ID PROFILE
+ *   rules/XX/ID     results of the rules in the ARF of given ID, one per
+ *                   line: RULE RESULT
+ *
+ * The records of an ARF are appended to the index in a single write while
+ * the index is locked, so concurrent imports don't interleave them. The
+ * rules file is written before, it's loaded only by the queries which
+ * need the rule results.
+ *
+ * The name of a blob is the 64-bit FNV-1a hash of its content in hex.
+ * Blobs are compared byte by byte before they are deduplicated, if two
+ * different blobs have the same hash, the later gets a "-N" suffix.
+ *
+ * The ARF is stored as a manifest blob listing the names and sizes of its
+ * parts in the order of the document, the name of the manifest is the ID
+ * of the ARF.
+ */
+#define DS_RDS_STORE_INDEX     "index"
+#define DS_RDS_STORE_BLOBS     "blobs"
+#define DS_RDS_STORE_RULES     "rules"
+#define DS_RDS_STORE_MANIFEST  "oscap-rds-store-manifest 1\n"
+#define DS_RDS_STORE_NAME_SIZE 32
+
+/// Size of the chunks the ARF is parsed in
+#define DS_RDS_STORE_CHUNK     (1 << 20)
+
+static const char *arf_ns_uri = "http://scap.nist.gov/schema/asset-reporting-format/1.1";
+static const char *ai_ns_uri = "http://scap.nist.gov/schema/asset-identification/1.1";
+static const char *xccdf_ns_prefix = "http://checklists.nist.gov/xccdf/";
+static const char *oval_res_ns_uri = "http://oval.mitre.org/XMLSchema/oval-results-5";
+static const char *oval_def_ns_uri = "http://oval.mitre.org/XMLSchema/oval-definitions-5";
+
+struct ds_rds_store_rule {
+	const char *rule;                       ///< ID of the rule (interned)
+	const char *result;                     ///< Result of the rule (interned)
+};
+
+struct ds_rds_store_entry {
+	const char *id;                         ///< ID of the ARF (interned)
+	uint64_t size;                          ///< Size of the ARF
+	uint64_t stored;                        ///< Size of the blobs added by the import
+	struct oscap_stringlist *hosts;
+	struct oscap_stringlist *profiles;
+	struct ds_rds_store_rule *rules;        ///< Sorted by rule ID once the entry is complete
+	size_t rule_count;
+	size_t rule_size;
+	bool rules_loaded;                      ///< The rules are read from the store on the first query
+};
+
+struct ds_rds_store {
+	char *path;                             ///< Directory of the store
+	struct oscap_strpool *strings;          ///< IDs and results repeat in every ARF
+	struct ds_rds_store_entry **entries;    ///< In the order of import
+	size_t entry_count;
+	struct oscap_htable *by_id;             ///< ID -> entry
+	uint64_t arf_bytes;
+	uint64_t blob_bytes;
+};
+
+static uint64_t ds_rds_store_hash(const char *data, size_t size)
+{
+	uint64_t h = 14695981039346656037ULL;
+
+	while (size-- > 0) {
+		h ^= (unsigned char)*data++;
+		h *= 1099511628211ULL;
+	}
+	return h;
+}
+
+static bool ds_rds_store_name_valid(const char *name)
+{
+	size_t i;
+
+	for (i = 0; i < 16; ++i) {
+		if (!((name[i] >= '0' && name[i] <= '9') || (name[i] >= 'a' && name[i] <= 'f')))
+			return false;
+	}
+	if (name[i] == '\0')
+		return true;
+	if (name[i++] != '-' || name[i] == '\0')
+		return false;
+	for (; name[i] != '\0'; ++i) {
+		if (name[i] < '0' || name[i] > '9')
+			return false;
+	}
+	return i < DS_RDS_STORE_NAME_SIZE;
+}
+
+static char *ds_rds_store_blob_path(const struct ds_rds_store *store, const char *name)
+{
+	return oscap_sprintf("%s/" DS_RDS_STORE_BLOBS "/%.2s/%s", store->path, name, name);
+}
+
+static char *ds_rds_store_rules_path(const struct ds_rds_store *store, const char *id)
+{
+	return oscap_sprintf("%s/" DS_RDS_STORE_RULES "/%.2s/%s", store->path, id, id);
+}
+
+static int ds_rds_store_mkdir(const char *path)
+{
+	if (mkdir(path, 0755) != 0 && errno != EEXIST) {
+		oscap_seterr(OSCAP_EFAMILY_GLIBC, "Could not create directory '%s': %s", path, strerror(errno));
+		return -1;
+	}
+	return 0;
+}
+
+/*
+ * Map the file, empty files are mapped as NULL.
+ */
+static int ds_rds_store_map(const char *path, const char **map, size_t *size)
+{
+	struct stat st;
+	int fd;
+
+	if ((fd = open(path, O_RDONLY)) < 0) {
+		oscap_seterr(OSCAP_EFAMILY_GLIBC, "Could not open '%s': %s", path, strerror(errno));
+		return -1;
+	}
+	if (fstat(fd, &st) != 0) {
+		oscap_seterr(OSCAP_EFAMILY_GLIBC, "Could not stat '%s': %s", path, strerror(errno));
+		close(fd);
+		return -1;
+	}
+
+	*size = st.st_size;
+	*map = NULL;
+
+	if (*size > 0) {
+		void *m = mmap(NULL, *size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+		if (m == MAP_FAILED) {
+			oscap_seterr(OSCAP_EFAMILY_GLIBC, "Could not map '%s': %s", path, strerror(errno));
+			close(fd);
+			return -1;
+		}
+		*map = m;
+	}
+	close(fd);
+	return 0;
+}
+
+static void ds_rds_store_unmap(const char *map, size_t size)
+{
+	if (map != NULL)
+		munmap((void *)map, size);
+}
+
+/*
+ * Compare the blob with the data.
+ * @returns 1 if they are the same, 0 if they differ, 2 if there is no
+ * such blob and -1 on error
+ */
+static int ds_rds_store_blob_compare(const char *path, const char *data, size_t size)
+{
+	const char *map;
+	size_t map_size;
+	struct stat st;
+	int same;
+
+	if (stat(path, &st) != 0) {
+		if (errno == ENOENT)
+			return 2;
+		oscap_seterr(OSCAP_EFAMILY_GLIBC, "Could not stat '%s': %s", path, strerror(errno));
+		return -1;
+	}
+	if ((size_t)st.st_size != size)
+		return 0;
+	if (ds_rds_store_map(path, &map, &map_size) != 0)
+		return -1;
+
+	same = map_size == size && (size == 0 || memcmp(map, data, size) == 0);
+	ds_rds_store_unmap(map, map_size);
+
+	return same;
+}
+
+/*
+ * Write the file through a temporary one, so it appears complete or not at all.
+ */
+static int ds_rds_store_file_write(const char *path, const char *data, size_t size)
+{
+	char *dir = oscap_sprintf("%.*s", (int)(strrchr(path, '/') - path), path);
+	char *tmp = oscap_sprintf("%s.tmp.%ld", path, (long)getpid());
+	int ret = -1;
+	FILE *fp;
+
+	if (ds_rds_store_mkdir(dir) != 0)
+		goto cleanup;
+
+	if ((fp = fopen(tmp, "wb")) == NULL) {
+		oscap_seterr(OSCAP_EFAMILY_GLIBC, "Could not open '%s' for writing: %s", tmp, strerror(errno));
+		goto cleanup;
+	}
+	if (fwrite(data, 1, size, fp) != size) {
+		oscap_seterr(OSCAP_EFAMILY_GLIBC, "Could not write '%s': %s", tmp, strerror(errno));
+		fclose(fp);
+		unlink(tmp);
+		goto cleanup;
+	}
+	if (fclose(fp) != 0) {
+		oscap_seterr(OSCAP_EFAMILY_GLIBC, "Could not write '%s': %s", tmp, strerror(errno));
+		unlink(tmp);
+		goto cleanup;
+	}
+	if (rename(tmp, path) != 0) {
+		oscap_seterr(OSCAP_EFAMILY_GLIBC, "Could not rename '%s' to '%s': %s", tmp, path, strerror(errno));
+		unlink(tmp);
+		goto cleanup;
+	}
+	ret = 0;
+
+cleanup:
+	oscap_free(dir);
+	oscap_free(tmp);
+	return ret;
+}
+
+/*
+ * Store the data as a blob unless there is the same blob already.
+ * The number of bytes written is added to stored.
+ */
+static int ds_rds_store_blob_put(struct ds_rds_store *store, const char *data, size_t size,
+		char name[DS_RDS_STORE_NAME_SIZE], uint64_t *stored)
+{
+	uint64_t hash = ds_rds_store_hash(data, size);
+	unsigned int n;
+
+	for (n = 0;; ++n) {
+		char *path;
+		int cmp;
+
+		if (n == 0)
+			snprintf(name, DS_RDS_STORE_NAME_SIZE, "%016" PRIx64, hash);
+		else
+			snprintf(name, DS_RDS_STORE_NAME_SIZE, "%016" PRIx64 "-%u", hash, n);
+
+		path = ds_rds_store_blob_path(store, name);
+		cmp = ds_rds_store_blob_compare(path, data, size);
+
+		if (cmp == 2) {
+			cmp = ds_rds_store_file_write(path, data, size) == 0 ? 1 : -1;
+			if (cmp == 1)
+				*stored += size;
+		}
+		oscap_free(path);
+
+		if (cmp != 0)
+			return cmp == 1 ? 0 : -1;
+	}
+}
+
+/*
+ * Map the blob and check that its content matches its name.
+ */
+static int ds_rds_store_blob_get(const struct ds_rds_store *store, const char *name, const char **map, size_t *size)
+{
+	char hash[17];
+	char *path;
+	int ret;
+
+	if (!ds_rds_store_name_valid(name)) {
+		oscap_seterr(OSCAP_EFAMILY_OSCAP, "'%s' is not a valid ID of a blob.", name);
+		return -1;
+	}
+
+	path = ds_rds_store_blob_path(store, name);
+	ret = ds_rds_store_map(path, map, size);
+
+	if (ret == 0) {
+		snprintf(hash, sizeof hash, "%016" PRIx64, ds_rds_store_hash(*map, *size));
+		if (strncmp(hash, name, 16) != 0) {
+			oscap_seterr(OSCAP_EFAMILY_OSCAP, "Blob '%s' of the store is corrupted.", path);
+			ds_rds_store_unmap(*map, *size);
+			ret = -1;
+		}
+	}
+	oscap_free(path);
+	return ret;
+}
+
+/*
+ * Index
+ */
+
+static struct ds_rds_store_entry *ds_rds_store_entry_new(struct ds_rds_store *store, const char *id)
+{
+	struct ds_rds_store_entry *entry = oscap_calloc(1, sizeof(struct ds_rds_store_entry));
+
+	entry->id = oscap_strpool_intern(store->strings, id);
+	entry->hosts = oscap_stringlist_new();
+	entry->profiles = oscap_stringlist_new();
+	return entry;
+}
+
+static void ds_rds_store_entry_free(struct ds_rds_store_entry *entry)
+{
+	if (entry == NULL)
+		return;
+	oscap_stringlist_free(entry->hosts);
+	oscap_stringlist_free(entry->profiles);
+	oscap_free(entry->rules);
+	oscap_free(entry);
+}
+
+static bool ds_rds_store_list_contains(struct oscap_stringlist *list, const char *str)
+{
+	struct oscap_string_iterator *it = oscap_stringlist_get_strings(list);
+	bool found = false;
+
+	while (!found && oscap_string_iterator_has_more(it))
+		found = oscap_streq(oscap_string_iterator_next(it), str);
+	oscap_string_iterator_free(it);
+	return found;
+}
+
+static void ds_rds_store_list_add(struct oscap_stringlist *list, const char *str)
+{
+	if (*str != '\0' && !ds_rds_store_list_contains(list, str))
+		oscap_stringlist_add_string(list, str);
+}
+
+static void ds_rds_store_entry_add_rule(struct ds_rds_store *store, struct ds_rds_store_entry *entry, const char *rule, const char *result)
+{
+	if (*rule == '\0')
+		return;
+	if (entry->rule_count == entry->rule_size) {
+		entry->rule_size = entry->rule_size == 0 ? 64 : entry->rule_size * 2;
+		entry->rules = oscap_realloc(entry->rules, sizeof(struct ds_rds_store_rule) * entry->rule_size);
+	}
+
+	entry->rules[entry->rule_count].rule = oscap_strpool_intern(store->strings, rule);
+	entry->rules[entry->rule_count].result = oscap_strpool_intern(store->strings, result);
+	entry->rule_count++;
+}
+
+static int ds_rds_store_rule_cmp(const void *a, const void *b)
+{
+	return strcmp(((const struct ds_rds_store_rule *)a)->rule, ((const struct ds_rds_store_rule *)b)->rule);
+}
+
+static const struct ds_rds_store_rule *ds_rds_store_entry_find_rule(const struct ds_rds_store_entry *entry, const char *rule)
+{
+	struct ds_rds_store_rule key = { .rule = rule };
+
+	if (entry->rule_count == 0)
+		return NULL;
+	return bsearch(&key, entry->rules, entry->rule_count, sizeof key, ds_rds_store_rule_cmp);
+}
+
+static void ds_rds_store_sort_rules(struct ds_rds_store_entry *entry)
+{
+	// rules are looked up by bsearch
+	qsort(entry->rules, entry->rule_count, sizeof(struct ds_rds_store_rule), ds_rds_store_rule_cmp);
+	entry->rules_loaded = true;
+}
+
+static void ds_rds_store_add_entry(struct ds_rds_store *store, struct ds_rds_store_entry *entry)
+{
+	store->entries = oscap_realloc(store->entries, sizeof(struct ds_rds_store_entry *) * (store->entry_count + 1));
+	store->entries[store->entry_count++] = entry;
+	oscap_htable_add(store->by_id, entry->id, entry);
+
+	store->arf_bytes += entry->size;
+	store->blob_bytes += entry->stored;
+}
+
+/*
+ * Split the line into at most max tab separated fields in place.
+ */
+static size_t ds_rds_store_split(char *line, char **fields, size_t max)
+{
+	size_t count = 0;
+
+	line[strcspn(line, "\n")] = '\0';
+
+	while (count < max) {
+		fields[count++] = line;
+		if ((line = strchr(line, '\t')) == NULL)
+			break;
+		*line++ = '\0';
+	}
+	return count;
+}
+
+/*
+ * Read the rule results of the entry unless they were read already.
+ */
+static int ds_rds_store_entry_load_rules(struct ds_rds_store *store, struct ds_rds_store_entry *entry)
+{
+	char *path, *line = NULL, *fields[2];
+	size_t line_size = 0;
+	FILE *fp;
+
+	if (entry->rules_loaded)
+		return 0;
+
+	path = ds_rds_store_rules_path(store, entry->id);
+	if ((fp = fopen(path, "r")) == NULL) {
+		if (errno == ENOENT) {
+			entry->rules_loaded = true;
+			oscap_free(path);
+			return 0;
+		}
+		oscap_seterr(OSCAP_EFAMILY_GLIBC, "Could not open '%s': %s", path, strerror(errno));
+		oscap_free(path);
+		return -1;
+	}
+
+	while (getline(&line, &line_size, fp) != -1) {
+		if (ds_rds_store_split(line, fields, 2) == 2)
+			ds_rds_store_entry_add_rule(store, entry, fields[0], fields[1]);
+	}
+	ds_rds_store_sort_rules(entry);
+
+	free(line);
+	fclose(fp);
+	oscap_free(path);
+	return 0;
+}
+
+static int ds_rds_store_load_index(struct ds_rds_store *store)
+{
+	char *path = oscap_sprintf("%s/" DS_RDS_STORE_INDEX, store->path);
+	struct ds_rds_store_entry *entry = NULL;
+	char *line = NULL, *fields[4];
+	size_t line_size = 0, count;
+	FILE *fp;
+
+	if ((fp = fopen(path, "r")) == NULL) {
+		if (errno == ENOENT) {
+			oscap_free(path);
+			return 0;
+		}
+		oscap_seterr(OSCAP_EFAMILY_GLIBC, "Could not open '%s': %s", path, strerror(errno));
+		oscap_free(path);
+		return -1;
+	}
+
+	// wait for the import which is appending to the index
+	if (flock(fileno(fp), LOCK_SH) != 0) {
+		oscap_seterr(OSCAP_EFAMILY_GLIBC, "Could not lock '%s': %s", path, strerror(errno));
+		fclose(fp);
+		oscap_free(path);
+		return -1;
+	}
+
+	/*
+	 * The records of an ARF follow its "arf" record, records of unknown
+	 * types and of unknown ARFs are skipped. An ARF imported by several
+	 * processes at once has more "arf" records, the first one is used.
+	 */
+	while (getline(&line, &line_size, fp) != -1) {
+		count = ds_rds_store_split(line, fields, 4);
+
+		if (count < 3)
+			continue;
+		if (strcmp(fields[0], "arf") == 0 && count >= 4) {
+			if (entry != NULL)
+				ds_rds_store_add_entry(store, entry);
+			entry = NULL;
+			if (oscap_htable_get(store->by_id, fields[1]) != NULL)
+				continue;
+			entry = ds_rds_store_entry_new(store, fields[1]);
+			entry->size = strtoull(fields[2], NULL, 10);
+			entry->stored = strtoull(fields[3], NULL, 10);
+			continue;
+		}
+		if (entry == NULL || strcmp(fields[1], entry->id) != 0)
+			continue;
+
+		if (strcmp(fields[0], "host") == 0)
+			ds_rds_store_list_add(entry->hosts, fields[2]);
+		else if (strcmp(fields[0], "profile") == 0)
+			ds_rds_store_list_add(entry->profiles, fields[2]);
+	}
+	if (entry != NULL)
+		ds_rds_store_add_entry(store, entry);
+
+	free(line);
+	fclose(fp);
+	oscap_free(path);
+	return 0;
+}
+
+static int ds_rds_store_write_rules(struct ds_rds_store *store, const struct ds_rds_store_entry *entry)
+{
+	char *path = ds_rds_store_rules_path(store, entry->id);
+	char *dir = oscap_sprintf("%s/" DS_RDS_STORE_RULES, store->path);
+	char *data = NULL;
+	size_t size = 0, i;
+	int ret = -1;
+	FILE *fp;
+
+	if (ds_rds_store_mkdir(dir) != 0)
+		goto cleanup;
+	if ((fp = open_memstream(&data, &size)) == NULL) {
+		oscap_seterr(OSCAP_EFAMILY_GLIBC, "Could not allocate the rules of '%s': %s", entry->id, strerror(errno));
+		goto cleanup;
+	}
+	for (i = 0; i < entry->rule_count; ++i)
+		fprintf(fp, "%s\t%s\n", entry->rules[i].rule, entry->rules[i].result);
+	fclose(fp);
+
+	ret = ds_rds_store_file_write(path, data, size);
+
+cleanup:
+	free(data);
+	oscap_free(dir);
+	oscap_free(path);
+	return ret;
+}
+
+static int ds_rds_store_write_index(struct ds_rds_store *store, const struct ds_rds_store_entry *entry)
+{
+	char *path = oscap_sprintf("%s/" DS_RDS_STORE_INDEX, store->path);
+	struct oscap_string_iterator *it;
+	char *data = NULL;
+	size_t size = 0, done;
+	ssize_t n = 0;
+	int fd, ret = -1;
+	FILE *fp;
+
+	if ((fp = open_memstream(&data, &size)) == NULL) {
+		oscap_seterr(OSCAP_EFAMILY_GLIBC, "Could not allocate the index records of '%s': %s", entry->id, strerror(errno));
+		oscap_free(path);
+		return -1;
+	}
+
+	fprintf(fp, "arf\t%s\t%" PRIu64 "\t%" PRIu64 "\n", entry->id, entry->size, entry->stored);
+
+	it = oscap_stringlist_get_strings(entry->hosts);
+	while (oscap_string_iterator_has_more(it))
+		fprintf(fp, "host\t%s\t%s\n", entry->id, oscap_string_iterator_next(it));
+	oscap_string_iterator_free(it);
+
+	it = oscap_stringlist_get_strings(entry->profiles);
+	while (oscap_string_iterator_has_more(it))
+		fprintf(fp, "profile\t%s\t%s\n", entry->id, oscap_string_iterator_next(it));
+	oscap_string_iterator_free(it);
+
+	fclose(fp);
+
+	if ((fd = open(path, O_WRONLY | O_APPEND | O_CREAT, 0644)) < 0) {
+		oscap_seterr(OSCAP_EFAMILY_GLIBC, "Could not open '%s' for writing: %s", path, strerror(errno));
+		goto cleanup;
+	}
+	// the records of the ARF are appended at once, other imports wait
+	if (flock(fd, LOCK_EX) != 0) {
+		oscap_seterr(OSCAP_EFAMILY_GLIBC, "Could not lock '%s': %s", path, strerror(errno));
+		close(fd);
+		goto cleanup;
+	}
+	for (done = 0; done < size; done += n) {
+		if ((n = write(fd, data + done, size - done)) < 0) {
+			if (errno == EINTR) {
+				n = 0;
+				continue;
+			}
+			break;
+		}
+	}
+	if (done == size)
+		ret = 0;
+	else
+		oscap_seterr(OSCAP_EFAMILY_GLIBC, "Could not write '%s': %s", path, strerror(errno));
+	if (close(fd) != 0 && ret == 0) {
+		oscap_seterr(OSCAP_EFAMILY_GLIBC, "Could not write '%s': %s", path, strerror(errno));
+		ret = -1;
+	}
+
+cleanup:
+	free(data);
+	oscap_free(path);
+	return ret;
+}
+
+struct ds_rds_store *ds_rds_store_open(const char *path)
+{
+	struct ds_rds_store *store;
+	char *blobs;
+
+	if (ds_rds_store_mkdir(path) != 0)
+		return NULL;
+
+	blobs = oscap_sprintf("%s/" DS_RDS_STORE_BLOBS, path);
+	if (ds_rds_store_mkdir(blobs) != 0) {
+		oscap_free(blobs);
+		return NULL;
+	}
+	oscap_free(blobs);
+
+	store = oscap_calloc(1, sizeof(struct ds_rds_store));
+	store->path = oscap_strdup(path);
+	store->strings = oscap_strpool_new();
+	store->by_id = oscap_htable_new();
+
+	if (ds_rds_store_load_index(store) != 0) {
+		ds_rds_store_free(store);
+		return NULL;
+	}
+	return store;
+}
+
+void ds_rds_store_free(struct ds_rds_store *store)
+{
+	size_t i;
+
+	if (store == NULL)
+		return;
+
+	for (i = 0; i < store->entry_count; ++i)
+		ds_rds_store_entry_free(store->entries[i]);
+	oscap_free(store->entries);
+	oscap_htable_free0(store->by_id);
+	oscap_strpool_free(store->strings);
+	oscap_free(store->path);
+	oscap_free(store);
+}
+
+/*
+ * Import
+ */
+
+struct ds_rds_store_range {
+	size_t start;
+	size_t end;
+};
+
+enum ds_rds_store_text {
+	DS_RDS_STORE_TEXT_NONE = 0,
+	DS_RDS_STORE_TEXT_HOST,
+	DS_RDS_STORE_TEXT_RESULT
+};
+
+struct ds_rds_store_element {
+	const xmlChar *uri;
+	const xmlChar *name;
+};
+
+struct ds_rds_store_parser {
+	xmlParserCtxtPtr ctxt;
+	const char *data;
+	size_t size;
+	bool is_arf;
+
+	struct ds_rds_store_element *stack;     ///< Open elements, the root at 0
+	size_t depth;
+	size_t stack_size;
+
+	size_t split_depth;                     ///< Depth of the element being split out or 0
+	size_t split_start;
+	struct ds_rds_store_range *ranges;      ///< Elements split out, in document order
+	size_t range_count;
+
+	enum ds_rds_store_text text_type;       ///< Which text is collected
+	size_t text_depth;
+	char *text;
+	size_t text_len;
+	size_t text_size;
+	char *rule;                             ///< ID of the current rule-result
+
+	struct ds_rds_store *store;
+	struct ds_rds_store_entry *entry;
+};
+
+static bool ds_rds_store_is(const struct ds_rds_store_parser *parser, size_t depth, const char *uri, const char *name)
+{
+	const struct ds_rds_store_element *e;
+
+	if (depth == 0 || depth > parser->depth)
+		return false;
+
+	e = parser->stack + depth - 1;
+	return e->uri != NULL && strcmp((const char *)e->uri, uri) == 0 && strcmp((const char *)e->name, name) == 0;
+}
+
+static bool ds_rds_store_is_xccdf(const struct ds_rds_store_parser *parser, size_t depth, const char *name)
+{
+	const struct ds_rds_store_element *e;
+
+	if (depth == 0 || depth > parser->depth)
+		return false;
+
+	e = parser->stack + depth - 1;
+	return e->uri != NULL && strncmp((const char *)e->uri, xccdf_ns_prefix, strlen(xccdf_ns_prefix)) == 0
+		&& strcmp((const char *)e->name, name) == 0;
+}
+
+static char *ds_rds_store_attr(const xmlChar **attrs, int nb_attributes, const char *name)
+{
+	int i;
+
+	// localname, prefix, URI, value, end
+	for (i = 0; i < nb_attributes; ++i, attrs += 5) {
+		if (attrs[2] == NULL && strcmp((const char *)attrs[0], name) == 0)
+			return oscap_sprintf("%.*s", (int)(attrs[4] - attrs[3]), (const char *)attrs[3]);
+	}
+	return NULL;
+}
+
+/*
+ * Values are stored in the tab separated index, squeeze the whitespace.
+ */
+static char *ds_rds_store_clean(char *str)
+{
+	char *src, *dst;
+
+	for (src = dst = str; *src != '\0'; ++src) {
+		if (*src == '\t' || *src == '\n' || *src == '\r' || *src == ' ') {
+			if (dst != str && dst[-1] != ' ')
+				*dst++ = ' ';
+		} else {
+			*dst++ = *src;
+		}
+	}
+	if (dst != str && dst[-1] == ' ')
+		--dst;
+	*dst = '\0';
+	return str;
+}
+
+/*
+ * Elements which are the same in the ARFs of many hosts are stored as
+ * separate blobs: the source DataStreams of the report requests and the
+ * OVAL definitions in the OVAL results.
+ */
+static bool ds_rds_store_is_shared(const struct ds_rds_store_parser *parser)
+{
+	size_t d = parser->depth;
+
+	if (ds_rds_store_is(parser, d - 1, arf_ns_uri, "content") && ds_rds_store_is(parser, d - 2, arf_ns_uri, "report-request"))
+		return true;
+
+	return ds_rds_store_is(parser, d, oval_def_ns_uri, "oval_definitions")
+		&& ds_rds_store_is(parser, d - 1, oval_res_ns_uri, "oval_results")
+		&& ds_rds_store_is(parser, d - 2, arf_ns_uri, "content")
+		&& ds_rds_store_is(parser, d - 3, arf_ns_uri, "report");
+}
+
+static void ds_rds_store_start_element(void *ctx, const xmlChar *localname, const xmlChar *prefix, const xmlChar *URI,
+		int nb_namespaces, const xmlChar **namespaces, int nb_attributes, int nb_defaulted, const xmlChar **attributes)
+{
+	struct ds_rds_store_parser *parser = ctx;
+	size_t d;
+
+	if (parser->depth == parser->stack_size) {
+		parser->stack_size = parser->stack_size == 0 ? 32 : parser->stack_size * 2;
+		parser->stack = oscap_realloc(parser->stack, sizeof(struct ds_rds_store_element) * parser->stack_size);
+	}
+	parser->stack[parser->depth].uri = URI;
+	parser->stack[parser->depth].name = localname;
+	d = ++parser->depth;
+
+	if (parser->split_depth != 0)
+		return;
+
+	if (d == 1) {
+		parser->is_arf = ds_rds_store_is(parser, 1, arf_ns_uri, "asset-report-collection");
+		if (!parser->is_arf)
+			xmlStopParser(parser->ctxt);
+		return;
+	}
+
+	if (ds_rds_store_is_shared(parser)) {
+		long pos = xmlByteConsumed(parser->ctxt);
+		size_t min = parser->range_count > 0 ? parser->ranges[parser->range_count - 1].end : 0;
+
+		/*
+		 * The parser is within the start tag, it begins with the last '<'
+		 * as attribute values can't contain it.
+		 */
+		if (pos > 0 && (size_t)pos <= parser->size) {
+			size_t start = pos - 1;
+
+			while (start > min && parser->data[start] != '<')
+				--start;
+			if (parser->data[start] == '<') {
+				parser->split_depth = d;
+				parser->split_start = start;
+			}
+		}
+		return;
+	}
+
+	if (ds_rds_store_is(parser, 2, arf_ns_uri, "assets") && URI != NULL && strcmp((const char *)URI, ai_ns_uri) == 0
+			&& (strcmp((const char *)localname, "hostname") == 0 || strcmp((const char *)localname, "fqdn") == 0)) {
+		parser->text_type = DS_RDS_STORE_TEXT_HOST;
+	} else if (ds_rds_store_is_xccdf(parser, d - 1, "TestResult") && ds_rds_store_is_xccdf(parser, d, "profile")) {
+		char *idref = ds_rds_store_attr(attributes, nb_attributes, "idref");
+
+		if (idref != NULL)
+			ds_rds_store_list_add(parser->entry->profiles, ds_rds_store_clean(idref));
+		oscap_free(idref);
+	} else if (ds_rds_store_is_xccdf(parser, d - 1, "TestResult") && ds_rds_store_is_xccdf(parser, d, "rule-result")) {
+		oscap_free(parser->rule);
+		parser->rule = ds_rds_store_attr(attributes, nb_attributes, "idref");
+	} else if (parser->rule != NULL && ds_rds_store_is_xccdf(parser, d - 1, "rule-result") && ds_rds_store_is_xccdf(parser, d, "result")) {
+		parser->text_type = DS_RDS_STORE_TEXT_RESULT;
+	}
+
+	if (parser->text_type != DS_RDS_STORE_TEXT_NONE) {
+		parser->text_depth = d;
+		parser->text_len = 0;
+	}
+}
+
+static void ds_rds_store_end_element(void *ctx, const xmlChar *localname, const xmlChar *prefix, const xmlChar *URI)
+{
+	struct ds_rds_store_parser *parser = ctx;
+	size_t d = parser->depth--;
+
+	if (parser->split_depth == d) {
+		long pos = xmlByteConsumed(parser->ctxt);
+
+		// the parser is just after the end tag
+		if (pos > 0 && (size_t)pos <= parser->size && (size_t)pos > parser->split_start && parser->data[pos - 1] == '>') {
+			parser->ranges = oscap_realloc(parser->ranges, sizeof(struct ds_rds_store_range) * (parser->range_count + 1));
+			parser->ranges[parser->range_count].start = parser->split_start;
+			parser->ranges[parser->range_count].end = pos;
+			parser->range_count++;
+		}
+		parser->split_depth = 0;
+		return;
+	}
+
+	if (parser->text_type == DS_RDS_STORE_TEXT_NONE || parser->text_depth != d)
+		return;
+
+	parser->text = oscap_realloc(parser->text, parser->text_len + 1);
+	parser->text[parser->text_len] = '\0';
+	ds_rds_store_clean(parser->text);
+
+	if (parser->text_type == DS_RDS_STORE_TEXT_HOST) {
+		ds_rds_store_list_add(parser->entry->hosts, parser->text);
+	} else {
+		ds_rds_store_entry_add_rule(parser->store, parser->entry, ds_rds_store_clean(parser->rule), parser->text);
+		oscap_free(parser->rule);
+		parser->rule = NULL;
+	}
+	parser->text_type = DS_RDS_STORE_TEXT_NONE;
+}
+
+static void ds_rds_store_characters(void *ctx, const xmlChar *ch, int len)
+{
+	struct ds_rds_store_parser *parser = ctx;
+
+	if (parser->text_type == DS_RDS_STORE_TEXT_NONE)
+		return;
+
+	if (parser->text_len + len + 1 > parser->text_size) {
+		parser->text_size = (parser->text_len + len + 1) * 2;
+		parser->text = oscap_realloc(parser->text, parser->text_size);
+	}
+	memcpy(parser->text + parser->text_len, ch, len);
+	parser->text_len += len;
+}
+
+static void ds_rds_store_xml_error(void *ctx, xmlErrorPtr error)
+{
+	oscap_setxmlerr(error);
+}
+
+/*
+ * Find the shared elements and fill in the index entry.
+ */
+static int ds_rds_store_parse(struct ds_rds_store_parser *parser, const char *arf_file)
+{
+	xmlSAXHandler sax;
+	size_t offset, chunk;
+	int ret = 0;
+
+	memset(&sax, 0, sizeof sax);
+	sax.initialized = XML_SAX2_MAGIC;
+	sax.startElementNs = ds_rds_store_start_element;
+	sax.endElementNs = ds_rds_store_end_element;
+	sax.characters = ds_rds_store_characters;
+	sax.serror = (xmlStructuredErrorFunc)ds_rds_store_xml_error;
+
+	parser->ctxt = xmlCreatePushParserCtxt(&sax, parser, NULL, 0, arf_file);
+	if (parser->ctxt == NULL) {
+		oscap_seterr(OSCAP_EFAMILY_XML, "Could not create parser for '%s'.", arf_file);
+		return -1;
+	}
+	xmlCtxtUseOptions(parser->ctxt, XML_PARSE_HUGE | XML_PARSE_NONET);
+
+	for (offset = 0; offset < parser->size && ret == 0; offset += chunk) {
+		chunk = parser->size - offset < DS_RDS_STORE_CHUNK ? parser->size - offset : DS_RDS_STORE_CHUNK;
+		ret = xmlParseChunk(parser->ctxt, parser->data + offset, chunk, 0);
+	}
+	if (ret == 0)
+		ret = xmlParseChunk(parser->ctxt, NULL, 0, 1);
+
+	if (!parser->is_arf) {
+		oscap_seterr(OSCAP_EFAMILY_OSCAP, "'%s' is not a result DataStream (ARF).", arf_file);
+		ret = -1;
+	} else if (ret != 0 || !parser->ctxt->wellFormed) {
+		oscap_seterr(OSCAP_EFAMILY_XML, "Could not parse '%s'.", arf_file);
+		ret = -1;
+	}
+
+	xmlFreeParserCtxt(parser->ctxt);
+	parser->ctxt = NULL;
+	return ret;
+}
+
+static int ds_rds_store_put_part(struct ds_rds_store *store, const char *data, size_t size, char **manifest, uint64_t *stored)
+{
+	char name[DS_RDS_STORE_NAME_SIZE];
+	char *line, *joined;
+
+	if (size == 0)
+		return 0;
+	if (ds_rds_store_blob_put(store, data, size, name, stored) != 0)
+		return -1;
+
+	line = oscap_sprintf("%s %zu\n", name, size);
+	joined = oscap_sprintf("%s%s", *manifest, line);
+	oscap_free(line);
+	oscap_free(*manifest);
+	*manifest = joined;
+	return 0;
+}
+
+char *ds_rds_store_import(struct ds_rds_store *store, const char *arf_file)
+{
+	struct ds_rds_store_parser parser;
+	char name[DS_RDS_STORE_NAME_SIZE];
+	char *manifest = NULL, *id = NULL;
+	uint64_t stored = 0;
+	size_t i, offset;
+
+	memset(&parser, 0, sizeof parser);
+	parser.store = store;
+
+	if (ds_rds_store_map(arf_file, &parser.data, &parser.size) != 0)
+		return NULL;
+
+	parser.entry = ds_rds_store_entry_new(store, "");
+	if (ds_rds_store_parse(&parser, arf_file) != 0)
+		goto cleanup;
+
+	manifest = oscap_strdup(DS_RDS_STORE_MANIFEST);
+	offset = 0;
+
+	for (i = 0; i <= parser.range_count; ++i) {
+		size_t start = i < parser.range_count ? parser.ranges[i].start : parser.size;
+
+		// results of the host before the shared element
+		if (ds_rds_store_put_part(store, parser.data + offset, start - offset, &manifest, &stored) != 0)
+			goto cleanup;
+		if (i == parser.range_count)
+			break;
+		if (ds_rds_store_put_part(store, parser.data + start, parser.ranges[i].end - start, &manifest, &stored) != 0)
+			goto cleanup;
+		offset = parser.ranges[i].end;
+	}
+
+	if (ds_rds_store_blob_put(store, manifest, strlen(manifest), name, &stored) != 0)
+		goto cleanup;
+
+	if (oscap_htable_get(store->by_id, name) == NULL) {
+		parser.entry->id = oscap_strpool_intern(store->strings, name);
+		parser.entry->size = parser.size;
+		parser.entry->stored = stored;
+		ds_rds_store_sort_rules(parser.entry);
+
+		// the index must not refer to rules which aren't written yet
+		if (ds_rds_store_write_rules(store, parser.entry) != 0)
+			goto cleanup;
+		if (ds_rds_store_write_index(store, parser.entry) != 0)
+			goto cleanup;
+		ds_rds_store_add_entry(store, parser.entry);
+		parser.entry = NULL;
+	}
+	id = oscap_strdup(name);
+
+cleanup:
+	ds_rds_store_unmap(parser.data, parser.size);
+	ds_rds_store_entry_free(parser.entry);
+	oscap_free(parser.stack);
+	oscap_free(parser.ranges);
+	oscap_free(parser.text);
+	oscap_free(parser.rule);
+	oscap_free(manifest);
+	return id;
+}
+
+/*
+ * Export
+ */
+
+int ds_rds_store_export(struct ds_rds_store *store, const char *arf_id, const char *target_file)
+{
+	const char *manifest = NULL, *line, *next;
+	size_t manifest_size = 0;
+	int ret = -1;
+	FILE *fp;
+
+	if (ds_rds_store_blob_get(store, arf_id, &manifest, &manifest_size) != 0)
+		return -1;
+
+	if (manifest_size < strlen(DS_RDS_STORE_MANIFEST)
+			|| strncmp(manifest, DS_RDS_STORE_MANIFEST, strlen(DS_RDS_STORE_MANIFEST)) != 0) {
+		oscap_seterr(OSCAP_EFAMILY_OSCAP, "'%s' is not an ARF of the store.", arf_id);
+		ds_rds_store_unmap(manifest, manifest_size);
+		return -1;
+	}
+
+	if ((fp = fopen(target_file, "wb")) == NULL) {
+		oscap_seterr(OSCAP_EFAMILY_GLIBC, "Could not open '%s' for writing: %s", target_file, strerror(errno));
+		ds_rds_store_unmap(manifest, manifest_size);
+		return -1;
+	}
+
+	for (line = manifest + strlen(DS_RDS_STORE_MANIFEST); line < manifest + manifest_size; line = next + 1) {
+		char name[DS_RDS_STORE_NAME_SIZE];
+		unsigned long long expected;
+		const char *blob;
+		size_t size;
+		int written;
+
+		if ((next = memchr(line, '\n', manifest + manifest_size - line)) == NULL
+				|| next - line >= DS_RDS_STORE_NAME_SIZE + 21
+				|| sscanf(line, "%31s %llu", name, &expected) != 2) {
+			oscap_seterr(OSCAP_EFAMILY_OSCAP, "Manifest of '%s' is corrupted.", arf_id);
+			goto cleanup;
+		}
+		if (ds_rds_store_blob_get(store, name, &blob, &size) != 0)
+			goto cleanup;
+		if (size != expected) {
+			oscap_seterr(OSCAP_EFAMILY_OSCAP, "Blob '%s' of '%s' has unexpected size.", name, arf_id);
+			ds_rds_store_unmap(blob, size);
+			goto cleanup;
+		}
+		written = fwrite(blob, 1, size, fp) == size;
+		ds_rds_store_unmap(blob, size);
+
+		if (!written) {
+			oscap_seterr(OSCAP_EFAMILY_GLIBC, "Could not write '%s': %s", target_file, strerror(errno));
+			goto cleanup;
+		}
+	}
+	ret = 0;
+
+cleanup:
+	if (fclose(fp) != 0 && ret == 0) {
+		oscap_seterr(OSCAP_EFAMILY_GLIBC, "Could not write '%s': %s", target_file, strerror(errno));
+		ret = -1;
+	}
+	if (ret != 0)
+		unlink(target_file);
+	ds_rds_store_unmap(manifest, manifest_size);
+	return ret;
+}
+
+/*
+ * Queries
+ */
+
+struct oscap_stringlist *ds_rds_store_search(struct ds_rds_store *store, const char *host, const char *profile, const char *rule)
+{
+	struct oscap_stringlist *ids = oscap_stringlist_new();
+	size_t i;
+
+	for (i = 0; i < store->entry_count; ++i) {
+		struct ds_rds_store_entry *entry = store->entries[i];
+
+		if (host != NULL && !ds_rds_store_list_contains(entry->hosts, host))
+			continue;
+		if (profile != NULL && !ds_rds_store_list_contains(entry->profiles, profile))
+			continue;
+		if (rule != NULL && (ds_rds_store_entry_load_rules(store, entry) != 0
+				|| ds_rds_store_entry_find_rule(entry, rule) == NULL))
+			continue;
+		oscap_stringlist_add_string(ids, entry->id);
+	}
+	return ids;
+}
+
+struct oscap_string_iterator *ds_rds_store_get_hosts(struct ds_rds_store *store, const char *arf_id)
+{
+	struct ds_rds_store_entry *entry = oscap_htable_get(store->by_id, arf_id);
+
+	return entry != NULL ? oscap_stringlist_get_strings(entry->hosts) : NULL;
+}
+
+struct oscap_string_iterator *ds_rds_store_get_profiles(struct ds_rds_store *store, const char *arf_id)
+{
+	struct ds_rds_store_entry *entry = oscap_htable_get(store->by_id, arf_id);
+
+	return entry != NULL ? oscap_stringlist_get_strings(entry->profiles) : NULL;
+}
+
+const char *ds_rds_store_get_rule_result(struct ds_rds_store *store, const char *arf_id, const char *rule)
+{
+	struct ds_rds_store_entry *entry = oscap_htable_get(store->by_id, arf_id);
+	const struct ds_rds_store_rule *r;
+
+	if (entry == NULL || ds_rds_store_entry_load_rules(store, entry) != 0
+			|| (r = ds_rds_store_entry_find_rule(entry, rule)) == NULL)
+		return NULL;
+	return r->result;
+}
+
+void ds_rds_store_get_usage(const struct ds_rds_store *store, size_t *arf_count, uint64_t *arf_bytes, uint64_t *blob_bytes)
+{
+	if (arf_count != NULL)
+		*arf_count = store->entry_count;
+	if (arf_bytes != NULL)
+		*arf_bytes = store->arf_bytes;
+	if (blob_bytes != NULL)
+		*blob_bytes = store->blob_bytes;
+}
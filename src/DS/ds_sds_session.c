@@ -33,6 +33,7 @@
 #include "common/public/oscap.h"
 #include "common/util.h"
 #include "ds_common.h"
+#include "ds_image_priv.h"
 #include "ds_sds_session.h"
 #include "ds_sds_session_priv.h"
 #include "sds_index_priv.h"
@@ -51,6 +52,8 @@ struct ds_sds_session {
 	const char *datastream_id;              ///< ID of selected datastream
 	const char *checklist_id;               ///< ID of selected checklist
 	struct oscap_htable *component_sources;	///< oscap_source for parsed components
+	bool from_image;                        ///< Components were loaded from a content image
+	const char *benchmark_id;               ///< ID of the Benchmark the image was written for
 };
 
 struct ds_sds_session *ds_sds_session_new_from_source(struct oscap_source *source)
@@ -83,6 +86,8 @@ void ds_sds_session_reset(struct ds_sds_session *session)
 	session->checklist_id = NULL;
 	session->datastream_id = NULL;
 	session->target_dir = NULL;
+	session->from_image = false;
+	session->benchmark_id = NULL;
 	oscap_htable_free(session->component_sources, (oscap_destruct_func) oscap_source_free);
 	session->component_sources = oscap_htable_new();
 }
@@ -157,8 +162,43 @@ struct oscap_htable *ds_sds_session_get_component_sources(struct ds_sds_session
 	return session->component_sources;
 }
 
+void ds_sds_session_set_image_checklist(struct ds_sds_session *session, const char *datastream_id, const char *checklist_id, const char *benchmark_id)
+{
+	session->from_image = true;
+	session->datastream_id = datastream_id;
+	session->checklist_id = checklist_id;
+	session->benchmark_id = benchmark_id;
+}
+
+struct oscap_source *ds_sds_session_get_source(struct ds_sds_session *session)
+{
+	return session->source;
+}
+
+static struct oscap_source *ds_sds_session_select_image_checklist(struct ds_sds_session *session, const char *datastream_id, const char *component_id, const char *benchmark_id)
+{
+	// The image holds only the checklist it was written for
+	if ((datastream_id != NULL && !oscap_streq(datastream_id, session->datastream_id)) ||
+			(component_id != NULL && !oscap_streq(component_id, session->checklist_id)) ||
+			(datastream_id == NULL && component_id == NULL && benchmark_id != NULL &&
+				!oscap_streq(benchmark_id, session->benchmark_id))) {
+		oscap_seterr(OSCAP_EFAMILY_OSCAP, "The content image %s has been written for datastream '%s' "
+				"and checklist '%s', write it again from the source DataStream to select a different one.",
+				oscap_source_readable_origin(session->source), session->datastream_id, session->checklist_id);
+		return NULL;
+	}
+	struct oscap_source *xccdf = oscap_htable_get(session->component_sources, "xccdf.xml");
+	if (xccdf == NULL) {
+		oscap_seterr(OSCAP_EFAMILY_OSCAP, "Internal error: Could not acquire handle to xccdf.xml source.");
+	}
+	return xccdf;
+}
+
 struct oscap_source *ds_sds_session_select_checklist(struct ds_sds_session *session, const char *datastream_id, const char *component_id, const char *benchmark_id)
 {
+	if (session->from_image)
+		return ds_sds_session_select_image_checklist(session, datastream_id, component_id, benchmark_id);
+
 	session->datastream_id = datastream_id;
 	session->checklist_id = component_id;
 
@@ -276,6 +316,26 @@ int ds_sds_session_register_component_with_dependencies(struct ds_sds_session *s
 	return res;
 }
 
+int ds_sds_session_write_image(struct ds_sds_session *session, const char *datastream_id, const char *component_id, const char *benchmark_id, const char *target_file)
+{
+	if (ds_sds_session_select_checklist(session, datastream_id, component_id, benchmark_id) == NULL)
+		return -1;
+
+	struct ds_stream_index *stream_idx = ds_sds_index_get_stream(ds_sds_session_get_sds_idx(session), session->datastream_id);
+	struct oscap_string_iterator *cpe_it = ds_stream_index_get_dictionaries(stream_idx);
+	bool has_dictionaries = oscap_string_iterator_has_more(cpe_it);
+	oscap_string_iterator_free(cpe_it);
+
+	if (has_dictionaries &&
+			ds_sds_session_register_component_with_dependencies(session, "dictionaries", NULL, NULL) != 0) {
+		oscap_seterr(OSCAP_EFAMILY_OSCAP, "Can't decompose CPE dictionaries from datastream '%s' from file '%s'!",
+				session->datastream_id, oscap_source_readable_origin(session->source));
+		return -1;
+	}
+
+	return ds_image_write(session, target_file);
+}
+
 int ds_sds_session_dump_component_files(struct ds_sds_session *session)
 {
 	return ds_dump_component_sources(session->component_sources);
@@ -38,6 +38,13 @@ xmlDoc *ds_sds_session_get_xmlDoc(struct ds_sds_session *session);
 int ds_sds_session_register_component_source(struct ds_sds_session *session, const char *relative_filepath, struct oscap_source *component);
 const char *ds_sds_session_get_target_dir(struct ds_sds_session *session);
 struct oscap_htable *ds_sds_session_get_component_sources(struct ds_sds_session *session);
+struct oscap_source *ds_sds_session_get_source(struct ds_sds_session *session);
+
+/**
+ * Mark the session as loaded from a content image. The components are
+ * expected to be registered already, the selection can't be changed.
+ */
+void ds_sds_session_set_image_checklist(struct ds_sds_session *session, const char *datastream_id, const char *checklist_id, const char *benchmark_id);
 
 OSCAP_HIDDEN_END;
 #endif
@@ -0,0 +1,127 @@
+/*
+ * Copyright 2026 Red Hat Inc., Durham, North Carolina.
+ * All Rights Reserved.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+#ifndef DS_RDS_STORE_H
+#define DS_RDS_STORE_H
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <stddef.h>
+#include <stdint.h>
+#include "oscap.h"
+#include "oscap_text.h"
+
+/**
+ * The ds_rds_store is a local on-disk store of result DataStreams (ARF).
+ *
+ * Every imported ARF is split into content addressed blobs: the source
+ * DataStreams of the report requests, the OVAL definitions embedded in
+ * the OVAL results and the rest of the document, which holds the results
+ * of the host. Blobs which are the same in many ARFs, typically the
+ * DataStream and the definitions, are stored once. The ARF is identified
+ * by the blob listing its parts and can be exported byte for byte the
+ * same as it was imported.
+ *
+ * The store keeps an index of the hosts, the profiles and the rule results
+ * of the imported ARFs. Several processes can import into the same store
+ * at once. The rule results are read from the store only by the queries
+ * which need them.
+ */
+struct ds_rds_store;
+
+/**
+ * Open the store in given directory, the directory is created if it
+ * doesn't exist.
+ * @memberof ds_rds_store
+ * @param path Directory of the store
+ * @returns the store or NULL with oscap error set
+ */
+struct ds_rds_store *ds_rds_store_open(const char *path);
+
+/**
+ * Dispose ds_rds_store structure.
+ * @memberof ds_rds_store
+ * @param store The store to dispose
+ */
+void ds_rds_store_free(struct ds_rds_store *store);
+
+/**
+ * Import a result DataStream into the store. Importing the same ARF again
+ * doesn't change the store and gives the same ID.
+ * @memberof ds_rds_store
+ * @param store The store
+ * @param arf_file Path of the ARF to import
+ * @returns the ID of the ARF in the store, to be freed by the caller,
+ * or NULL with oscap error set
+ */
+char *ds_rds_store_import(struct ds_rds_store *store, const char *arf_file);
+
+/**
+ * Write the ARF of given ID into a file. The content of the blobs is
+ * verified while it's written.
+ * @memberof ds_rds_store
+ * @param store The store
+ * @param arf_id ID of the ARF as returned by ds_rds_store_import
+ * @param target_file Path of the file to write
+ * @returns 0 on success
+ */
+int ds_rds_store_export(struct ds_rds_store *store, const char *arf_id, const char *target_file);
+
+/**
+ * Find the ARFs matching all the given criteria, NULL matches any value.
+ * @memberof ds_rds_store
+ * @param store The store
+ * @param host Hostname or FQDN of an asset in the ARF
+ * @param profile ID of the profile of an XCCDF TestResult in the ARF
+ * @param rule ID of a rule with a result in the ARF
+ * @returns IDs of the ARFs in the order of import, to be freed by the caller
+ */
+struct oscap_stringlist *ds_rds_store_search(struct ds_rds_store *store, const char *host, const char *profile, const char *rule);
+
+/**
+ * Get the hostnames and FQDNs of the assets of the ARF.
+ * @memberof ds_rds_store
+ * @returns iterator or NULL if there is no such ARF
+ */
+struct oscap_string_iterator *ds_rds_store_get_hosts(struct ds_rds_store *store, const char *arf_id);
+
+/**
+ * Get the profiles of the XCCDF TestResults in the ARF.
+ * @memberof ds_rds_store
+ * @returns iterator or NULL if there is no such ARF
+ */
+struct oscap_string_iterator *ds_rds_store_get_profiles(struct ds_rds_store *store, const char *arf_id);
+
+/**
+ * Get the result of the rule in the ARF, e.g. "pass" or "fail".
+ * @memberof ds_rds_store
+ * @returns the result or NULL if the ARF has no result of the rule
+ */
+const char *ds_rds_store_get_rule_result(struct ds_rds_store *store, const char *arf_id, const char *rule);
+
+/**
+ * Get the number and the total size of the ARFs in the store and the size
+ * of the blobs they are stored in.
+ * @memberof ds_rds_store
+ */
+void ds_rds_store_get_usage(const struct ds_rds_store *store, size_t *arf_count, uint64_t *arf_bytes, uint64_t *blob_bytes);
+
+#endif
@@ -143,6 +143,23 @@ struct oscap_source *ds_sds_session_get_component_by_href(struct ds_sds_session
  */
 int ds_sds_session_register_component_with_dependencies(struct ds_sds_session *session, const char *container_name, const char *component_id, const char *target_filename);
 
+/**
+ * Write the selected checklist into a content image. The image holds the checklist
+ * with all its dependencies and the CPE dictionaries already extracted from the
+ * collection, so that evaluation of the image doesn't need to build the DOM of
+ * the whole Source DataStream and validate it again. The components are stored
+ * as XML, they are still parsed when the image is evaluated. Parameters are the
+ * same as for ds_sds_session_select_checklist.
+ * @memberof ds_sds_session
+ * @param session The Source DataStream session
+ * @param datastream_id ID of DataStream within collection or NULL
+ * @param component_id ID of (XCCDF) checklist within datastream or NULL
+ * @param benchmark_id ID of Benchmark element within checklist or NULL
+ * @param target_file Path of the image to write
+ * @returns 0 on success
+ */
+int ds_sds_session_write_image(struct ds_sds_session *session, const char *datastream_id, const char *component_id, const char *benchmark_id, const char *target_file);
+
 /**
  * Store cached component files to the disc.
  * @memberof ds_sds_session
@@ -60,6 +60,10 @@ struct oval_agent_session {
 	struct oval_syschar_model    * sys_models[2];
 	struct oval_results_model    * res_model;
 	oval_probe_session_t  * psess;
+	bool probes_prespawned;
+	bool sysinfo_outdated;
+	oval_probe_startup_reporter startup_reporter;
+	void *startup_arg;
 };
 
 
@@ -86,11 +90,22 @@ static const struct oval_result_to_xccdf_spec XCCDF_OVAL_RESULTS_MAP[] = {
 	{0, 0, 0}
 };
 
+static int _oval_agent_query_sysinfo(oval_agent_session_t *ag_sess)
+{
+	struct oval_sysinfo *sysinfo;
+
+	if (oval_probe_query_sysinfo(ag_sess->psess, &sysinfo) != 0)
+		return -1;
+	oval_syschar_model_set_sysinfo(ag_sess->sys_model, sysinfo);
+	oval_sysinfo_free(sysinfo);
+	ag_sess->sysinfo_outdated = false;
+
+	return 0;
+}
+
 oval_agent_session_t * oval_agent_new_session(struct oval_definition_model *model, const char * name) {
 	oval_agent_session_t *ag_sess;
-	struct oval_sysinfo *sysinfo;
 	struct oval_generator *generator;
-	int ret;
 
         /* Optimalization */
         oval_definition_model_optimize_by_filter_propagation(model);
@@ -101,17 +116,17 @@ oval_agent_session_t * oval_agent_new_session(struct oval_definition_model *mode
 	ag_sess->cur_var_model = NULL;
 	ag_sess->sys_model = oval_syschar_model_new(model);
 	ag_sess->psess     = oval_probe_session_new(ag_sess->sys_model);
+	ag_sess->probes_prespawned = false;
+	ag_sess->startup_reporter = NULL;
+	ag_sess->startup_arg = NULL;
 
 	/* probe sysinfo */
-	ret = oval_probe_query_sysinfo(ag_sess->psess, &sysinfo);
-	if (ret != 0) {
+	if (_oval_agent_query_sysinfo(ag_sess) != 0) {
 		oval_probe_session_destroy(ag_sess->psess);
 		oval_syschar_model_free(ag_sess->sys_model);
 		oscap_free(ag_sess);
 		return NULL;
 	}
-	oval_syschar_model_set_sysinfo(ag_sess->sys_model, sysinfo);
-	oval_sysinfo_free(sysinfo);
 
 	/* one system only */
 	ag_sess->sys_models[0] = ag_sess->sys_model;
@@ -143,6 +158,12 @@ void oval_agent_set_product_name(oval_agent_session_t *ag_sess, char * product_n
 	oval_generator_set_product_name(generator, product_name);
 }
 
+void oval_agent_set_probe_startup_reporter(oval_agent_session_t *ag_sess, oval_probe_startup_reporter reporter, void *arg)
+{
+	ag_sess->startup_reporter = reporter;
+	ag_sess->startup_arg = arg;
+}
+
 static struct oval_result_system *_oval_agent_get_first_result_system(oval_agent_session_t *ag_sess)
 {
 	struct oval_results_model *rmodel = oval_agent_get_results_model(ag_sess);
@@ -160,6 +181,23 @@ int oval_agent_eval_definition(oval_agent_session_t *ag_sess, const char *id)
 	int ret;
 	struct oval_result_system *rsystem;
 
+	/* the probes were restarted, possibly for another system */
+	if (ag_sess->sysinfo_outdated && _oval_agent_query_sysinfo(ag_sess) != 0)
+		return -1;
+
+	/*
+	 * Start all the probes needed by the definition model at once
+	 * so that they initialize in parallel instead of one by one
+	 * as the definitions are evaluated.
+	 */
+	if (!ag_sess->probes_prespawned) {
+		ag_sess->probes_prespawned = true;
+
+		if (oval_probe_session_prespawn(ag_sess->psess, ag_sess->def_model,
+				ag_sess->startup_reporter, ag_sess->startup_arg) < 0)
+			dW("Probe pre-spawn failed, the probes will be started on demand\n");
+	}
+
 	/* probe */
 	ret = oval_probe_query_definition(ag_sess->psess, id);
 	if (ret == -1)
@@ -207,7 +245,8 @@ struct oval_result_definition * oval_agent_get_result_definition(oval_agent_sess
 	return rdef;
 }
 
-int oval_agent_reset_session(oval_agent_session_t * ag_sess) {
+static void _oval_agent_reset_variables(oval_agent_session_t *ag_sess)
+{
 	ag_sess->cur_var_model = NULL;
 	oval_definition_model_clear_external_variables(ag_sess->def_model);
 
@@ -229,9 +268,24 @@ int oval_agent_reset_session(oval_agent_session_t * ag_sess) {
 	        generator = oval_results_model_get_generator(ag_sess->res_model);
         	oval_generator_set_product_name(generator, ag_sess->product_name);
 	}
+}
+
+int oval_agent_reset_session(oval_agent_session_t * ag_sess) {
+	_oval_agent_reset_variables(ag_sess);
 
 	oval_probe_session_destroy(ag_sess->psess);
 	ag_sess->psess = oval_probe_session_new(ag_sess->sys_model);
+	ag_sess->probes_prespawned = false;
+
+	return 0;
+}
+
+int oval_agent_reset_probes(oval_agent_session_t *ag_sess)
+{
+	oval_probe_session_destroy(ag_sess->psess);
+	ag_sess->psess = oval_probe_session_new(ag_sess->sys_model);
+	ag_sess->probes_prespawned = false;
+	ag_sess->sysinfo_outdated = true;
 
 	return 0;
 }
@@ -378,6 +432,33 @@ static bool _stringlist_conflicts_with_value_it(struct oscap_stringlist *slist,
 	return oscap_list_get_itemcount((struct oscap_list *) slist) != multival_count;
 }
 
+/**
+ * Find the external variables whose values are going to change when the
+ * existing bindings are replaced by the new batch of variable bindings.
+ * @param dict new bindings as returned by _binding_iterator_to_dict
+ * @return map of the ids of the changed variables
+ */
+static struct oval_string_map *_oval_agent_changed_variables(struct oval_definition_model *def_model, struct oscap_htable *dict)
+{
+	struct oval_string_map *changed = oval_string_map_new();
+	struct oval_variable_iterator *var_it = oval_definition_model_get_variables(def_model);
+	while (oval_variable_iterator_has_more(var_it)) {
+		struct oval_variable *variable = oval_variable_iterator_next(var_it);
+		if (oval_variable_get_type(variable) != OVAL_VARIABLE_EXTERNAL)
+			continue;
+
+		struct oval_value_iterator *value_it = oval_variable_get_values(variable);
+		if (oval_value_iterator_has_more(value_it)) {
+			struct oscap_stringlist *value_list = (struct oscap_stringlist *) oscap_htable_get(dict, oval_variable_get_id(variable));
+			if (value_list == NULL || _stringlist_conflicts_with_value_it(value_list, value_it))
+				oval_string_map_put(changed, oval_variable_get_id(variable), variable);
+		}
+		oval_value_iterator_free(value_it);
+	}
+	oval_variable_iterator_free(var_it);
+	return changed;
+}
+
 /**
  * Finds out, if the new batch of variable bindings compel new variable model
  * (so-called multiset). Creates new variable model if needed.
@@ -452,12 +533,20 @@ static void _oval_agent_resolve_variables_conflict(struct oval_agent_session *se
 		}
 	}
 	oscap_htable_iterator_free(hit);
-	oscap_htable_free(dict, (oscap_destruct_func) oscap_stringlist_free);
 
     if (conflict) {
-        /* We have a conflict, clear session and external variables */
-        oval_agent_reset_session(session);
+        /* We have a conflict, clear external variables. The probes keep running,
+         * only the results which depend on the changed variables are dropped. */
+        struct oval_string_map *changed = _oval_agent_changed_variables(def_model, dict);
+        _oval_agent_reset_variables(session);
+        if (oval_probe_hint_variables(session->psess, def_model, changed) != 0) {
+            oval_probe_session_destroy(session->psess);
+            session->psess = oval_probe_session_new(session->sys_model);
+            session->probes_prespawned = false;
+        }
+        oval_string_map_free(changed, NULL);
     }
+    oscap_htable_free(dict, (oscap_destruct_func) oscap_stringlist_free);
 
     if (!session->cur_var_model) {
 	    session->cur_var_model = oval_variable_model_new();
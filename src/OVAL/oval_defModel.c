@@ -43,11 +43,18 @@
 #include "oval_probe_impl.h"
 #include "common/util.h"
 #include "common/debug_priv.h"
+#include "common/list.h"
 #include "common/_error.h"
 #include "common/elements.h"
+#include "common/metrics_priv.h"
 #include "oscap_source.h"
 #include "source/oscap_source_priv.h"
 
+/// Hash table size for the ID tables of the filtered import
+#ifndef OVAL_REFS_HSIZE
+# define OVAL_REFS_HSIZE 4093
+#endif
+
 typedef struct oval_definition_model {
 	struct oval_generator *generator;
 	struct oval_string_map *definition_map;
@@ -219,16 +226,17 @@ void oval_definition_model_add_variable(struct oval_definition_model *model, str
 	oval_string_map_put(model->variable_map, key, (void *)variable);
 }
 
-static inline int _oval_definition_model_merge_source(struct oval_definition_model *model, struct oscap_source *source)
+static int _oval_definition_model_merge_reader(struct oval_definition_model *model, xmlTextReaderPtr reader, struct oscap_htable *filter)
 {
 	/* setup context */
 	struct oval_parser_context context;
-	context.reader = oscap_source_get_xmlTextReader(source);
+	context.reader = reader;
 	if (context.reader == NULL) {
 		return -1;
 	}
 	context.definition_model = model;
 	context.user_data = NULL;
+	context.filter = filter;
 	/* jump into oval_definitions */
 	while (xmlTextReaderRead(context.reader) == 1
 		&& xmlTextReaderNodeType(context.reader) != XML_READER_TYPE_ELEMENT) ;
@@ -238,14 +246,211 @@ static inline int _oval_definition_model_merge_source(struct oval_definition_mod
 	return ret;
 }
 
+static inline int _oval_definition_model_merge_source(struct oval_definition_model *model, struct oscap_source *source, struct oscap_htable *filter)
+{
+	return _oval_definition_model_merge_reader(model, oscap_source_get_xmlTextReader(source), filter);
+}
+
+/*
+ * Add the time, the number of loaded definitions and the memory peak of a
+ * load to the scan profile.
+ */
+static void _oval_definition_model_load_metrics(struct oval_definition_model *model, struct oscap_source *source, struct oscap_metrics_sample *sample)
+{
+	struct oval_definition_iterator *it;
+
+	if (!sample->active)
+		return;
+
+	oscap_metrics_stop(sample);
+	oscap_metrics_max_rss(sample);
+
+	if (model != NULL) {
+		it = oval_definition_model_get_definitions(model);
+		while (oval_definition_iterator_has_more(it)) {
+			oval_definition_iterator_next(it);
+			sample->items++;
+		}
+		oval_definition_iterator_free(it);
+	}
+
+	oscap_metrics_add(OSCAP_METRICS_LOAD, oscap_source_readable_origin(source), sample);
+}
+
 struct oval_definition_model *oval_definition_model_import_source(struct oscap_source *source)
 {
+	struct oscap_metrics_sample sample;
+
+	oscap_metrics_start(&sample);
         struct oval_definition_model *model = oval_definition_model_new();
-	int ret = _oval_definition_model_merge_source(model, source);
+	int ret = _oval_definition_model_merge_source(model, source, NULL);
         if (ret == -1 ) {
                 oval_definition_model_free(model);
                 model = NULL;
         }
+	_oval_definition_model_load_metrics(model, source, &sample);
+	return model;
+}
+
+/* Attributes which refer to other definitions, tests, objects, states or variables */
+static const char *_oval_ref_attributes[] = {
+	"definition_ref", "test_ref", "object_ref", "state_ref", "var_ref", NULL
+};
+
+/*
+ * Scan the document for references between the definitions, tests, objects,
+ * states and variables without building any of them. Returns a table mapping
+ * the ID of each of them to the list of IDs it refers to.
+ */
+static struct oscap_htable *_oval_definition_model_scan_refs(struct oscap_source *source)
+{
+	struct oscap_htable *refs;
+	struct oscap_stringlist *cur = NULL;
+	xmlTextReaderPtr reader;
+	bool in_container = false;
+
+	reader = oscap_source_get_streaming_xmlTextReader(source);
+	if (reader == NULL)
+		return NULL;
+
+	refs = oscap_htable_new1((oscap_compare_func) strcmp, OVAL_REFS_HSIZE);
+
+	while (xmlTextReaderRead(reader) == 1) {
+		if (xmlTextReaderNodeType(reader) != XML_READER_TYPE_ELEMENT)
+			continue;
+
+		int depth = xmlTextReaderDepth(reader);
+		const char *name = (const char *) xmlTextReaderConstLocalName(reader);
+
+		if (depth == 1) {
+			const char *ns = (const char *) xmlTextReaderConstNamespaceUri(reader);
+			in_container = ns != NULL && !strcmp(ns, (const char *) OVAL_DEFINITIONS_NAMESPACE) &&
+				(!strcmp(name, "definitions") || !strcmp(name, "tests") || !strcmp(name, "objects") ||
+				 !strcmp(name, "states") || !strcmp(name, "variables"));
+			cur = NULL;
+			continue;
+		}
+		if (!in_container || depth < 2)
+			continue;
+
+		if (depth == 2) {
+			char *id = (char *) xmlTextReaderGetAttribute(reader, BAD_CAST "id");
+			cur = NULL;
+			if (id != NULL) {
+				cur = oscap_htable_get(refs, id);
+				if (cur == NULL) {
+					cur = oscap_stringlist_new();
+					oscap_htable_add(refs, id, cur);
+				}
+				oscap_free(id);
+			}
+			continue;
+		}
+		if (cur == NULL)
+			continue;
+
+		for (int i = 0; _oval_ref_attributes[i] != NULL; i++) {
+			char *ref = (char *) xmlTextReaderGetAttribute(reader, BAD_CAST _oval_ref_attributes[i]);
+			if (ref != NULL) {
+				oscap_stringlist_add_string(cur, ref);
+				oscap_free(ref);
+			}
+		}
+		/* filters, the objects of sets and variable_object refer by their text */
+		if (!strcmp(name, "filter") || !strcmp(name, "object_reference") || !strcmp(name, "var_ref")) {
+			char *ref = NULL;
+			oscap_parser_text_value(reader, oscap_text_consumer, &ref);
+			if (ref != NULL) {
+				oscap_stringlist_add_string(cur, oscap_trim(ref));
+				oscap_free(ref);
+			}
+		}
+	}
+	xmlFreeTextReader(reader);
+
+	return refs;
+}
+
+/*
+ * Compute IDs of everything reachable from the given definitions.
+ */
+static struct oscap_htable *_oval_definition_model_closure(struct oscap_htable *refs, struct oscap_stringlist *definition_ids)
+{
+	struct oscap_htable *closure;
+	struct oscap_string_iterator *it;
+	const char **stack = NULL;
+	size_t count = 0, size = 0;
+
+	closure = oscap_htable_new1((oscap_compare_func) strcmp, OVAL_REFS_HSIZE);
+
+	it = oscap_stringlist_get_strings(definition_ids);
+	while (oscap_string_iterator_has_more(it)) {
+		if (count == size) {
+			size = size ? size * 2 : 64;
+			stack = oscap_realloc(stack, size * sizeof(const char *));
+		}
+		stack[count++] = oscap_string_iterator_next(it);
+	}
+	oscap_string_iterator_free(it);
+
+	while (count > 0) {
+		const char *id = stack[--count];
+		struct oscap_stringlist *targets;
+
+		if (!oscap_htable_add(closure, id, closure))
+			continue;
+		if ((targets = oscap_htable_get(refs, id)) == NULL)
+			continue;
+
+		it = oscap_stringlist_get_strings(targets);
+		while (oscap_string_iterator_has_more(it)) {
+			const char *ref = oscap_string_iterator_next(it);
+			if (oscap_htable_get(closure, ref) != NULL)
+				continue;
+			if (count == size) {
+				size = size ? size * 2 : 64;
+				stack = oscap_realloc(stack, size * sizeof(const char *));
+			}
+			stack[count++] = ref;
+		}
+		oscap_string_iterator_free(it);
+	}
+	oscap_free(stack);
+
+	return closure;
+}
+
+/*
+ * Both passes read the document with a streaming reader, so the DOM of the
+ * source isn't built unless it has been already (e.g. by the validation or
+ * because the source is a component of a data stream). Only the referenced
+ * definitions, tests, objects, states and variables are built.
+ */
+struct oval_definition_model *oval_definition_model_import_source_filtered(struct oscap_source *source, struct oscap_stringlist *definition_ids)
+{
+	struct oval_definition_model *model;
+	struct oscap_htable *refs, *closure;
+	struct oscap_metrics_sample sample;
+	int ret;
+
+	if (definition_ids == NULL)
+		return oval_definition_model_import_source(source);
+
+	oscap_metrics_start(&sample);
+	refs = _oval_definition_model_scan_refs(source);
+	if (refs == NULL)
+		return NULL;
+	closure = _oval_definition_model_closure(refs, definition_ids);
+	oscap_htable_free(refs, (oscap_destruct_func) oscap_stringlist_free);
+
+	model = oval_definition_model_new();
+	ret = _oval_definition_model_merge_reader(model, oscap_source_get_streaming_xmlTextReader(source), closure);
+	oscap_htable_free(closure, NULL);
+	if (ret == -1) {
+		oval_definition_model_free(model);
+		model = NULL;
+	}
+	_oval_definition_model_load_metrics(model, source, &sample);
 	return model;
 }
 
@@ -264,7 +469,7 @@ int oval_definition_model_merge(struct oval_definition_model *model, const char
 	int ret;
 
 	struct oscap_source *source = oscap_source_new_from_file(file);
-	ret = _oval_definition_model_merge_source(model, source);
+	ret = _oval_definition_model_merge_source(model, source, NULL);
 
 	oscap_source_free(source);
 
@@ -173,6 +173,13 @@ const char * oval_definition_model_get_schema(struct oval_definition_model * mod
 void oval_definition_model_set_schema(struct oval_definition_model *model, const char *version);
 oval_version_t oval_definition_model_get_schema_version(struct oval_definition_model *model);
 
+/**
+ * Import only the given definitions and the tests, objects, states and
+ * variables they depend on, skipping the rest of the document.
+ * @param definition_ids IDs of the definitions, NULL imports everything
+ */
+struct oval_definition_model *oval_definition_model_import_source_filtered(struct oscap_source *source, struct oscap_stringlist *definition_ids);
+
 struct oval_string_map *oval_definition_model_build_vardef_mapping(struct oval_definition_model *model);
 struct oval_string_iterator *oval_definition_model_get_definitions_dependent_on_variable(struct oval_definition_model *model, struct oval_variable *variable);
 
@@ -118,6 +118,7 @@ int oval_directives_model_import_source(struct oval_directives_model *model, str
 	}
         context.directives_model = model;
         context.user_data = NULL;
+        context.filter = NULL;
         /* jump into oval_system_characteristics */
         xmlTextReaderRead(context.reader);
 
@@ -41,6 +41,7 @@
 #include "oval_definitions_impl.h"
 #include "common/util.h"
 #include "common/debug_priv.h"
+#include "common/list.h"
 #include "common/_error.h"
 #include "common/elements.h"
 #include "common/public/oscap.h"
@@ -147,6 +148,35 @@ char *oval_determine_document_schema_version(const char *document, oscap_documen
 	return ret;
 }
 
+/*
+ * Parse one of the definitions, tests, objects, states or variables,
+ * skipping it if it isn't in the context filter.
+ */
+static int oval_parser_filtered_tag(xmlTextReaderPtr reader, struct oval_parser_context *context, void *user)
+{
+	oval_xml_tag_parser tag_parser = *(oval_xml_tag_parser *) user;
+	char *id;
+	int ret;
+
+	id = (char *) xmlTextReaderGetAttribute(reader, BAD_CAST "id");
+	if (id != NULL && oscap_htable_get(context->filter, id) == NULL) {
+		ret = xmlTextReaderIsEmptyElement(reader) ? 0 : oval_parser_skip_tag(reader, context);
+	} else {
+		ret = (*tag_parser) (reader, context, NULL);
+	}
+	oscap_free(id);
+
+	return ret;
+}
+
+static int oval_parser_parse_container(xmlTextReaderPtr reader, struct oval_parser_context *context, oval_xml_tag_parser tag_parser)
+{
+	if (context->filter == NULL)
+		return oval_parser_parse_tag(reader, context, tag_parser, NULL);
+
+	return oval_parser_parse_tag(reader, context, &oval_parser_filtered_tag, &tag_parser);
+}
+
 /*
  * -1 error; 0 OK; 1 warning
  */
@@ -170,15 +200,15 @@ int oval_definition_model_parse(xmlTextReaderPtr reader, struct oval_parser_cont
 
 			int is_oval = strcmp((const char *)OVAL_DEFINITIONS_NAMESPACE, namespace) == 0;
 			if (is_oval && (strcmp(tagname, tagname_definitions) == 0)) {
-				ret = oval_parser_parse_tag(reader, context, &oval_definition_parse_tag, NULL);
+				ret = oval_parser_parse_container(reader, context, &oval_definition_parse_tag);
 			} else if (is_oval && strcmp(tagname, tagname_tests) == 0) {
-				ret = oval_parser_parse_tag(reader, context, &oval_test_parse_tag, NULL);
+				ret = oval_parser_parse_container(reader, context, &oval_test_parse_tag);
 			} else if (is_oval && strcmp(tagname, tagname_objects) == 0) {
-				ret =  oval_parser_parse_tag(reader, context, &oval_object_parse_tag, NULL);
+				ret =  oval_parser_parse_container(reader, context, &oval_object_parse_tag);
 			} else if (is_oval && strcmp(tagname, tagname_states) == 0) {
-				ret =  oval_parser_parse_tag(reader, context, &oval_state_parse_tag, NULL);
+				ret =  oval_parser_parse_container(reader, context, &oval_state_parse_tag);
 			} else if (is_oval && strcmp(tagname, tagname_variables) == 0) {
-				ret =  oval_parser_parse_tag(reader, context, &oval_variable_parse_tag, NULL);
+				ret =  oval_parser_parse_container(reader, context, &oval_variable_parse_tag);
 			} else if (is_oval && strcmp(tagname, tagname_generator) == 0) {
 				struct oval_generator *gen;
 				gen = oval_definition_model_get_generator(context->definition_model);
@@ -50,6 +50,7 @@ struct oval_parser_context {
 	struct oval_directives_model *directives_model;
 	xmlTextReader *reader;
 	void *user_data;
+	struct oscap_htable *filter;	///< IDs of the definitions, tests, ... to parse, NULL to parse all
 };
 
 int oval_definition_model_parse(xmlTextReaderPtr, struct oval_parser_context *);
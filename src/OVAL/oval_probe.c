@@ -43,6 +43,7 @@
 #include "common/util.h"
 #include "common/bfind.h"
 #include "common/debug_priv.h"
+#include "common/metrics_priv.h"
 
 #include "_oval_probe_session.h"
 #include "_oval_probe_handler.h"
@@ -227,6 +228,23 @@ static void _syschar_add_bindings(struct oval_syschar *sc, struct oval_string_ma
 	oval_collection_iterator_free(var_itr);
 }
 
+static uint64_t _syschar_count_items(struct oval_syschar *sysc)
+{
+	struct oval_sysitem_iterator *item_itr;
+	uint64_t count = 0;
+
+	item_itr = oval_syschar_get_sysitem(sysc);
+
+	while (oval_sysitem_iterator_has_more(item_itr)) {
+		oval_sysitem_iterator_next(item_itr);
+		++count;
+	}
+
+	oval_sysitem_iterator_free(item_itr);
+
+	return (count);
+}
+
 int oval_probe_query_object(oval_probe_session_t *psess, struct oval_object *object, int flags, struct oval_syschar **out_syschar)
 {
 	char *oid;
@@ -235,6 +253,7 @@ int oval_probe_query_object(oval_probe_session_t *psess, struct oval_object *obj
         oval_ph_t *ph;
 	struct oval_string_map *vm;
 	struct oval_syschar_model *model;
+	struct oscap_metrics_sample stats;
 	int ret;
 
 	oid = oval_object_get_id(object);
@@ -261,6 +280,13 @@ int oval_probe_query_object(oval_probe_session_t *psess, struct oval_object *obj
 			if (sc_flg != SYSCHAR_FLAG_UNKNOWN || (flags & OVAL_PDFLAG_NOREPLY)) {
 				if (out_syschar)
 					*out_syschar = sysc;
+
+				if (__oscap_metrics_enabled) {
+					memset(&stats, 0, sizeof stats);
+					stats.active     = true;
+					stats.cache_hits = 1;
+					oscap_metrics_add(OSCAP_METRICS_OBJECT, oid, &stats);
+				}
 				return 0;
 			}
 		}
@@ -283,10 +309,19 @@ int oval_probe_query_object(oval_probe_session_t *psess, struct oval_object *obj
 		return 1;
         }
 
-	if ((ret = ph->func(type, ph->uptr, PROBE_HANDLER_ACT_EVAL, sysc, flags)) != 0) {
-		return ret;
+	oscap_metrics_start(&stats);
+	ret = ph->func(type, ph->uptr, PROBE_HANDLER_ACT_EVAL, sysc, flags);
+	oscap_metrics_stop(&stats);
+
+	if (stats.active) {
+		if (ret == 0 && !(flags & OVAL_PDFLAG_NOREPLY))
+			stats.items = _syschar_count_items(sysc);
+		oscap_metrics_add(OSCAP_METRICS_OBJECT, oid, &stats);
 	}
 
+	if (ret != 0)
+		return ret;
+
 	if (!(flags & OVAL_PDFLAG_NOREPLY)) {
 		vm = oval_string_map_new();
 		oval_obj_collect_var_refs(object, vm);
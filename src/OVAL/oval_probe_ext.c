@@ -32,6 +32,7 @@
 #include <sys/stat.h>
 #include <unistd.h>
 #include <stdlib.h>
+#include <time.h>
 
 #include "common/_error.h"
 #include "common/alloc.h"
@@ -39,6 +40,8 @@
 #include "common/util.h"
 #include "common/bfind.h"
 #include "common/debug_priv.h"
+#include "common/trace_priv.h"
+#include "common/metrics_priv.h"
 #include "probes/public/probe-api.h"
 #include "oval_probe_ext.h"
 #include "oval_sexp.h"
@@ -75,6 +78,14 @@ oval_pext_t *oval_pext_new(void)
         if (pext->probe_dir == NULL)
                 pext->probe_dir = OVAL_PROBE_DIR;
 
+#if defined(OVAL_PROBEDIR_ENV)
+        pext->module_dir = getenv("OVAL_PROBE_MODULE_DIR");
+#else
+        pext->module_dir = NULL;
+#endif
+        if (pext->module_dir == NULL)
+                pext->module_dir = OVAL_PROBE_MODULE_DIR;
+
         pext->pdtbl     = NULL;
         pext->pdsc      = NULL;
         pext->pdsc_cnt  = 0;
@@ -179,6 +190,7 @@ static oval_pd_t *oval_pdtbl_get(oval_pdtbl_t * tbl, oval_subtype_t type)
 /*
  * oval_probe_cmd_
  */
+static SEXP_t *oval_probe_cmd_obj_eval1(oval_pext_t *pext, SEXP_t *sexp);
 static SEXP_t *oval_probe_cmd_obj_eval(SEXP_t *sexp, void *arg);
 static SEXP_t *oval_probe_cmd_ste_fetch(SEXP_t *sexp, void *arg);
 static int     oval_probe_cmd_init(oval_pext_t *pext);
@@ -206,19 +218,15 @@ static int oval_probe_cmd_init(oval_pext_t *pext)
 	return (0);
 }
 
-static SEXP_t *oval_probe_cmd_obj_eval(SEXP_t *sexp, void *arg)
+static SEXP_t *oval_probe_cmd_obj_eval1(oval_pext_t *pext, SEXP_t *sexp)
 {
 	char *id_str;
 	struct oval_definition_model *defs;
 	struct oval_object  *obj;
 	struct oval_syschar *res;
-	oval_pext_t *pext = (oval_pext_t *) arg;
 	SEXP_t *ret, *ret_code;
 	int r;
 
-        assume_d (sexp != NULL, NULL);
-        assume_d (arg  != NULL, NULL);
-
 	if (!SEXP_stringp(sexp)) {
 		oscap_dlprintf(DBG_E, "Invalid argument: type=%s.\n", SEXP_strtype(sexp));
 		return (NULL);
@@ -264,6 +272,40 @@ static SEXP_t *oval_probe_cmd_obj_eval(SEXP_t *sexp, void *arg)
 	return (ret);
 }
 
+/*
+ * The argument is either an object id or a list of object ids. The
+ * reply is a list (id flag) or, in the latter case, a list of them.
+ */
+static SEXP_t *oval_probe_cmd_obj_eval(SEXP_t *sexp, void *arg)
+{
+	oval_pext_t *pext = (oval_pext_t *) arg;
+	SEXP_t *id, *res, *ret_list;
+
+        assume_d (sexp != NULL, NULL);
+        assume_d (arg  != NULL, NULL);
+
+	if (!SEXP_listp(sexp))
+		return oval_probe_cmd_obj_eval1(pext, sexp);
+
+	ret_list = SEXP_list_new(NULL);
+
+	SEXP_list_foreach(id, sexp) {
+		res = oval_probe_cmd_obj_eval1(pext, id);
+
+		if (res == NULL) {
+			SEXP_free(ret_list);
+			SEXP_free(id);
+
+			return (NULL);
+		}
+
+		SEXP_list_add(ret_list, res);
+		SEXP_free(res);
+	}
+
+	return (ret_list);
+}
+
 static SEXP_t *oval_probe_cmd_ste_fetch(SEXP_t *sexp, void *arg)
 {
 	SEXP_t *id, *ste_list, *ste_sexp;
@@ -430,9 +472,46 @@ static inline int _handle_SEAP_receive_failure(SEAP_CTX_t *ctx, oval_pd_t *pd, S
 	return (-1);
 }
 
-static int oval_probe_comm(SEAP_CTX_t *ctx, oval_pd_t *pd, const SEXP_t *s_iobj, int flags, SEXP_t **out_sexp)
+/*
+ * Add the SEAP traffic of one query and the probe side statistics sent
+ * along with the reply to the sample, if there's one to fill.
+ */
+static void oval_probe_comm_stats(SEAP_CTX_t *ctx, oval_pd_t *pd, SEAP_msg_t *s_imsg,
+                                  uint64_t bytes_in, uint64_t bytes_out,
+                                  struct oscap_metrics_sample *stats)
+{
+	uint64_t in, out;
+	SEXP_t *cpu_time;
+
+	if (stats == NULL || !stats->active)
+		return;
+
+	if (SEAP_iostat(ctx, pd->sd, &in, &out) == 0) {
+		stats->bytes_in  += in  - bytes_in;
+		stats->bytes_out += out - bytes_out;
+	}
+
+	if ((cpu_time = SEAP_msgattr_get(s_imsg, "cpu-time")) != NULL) {
+		stats->probe_cpu += (double)SEXP_number_getu_64(cpu_time) / 1000000.0;
+		SEXP_free(cpu_time);
+	}
+
+	if (SEAP_msgattr_exists(s_imsg, "rcache-hit"))
+		++stats->cache_hits;
+}
+
+/*
+ * Send the object to the probe and wait for the reply. If `part_cb' is not
+ * NULL, the probe may send large replies in parts; every part is passed to
+ * `part_cb' as soon as it's received and only the rest of the reply is
+ * returned in `out_sexp'.
+ */
+static int oval_probe_comm(SEAP_CTX_t *ctx, oval_pd_t *pd, const SEXP_t *s_iobj, int flags, SEXP_t **out_sexp,
+                           struct oscap_metrics_sample *stats,
+                           int (*part_cb)(const SEXP_t *, void *), void *part_arg)
 {
 	int retry, ret;
+	uint64_t bytes_in = 0, bytes_out = 0;
 
 	SEAP_msg_t *s_imsg, *s_omsg;
 	SEXP_t *s_oobj;
@@ -490,8 +569,18 @@ static int oval_probe_comm(SEAP_CTX_t *ctx, oval_pd_t *pd, const SEXP_t *s_iobj,
 			}
 		}
 
+		if (part_cb != NULL && !(flags & OVAL_PDFLAG_NOREPLY))
+			SEAP_msgattr_set(s_omsg, "stream", NULL);
+
+		/* the probe reports its CPU time only when asked to */
+		if (stats != NULL && stats->active)
+			SEAP_msgattr_set(s_omsg, "profile", NULL);
+
 		oscap_dlprintf(DBG_I, "Sending message.\n");
 
+		if (stats != NULL && stats->active)
+			SEAP_iostat(ctx, pd->sd, &bytes_in, &bytes_out);
+
 		ret = SEAP_sendmsg(ctx, pd->sd, s_omsg);
 		if (ret != 0) {
                         protect_errno {
@@ -587,7 +676,55 @@ static int oval_probe_comm(SEAP_CTX_t *ctx, oval_pd_t *pd, const SEXP_t *s_iobj,
 		break;
 	}
 
+	/*
+	 * Parts of a streamed reply. The request isn't retried once a part
+	 * was received, the caller has already consumed it.
+	 */
+	while (SEAP_msgattr_exists(s_imsg, "part-of")) {
+		SEXP_t *s_part_of;
+		SEAP_msgid_t part_of;
+
+		s_part_of = SEAP_msgattr_get(s_imsg, "part-of");
+#if SEAP_MSGID_BITS == 64
+		part_of = SEXP_number_getu_64(s_part_of);
+#else
+		part_of = SEXP_number_getu_32(s_part_of);
+#endif
+		SEXP_free(s_part_of);
+
+		if (part_cb == NULL || part_of != SEAP_msg_id(s_omsg)) {
+			oscap_seterr(OSCAP_EFAMILY_OVAL, "Unexpected part of a reply from probe at sd=%d (%s)",
+				     pd->sd, oval_subtype_to_str(pd->subtype));
+			ret = -1;
+		} else {
+			s_oobj = SEAP_msg_get(s_imsg);
+			ret = part_cb(s_oobj, part_arg);
+			SEXP_free(s_oobj);
+		}
+
+		SEAP_msg_free(s_imsg);
+		s_imsg = NULL;
+
+		if (ret != 0) {
+			/* the rest of the reply is still on the way, drop the connection */
+			SEAP_close(ctx, pd->sd);
+			pd->sd = -1;
+			SEAP_msg_free(s_omsg);
+			return (-1);
+		}
+
+		if (SEAP_recvmsg(ctx, pd->sd, &s_imsg) != 0) {
+			protect_errno {
+				_handle_SEAP_receive_failure(ctx, pd, s_omsg, flags);
+				SEAP_msg_free(s_imsg);
+				SEAP_msg_free(s_omsg);
+			}
+			return (errno == ECONNABORTED ? -2 : -1);
+		}
+	}
+
 	s_oobj = SEAP_msg_get(s_imsg);
+	oval_probe_comm_stats(ctx, pd, s_imsg, bytes_in, bytes_out, stats);
 
 	SEAP_msg_free(s_imsg);
 	SEAP_msg_free(s_omsg);
@@ -606,6 +743,38 @@ static int oval_pdsc_cmp(oval_pdsc_t *a, oval_pdsc_t *b)
 	return (a->type - b->type);
 }
 
+/*
+ * Build the URI used to connect to a probe. If OSCAP_PROBE_INPROCESS is set and
+ * the probe is also installed as a module in the module directory, the probe is loaded into this process
+ * and connected using the "mem" scheme. Offline scans always use the separate
+ * probe executable because the probe changes its root directory.
+ */
+static size_t oval_probe_ext_uri(oval_pext_t *pext, oval_pdsc_t *dsc, char *uri, size_t urisize)
+{
+        const char *env;
+        struct stat st;
+        size_t len;
+
+        env = getenv("OSCAP_PROBE_INPROCESS");
+
+        if (env != NULL && *env != '\0') {
+                env = getenv("OSCAP_PROBE_ROOT");
+
+                if (env == NULL || *env == '\0') {
+                        len = snprintf(uri, urisize, "%s://%s/%s%s", OVAL_PROBE_MODULE_SCHEME,
+                                       pext->module_dir, dsc->file, OVAL_PROBE_MODULE_SUFFIX);
+
+                        if (len < urisize &&
+                            stat(uri + strlen(OVAL_PROBE_MODULE_SCHEME) + 3, &st) == 0 && S_ISREG(st.st_mode))
+                                return (len);
+
+                        dI("No in-process module for %s, using %s.\n", dsc->name, OVAL_PROBE_SCHEME);
+                }
+        }
+
+        return snprintf(uri, urisize, "%s://%s/%s", OVAL_PROBE_SCHEME, pext->probe_dir, dsc->file);
+}
+
 static oval_pdsc_t *oval_pdsc_lookup(oval_pdsc_t pdsc[], int count, oval_subtype_t type)
 {
 	return oscap_bfind(pdsc, count, sizeof(oval_pdsc_t), &type,
@@ -637,7 +806,7 @@ static int oval_probe_sys_eval(SEAP_CTX_t *ctx, oval_pd_t *pd, struct oval_sysch
                 SEXP_free (r0);
         }
 
-        ret = oval_probe_comm(ctx, pd, s_obj, 0, &r0);
+        ret = oval_probe_comm(ctx, pd, s_obj, 0, &r0, NULL, NULL, NULL);
         SEXP_free(s_obj);
 
 	if (ret != 0)
@@ -774,10 +943,8 @@ int oval_probe_sys_handler(oval_subtype_t type, void *ptr, int act, ...)
         {
                 char         probe_uri[PATH_MAX + 1];
                 size_t       probe_urilen;
-                char        *probe_dir;
                 oval_pdsc_t *probe_dsc;
 
-                probe_dir = pext->probe_dir;
                 probe_dsc = oval_pdsc_lookup(pext->pdsc, pext->pdsc_cnt, type);
 
 		if (probe_dsc == NULL) {
@@ -787,8 +954,7 @@ int oval_probe_sys_handler(oval_subtype_t type, void *ptr, int act, ...)
 			break;
 		}
 
-                probe_urilen = snprintf(probe_uri, sizeof probe_uri,
-                                        "%s://%s/%s", OVAL_PROBE_SCHEME, probe_dir, probe_dsc->file);
+                probe_urilen = oval_probe_ext_uri(pext, probe_dsc, probe_uri, sizeof probe_uri);
 
                 if (probe_urilen >= sizeof probe_uri) {
                         oscap_seterr (OSCAP_EFAMILY_GLIBC, "probe URI too long");
@@ -841,10 +1007,8 @@ int oval_probe_ext_handler(oval_subtype_t type, void *ptr, int act, ...)
                 if (pd == NULL) {
                         char         probe_uri[PATH_MAX + 1];
                         size_t       probe_urilen;
-                        char        *probe_dir;
                         oval_pdsc_t *probe_dsc;
 
-                        probe_dir = pext->probe_dir;
                         probe_dsc = oval_pdsc_lookup(pext->pdsc, pext->pdsc_cnt, oval_object_get_subtype(obj));
 
 			if (probe_dsc == NULL) {
@@ -854,8 +1018,7 @@ int oval_probe_ext_handler(oval_subtype_t type, void *ptr, int act, ...)
 				return (1);
 			}
 
-                        probe_urilen = snprintf(probe_uri, sizeof probe_uri,
-                                                "%s://%s/%s", OVAL_PROBE_SCHEME, probe_dir, probe_dsc->file);
+                        probe_urilen = oval_probe_ext_uri(pext, probe_dsc, probe_uri, sizeof probe_uri);
 
                         if (probe_urilen >= sizeof probe_uri) {
                                 oscap_seterr (OSCAP_EFAMILY_GLIBC, "probe URI too long");
@@ -881,7 +1044,9 @@ int oval_probe_ext_handler(oval_subtype_t type, void *ptr, int act, ...)
                         }
                 }
 
+		oscap_trace_begin("probe_query", oval_object_get_id(obj));
 		ret = oval_probe_ext_eval(pext->pdtbl->ctx, pd, pext, sys, flags);
+		oscap_trace_end("probe_query", oval_object_get_id(obj), 0, 0);
 
 		if (ret >= 0)
 			ret = 0;
@@ -1047,10 +1212,17 @@ _ret:
         return(ret);
 }
 
+static int oval_probe_ext_part(const SEXP_t *s_part, void *arg)
+{
+	return oval_sexp_to_sysch_part((struct oval_sexp_sysch_state *)arg, s_part);
+}
+
 int oval_probe_ext_eval(SEAP_CTX_t *ctx, oval_pd_t *pd, oval_pext_t *pext, struct oval_syschar *syschar, int flags)
 {
         SEXP_t *s_obj, *s_sys;
 	struct oval_object *object;
+	struct oval_sexp_sysch_state state;
+	struct oscap_metrics_sample stats;
 	int ret;
 
 	if (syschar == NULL) {
@@ -1064,10 +1236,23 @@ int oval_probe_ext_eval(SEAP_CTX_t *ctx, oval_pd_t *pd, oval_pext_t *pext, struc
 	if (ret != 0)
 		return (1);
 
-	ret = oval_probe_comm(ctx, pd, s_obj, flags, &s_sys);
+	/*
+	 * Only the probe side is measured here, the time and the number of
+	 * calls are accounted for by oval_probe_query_object.
+	 */
+	memset(&stats, 0, sizeof stats);
+	stats.active = __oscap_metrics_enabled;
+
+	oval_sexp_to_sysch_begin(&state, syschar);
+	ret = oval_probe_comm(ctx, pd, s_obj, flags, &s_sys, &stats, &oval_probe_ext_part, &state);
 	SEXP_free(s_obj);
+	oscap_metrics_add(OSCAP_METRICS_OBJECT, oval_object_get_id(object), &stats);
 
 	if (ret != 0) {
+		protect_errno {
+			oval_sexp_to_sysch_abort(&state);
+		}
+
 		switch (errno) {
 		case ECONNABORTED:
 			dI("Closing sd=%d (pd=%p) after abort\n", pd->sd, pd);
@@ -1088,13 +1273,14 @@ int oval_probe_ext_eval(SEAP_CTX_t *ctx, oval_pd_t *pd, oval_pext_t *pext, struc
                         oscap_dlprintf(DBG_W, "Obtrusive data from probe!\n");
                         SEXP_free(s_sys);
 		}
+		oval_sexp_to_sysch_end(&state, NULL);
 		return (0);
 	}
 
         /*
-	 * Convert the received S-exp to OVAL system characteristic.
+	 * Convert the rest of the received S-exp to OVAL system characteristic.
 	 */
-	ret = oval_sexp_to_sysch(s_sys, syschar);
+	ret = oval_sexp_to_sysch_end(&state, s_sys);
 	SEXP_free(s_sys);
 
 	return (ret);
@@ -1107,6 +1293,204 @@ int oval_probe_ext_reset(SEAP_CTX_t *ctx, oval_pd_t *pd, oval_pext_t *pext)
         return (0);
 }
 
+int oval_probe_ext_invalidate(oval_pext_t *pext, SEXP_t *id_list)
+{
+        oval_pd_t *pd;
+        SEXP_t    *s_ret;
+        size_t     i;
+
+        if (pext->do_init)
+                return (0); /* no probes are running */
+
+        for (i = 0; i < pext->pdtbl->count; ++i) {
+                pd = pext->pdtbl->memb[i];
+
+                if (pd->sd == -1)
+                        continue;
+
+                s_ret = SEAP_cmd_exec(pext->pdtbl->ctx, pd->sd, SEAP_EXEC_RECV, PROBECMD_RC_DEL,
+                                      id_list, SEAP_CMDTYPE_SYNC, NULL, NULL);
+
+                if (s_ret == NULL) {
+                        /*
+                         * Restart the probe on the next query rather than
+                         * risk using stale results from its cache.
+                         */
+                        dW("Can't invalidate the result cache of the probe at sd=%d, closing\n", pd->sd);
+                        SEAP_close(pext->pdtbl->ctx, pd->sd);
+                        pd->sd = -1;
+                        continue;
+                }
+
+                SEXP_free(s_ret);
+        }
+
+        return (0);
+}
+
+struct oval_probe_prespawn {
+        oval_pd_t      *pd;
+        SEAP_CTX_t     *ctx;
+        const char     *name;
+        struct timespec start;
+        double          startup;
+        pthread_t       tid;
+        bool            ready;
+};
+
+static double oval_probe_elapsed(const struct timespec *start)
+{
+        struct timespec now;
+
+        clock_gettime(CLOCK_MONOTONIC, &now);
+
+        return ((double)(now.tv_sec - start->tv_sec) +
+                (double)(now.tv_nsec - start->tv_nsec) / 1000000000.0);
+}
+
+/*
+ * Wait for the probe to reply to the ready command, i.e. until
+ * it's running and probe_init() has finished.
+ */
+static void *oval_probe_ext_waitready(void *arg)
+{
+        struct oval_probe_prespawn *ps = (struct oval_probe_prespawn *)arg;
+        SEXP_t *s_ret;
+
+        s_ret = SEAP_cmd_exec(ps->ctx, ps->pd->sd, SEAP_EXEC_RECV, PROBECMD_READY,
+                              NULL, SEAP_CMDTYPE_SYNC, NULL, NULL);
+
+        ps->startup = oval_probe_elapsed(&ps->start);
+        ps->ready   = (s_ret != NULL);
+
+        SEXP_free(s_ret);
+
+        return (NULL);
+}
+
+int oval_probe_ext_prespawn(oval_pext_t *pext, struct oval_definition_model *model,
+                            oval_probe_startup_reporter reporter, void *arg)
+{
+        struct oval_object_iterator *obj_itr;
+        struct oval_probe_prespawn  *ps;
+        oval_subtype_t *types;
+        size_t type_cnt, ps_cnt, i;
+        int ret;
+
+        if (pext->do_init) {
+                if (oval_probe_ext_init(pext) != 0)
+                        return (-1);
+        }
+
+        /*
+         * Collect the set of object types used by the model
+         */
+        types    = NULL;
+        type_cnt = 0;
+        obj_itr  = oval_definition_model_get_objects(model);
+
+        while (oval_object_iterator_has_more(obj_itr)) {
+                oval_subtype_t type = oval_object_get_subtype(oval_object_iterator_next(obj_itr));
+
+                for (i = 0; i < type_cnt; ++i) {
+                        if (types[i] == type)
+                                break;
+                }
+
+                if (i == type_cnt) {
+                        types = oscap_realloc(types, sizeof(oval_subtype_t) * (type_cnt + 1));
+                        types[type_cnt++] = type;
+                }
+        }
+
+        oval_object_iterator_free(obj_itr);
+
+        /*
+         * Start the probes. Connecting only forks the probe, the probes
+         * initialize concurrently while the other ones are started.
+         */
+        ps     = oscap_alloc(sizeof(struct oval_probe_prespawn) * (type_cnt + 1));
+        ps_cnt = 0;
+
+        for (i = 0; i < type_cnt; ++i) {
+                char         probe_uri[PATH_MAX + 1];
+                size_t       probe_urilen;
+                oval_pdsc_t *probe_dsc;
+                oval_pd_t   *pd;
+
+                probe_dsc = oval_pdsc_lookup(pext->pdsc, pext->pdsc_cnt, types[i]);
+
+                if (probe_dsc == NULL)
+                        continue; /* not an external probe or not installed */
+
+                if (oval_pdtbl_get(pext->pdtbl, types[i]) != NULL)
+                        continue; /* already started */
+
+                probe_urilen = oval_probe_ext_uri(pext, probe_dsc, probe_uri, sizeof probe_uri);
+
+                if (probe_urilen >= sizeof probe_uri)
+                        continue;
+
+                if (oval_pdtbl_add(pext->pdtbl, types[i], -1, probe_uri) != 0)
+                        continue;
+
+                pd = oval_pdtbl_get(pext->pdtbl, types[i]);
+
+                if (pd == NULL)
+                        continue;
+
+                clock_gettime(CLOCK_MONOTONIC, &ps[ps_cnt].start);
+                pd->sd = SEAP_connect(pext->pdtbl->ctx, pd->uri, 0);
+
+                if (pd->sd < 0) {
+                        /* oval_probe_comm() will retry and report the error */
+                        dW("Can't start the %s probe: %u, %s.\n", probe_dsc->name, errno, strerror(errno));
+                        pd->sd = -1;
+                        continue;
+                }
+
+                ps[ps_cnt].pd    = pd;
+                ps[ps_cnt].ctx   = pext->pdtbl->ctx;
+                ps[ps_cnt].name  = probe_dsc->name;
+                ps[ps_cnt].ready = false;
+
+                if (pthread_create(&ps[ps_cnt].tid, NULL, &oval_probe_ext_waitready, &ps[ps_cnt]) != 0) {
+                        dW("Can't create a thread: %u, %s.\n", errno, strerror(errno));
+                        ps[ps_cnt].ready = true; /* the first query will wait instead */
+                        ps[ps_cnt].tid   = pthread_self();
+                }
+
+                ++ps_cnt;
+        }
+
+        oscap_free(types);
+
+        ret = 0;
+
+        for (i = 0; i < ps_cnt; ++i) {
+                if (!pthread_equal(ps[i].tid, pthread_self()))
+                        pthread_join(ps[i].tid, NULL);
+
+                if (!ps[i].ready) {
+                        dW("The %s probe didn't start.\n", ps[i].name);
+                        SEAP_close(ps[i].ctx, ps[i].pd->sd);
+                        ps[i].pd->sd = -1;
+                        continue;
+                }
+
+                dI("The %s probe started in %.3f s.\n", ps[i].name, ps[i].startup);
+
+                if (reporter != NULL)
+                        reporter(ps[i].name, ps[i].startup, arg);
+
+                ++ret;
+        }
+
+        oscap_free(ps);
+
+        return (ret);
+}
+
 #include <signal.h>
 #include "SEAP/_seap-types.h"
 #include "SEAP/seap-descriptor.h"
@@ -27,6 +27,7 @@
 #include <stdbool.h>
 #include "oval_probe_impl.h"
 #include "oval_system_characteristics_impl.h"
+#include "public/oval_probe_session.h"
 #include "common/util.h"
 
 typedef struct {
@@ -58,6 +59,7 @@ struct oval_pext {
         size_t        pdsc_cnt;
         oval_pdtbl_t *pdtbl;
         char         *probe_dir;
+        char         *module_dir;
 
         void *sess_ptr;
         struct oval_syschar_model **model;
@@ -71,6 +73,9 @@ int oval_probe_ext_init(oval_pext_t *pext);
 int oval_probe_ext_eval(SEAP_CTX_t *ctx, oval_pd_t *pd, oval_pext_t *pext, struct oval_syschar *syschar, int flags);
 int oval_probe_ext_reset(SEAP_CTX_t *ctx, oval_pd_t *pd, oval_pext_t *pext);
 int oval_probe_ext_abort(SEAP_CTX_t *ctx, oval_pd_t *pd, oval_pext_t *pext);
+int oval_probe_ext_invalidate(oval_pext_t *pext, SEXP_t *id_list);
+int oval_probe_ext_prespawn(oval_pext_t *pext, struct oval_definition_model *model,
+                            oval_probe_startup_reporter reporter, void *arg);
 
 int oval_probe_ext_handler(oval_subtype_t type, void *ptr, int act, ...);
 int oval_probe_sys_handler(oval_subtype_t type, void *ptr, int act, ...);
@@ -24,11 +24,16 @@
 #include <config.h>
 #endif
 
+#include <string.h>
+
 #include "public/oval_definitions.h"
 #include "public/oval_system_characteristics.h"
 #include "oval_system_characteristics_impl.h"
 #include "oval_probe_impl.h"
 #include "_oval_probe_session.h"
+#include "collectVarRefs_impl.h"
+#include "adt/oval_string_map_impl.h"
+#include "common/debug_priv.h"
 
 static int _oval_probe_hint_criteria(oval_probe_session_t *sess, struct oval_criteria_node *cnode, int variable_instance_hint);
 static int _oval_probe_hint_object(oval_probe_session_t *psess, struct oval_object *object, int variable_instance_hint);
@@ -99,3 +104,66 @@ int _oval_probe_hint_object(oval_probe_session_t *psess, struct oval_object *obj
 	}
 	return 0;
 }
+
+static bool _oval_probe_hint_refs_changed(struct oval_string_map *refs, struct oval_string_map *changed)
+{
+	bool ret = false;
+	struct oval_string_iterator *ref_it = (struct oval_string_iterator *) oval_string_map_keys(refs);
+
+	while (!ret && oval_string_iterator_has_more(ref_it)) {
+		char *var_id = oval_string_iterator_next(ref_it);
+		ret = oval_string_map_get_value(changed, var_id) != NULL;
+	}
+	oval_string_iterator_free(ref_it);
+	return ret;
+}
+
+/**
+ * Drops the results of objects and the states that depend on any of the
+ * changed variables from the result caches of the running probes. Probes
+ * keep the results of objects they've already collected for the lifetime
+ * of the session; when a new variable instance is injected, only these
+ * entries have to be collected again.
+ * @param changed map of the ids of the changed variables
+ * @returns 0 on success; -1 on error
+ */
+int oval_probe_hint_variables(oval_probe_session_t *sess, struct oval_definition_model *model, struct oval_string_map *changed)
+{
+	SEXP_t *id_list = SEXP_list_new(NULL);
+
+	struct oval_object_iterator *obj_it = oval_definition_model_get_objects(model);
+	while (oval_object_iterator_has_more(obj_it)) {
+		struct oval_object *object = oval_object_iterator_next(obj_it);
+		struct oval_string_map *refs = oval_string_map_new();
+
+		oval_obj_collect_var_refs(object, refs);
+		if (_oval_probe_hint_refs_changed(refs, changed)) {
+			SEXP_t *id = SEXP_string_new(oval_object_get_id(object), strlen(oval_object_get_id(object)));
+			SEXP_list_add(id_list, id);
+			SEXP_free(id);
+		}
+		oval_string_map_free(refs, NULL);
+	}
+	oval_object_iterator_free(obj_it);
+
+	struct oval_state_iterator *ste_it = oval_definition_model_get_states(model);
+	while (oval_state_iterator_has_more(ste_it)) {
+		struct oval_state *state = oval_state_iterator_next(ste_it);
+		struct oval_string_map *refs = oval_string_map_new();
+
+		oval_ste_collect_var_refs(state, refs);
+		if (_oval_probe_hint_refs_changed(refs, changed)) {
+			SEXP_t *id = SEXP_string_new(oval_state_get_id(state), strlen(oval_state_get_id(state)));
+			SEXP_list_add(id_list, id);
+			SEXP_free(id);
+		}
+		oval_string_map_free(refs, NULL);
+	}
+	oval_state_iterator_free(ste_it);
+
+	dI("%zu objects and states depend on the changed variables.\n", SEXP_list_length(id_list));
+
+	int ret = SEXP_list_length(id_list) > 0 ? oval_probe_ext_invalidate(sess->pext, id_list) : 0;
+	SEXP_free(id_list);
+	return ret;
+}
@@ -48,11 +48,17 @@
 OSCAP_HIDDEN_START;
 
 #define OVAL_PROBE_SCHEME "pipe"
+#define OVAL_PROBE_MODULE_SCHEME "mem"
+#define OVAL_PROBE_MODULE_SUFFIX ".so"
 
 #ifndef OVAL_PROBE_DIR
 # define OVAL_PROBE_DIR    "/usr/libexec/openscap"
 #endif
 
+#ifndef OVAL_PROBE_MODULE_DIR
+# define OVAL_PROBE_MODULE_DIR "/usr/lib/openscap"
+#endif
+
 #define OVAL_PROBE_MAXRETRY 0
 
 OSCAP_HIDDEN_END;
@@ -69,6 +75,7 @@ const char *oval_subtype_to_str(oval_subtype_t subtype);
 oval_subtype_t oval_str_to_subtype(const char *str);
 
 int oval_probe_hint_definition(oval_probe_session_t *sess, struct oval_definition *definition, int variable_instance_hint);
+int oval_probe_hint_variables(oval_probe_session_t *sess, struct oval_definition_model *model, struct oval_string_map *changed);
 
 #endif /* OVAL_PROBE_IMPL_H */
 /// @}
@@ -71,10 +71,8 @@ static void ncache_libfree(void)
  */
 static void ncache_libinit(void)
 {
-        if (OSCAP_GSYM(ncache) == NULL) {
-                OSCAP_GSYM(ncache) = probe_ncache_new();
+        if (probe_ncache_libcache() != NULL)
                 atexit(ncache_libfree);
-        }
 }
 
 static void oval_probe_session_libinit(void)
@@ -187,6 +185,17 @@ int oval_probe_session_reset(oval_probe_session_t *sess, struct oval_syschar_mod
         return(0);
 }
 
+int oval_probe_session_prespawn(oval_probe_session_t *sess, struct oval_definition_model *model,
+                                oval_probe_startup_reporter reporter, void *arg)
+{
+        if (sess == NULL || model == NULL) {
+                oscap_seterr(OSCAP_EFAMILY_OVAL, "Invalid arguments");
+                return (-1);
+        }
+
+        return oval_probe_ext_prespawn(sess->pext, model, reporter, arg);
+}
+
 int oval_probe_session_abort(oval_probe_session_t *sess)
 {
 	oval_ph_t *ph;
@@ -771,14 +771,21 @@ static struct oval_message *oval_sexp_to_msg(const SEXP_t *msg)
 
 static struct oval_sysent *oval_sexp_to_sysent(struct oval_syschar_model *model, struct oval_sysitem *item, SEXP_t * sexp, struct oval_string_map *mask_map)
 {
-	char *key;
+	char key_buf[128], *key;
+	size_t key_len;
 	oval_syschar_status_t status;
 	oval_datatype_t dt;
 	struct oval_sysent *ent;
 
-	key = probe_ent_getname(sexp);
-	if (!key)
-		return NULL;
+	/* avoid allocating the name, it's going to be interned anyway */
+	key = key_buf;
+	key_len = probe_ent_getname_r(sexp, key_buf, sizeof key_buf);
+
+	if (key_len == 0 || key_len == (size_t)-1) {
+		key = probe_ent_getname(sexp);
+		if (!key)
+			return NULL;
+	}
 
 	if (strcmp("message", key) == 0 && item != NULL) {
 	    struct oval_message *msg;
@@ -802,6 +809,9 @@ static struct oval_sysent *oval_sexp_to_sysent(struct oval_syschar_model *model,
 	    oval_message_set_text(msg, txt);
 	    oval_sysitem_add_message(item, msg);
 
+	    if (key != key_buf)
+		    oscap_free(key);
+
 	    return (NULL);
 	}
 
@@ -809,7 +819,7 @@ static struct oval_sysent *oval_sexp_to_sysent(struct oval_syschar_model *model,
 	dt = probe_ent_getdatatype(sexp);
 
 	ent = oval_sysent_new(model);
-	oval_sysent_set_name(ent, key);
+	oval_sysent_set_name_interned(ent, key);
 	oval_sysent_set_status(ent, status);
 	oval_sysent_set_datatype(ent, dt);
 	if (mask_map == NULL || oval_string_map_get_value(mask_map, key) == NULL)
@@ -817,6 +827,10 @@ static struct oval_sysent *oval_sexp_to_sysent(struct oval_syschar_model *model,
 	else
 		oval_sysent_set_mask(ent, 1);
 
+	if (key != key_buf)
+		oscap_free(key);
+	key = oval_sysent_get_name(ent);
+
 	if (status != SYSCHAR_STATUS_EXISTS)
 		return ent;
 
@@ -832,7 +846,7 @@ static struct oval_sysent *oval_sexp_to_sysent(struct oval_syschar_model *model,
 		}
 		SEXP_free(srfs);
 	} else {
-		char val[64], *valp = val;
+		char val[256], *valp = val;
 		SEXP_t *sval;
 		SEXP_numtype_t sndt;
 
@@ -873,7 +887,8 @@ static struct oval_sysent *oval_sexp_to_sysent(struct oval_syschar_model *model,
 		case OVAL_DATATYPE_IPV6ADDR:
 		case OVAL_DATATYPE_STRING:
 		case OVAL_DATATYPE_VERSION:
-			valp = SEXP_string_cstr(sval);
+			if (SEXP_string_cstr_r(sval, val, sizeof val) == (size_t)-1)
+				valp = SEXP_string_cstr(sval);
 			break;
 		default:
 			dE("Unexpected OVAL datatype: %d, '%s', name: '%s'.\n",
@@ -882,7 +897,7 @@ static struct oval_sysent *oval_sexp_to_sysent(struct oval_syschar_model *model,
 			break;
 		}
 
-		oval_sysent_set_value(ent, valp);
+		oval_sysent_set_value_interned(ent, valp);
 		if (valp != val)
 			oscap_free(valp);
                 SEXP_free(sval);
@@ -953,31 +968,22 @@ static struct oval_sysitem *oval_sexp_to_sysitem(struct oval_syschar_model *mode
 	return sysitem;
 }
 
-int oval_sexp_to_sysch(const SEXP_t *cobj, struct oval_syschar *syschar)
+void oval_sexp_to_sysch_begin(struct oval_sexp_sysch_state *state, struct oval_syschar *syschar)
 {
-	oval_syschar_collection_flag_t flag;
-	SEXP_t *messages, *msg, *items, *item, *mask;
+	state->syschar  = syschar;
+	state->item_ids = oval_string_map_new();
+	state->received = false;
+}
+
+int oval_sexp_to_sysch_part(struct oval_sexp_sysch_state *state, const SEXP_t *cobj)
+{
+	SEXP_t *items, *item, *mask;
 	struct oval_syschar_model *model;
-	struct oval_string_map *itm_id_map;
         struct oval_string_map *item_mask_map;
 
 	_A(cobj != NULL);
 
-	flag = probe_cobj_get_flag(cobj);
-	oval_syschar_set_flag(syschar, flag);
-
-	messages = probe_cobj_get_msgs(cobj);
-	SEXP_list_foreach(msg, messages) {
-		struct oval_message *omsg;
-
-		omsg = oval_sexp_to_msg(msg);
-		if (omsg != NULL)
-			oval_syschar_add_message(syschar, omsg);
-	}
-	SEXP_free(messages);
-
-	itm_id_map = oval_string_map_new();
-	model = oval_syschar_get_model(syschar);
+	model = oval_syschar_get_model(state->syschar);
 	items = probe_cobj_get_items(cobj);
 
         mask = probe_cobj_get_mask(cobj);
@@ -1001,18 +1007,76 @@ int oval_sexp_to_sysch(const SEXP_t *cobj, struct oval_syschar *syschar)
 			char *itm_id;
 
 			itm_id = oval_sysitem_get_id(sysitem);
-			if (oval_string_map_get_value(itm_id_map, itm_id) == NULL) {
-				oval_string_map_put(itm_id_map, itm_id, itm_id);
-				oval_syschar_add_sysitem(syschar, sysitem);
+			if (oval_string_map_get_value(state->item_ids, itm_id) == NULL) {
+				oval_string_map_put(state->item_ids, itm_id, itm_id);
+				oval_syschar_add_sysitem(state->syschar, sysitem);
+				state->received = true;
 			}
 		}
 	}
 	SEXP_free(items);
-	oval_string_map_free(itm_id_map, NULL);
         if (item_mask_map != NULL)
             oval_string_map_free_string(item_mask_map);
 
 	return 0;
 }
 
+int oval_sexp_to_sysch_end(struct oval_sexp_sysch_state *state, const SEXP_t *cobj)
+{
+	oval_syschar_collection_flag_t flag;
+	SEXP_t *messages, *msg;
+	int ret = 0;
+
+	if (cobj != NULL) {
+		flag = probe_cobj_get_flag(cobj);
+		oval_syschar_set_flag(state->syschar, flag);
+
+		messages = probe_cobj_get_msgs(cobj);
+		SEXP_list_foreach(msg, messages) {
+			struct oval_message *omsg;
+
+			omsg = oval_sexp_to_msg(msg);
+			if (omsg != NULL)
+				oval_syschar_add_message(state->syschar, omsg);
+		}
+		SEXP_free(messages);
+
+		ret = oval_sexp_to_sysch_part(state, cobj);
+	}
+
+	oval_string_map_free(state->item_ids, NULL);
+	state->item_ids = NULL;
+
+	return (ret);
+}
+
+/*
+ * The reply wasn't received completely. If some parts of it were, their
+ * items are dropped and the object is flagged as an error, the incomplete
+ * collection mustn't be evaluated as if it was the whole one.
+ */
+void oval_sexp_to_sysch_abort(struct oval_sexp_sysch_state *state)
+{
+	if (state->received) {
+		oval_syschar_clear_sysitems(state->syschar);
+		oval_syschar_set_flag(state->syschar, SYSCHAR_FLAG_ERROR);
+		oval_syschar_add_new_message(state->syschar, "The collected items were received only partially.",
+		                             OVAL_MESSAGE_LEVEL_ERROR);
+	}
+
+	oval_string_map_free(state->item_ids, NULL);
+	state->item_ids = NULL;
+}
+
+int oval_sexp_to_sysch(const SEXP_t *cobj, struct oval_syschar *syschar)
+{
+	struct oval_sexp_sysch_state state;
+
+	_A(cobj != NULL);
+
+	oval_sexp_to_sysch_begin(&state, syschar);
+
+	return oval_sexp_to_sysch_end(&state, cobj);
+}
+
 /// @}
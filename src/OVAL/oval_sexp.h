@@ -52,6 +52,23 @@ int oval_state_to_sexp(void *sess, struct oval_state *state, SEXP_t **out_sexp);
  * S-exp -> OVAL
  */
 int oval_sexp_to_sysch(const SEXP_t *cobj, struct oval_syschar *syschar);
+
+/*
+ * Incremental conversion of a collected object received in parts. Every
+ * part contributes its items, the flag and the messages are taken from the
+ * last one passed to oval_sexp_to_sysch_end. Passing NULL to it only
+ * releases the state.
+ */
+struct oval_sexp_sysch_state {
+	struct oval_syschar *syschar;
+	struct oval_string_map *item_ids;
+	bool received; ///< some items were added already
+};
+
+void oval_sexp_to_sysch_begin(struct oval_sexp_sysch_state *state, struct oval_syschar *syschar);
+int oval_sexp_to_sysch_part(struct oval_sexp_sysch_state *state, const SEXP_t *cobj);
+int oval_sexp_to_sysch_end(struct oval_sexp_sysch_state *state, const SEXP_t *cobj);
+void oval_sexp_to_sysch_abort(struct oval_sexp_sysch_state *state);
 OSCAP_HIDDEN_END;
 
 #endif				/* OVAL_SEXP_H */
@@ -53,6 +53,8 @@ typedef struct oval_sysent {
 	int mask;
 	oval_datatype_t datatype;
 	oval_syschar_status_t status;
+	bool name_interned;  ///< the name is owned by the string pool of the model
+	bool value_interned; ///< the value is owned by the string pool of the model
 } oval_sysent_t;
 
 struct oval_sysent *oval_sysent_new(struct oval_syschar_model *model)
@@ -68,6 +70,8 @@ struct oval_sysent *oval_sysent_new(struct oval_syschar_model *model)
 	sysent->datatype = OVAL_DATATYPE_UNKNOWN;
 	sysent->mask = 0;
 	sysent->model = model;
+	sysent->name_interned  = false;
+	sysent->value_interned = false;
 	return sysent;
 }
 
@@ -77,12 +81,12 @@ struct oval_sysent *oval_sysent_clone(struct oval_syschar_model *new_model, stru
 
 	char *old_value = oval_sysent_get_value(old_item);
 	if (old_value) {
-		oval_sysent_set_value(new_item, oscap_strdup(old_value));
+		oval_sysent_set_value_interned(new_item, old_value);
 	}
 
 	char *old_name = oval_sysent_get_name(old_item);
 	if (old_name) {
-		oval_sysent_set_name(new_item, oscap_strdup(old_name));
+		oval_sysent_set_name_interned(new_item, old_name);
 	}
 
 	oval_sysent_set_datatype(new_item, oval_sysent_get_datatype(old_item));
@@ -97,9 +101,9 @@ void oval_sysent_free(struct oval_sysent *sysent)
 	if (sysent == NULL)
 		return;
 
-	if (sysent->name != NULL)
+	if (sysent->name != NULL && !sysent->name_interned)
 		oscap_free(sysent->name);
-	if (sysent->value != NULL)
+	if (sysent->value != NULL && !sysent->value_interned)
 		oscap_free(sysent->value);
 	if (sysent->record_fields)
 		oval_collection_free_items(sysent->record_fields, (oscap_destruct_func) oval_record_field_free);
@@ -174,9 +178,23 @@ int oval_sysent_get_mask(struct oval_sysent *sysent)
 void oval_sysent_set_name(struct oval_sysent *sysent, char *name)
 {
 	__attribute__nonnull__(sysent);
-	if (sysent->name != NULL)
+	if (sysent->name != NULL && !sysent->name_interned)
 		oscap_free(sysent->name);
 	sysent->name = name;
+	sysent->name_interned = false;
+}
+
+void oval_sysent_set_name_interned(struct oval_sysent *sysent, const char *name)
+{
+	__attribute__nonnull__(sysent);
+	if (sysent->model == NULL) {
+		oval_sysent_set_name(sysent, oscap_strdup(name));
+		return;
+	}
+	if (sysent->name != NULL && !sysent->name_interned)
+		oscap_free(sysent->name);
+	sysent->name = (char *) oval_syschar_model_intern(sysent->model, name);
+	sysent->name_interned = true;
 }
 
 void oval_sysent_set_status(struct oval_sysent *sysent, oval_syschar_status_t status)
@@ -200,9 +218,23 @@ void oval_sysent_set_mask(struct oval_sysent *sysent, int mask)
 void oval_sysent_set_value(struct oval_sysent *sysent, char *value)
 {
 	__attribute__nonnull__(sysent);
-	if (sysent->value != NULL)
+	if (sysent->value != NULL && !sysent->value_interned)
 		oscap_free(sysent->value);
 	sysent->value = oscap_strdup(value);
+	sysent->value_interned = false;
+}
+
+void oval_sysent_set_value_interned(struct oval_sysent *sysent, const char *value)
+{
+	__attribute__nonnull__(sysent);
+	if (sysent->model == NULL) {
+		oval_sysent_set_value(sysent, (char *) value);
+		return;
+	}
+	if (sysent->value != NULL && !sysent->value_interned)
+		oscap_free(sysent->value);
+	sysent->value = (char *) oval_syschar_model_intern(sysent->model, value);
+	sysent->value_interned = true;
 }
 
 void oval_sysent_add_record_field(struct oval_sysent *sysent, struct oval_record_field *rf)
@@ -214,7 +246,7 @@ void oval_sysent_add_record_field(struct oval_sysent *sysent, struct oval_record
 
 static void oval_sysent_value_consumer_(char *value, void *sysent)
 {
-	oval_sysent_set_value(sysent, value);
+	oval_sysent_set_value_interned(sysent, value);
 }
 
 static void _oval_sysent_record_field_consumer(struct oval_record_field *rf,
@@ -236,21 +268,19 @@ int oval_sysent_parse_tag(xmlTextReaderPtr reader, struct oval_parser_context *c
 			  oval_sysent_consumer consumer, void *user)
 {
 	int ret, mask;
-	char *tagname;
+	const char *tagname;
 	struct oval_sysent *sysent;
 	oval_datatype_t datatype;
 	oval_syschar_status_t status;
 
 	__attribute__nonnull__(context);
 
-	tagname = (char *) xmlTextReaderLocalName(reader);
-	if (!strcmp("#text", tagname)) {
-		xmlFree(tagname);
+	tagname = (const char *) xmlTextReaderConstLocalName(reader);
+	if (!strcmp("#text", tagname))
 		return 0;
-	}
 
 	sysent = oval_sysent_new(context->syschar_model);
-	oval_sysent_set_name(sysent, tagname);
+	oval_sysent_set_name_interned(sysent, tagname);
 
 	mask = oval_parser_boolean_attribute(reader, "mask", 0);
 	oval_sysent_set_mask(sysent, mask);
@@ -47,6 +47,7 @@
 #include "common/debug_priv.h"
 #include "common/_error.h"
 #include "common/elements.h"
+#include "common/strpool_priv.h"
 #include "oscap_source.h"
 #include "source/oscap_source_priv.h"
 
@@ -57,6 +58,7 @@ typedef struct oval_syschar_model {
 	struct oval_definition_model *definition_model;
 	struct oval_smc *syschar_map;				///< Represents objects within <collected_objects> element
 	struct oval_string_map *sysitem_map;			///< Represents items within <system_data> element
+	struct oscap_strpool *strings;				///< Entity names and values shared by the items
         char *schema;
 } oval_syschar_model_t;						///< Represents <oval_system_characteristics> element
 
@@ -79,6 +81,7 @@ struct oval_syschar_model *oval_syschar_model_new(struct oval_definition_model *
 	newmodel->definition_model = definition_model;
 	newmodel->syschar_map = oval_smc_new();
 	newmodel->sysitem_map = oval_string_map_new();
+	newmodel->strings = oscap_strpool_new();
         newmodel->schema = oscap_strdup(OVAL_SYS_SCHEMA_LOCATION);
 
 	/* check possible allocation problems */
@@ -145,6 +148,7 @@ void oval_syschar_model_free(struct oval_syschar_model *model)
 		oval_smc_free(model->syschar_map, (oscap_destruct_func) oval_syschar_free);
 	if (model->sysitem_map)
 		oval_string_map_free(model->sysitem_map, (oscap_destruct_func) oval_sysitem_free);
+	oscap_strpool_free(model->strings);
         if (model->schema)
                 oscap_free(model->schema);
 
@@ -152,6 +156,7 @@ void oval_syschar_model_free(struct oval_syschar_model *model)
 	model->definition_model = NULL;
 	model->syschar_map = NULL;
 	model->sysitem_map = NULL;
+	model->strings = NULL;
         model->schema = NULL;
 
 	oval_generator_free(model->generator);
@@ -167,6 +172,14 @@ void oval_syschar_model_reset(struct oval_syschar_model *model)
                 oval_string_map_free(model->sysitem_map, (oscap_destruct_func) oval_sysitem_free);
         model->syschar_map = oval_smc_new();
         model->sysitem_map = oval_string_map_new();
+        /* nothing refers to the pooled strings once the items are gone */
+        oscap_strpool_free(model->strings);
+        model->strings = oscap_strpool_new();
+}
+
+const char *oval_syschar_model_intern(struct oval_syschar_model *model, const char *str)
+{
+	return oscap_strpool_intern(model->strings, str);
 }
 
 struct oval_generator *oval_syschar_model_get_generator(struct oval_syschar_model *model)
@@ -252,6 +265,7 @@ int oval_syschar_model_import_source(struct oval_syschar_model *model, struct os
         context.definition_model = oval_syschar_model_get_definition_model(model);
         context.syschar_model = model;
         context.user_data = NULL;
+        context.filter = NULL;
 
 	/* jump into oval_system_characteristics */
 	xmlTextReaderRead(context.reader);
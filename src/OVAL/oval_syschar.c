@@ -135,6 +135,13 @@ void oval_syschar_add_sysitem(struct oval_syschar *syschar, struct oval_sysitem
 	oval_collection_add(syschar->sysitem, sysitem);
 }
 
+void oval_syschar_clear_sysitems(struct oval_syschar *syschar) {
+	__attribute__nonnull__(syschar);
+
+	oval_collection_free_items(syschar->sysitem, NULL);	//sysitems are shared with syschar_model
+	syschar->sysitem = oval_collection_new();
+}
+
 void oval_syschar_add_variable_binding(struct oval_syschar *syschar, struct oval_variable_binding *binding) {
 	__attribute__nonnull__(syschar);
 
@@ -63,11 +63,19 @@ typedef void (*oval_sysent_consumer) (struct oval_sysent *, void *client);
 int oval_sysent_parse_tag(xmlTextReaderPtr, struct oval_parser_context *, oval_sysent_consumer, void *);
 void oval_sysent_to_dom(struct oval_sysent *sysent, xmlDoc * doc, xmlNode * tag_parent);
 void oval_sysent_to_print(struct oval_sysent *, char *, int);
+/*
+ * Set the name or the value to a string from the string pool of the model
+ * the entity belongs to. Most names and many values are the same in all
+ * items, so they're stored only once.
+ */
+void oval_sysent_set_name_interned(struct oval_sysent *sysent, const char *name);
+void oval_sysent_set_value_interned(struct oval_sysent *sysent, const char *value);
 
 /* syschar_model */
 typedef bool oval_syschar_resolver(struct oval_syschar *, void *);
 xmlNode *oval_syschar_model_to_dom(struct oval_syschar_model *, xmlDocPtr, xmlNode *, oval_syschar_resolver, void *);
 void oval_syschar_model_reset(struct oval_syschar_model *model);
+const char *oval_syschar_model_intern(struct oval_syschar_model *model, const char *str);
 
 struct oval_syschar *oval_syschar_model_get_new_syschar(struct oval_syschar_model *, struct oval_object *);
 struct oval_sysitem *oval_syschar_model_get_new_sysitem(struct oval_syschar_model *, const char *id);
@@ -81,6 +89,7 @@ struct oval_syschar_iterator *oval_syschar_iterator_new(struct oval_smc *mapping
 int oval_syschar_get_variable_instance_hint(const struct oval_syschar *syschar);
 void oval_syschar_set_variable_instance_hint(struct oval_syschar *syschar, int variable_instance_hint_in);
 const char *oval_syschar_get_id(const struct oval_syschar *syschar);
+void oval_syschar_clear_sysitems(struct oval_syschar *syschar);
 
 OSCAP_HIDDEN_END;
 
@@ -45,6 +45,12 @@ typedef struct {
         int     (*sch_close)    (SEAP_desc_t *, uint32_t);
         ssize_t (*sch_sendsexp) (SEAP_desc_t *, SEXP_t *, uint32_t);
         int     (*sch_select)   (SEAP_desc_t *, int, uint16_t, uint32_t);
+        /*
+         * Optional. Schemes which don't serialize S-expressions set
+         * this to receive one packet S-exp at a time; sch_recv isn't
+         * used then. Returns 1 on success and 0 on EOF.
+         */
+        ssize_t (*sch_recvsexp) (SEAP_desc_t *, SEXP_t **, uint32_t);
 } SEAP_schemefn_t;
 
 extern const SEAP_schemefn_t __schtbl[];
@@ -57,6 +63,7 @@ extern const SEAP_schemefn_t __schtbl[];
 #define SCH_CLOSE(idx, ...)    __schtbl[idx].sch_close (__VA_ARGS__)
 #define SCH_SENDSEXP(idx, ...) __schtbl[idx].sch_sendsexp (__VA_ARGS__)
 #define SCH_SELECT(idx, ...)   __schtbl[idx].sch_select (__VA_ARGS__)
+#define SCH_RECVSEXP(idx, ...) __schtbl[idx].sch_recvsexp (__VA_ARGS__)
 
 #define SEAP_IO_EVREAD  0x01
 #define SEAP_IO_EVWRITE 0x02
@@ -79,9 +86,13 @@ SEAP_scheme_t SEAP_scheme_search (const SEAP_schemefn_t fntable[], const char *s
 #include "sch_generic.h"
 #define SCH_GENERIC 2
 
+/* mem */
+#include "sch_mem.h"
+#define SCH_MEM     3
+
 /* pipe */
 #include "sch_pipe.h"
-#define SCH_PIPE    3
+#define SCH_PIPE    4
 
 #define SCH_NONE    255
 
@@ -0,0 +1,72 @@
+/*
+ * Copyright 2026 Red Hat Inc., Durham, North Carolina.
+ * All Rights Reserved.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#pragma once
+#ifndef _SEXP_INDEX_H
+#define _SEXP_INDEX_H
+
+#include <stdint.h>
+#include "_sexp-types.h"
+#include "_sexp-value.h"
+#include "../../../common/util.h"
+
+OSCAP_HIDDEN_START;
+
+/*
+ * Lists with fewer members than this are not worth hashing, the index
+ * only counts their members until they grow.
+ */
+#define SEXP_LIST_INDEX_MIN 8
+
+struct SEXP_list_ient {
+        uint32_t hash;
+        uint32_t pos;  /* position of the member in the list */
+};
+
+/*
+ * Index of the members of a list value by name, see SEXP_list_index().
+ * Entries are kept in the order of positions and the hash table is
+ * probed linearly, so the members of the same name are found in the
+ * order of the list.
+ */
+struct SEXP_list_index {
+        void     *b_addr;  /* the list the index describes */
+        uint16_t  offset;
+        uint32_t  length;  /* members seen so far, including the head */
+        uint32_t  count;
+        uint32_t  alloc;
+        struct SEXP_list_ient *entries;
+        uint32_t *slots;   /* entry number + 1, 0 is a free slot */
+        uint32_t  mask;    /* slot count - 1, 0 if there is no table */
+};
+
+struct SEXP_list_index *SEXP_rawlist_index_new (struct SEXP_val_list *list);
+void SEXP_rawlist_index_free (struct SEXP_list_index *index);
+
+/*
+ * Hooks of the list functions which modify a list value in place.
+ * They keep the index of the value, if there is one, up to date.
+ */
+void SEXP_rawlist_index_add (struct SEXP_val_list *list, const SEXP_t *s_exp);
+void SEXP_rawlist_index_replace (struct SEXP_val_list *list, uint32_t n, const SEXP_t *o_val, const SEXP_t *n_val);
+void SEXP_rawlist_index_drop (struct SEXP_val_list *list);
+
+OSCAP_HIDDEN_END;
+
+#endif /* _SEXP_INDEX_H */
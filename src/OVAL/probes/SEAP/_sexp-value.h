@@ -84,9 +84,12 @@ SEXP_DEFNUM(u64, uint64_t);
  * List
  */
 
+struct SEXP_list_index;
+
 struct SEXP_val_list {
         void    *b_addr;
         uint16_t offset;
+        struct SEXP_list_index *index; /* see _sexp-index.h */
 } __attribute__ ((packed));
 
 #define SEXP_LCASTP(p) ((struct SEXP_val_list *)(p))
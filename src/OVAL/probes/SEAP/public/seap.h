@@ -62,6 +62,11 @@ int     SEAP_close (SEAP_CTX_t *ctx, int sd);
 
 int SEAP_openfd (SEAP_CTX_t *ctx, int fd, uint32_t flags);
 int SEAP_openfd2 (SEAP_CTX_t *ctx, int ifd, int ofd, uint32_t flags);
+/*
+ * Attach to the module end of an in-process ("mem" scheme) channel.
+ * `chan' is the handle passed to the module entry point.
+ */
+int SEAP_openmem (SEAP_CTX_t *ctx, void *chan, uint32_t flags);
 
 SEAP_msg_t *SEAP_msg_new (void);
 void        SEAP_msg_free (SEAP_msg_t *msg);
@@ -78,6 +83,7 @@ int SEAP_sendsexp (SEAP_CTX_t *ctx, int sd, SEXP_t *sexp);
 int SEAP_sendmsg  (SEAP_CTX_t *ctx, int sd, SEAP_msg_t *seap_msg);
 
 int SEAP_reply (SEAP_CTX_t *ctx, int sd, SEAP_msg_t *rep_msg, SEAP_msg_t *req_msg);
+int SEAP_reply_part (SEAP_CTX_t *ctx, int sd, SEAP_msg_t *rep_msg, SEAP_msg_t *req_msg);
 
 int SEAP_senderr (SEAP_CTX_t *ctx, int sd, SEAP_err_t *err);
 int SEAP_recverr (SEAP_CTX_t *ctx, int sd, SEAP_err_t **err);
@@ -85,6 +91,12 @@ int SEAP_recverr_byid (SEAP_CTX_t *ctx, int sd, SEAP_err_t **err, SEAP_msgid_t i
 
 int SEAP_replyerr (SEAP_CTX_t *ctx, int sd, SEAP_msg_t *rep_msg, uint32_t e);
 
+/*
+ * Get the number of bytes received and sent through the descriptor
+ * `sd' so far. Either of the pointers may be NULL.
+ */
+int SEAP_iostat (SEAP_CTX_t *ctx, int sd, uint64_t *bytes_in, uint64_t *bytes_out);
+
 #ifdef __cplusplus
 }
 #endif
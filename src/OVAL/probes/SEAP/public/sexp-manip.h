@@ -297,7 +297,7 @@ char  *SEXP_string_cstrp (const SEXP_t *s_exp);
  * Get a C substring from a sexp object.
  * @param s_sexp the queried sexp object
  * @param beg the position of the fisrt character of the substring
- * @param len the length of the substring
+ * @param len the length of the substring, 0 means up to the end of the string
  */
 char *SEXP_string_subcstr (const SEXP_t *s_exp, size_t beg, size_t len);
 
@@ -466,6 +466,57 @@ SEXP_list_it *SEXP_list_it_new(const SEXP_t *list);
 SEXP_t *SEXP_list_it_next(SEXP_list_it *it);
 void SEXP_list_it_free(SEXP_list_it *it);
 
+/**
+ * List cursor. Unlike SEXP_list_nth, which walks the list from the
+ * beginning, each step of the cursor takes constant time. The cursor
+ * doesn't hold a reference to the list; the list must not be modified
+ * other than by adding new members while the cursor is used.
+ */
+typedef struct {
+        void    *block;
+        uint16_t index;
+} SEXP_list_cursor_t;
+
+/**
+ * Set the cursor to the n-th member of a list.
+ * @param cursor the cursor
+ * @param list the list
+ * @param n the position of the first member returned by SEXP_list_cursor_next
+ * @return 0 on success, -1 if list is not a list
+ */
+int SEXP_list_cursor_init(SEXP_list_cursor_t *cursor, const SEXP_t *list, uint32_t n);
+
+/**
+ * Get the member at the cursor and move the cursor to the next one.
+ * @param cursor the cursor
+ * @return a new reference to the member or NULL at the end of the list
+ */
+SEXP_t *SEXP_list_cursor_next(SEXP_list_cursor_t *cursor);
+
+/**
+ * Attach an index of members by name to a list. The name of a member is
+ * its first element if it's a string or the first element of its first
+ * element, which is how probe objects, items and entities are named:
+ * ((name :attr val ...) member ...). The head of the list itself is not
+ * indexed. The index belongs to the value of the list, it's kept up to
+ * date by SEXP_list_add and the other list functions and is freed with
+ * the value. Short lists are not hashed until they grow.
+ * @param list the list
+ * @return 0 on success, -1 if list is not a list
+ */
+int SEXP_list_index(SEXP_t *list);
+
+/**
+ * Find the n-th member of the given name using the index of the list.
+ * @param list the list
+ * @param name the name of the member
+ * @param n the number of the member among the members of the same name, starting at 1
+ * @param memb the new reference to the member is stored here
+ * @return 1 if the member was found, 0 if it wasn't and -1 if the list
+ * has no usable index, in which case the caller has to search the list
+ */
+int SEXP_list_index_nth(const SEXP_t *list, const char *name, uint32_t n, SEXP_t **memb);
+
 #if __STDC_VERSION__ >= 199901L
 # include <common/util.h>
 
@@ -0,0 +1,442 @@
+/*
+ * Copyright 2026 Red Hat Inc., Durham, North Carolina.
+ * All Rights Reserved.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+#include <time.h>
+#include <dlfcn.h>
+#include <pthread.h>
+#include <common/assume.h>
+
+#include "generic/common.h"
+#include "public/sm_alloc.h"
+#include "public/sexp-manip.h"
+#include "_sexp-types.h"
+#include "_seap-types.h"
+#include "_seap-scheme.h"
+#include "sch_mem.h"
+#include "seap-descriptor.h"
+#include "../../../common/debug_priv.h"
+
+#ifndef RTLD_NODELETE
+# define RTLD_NODELETE 0
+#endif
+
+struct sch_memmsg {
+        SEXP_t            *sexp;
+        struct sch_memmsg *next;
+};
+
+/*
+ * Both ends of the connection share one channel. Messages queued
+ * in head[n] are waiting to be received by the end n.
+ */
+struct sch_memchan {
+        pthread_mutex_t    lock;
+        pthread_cond_t     cond;
+        struct sch_memmsg *head[2];
+        struct sch_memmsg *tail[2];
+        bool               open[2];
+        bool               attached;
+        unsigned int       refs;
+        int                error;  /* return value of the entry point */
+        sch_mem_entry_t    entry;
+};
+
+static sch_memchan_t *sch_memchan_new (sch_mem_entry_t entry)
+{
+        sch_memchan_t *chan;
+
+        chan = sm_talloc (sch_memchan_t);
+        memset (chan, 0, sizeof (sch_memchan_t));
+
+        pthread_mutex_init (&chan->lock, NULL);
+        pthread_cond_init (&chan->cond, NULL);
+
+        chan->open[0] = true;
+        chan->open[1] = true;
+        chan->refs    = 1;
+        chan->entry   = entry;
+
+        return (chan);
+}
+
+static void sch_memchan_shut (sch_memchan_t *chan, int side)
+{
+        pthread_mutex_lock (&chan->lock);
+        chan->open[side] = false;
+        pthread_cond_broadcast (&chan->cond);
+        pthread_mutex_unlock (&chan->lock);
+}
+
+static void sch_memchan_unref (sch_memchan_t *chan)
+{
+        struct sch_memmsg *msg;
+        unsigned int refs;
+        int side;
+
+        pthread_mutex_lock (&chan->lock);
+        refs = --chan->refs;
+        pthread_mutex_unlock (&chan->lock);
+
+        if (refs > 0)
+                return;
+
+        for (side = 0; side < 2; ++side) {
+                while ((msg = chan->head[side]) != NULL) {
+                        chan->head[side] = msg->next;
+                        SEXP_free (msg->sexp);
+                        sm_free (msg);
+                }
+        }
+
+        pthread_cond_destroy (&chan->cond);
+        pthread_mutex_destroy (&chan->lock);
+        sm_free (chan);
+}
+
+static void *sch_mem_thread (void *arg)
+{
+        sch_memchan_t *chan = (sch_memchan_t *)arg;
+        int ret;
+
+        if ((ret = chan->entry (chan)) != 0) {
+                dI("In-process entry point returned an error: %d, %s\n", ret, strerror (ret));
+
+                pthread_mutex_lock (&chan->lock);
+                chan->error = ret;
+                pthread_mutex_unlock (&chan->lock);
+        }
+        /*
+         * Make sure the connecting end sees EOF, or the error of the
+         * entry point, even if the entry point didn't attach to the
+         * channel or didn't close it.
+         */
+        sch_memchan_shut (chan, 1);
+        sch_memchan_unref (chan);
+
+        return (NULL);
+}
+
+int sch_mem_connect (SEAP_desc_t *desc, const char *uri, uint32_t flags)
+{
+        sch_memdata_t  *data;
+        sch_memchan_t  *chan;
+        sch_mem_entry_t entry;
+        void           *module;
+
+        assume_r (desc != NULL, -1, errno = EFAULT;);
+        assume_r (uri  != NULL, -1, errno = EFAULT;);
+        assume_r (desc->scheme_data == NULL, -1, errno = EALREADY;);
+
+        if (uri[0] != '/' || uri[1] != '/') {
+                errno = EINVAL;
+                return (-1);
+        }
+
+        uri += 2;
+
+        /*
+         * Modules are never unloaded. Probe code isn't written to be
+         * unloaded and a reconnect after a reset would load it again.
+         */
+        module = dlopen (*uri != '\0' ? uri : NULL, RTLD_NOW | RTLD_LOCAL | RTLD_NODELETE);
+
+        if (module == NULL) {
+                dI("dlopen(%s) failed: %s\n", uri, dlerror ());
+                errno = ENOENT;
+                return (-1);
+        }
+
+        entry = (sch_mem_entry_t) dlsym (module, SCH_MEM_ENTRY);
+
+        if (entry == NULL) {
+                dI("%s: symbol %s not found\n", uri, SCH_MEM_ENTRY);
+                dlclose (module);
+                errno = ENOEXEC;
+                return (-1);
+        }
+
+        chan = sch_memchan_new (entry);
+        data = sm_talloc (sch_memdata_t);
+
+        data->chan     = chan;
+        data->side     = 0;
+        data->module   = module;
+        data->joinable = false;
+
+        ++chan->refs; /* reference held by the thread */
+
+        if ((errno = pthread_create (&data->thread, NULL, &sch_mem_thread, chan)) != 0) {
+                protect_errno {
+                        chan->refs = 1;
+                        sch_memchan_unref (chan);
+                        dlclose (module);
+                        sm_free (data);
+                }
+                return (-1);
+        }
+
+        data->joinable    = true;
+        desc->scheme_data = (void *)data;
+
+        return (0);
+}
+
+int sch_mem_attach (SEAP_desc_t *desc, void *chanp, uint32_t flags)
+{
+        sch_memdata_t *data;
+        sch_memchan_t *chan = (sch_memchan_t *)chanp;
+
+        assume_r (desc != NULL, -1, errno = EFAULT;);
+        assume_r (chan != NULL, -1, errno = EFAULT;);
+        assume_r (desc->scheme_data == NULL, -1, errno = EALREADY;);
+
+        pthread_mutex_lock (&chan->lock);
+
+        if (chan->attached || !chan->open[1]) {
+                pthread_mutex_unlock (&chan->lock);
+                errno = EALREADY;
+                return (-1);
+        }
+
+        chan->attached = true;
+        ++chan->refs;
+
+        pthread_mutex_unlock (&chan->lock);
+
+        data = sm_talloc (sch_memdata_t);
+        data->chan     = chan;
+        data->side     = 1;
+        data->module   = NULL;
+        data->joinable = false;
+
+        desc->scheme_data = (void *)data;
+
+        return (0);
+}
+
+int sch_mem_openfd (SEAP_desc_t *desc, int fd, uint32_t flags)
+{
+        errno = EOPNOTSUPP;
+        return (-1);
+}
+
+int sch_mem_openfd2 (SEAP_desc_t *desc, int ifd, int ofd, uint32_t flags)
+{
+        errno = EOPNOTSUPP;
+        return (-1);
+}
+
+ssize_t sch_mem_recv (SEAP_desc_t *desc, void *buf, size_t len, uint32_t flags)
+{
+        errno = EOPNOTSUPP;
+        return (-1);
+}
+
+ssize_t sch_mem_send (SEAP_desc_t *desc, void *buf, size_t len, uint32_t flags)
+{
+        errno = EOPNOTSUPP;
+        return (-1);
+}
+
+ssize_t sch_mem_sendsexp (SEAP_desc_t *desc, SEXP_t *sexp, uint32_t flags)
+{
+        sch_memdata_t     *data;
+        sch_memchan_t     *chan;
+        struct sch_memmsg *msg;
+        int peer;
+
+        assume_d (desc != NULL, -1, errno = EFAULT;);
+        assume_d (sexp != NULL, -1, errno = EFAULT;);
+
+        data = (sch_memdata_t *)desc->scheme_data;
+
+        assume_r (data != NULL, -1, errno = EBADF;);
+
+        chan = data->chan;
+        peer = !data->side;
+
+        msg = sm_talloc (struct sch_memmsg);
+        msg->sexp = SEXP_ref (sexp);
+        msg->next = NULL;
+
+        pthread_mutex_lock (&chan->lock);
+
+        if (!chan->open[peer] || !chan->open[data->side]) {
+                pthread_mutex_unlock (&chan->lock);
+
+                SEXP_free (msg->sexp);
+                sm_free (msg);
+
+                errno = EPIPE;
+                return (-1);
+        }
+
+        if (chan->tail[peer] != NULL)
+                chan->tail[peer]->next = msg;
+        else
+                chan->head[peer] = msg;
+
+        chan->tail[peer] = msg;
+
+        pthread_cond_broadcast (&chan->cond);
+        pthread_mutex_unlock (&chan->lock);
+
+        return (0);
+}
+
+ssize_t sch_mem_recvsexp (SEAP_desc_t *desc, SEXP_t **sexp, uint32_t flags)
+{
+        sch_memdata_t     *data;
+        sch_memchan_t     *chan;
+        struct sch_memmsg *msg;
+        int side;
+
+        assume_d (desc != NULL, -1, errno = EFAULT;);
+        assume_d (sexp != NULL, -1, errno = EFAULT;);
+
+        data = (sch_memdata_t *)desc->scheme_data;
+
+        assume_r (data != NULL, -1, errno = EBADF;);
+
+        chan = data->chan;
+        side = data->side;
+
+        pthread_mutex_lock (&chan->lock);
+
+        while (chan->head[side] == NULL && chan->open[!side] && chan->open[side])
+                pthread_cond_wait (&chan->cond, &chan->lock);
+
+        if ((msg = chan->head[side]) != NULL) {
+                chan->head[side] = msg->next;
+
+                if (chan->head[side] == NULL)
+                        chan->tail[side] = NULL;
+        } else if (side == 0 && chan->error != 0) {
+                /* the module failed, report why instead of a plain EOF */
+                errno = chan->error;
+                pthread_mutex_unlock (&chan->lock);
+                return (-1);
+        }
+
+        pthread_mutex_unlock (&chan->lock);
+
+        if (msg == NULL)
+                return (0); /* EOF */
+
+        *sexp = msg->sexp;
+        sm_free (msg);
+
+        return (1);
+}
+
+int sch_mem_close (SEAP_desc_t *desc, uint32_t flags)
+{
+        sch_memdata_t *data;
+
+        assume_d (desc != NULL, -1, errno = EFAULT;);
+
+        data = (sch_memdata_t *)desc->scheme_data;
+
+        assume_r (data != NULL, -1, errno = EBADF;);
+
+        sch_memchan_shut (data->chan, data->side);
+
+        if (data->joinable) {
+                /*
+                 * The module end receives EOF and is expected to shut
+                 * down and return from the entry point.
+                 */
+                if ((errno = pthread_join (data->thread, NULL)) != 0)
+                        dI("pthread_join: %d, %s\n", errno, strerror (errno));
+        }
+
+        if (data->module != NULL)
+                dlclose (data->module);
+
+        sch_memchan_unref (data->chan);
+        sm_free (data);
+
+        desc->scheme_data = NULL;
+
+        return (0);
+}
+
+int sch_mem_select (SEAP_desc_t *desc, int ev, uint16_t timeout, uint32_t flags)
+{
+        sch_memdata_t  *data;
+        sch_memchan_t  *chan;
+        struct timespec deadline;
+        int side, ret;
+
+        assume_d (desc != NULL, -1, errno = EFAULT;);
+
+        data = (sch_memdata_t *)desc->scheme_data;
+
+        assume_r (data != NULL, -1, errno = EBADF;);
+
+        switch (ev) {
+        case SEAP_IO_EVREAD:
+                break;
+        case SEAP_IO_EVWRITE:
+                /* the queues are unbounded, writing never blocks */
+                return (0);
+        default:
+                errno = EINVAL;
+                return (-1);
+        }
+
+        chan = data->chan;
+        side = data->side;
+
+        if (timeout > 0) {
+                if (clock_gettime (CLOCK_REALTIME, &deadline) != 0)
+                        return (-1);
+
+                deadline.tv_sec += (time_t)timeout;
+        }
+
+        pthread_mutex_lock (&chan->lock);
+
+        /* EOF is reported as a read event, the same way select(2) does */
+        while (chan->head[side] == NULL && chan->open[!side] && chan->open[side]) {
+                if (timeout > 0) {
+                        ret = pthread_cond_timedwait (&chan->cond, &chan->lock, &deadline);
+
+                        if (ret == ETIMEDOUT) {
+                                pthread_mutex_unlock (&chan->lock);
+                                errno = ETIMEDOUT;
+                                return (-1);
+                        }
+                } else
+                        pthread_cond_wait (&chan->cond, &chan->lock);
+        }
+
+        pthread_mutex_unlock (&chan->lock);
+
+        return (0);
+}
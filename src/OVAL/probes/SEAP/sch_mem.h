@@ -0,0 +1,75 @@
+/*
+ * Copyright 2026 Red Hat Inc., Durham, North Carolina.
+ * All Rights Reserved.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#pragma once
+#ifndef SCH_MEM_H
+#define SCH_MEM_H
+
+#include <stdbool.h>
+#include <pthread.h>
+#include <sys/types.h>
+#include "../../../common/util.h"
+
+OSCAP_HIDDEN_START;
+
+/*
+ * The "mem" scheme connects two SEAP descriptors living in the same
+ * process. S-expressions are passed between the two ends by reference,
+ * nothing is serialized or parsed.
+ *
+ * URI format: mem://<path>
+ *
+ * <path> is a shared object exporting the SCH_MEM_ENTRY function. An
+ * empty path means that the entry point is linked into the program
+ * itself. The entry point is started in a new thread and receives the
+ * channel handle which it has to attach to its own SEAP context using
+ * SEAP_openmem(). The connection is closed when either end is closed;
+ * the connecting end waits for the entry point to return. A non-zero
+ * return value of the entry point is an errno value, the connecting
+ * end receives it instead of EOF.
+ */
+#define SCH_MEM_ENTRY "probe_module_main"
+
+typedef int (*sch_mem_entry_t)(void *chan);
+
+typedef struct sch_memchan sch_memchan_t;
+
+typedef struct {
+        sch_memchan_t *chan;
+        int            side;   /* 0 - connecting end, 1 - module end */
+        void          *module; /* dlopen() handle */
+        pthread_t      thread;
+        bool           joinable;
+} sch_memdata_t;
+
+int sch_mem_connect (SEAP_desc_t *desc, const char *uri, uint32_t flags);
+int sch_mem_openfd (SEAP_desc_t *desc, int fd, uint32_t flags);
+int sch_mem_openfd2 (SEAP_desc_t *desc, int ifd, int ofd, uint32_t flags);
+ssize_t sch_mem_recv (SEAP_desc_t *desc, void *buf, size_t len, uint32_t flags);
+ssize_t sch_mem_send (SEAP_desc_t *desc, void *buf, size_t len, uint32_t flags);
+ssize_t sch_mem_sendsexp (SEAP_desc_t *desc, SEXP_t *sexp, uint32_t flags);
+ssize_t sch_mem_recvsexp (SEAP_desc_t *desc, SEXP_t **sexp, uint32_t flags);
+int sch_mem_close (SEAP_desc_t *desc, uint32_t flags);
+int sch_mem_select (SEAP_desc_t *desc, int ev, uint16_t timeout, uint32_t flags);
+
+int sch_mem_attach (SEAP_desc_t *desc, void *chan, uint32_t flags);
+
+OSCAP_HIDDEN_END;
+
+#endif /* SCH_MEM_H */
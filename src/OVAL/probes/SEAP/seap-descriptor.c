@@ -76,6 +76,8 @@ int SEAP_desc_add (SEAP_desctable_t *sd_table, SEXP_pstate_t *pstate,
 		sd_dsc->msg_queue = NULL;
 		sd_dsc->err_queue = rbt_i32_new();
 		sd_dsc->cmd_queue = NULL;
+		sd_dsc->bytes_in  = 0;
+		sd_dsc->bytes_out = 0;
 
 		SEAP_packetq_init(&sd_dsc->pck_queue);
 
@@ -64,6 +64,9 @@ typedef struct {
         SEAP_cmdid_t   next_cid;
         SEAP_cmdtbl_t *cmd_c_table; /* Local SEAP commands */
         SEAP_cmdtbl_t *cmd_w_table; /* Waiting SEAP commands */
+
+        uint64_t bytes_in;  /* Number of bytes received */
+        uint64_t bytes_out; /* Number of bytes sent */
 } SEAP_desc_t;
 
 #define SEAP_DESC_FDIN  0x00000001
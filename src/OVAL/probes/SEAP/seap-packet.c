@@ -39,6 +39,7 @@
 #include "public/seap-command.h"
 #include "public/seap-error.h"
 #include "public/sm_alloc.h"
+#include "../../../common/trace_priv.h"
 
 SEAP_packet_t *SEAP_packet_new (void)
 {
@@ -171,15 +172,19 @@ static int SEAP_packet_sexp2msg (SEXP_t *sexp_msg, SEAP_msg_t *seap_msg)
 
                                 SEXP_free (attr_val);
                         } else {
-                                seap_msg->attrs[attr_i].name  = SEXP_string_subcstr (attr_name, 1, 0);
+                                /* the name without the leading colon */
+                                seap_msg->attrs[attr_i].name  = SEXP_string_subcstr (attr_name, 1, SEXP_string_length (attr_name) - 1);
                                 seap_msg->attrs[attr_i].value = SEXP_list_nth (sexp_msg, msg_n + 1);
 
-                                if (seap_msg->attrs[attr_i].value == NULL) {
-                                        dI("Unexpected error: \"%s\": No attribute value at position %u in the message (%p).\n",
-                                           seap_msg->attrs[attr_i].name, msg_n + 1, sexp_msg);
+                                if (seap_msg->attrs[attr_i].name == NULL || seap_msg->attrs[attr_i].value == NULL) {
+                                        dI("Unexpected error: No attribute name or value at position %u in the message (%p).\n",
+                                           msg_n, sexp_msg);
 
                                         sm_free (seap_msg->attrs[attr_i].name);
 
+                                        if (seap_msg->attrs[attr_i].value != NULL)
+                                                SEXP_free (seap_msg->attrs[attr_i].value);
+
                                         for (; attr_i > 0; --attr_i) {
                                                 sm_free (seap_msg->attrs[attr_i - 1].name);
 
@@ -597,6 +602,7 @@ int SEAP_packet_recv (SEAP_CTX_t *ctx, int sd, SEAP_packet_t **packet)
         void        *data_buffer;
         size_t       data_buflen;
         ssize_t      data_length;
+        size_t       data_total;
 
         SEXP_psetup_t *psetup;
         SEXP_pstate_t *pstate;
@@ -664,6 +670,36 @@ eloop_start:
         }
 eloop_exit:
 
+        /*
+         * Schemes which pass S-expressions by reference deliver
+         * whole packets, so there's nothing to parse.
+         */
+        if (__schtbl[dsc->scheme].sch_recvsexp != NULL) {
+                SEXP_t *sexp_recv = NULL;
+
+                switch (SCH_RECVSEXP(dsc->scheme, dsc, &sexp_recv, 0)) {
+                case 1:
+                        DESC_RUNLOCK(dsc);
+                        break;
+                case 0:
+                        dI("EOF\n");
+                        DESC_RUNLOCK(dsc);
+                        errno = ECONNABORTED;
+                        return (-1);
+                default:
+                        protect_errno {
+                                dI("FAIL: recv failed: dsc=%p, errno=%u, %s.\n", dsc, errno, strerror (errno));
+                                DESC_RUNLOCK(dsc);
+                        }
+                        return (-1);
+                }
+
+                sexp_buffer = SEXP_list_new (sexp_recv, NULL);
+                SEXP_free (sexp_recv);
+
+                goto packet_decode;
+        }
+
         /*
          * Receive loop
          * The read mutex is locked during execution of this loop and
@@ -673,6 +709,7 @@ eloop_exit:
 
         pstate = NULL;
         psetup = SEXP_psetup_new ();
+        data_total = 0;
 
         /*
          * All buffer passed to SEXP_parse will be freed by
@@ -712,6 +749,7 @@ eloop_exit:
                 }
 
                 _A(data_length > 0);
+                data_total += (size_t)data_length;
 
                 if (data_buflen != (size_t)(data_length)) {
                         data_buffer = sm_realloc (data_buffer, data_length);
@@ -726,6 +764,8 @@ eloop_exit:
                         DESC_RUNLOCK(dsc);
 
                         if (SEXP_list_length (sexp_buffer) > 0) {
+                                __sync_fetch_and_add(&dsc->bytes_in, (uint64_t)data_total);
+                                oscap_trace_instant("seap_recv", NULL, 1, data_total);
                                 break;
                         } else {
                                 SEXP_list_free (sexp_buffer);
@@ -771,6 +811,7 @@ eloop_exit:
         }
 
         SEXP_psetup_free (psetup);
+packet_decode:
 	SEXP_VALIDATE(sexp_buffer);
 	(*packet) = NULL;
 
@@ -973,14 +1014,20 @@ int SEAP_packet_send (SEAP_CTX_t *ctx, int sd, SEAP_packet_t *packet)
         }
 
         if (DESC_WLOCK (dsc)) {
-                ret = 0;
+                ssize_t sent;
 
-                if (SCH_SENDSEXP(dsc->scheme, dsc, packet_sexp, 0) < 0) {
+                ret  = 0;
+                sent = SCH_SENDSEXP(dsc->scheme, dsc, packet_sexp, 0);
+
+                if (sent < 0) {
                         ret = -1;
 
                         protect_errno {
                                 dI("FAIL: errno=%u, %s.\n", errno, strerror (errno));
                         }
+                } else {
+                        __sync_fetch_and_add(&dsc->bytes_out, (uint64_t)sent);
+                        oscap_trace_instant("seap_send", NULL, 1, (uint64_t)sent);
                 }
 
                 DESC_WUNLOCK(dsc);
@@ -176,6 +176,36 @@ int SEAP_openfd2 (SEAP_CTX_t *ctx, int ifd, int ofd, uint32_t flags)
         return (sd);
 }
 
+int SEAP_openmem (SEAP_CTX_t *ctx, void *chan, uint32_t flags)
+{
+        SEAP_desc_t *dsc;
+        int sd;
+
+        sd = SEAP_desc_add (ctx->sd_table, NULL, SCH_MEM, NULL);
+
+        if (sd < 0) {
+                dI("Can't create/add new SEAP descriptor\n");
+                return (-1);
+        }
+
+        dsc = SEAP_desc_get (ctx->sd_table, sd);
+
+        if (dsc == NULL) {
+                errno = ESRCH;
+                return(-1);
+        }
+
+        if (sch_mem_attach (dsc, chan, flags) != 0) {
+                dI("FAIL: errno=%u, %s.\n", errno, strerror (errno));
+                protect_errno {
+                        SEAP_desc_del (ctx->sd_table, sd);
+                }
+                return (-1);
+        }
+
+        return (sd);
+}
+
 int SEAP_recvsexp (SEAP_CTX_t *ctx, int sd, SEXP_t **sexp)
 {
         SEAP_msg_t *msg = NULL;
@@ -483,6 +513,40 @@ int SEAP_reply (SEAP_CTX_t *ctx, int sd, SEAP_msg_t *rep_msg, SEAP_msg_t *req_ms
         }
 }
 
+/*
+ * Send a part of the reply to `req_msg'. Any number of parts may be sent
+ * before the reply itself; the receiver recognizes them by the `part-of'
+ * attribute which holds the ID of the request.
+ */
+int SEAP_reply_part (SEAP_CTX_t *ctx, int sd, SEAP_msg_t *rep_msg, SEAP_msg_t *req_msg)
+{
+        SEXP_t *r0;
+        int     ret;
+
+        _A(ctx     != NULL);
+        _A(rep_msg != NULL);
+        _A(req_msg != NULL);
+
+        if (SEAP_msgattr_exists (req_msg, "no-reply")) {
+                errno = EINVAL;
+                return (-1);
+        }
+
+        ret = SEAP_msgattr_set (rep_msg, "part-of",
+#if SEAP_MSGID_BITS == 64
+                                r0 = SEXP_number_newu_64 (req_msg->id)
+#else
+                                r0 = SEXP_number_newu_32 (req_msg->id)
+#endif
+                );
+        SEXP_free (r0);
+
+        if (ret != 0)
+                return (-1);
+
+        return SEAP_sendmsg (ctx, sd, rep_msg);
+}
+
 static int __SEAP_senderr (SEAP_CTX_t *ctx, int sd, SEAP_err_t *err, unsigned int type)
 {
         SEAP_packet_t *packet;
@@ -584,6 +648,27 @@ int SEAP_write (SEAP_CTX_t *ctx, int sd, SEXP_t *sexp)
         return (-1);
 }
 
+int SEAP_iostat (SEAP_CTX_t *ctx, int sd, uint64_t *bytes_in, uint64_t *bytes_out)
+{
+        SEAP_desc_t *dsc;
+
+        _A(ctx != NULL);
+
+        dsc = SEAP_desc_get (ctx->sd_table, sd);
+
+        if (dsc == NULL) {
+                errno = EBADF;
+                return (-1);
+        }
+
+        if (bytes_in != NULL)
+                *bytes_in  = __sync_fetch_and_add(&dsc->bytes_in, 0);
+        if (bytes_out != NULL)
+                *bytes_out = __sync_fetch_and_add(&dsc->bytes_out, 0);
+
+        return (0);
+}
+
 int SEAP_close (SEAP_CTX_t *ctx, int sd)
 {
         SEAP_desc_t *dsc;
@@ -0,0 +1,328 @@
+/**
+ * @file   sexp-index.c
+ * @brief  Index of list members by name - implementation
+ *
+ * @addtogroup SEXPRESSIONS
+ * @{
+ */
+
+/*
+ * Copyright 2026 Red Hat Inc., Durham, North Carolina.
+ * All Rights Reserved.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <errno.h>
+
+#include "public/sm_alloc.h"
+#include "_sexp-types.h"
+#include "_sexp-value.h"
+#include "_sexp-index.h"
+#include "public/sexp-manip.h"
+#include "MurmurHash3.h"
+
+/*
+ * The name of a member is the name of an entity: the first element of
+ * the member if it's a string, or the first element of the first element,
+ * as in ((name :attr val) ...).
+ */
+static bool SEXP_rawval_memb_name (const SEXP_t *memb, const char **name, size_t *len)
+{
+        SEXP_val_t v_dsc;
+        int depth;
+
+        for (depth = 0; memb != NULL && memb->s_valp != 0; ++depth) {
+                SEXP_val_dsc (&v_dsc, memb->s_valp);
+
+                switch (v_dsc.type) {
+                case SEXP_VALTYPE_STRING:
+                        if (depth == 0)
+                                return (false);
+
+                        *name = (const char *)v_dsc.mem;
+                        *len  = v_dsc.hdr->size;
+
+                        return (true);
+                case SEXP_VALTYPE_LIST:
+                        if (depth == 2)
+                                return (false);
+
+                        memb = SEXP_rawval_lblk_nth ((uintptr_t)SEXP_LCASTP(v_dsc.mem)->b_addr,
+                                                     SEXP_LCASTP(v_dsc.mem)->offset + 1);
+                        break;
+                default:
+                        return (false);
+                }
+        }
+
+        return (false);
+}
+
+static uint32_t SEXP_list_index_hash (const char *name, size_t len)
+{
+        uint32_t hash;
+
+        MurmurHash3_x86_32 (name, (int)len, 0, &hash);
+
+        return (hash);
+}
+
+static void SEXP_list_index_place (struct SEXP_list_index *index, uint32_t e)
+{
+        uint32_t s;
+
+        for (s = index->entries[e].hash & index->mask; index->slots[s] != 0; s = (s + 1) & index->mask);
+
+        index->slots[s] = e + 1;
+}
+
+static void SEXP_list_index_insert (struct SEXP_list_index *index, const SEXP_t *memb, uint32_t pos)
+{
+        const char *name;
+        size_t len;
+        uint32_t e;
+
+        if (!SEXP_rawval_memb_name (memb, &name, &len))
+                return;
+
+        if (index->count == index->alloc) {
+                index->alloc   = index->alloc > 0 ? index->alloc * 2 : SEXP_LIST_INDEX_MIN;
+                index->entries = sm_realloc (index->entries, sizeof (struct SEXP_list_ient) * index->alloc);
+        }
+
+        if (2 * (index->count + 1) > index->mask + 1) {
+                /* keep the table at most half full, entries are placed again in the list order */
+                index->mask  = 2 * (index->mask + 1) - 1;
+                index->slots = sm_reallocf (index->slots, sizeof (uint32_t) * (index->mask + 1));
+                memset (index->slots, 0, sizeof (uint32_t) * (index->mask + 1));
+
+                for (e = 0; e < index->count; ++e)
+                        SEXP_list_index_place (index, e);
+        }
+
+        e = index->count++;
+        index->entries[e].hash = SEXP_list_index_hash (name, len);
+        index->entries[e].pos  = pos;
+
+        SEXP_list_index_place (index, e);
+}
+
+/*
+ * (Re)build the table from the members of the list.
+ */
+static void SEXP_list_index_build (struct SEXP_list_index *index, struct SEXP_val_list *list)
+{
+        struct SEXP_val_lblk *lblk;
+        uint32_t pos, slots;
+        uint16_t i;
+
+        for (slots = 2 * SEXP_LIST_INDEX_MIN; slots < 2 * index->length; slots *= 2);
+
+        index->count = 0;
+        index->mask  = slots - 1;
+        index->slots = sm_reallocf (index->slots, sizeof (uint32_t) * slots);
+        memset (index->slots, 0, sizeof (uint32_t) * slots);
+
+        lblk = SEXP_VALP_LBLK(list->b_addr);
+        i    = list->offset;
+        pos  = 0;
+
+        while (lblk != NULL) {
+                for (; i < lblk->real; ++i) {
+                        /* the head of the list is not indexed */
+                        if (++pos > 1)
+                                SEXP_list_index_insert (index, lblk->memb + i, pos);
+                }
+
+                lblk = SEXP_VALP_LBLK(lblk->nxsz);
+                i    = 0;
+        }
+
+        index->length = pos;
+        index->b_addr = list->b_addr;
+        index->offset = list->offset;
+}
+
+struct SEXP_list_index *SEXP_rawlist_index_new (struct SEXP_val_list *list)
+{
+        struct SEXP_list_index *index;
+
+        index = sm_talloc (struct SEXP_list_index);
+        index->b_addr  = list->b_addr;
+        index->offset  = list->offset;
+        index->length  = SEXP_rawval_list_length (list);
+        index->count   = 0;
+        index->alloc   = 0;
+        index->entries = NULL;
+        index->slots   = NULL;
+        index->mask    = 0;
+
+        if (index->length >= SEXP_LIST_INDEX_MIN)
+                SEXP_list_index_build (index, list);
+
+        return (index);
+}
+
+void SEXP_rawlist_index_free (struct SEXP_list_index *index)
+{
+        if (index == NULL)
+                return;
+
+        sm_free (index->entries);
+        sm_free (index->slots);
+        sm_free (index);
+}
+
+void SEXP_rawlist_index_add (struct SEXP_val_list *list, const SEXP_t *s_exp)
+{
+        struct SEXP_list_index *index = list->index;
+
+        if (index == NULL)
+                return;
+
+        /* the head block might have been copied if it was shared */
+        index->b_addr = list->b_addr;
+        index->offset = list->offset;
+
+        ++index->length;
+
+        if (index->mask == 0) {
+                if (index->length >= SEXP_LIST_INDEX_MIN)
+                        SEXP_list_index_build (index, list);
+        } else if (index->length > 1)
+                SEXP_list_index_insert (index, s_exp, index->length);
+}
+
+void SEXP_rawlist_index_replace (struct SEXP_val_list *list, uint32_t n, const SEXP_t *o_val, const SEXP_t *n_val)
+{
+        struct SEXP_list_index *index = list->index;
+        const char *o_name, *n_name;
+        size_t o_len, n_len;
+        bool o_named, n_named;
+
+        if (index == NULL)
+                return;
+
+        index->b_addr = list->b_addr;
+        index->offset = list->offset;
+
+        if (n == 1 || index->mask == 0)
+                return;
+
+        o_named = SEXP_rawval_memb_name (o_val, &o_name, &o_len);
+        n_named = SEXP_rawval_memb_name (n_val, &n_name, &n_len);
+
+        /* the index stays valid if the member keeps its name */
+        if (o_named == n_named &&
+            (!o_named || (o_len == n_len && memcmp (o_name, n_name, o_len) == 0)))
+                return;
+
+        SEXP_rawlist_index_drop (list);
+}
+
+void SEXP_rawlist_index_drop (struct SEXP_val_list *list)
+{
+        SEXP_rawlist_index_free (list->index);
+        list->index = NULL;
+}
+
+int SEXP_list_index (SEXP_t *list)
+{
+        SEXP_val_t v_dsc;
+
+        if (list == NULL) {
+                errno = EFAULT;
+                return (-1);
+        }
+
+        SEXP_VALIDATE(list);
+        SEXP_val_dsc (&v_dsc, list->s_valp);
+
+        if (v_dsc.type != SEXP_VALTYPE_LIST) {
+                errno = EINVAL;
+                return (-1);
+        }
+
+        if (SEXP_LCASTP(v_dsc.mem)->index == NULL)
+                SEXP_LCASTP(v_dsc.mem)->index = SEXP_rawlist_index_new (SEXP_LCASTP(v_dsc.mem));
+
+        return (0);
+}
+
+int SEXP_list_index_nth (const SEXP_t *list, const char *name, uint32_t n, SEXP_t **memb)
+{
+        SEXP_val_t v_dsc;
+        struct SEXP_val_list   *l_val;
+        struct SEXP_list_index *index;
+        struct SEXP_list_ient  *e;
+        const char *m_name;
+        size_t len, m_len;
+        uint32_t hash, s;
+        SEXP_t *m;
+
+        if (list == NULL || name == NULL || memb == NULL) {
+                errno = EFAULT;
+                return (-1);
+        }
+
+        SEXP_VALIDATE(list);
+        SEXP_val_dsc (&v_dsc, list->s_valp);
+
+        if (v_dsc.type != SEXP_VALTYPE_LIST || n < 1) {
+                errno = EINVAL;
+                return (-1);
+        }
+
+        l_val = SEXP_LCASTP(v_dsc.mem);
+        index = l_val->index;
+
+        if (index == NULL || index->mask == 0 ||
+            index->b_addr != l_val->b_addr || index->offset != l_val->offset)
+                return (-1);
+
+        len  = strlen (name);
+        hash = SEXP_list_index_hash (name, len);
+
+        for (s = hash & index->mask; index->slots[s] != 0; s = (s + 1) & index->mask) {
+                e = index->entries + index->slots[s] - 1;
+
+                if (e->hash != hash)
+                        continue;
+
+                m = SEXP_rawval_lblk_nth ((uintptr_t)l_val->b_addr, l_val->offset + e->pos);
+
+                if (!SEXP_rawval_memb_name (m, &m_name, &m_len) ||
+                    m_len != len || memcmp (m_name, name, len) != 0)
+                        continue;
+
+                if (--n == 0) {
+                        *memb = SEXP_ref (m);
+                        return (1);
+                }
+        }
+
+        *memb = NULL;
+        return (0);
+}
+
+/// @}
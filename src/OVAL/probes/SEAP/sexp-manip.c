@@ -46,6 +46,7 @@
 #include "_sexp-value.h"
 #include "_sexp-manip.h"
 #include "_sexp-rawptr.h"
+#include "_sexp-index.h"
 #include "public/sexp-manip.h"
 #include "public/sexp-manip_r.h"
 
@@ -842,11 +843,10 @@ char *SEXP_string_subcstr (const SEXP_t *s_exp, size_t beg, size_t len)
 
         s_len -= beg;
 
-        if (s_len > len)
+        if (len > 0 && s_len > len)
                 s_len = len;
 
         if (s_len > 0) {
-                s_len = v_dsc.hdr->size / sizeof (char);
                 s_str = sm_alloc (sizeof (char) * (s_len + 1));
 
                 memcpy (s_str, ((char *) v_dsc.mem) + beg, sizeof (char) * s_len);
@@ -1094,6 +1094,7 @@ SEXP_t *SEXP_list_replace (SEXP_t *list, uint32_t n, const SEXP_t *n_val)
 
         if (v_dsc.hdr->refs > 1) {
 		uintptr_t uptr = SEXP_rawval_list_copy (list->s_valp);
+		bool indexed = SEXP_LCASTP(v_dsc.mem)->index != NULL;
 
 		if (SEXP_rawval_decref (list->s_valp)) {
 			/* TODO: handle this */
@@ -1102,6 +1103,9 @@ SEXP_t *SEXP_list_replace (SEXP_t *list, uint32_t n, const SEXP_t *n_val)
 
 		list->s_valp = uptr;
 		SEXP_val_dsc (&v_dsc, list->s_valp);
+
+		if (indexed)
+			SEXP_LCASTP(v_dsc.mem)->index = SEXP_rawlist_index_new (SEXP_LCASTP(v_dsc.mem));
         }
 
         _A(n > 0);
@@ -1110,6 +1114,9 @@ SEXP_t *SEXP_list_replace (SEXP_t *list, uint32_t n, const SEXP_t *n_val)
                                                                             SEXP_LCASTP(v_dsc.mem)->offset + n,
                                                                             n_val, &o_val);
 
+        if (o_val != NULL)
+                SEXP_rawlist_index_replace (SEXP_LCASTP(v_dsc.mem), n, o_val, n_val);
+
         return (o_val);
 }
 
@@ -1205,6 +1212,7 @@ SEXP_t *SEXP_list_add (SEXP_t *list, const SEXP_t *s_exp)
                  * original value.
                  */
                 uintptr_t uptr = SEXP_rawval_list_copy (list->s_valp);
+                bool indexed = SEXP_LCASTP(v_dsc.mem)->index != NULL;
 
                 if (SEXP_rawval_decref (list->s_valp)) {
                         /* TODO: handle this */
@@ -1216,6 +1224,10 @@ SEXP_t *SEXP_list_add (SEXP_t *list, const SEXP_t *s_exp)
 
                 uptr = SEXP_rawval_lblk_last ((uintptr_t)SEXP_LCASTP(v_dsc.mem)->b_addr);
                 SEXP_rawval_lblk_add1 (uptr, s_exp);
+
+                /* the original value keeps its index, the copy gets its own */
+                if (indexed)
+                        SEXP_LCASTP(v_dsc.mem)->index = SEXP_rawlist_index_new (SEXP_LCASTP(v_dsc.mem));
         } else {
                 /*
                  * Only one reference exists to the value.
@@ -1225,6 +1237,7 @@ SEXP_t *SEXP_list_add (SEXP_t *list, const SEXP_t *s_exp)
                  * function SEXP_rawval_list_add.
                  */
                 SEXP_LCASTP(v_dsc.mem)->b_addr = (void *)SEXP_rawval_lblk_add ((uintptr_t)SEXP_LCASTP(v_dsc.mem)->b_addr, s_exp);
+                SEXP_rawlist_index_add (SEXP_LCASTP(v_dsc.mem), s_exp);
         }
 
         return (list);
@@ -1291,6 +1304,7 @@ SEXP_t *SEXP_list_pop (SEXP_t *list)
         }
 
         lblk = SEXP_VALP_LBLK(SEXP_LCASTP(v_dsc.mem)->b_addr);
+        SEXP_rawlist_index_drop (SEXP_LCASTP(v_dsc.mem));
 
         if (lblk != NULL) {
                 if (++SEXP_LCASTP(v_dsc.mem)->offset == lblk->real) {
@@ -1367,6 +1381,60 @@ void SEXP_list_it_free(SEXP_list_it *it)
         sm_free(it);
 }
 
+int SEXP_list_cursor_init(SEXP_list_cursor_t *cursor, const SEXP_t *list, uint32_t n)
+{
+        SEXP_val_t v_dsc;
+        struct SEXP_val_lblk *lblk;
+        uint32_t i;
+
+        if (cursor == NULL || list == NULL) {
+                errno = EFAULT;
+                return (-1);
+        }
+
+        SEXP_VALIDATE(list);
+        SEXP_val_dsc(&v_dsc, list->s_valp);
+
+        if (v_dsc.type != SEXP_VALTYPE_LIST || n < 1) {
+                errno = EINVAL;
+                return (-1);
+        }
+
+        lblk = SEXP_VALP_LBLK(SEXP_LCASTP(v_dsc.mem)->b_addr);
+        i    = SEXP_LCASTP(v_dsc.mem)->offset + n - 1;
+
+        while (lblk != NULL && i >= lblk->real) {
+                i   -= lblk->real;
+                lblk = SEXP_VALP_LBLK(lblk->nxsz);
+        }
+
+        cursor->block = lblk;
+        cursor->index = lblk != NULL ? i : 0;
+
+        return (0);
+}
+
+SEXP_t *SEXP_list_cursor_next(SEXP_list_cursor_t *cursor)
+{
+        struct SEXP_val_lblk *lblk = cursor->block;
+
+        /*
+         * Move to the next block only when the member is needed, members
+         * added to the last block in the meantime are not skipped.
+         */
+        while (lblk != NULL && cursor->index >= lblk->real) {
+                lblk = SEXP_VALP_LBLK(lblk->nxsz);
+                cursor->index = 0;
+        }
+
+        cursor->block = lblk;
+
+        if (lblk == NULL)
+                return (NULL);
+
+        return (SEXP_ref(lblk->memb + cursor->index++));
+}
+
 SEXP_t *SEXP_list_sort(SEXP_t *list, int(*compare)(const SEXP_t *, const SEXP_t *))
 {
         SEXP_val_t v_dsc;
@@ -1389,6 +1457,7 @@ SEXP_t *SEXP_list_sort(SEXP_t *list, int(*compare)(const SEXP_t *, const SEXP_t
          * TODO: check reference counts and make copies of list
          * blocks if needed
          */
+        SEXP_rawlist_index_drop (SEXP_LCASTP(v_dsc.mem));
 
         /*
          * PASS #1: Sort each block and build the iterator array
@@ -1647,6 +1716,7 @@ SEXP_t *SEXP_unref (SEXP_t *s_exp_o)
                                 if (SEXP_LCASTP(v_dsc.mem)->b_addr != NULL)
                                         SEXP_rawval_lblk_free ((uintptr_t)SEXP_LCASTP(v_dsc.mem)->b_addr, SEXP_free_lmemb);
 
+                                SEXP_rawlist_index_free (SEXP_LCASTP(v_dsc.mem)->index);
                                 sm_free (v_dsc.hdr);
                                 break;
                         default:
@@ -1842,6 +1912,7 @@ static void SEXP_free_lmemb (SEXP_t *s_exp)
                                 if (SEXP_LCASTP(v_dsc.mem)->b_addr != NULL)
                                         SEXP_rawval_lblk_free ((uintptr_t)SEXP_LCASTP(v_dsc.mem)->b_addr, SEXP_free_lmemb);
 
+                                SEXP_rawlist_index_free (SEXP_LCASTP(v_dsc.mem)->index);
                                 sm_free (v_dsc.hdr);
                                 break;
                         default:
@@ -29,6 +29,7 @@
 #include "_sexp-types.h"
 #include "_sexp-value.h"
 #include "_sexp-rawptr.h"
+#include "_sexp-index.h"
 #include "public/sexp-manip_r.h"
 
 SEXP_t *SEXP_init(SEXP_t *sexp_mem)
@@ -293,7 +294,7 @@ SEXP_t *SEXP_list_new_rv (SEXP_t *sexp_mem, SEXP_t *memb, va_list alist)
                 s_ptr[++s_cur] = va_arg (alist, SEXP_t *);
         }
 
-        if (SEXP_val_new (&v_dsc, sizeof (void *) + sizeof (uint16_t),
+        if (SEXP_val_new (&v_dsc, sizeof (struct SEXP_val_list),
                           SEXP_VALTYPE_LIST) != 0)
         {
                 /* TODO: handle this */
@@ -317,6 +318,8 @@ SEXP_t *SEXP_list_new_rv (SEXP_t *sexp_mem, SEXP_t *memb, va_list alist)
                 SEXP_LCASTP(v_dsc.mem)->b_addr = NULL;
         }
 
+        SEXP_LCASTP(v_dsc.mem)->index = NULL;
+
         SEXP_init(sexp_mem);
         sexp_mem->s_type = NULL;
         sexp_mem->s_valp = v_dsc.ptr;
@@ -362,7 +365,7 @@ SEXP_t *SEXP_list_rest_r (SEXP_t *rest, const SEXP_t *list)
                 return (NULL);
         }
 
-        if (SEXP_val_new (&v_dsc_r, sizeof (void *) + sizeof (uint16_t),
+        if (SEXP_val_new (&v_dsc_r, sizeof (struct SEXP_val_list),
                           SEXP_VALTYPE_LIST) != 0)
         {
                 /* TODO: handle this */
@@ -371,6 +374,7 @@ SEXP_t *SEXP_list_rest_r (SEXP_t *rest, const SEXP_t *list)
 
         SEXP_LCASTP(v_dsc_r.mem)->offset = SEXP_LCASTP(v_dsc_o.mem)->offset + 1;
         SEXP_LCASTP(v_dsc_r.mem)->b_addr = SEXP_LCASTP(v_dsc_o.mem)->b_addr;
+        SEXP_LCASTP(v_dsc_r.mem)->index  = NULL;
 
         lblk = SEXP_VALP_LBLK(SEXP_LCASTP(v_dsc_r.mem)->b_addr);
 
@@ -432,6 +436,7 @@ void __SEXP_free_r (SEXP_t *s_exp, const char *file, uint32_t line, const char *
                                 if (SEXP_LCASTP(v_dsc.mem)->b_addr != NULL)
                                         SEXP_rawval_lblk_free ((uintptr_t)SEXP_LCASTP(v_dsc.mem)->b_addr, SEXP_free_r);
 
+                                SEXP_rawlist_index_free (SEXP_LCASTP(v_dsc.mem)->index);
                                 sm_free (v_dsc.hdr);
                                 break;
                         default:
@@ -25,6 +25,11 @@
 
 #define CRAPI_IO_BUFSZ 4096
 
+/* Size of the reads done when computing several digests at once */
+#ifndef CRAPI_MDIGEST_BUFSZ
+# define CRAPI_MDIGEST_BUFSZ (128 * 1024)
+#endif
+
 #ifndef _FILE_OFFSET_BITS
 # define _FILE_OFFSET_BITS 32
 #endif
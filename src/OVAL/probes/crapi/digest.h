@@ -55,4 +55,11 @@ struct digest_ctbl_t {
 
 int crapi_mdigest_fd (int fd, int num, ... /*crapi_alg_t alg, void *dst, size_t *size, ...*/);
 
+/*
+ * Same as crapi_mdigest_fd, with the algorithms, destination buffers and
+ * their sizes passed in arrays of num elements. All the digests are
+ * computed in a single pass over the file.
+ */
+int crapi_mdigest_fdv (int fd, int num, const crapi_alg_t alg[], void *dst[], size_t *size[]);
+
 #endif /* CRAPI_DIGEST_H */
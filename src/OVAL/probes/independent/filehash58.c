@@ -45,6 +45,8 @@
 #include <limits.h>
 #include <pthread.h>
 #include <errno.h>
+#include <unistd.h>
+#include <stdbool.h>
 #include <crapi/crapi.h>
 #include <probe/probe.h>
 #include <probe/option.h>
@@ -56,8 +58,6 @@
 
 #define FILE_SEPARATOR '/'
 
-static pthread_mutex_t __filehash58_probe_mutex;
-
 #define CRAPI_INVALID -1
 
 static const struct oscap_string_map CRAPI_ALG_MAP[] = {
@@ -82,6 +82,57 @@ static const struct oscap_string_map CRAPI_ALG_MAP_SIZE[] = {
 	{0, NULL}
 };
 
+/// Number of hash types in CRAPI_ALG_MAP
+#define FILEHASH58_ALG_CNT 6
+
+/// Maximum number of threads hashing the files of one object, including the probe worker
+#ifndef FILEHASH58_THREADS_MAX
+# define FILEHASH58_THREADS_MAX 4
+#endif
+
+/// Number of files handed over to the hashing threads at once
+#ifndef FILEHASH58_BATCH_SIZE
+# define FILEHASH58_BATCH_SIZE 64
+#endif
+
+struct filehash58_file {
+	OVAL_FTSENT *ent;
+	char    filepath[PATH_MAX + 1];
+	int     err;	///< errno if the file couldn't be opened, -1 if hashing failed
+	uint8_t digest[FILEHASH58_ALG_CNT][64];
+	size_t  digest_len[FILEHASH58_ALG_CNT];
+};
+
+struct filehash58_batch {
+	struct filehash58_file files[FILEHASH58_BATCH_SIZE];
+	size_t count;
+	size_t next;	///< index of the next file to be hashed
+	size_t done;	///< number of hashed files
+
+	int         alg_cnt;
+	crapi_alg_t alg[FILEHASH58_ALG_CNT];
+	const char *alg_name[FILEHASH58_ALG_CNT];
+
+	pthread_cond_t cond;
+	struct filehash58_batch *queue_next;
+};
+
+/*
+ * The threads are shared by all the objects evaluated by the probe at
+ * the same time. Each probe worker also hashes the files of its own
+ * batch, so that the work gets done even if all the threads are busy
+ * with other batches.
+ */
+struct filehash58_pool {
+	pthread_mutex_t mutex;
+	pthread_cond_t  cond;
+	pthread_t       threads[FILEHASH58_THREADS_MAX];
+	int             thread_cnt;
+	bool            stop;
+	struct filehash58_batch *queue;
+};
+
+static struct filehash58_pool __filehash58_pool;
 
 static int mem2hex (uint8_t *mem, size_t mlen, char *str, size_t slen)
 {
@@ -103,17 +154,16 @@ static int mem2hex (uint8_t *mem, size_t mlen, char *str, size_t slen)
 	return (0);
 }
 
-static int filehash58_cb (const char *p, const char *f, const char *h, probe_ctx *ctx)
+/*
+ * Compute all the requested digests of the file in one pass.
+ */
+static void filehash58_hash (struct filehash58_batch *batch, struct filehash58_file *file)
 {
-	SEXP_t *itm;
-
-	char   pbuf[PATH_MAX+1];
-	size_t plen, flen;
-
-	int fd;
-
-	if (f == NULL)
-		return (0);
+	const char *p = file->ent->path, *f = file->ent->file;
+	void   *dst[FILEHASH58_ALG_CNT];
+	size_t *dstlen[FILEHASH58_ALG_CNT];
+	size_t  plen, flen;
+	int fd, i;
 
 	/*
 	 * Prepare path
@@ -121,119 +171,247 @@ static int filehash58_cb (const char *p, const char *f, const char *h, probe_ctx
 	plen = strlen (p);
 	flen = strlen (f);
 
-	if (plen + flen + 1 > PATH_MAX)
-		return (-1);
+	if (plen + flen + 1 > PATH_MAX) {
+		file->err = ENAMETOOLONG;
+		return;
+	}
 
-	memcpy (pbuf, p, sizeof (char) * plen);
+	memcpy (file->filepath, p, sizeof (char) * plen);
 
-	if (p[plen - 1] != FILE_SEPARATOR) {
-		pbuf[plen] = FILE_SEPARATOR;
+	if (plen == 0 || p[plen - 1] != FILE_SEPARATOR) {
+		file->filepath[plen] = FILE_SEPARATOR;
 		++plen;
 	}
 
-	memcpy (pbuf + plen, f, sizeof (char) * flen);
-	pbuf[plen+flen] = '\0';
+	memcpy (file->filepath + plen, f, sizeof (char) * flen);
+	file->filepath[plen+flen] = '\0';
 
 	/*
 	 * Open the file
 	 */
-	fd = open (pbuf, O_RDONLY);
+	fd = open (file->filepath, O_RDONLY);
 
 	if (fd < 0) {
-		strerror_r (errno, pbuf, PATH_MAX);
-		pbuf[PATH_MAX] = '\0';
-
-		itm = probe_item_create (OVAL_INDEPENDENT_FILE_HASH58, NULL,
-					"filepath", OVAL_DATATYPE_STRING, pbuf,
-					"path",     OVAL_DATATYPE_STRING, p,
-					"filename", OVAL_DATATYPE_STRING, f,
-					"hash_type",OVAL_DATATYPE_STRING, h,
-					NULL);
-		probe_item_add_msg(itm, OVAL_MESSAGE_LEVEL_ERROR,
-			"Can't open \"%s\": errno=%d, %s.", pbuf, errno, strerror (errno));
-		probe_item_setstatus(itm, SYSCHAR_STATUS_ERROR);
-	} else {
-		uint8_t hash_dst[1025];
-		size_t  hash_dstlen = sizeof hash_dst;
-		char    hash_str[2051];
-
-		crapi_alg_t hash_type;
-
-		hash_type = oscap_string_to_enum(CRAPI_ALG_MAP, h);
-		hash_dstlen = oscap_string_to_enum(CRAPI_ALG_MAP_SIZE, h);
-
-		/*
-		 * Compute hash value
-		 */
-		if (crapi_mdigest_fd (fd, 1, hash_type, hash_dst, &hash_dstlen) != 0) {
-			close (fd);
-			return (-1);
-		}
+		file->err = errno;
+		return;
+	}
+
+	for (i = 0; i < batch->alg_cnt; ++i) {
+		file->digest_len[i] = oscap_string_to_enum(CRAPI_ALG_MAP_SIZE, batch->alg_name[i]);
+		dst[i]    = file->digest[i];
+		dstlen[i] = &file->digest_len[i];
+	}
+
+	/*
+	 * Compute hash values
+	 */
+	file->err = crapi_mdigest_fdv (fd, batch->alg_cnt, batch->alg, dst, dstlen) != 0 ? -1 : 0;
+	close (fd);
+}
 
-		close (fd);
-
-		hash_str[0] = '\0';
-		mem2hex (hash_dst, hash_dstlen, hash_str, sizeof hash_str);
-
-		/*
-		 * Create and add the item
-		 */
-		itm = probe_item_create(OVAL_INDEPENDENT_FILE_HASH58, NULL,
-					"filepath", OVAL_DATATYPE_STRING, pbuf,
-					"path",     OVAL_DATATYPE_STRING, p,
-					"filename", OVAL_DATATYPE_STRING, f,
-					"hash_type",OVAL_DATATYPE_STRING, h,
-					"hash",     OVAL_DATATYPE_STRING, hash_str,
-					NULL);
-
-		if (hash_dstlen == 0) {
-			probe_item_add_msg(itm, OVAL_MESSAGE_LEVEL_ERROR,
-					   "Unable to compute %s hash value of \"%s\".", h, pbuf);
-			probe_item_setstatus(itm, SYSCHAR_STATUS_ERROR);
+static void filehash58_queue_remove (struct filehash58_pool *pool, struct filehash58_batch *batch)
+{
+	struct filehash58_batch **prev;
+
+	for (prev = &pool->queue; *prev != NULL; prev = &(*prev)->queue_next) {
+		if (*prev == batch) {
+			*prev = batch->queue_next;
+			break;
 		}
 	}
+}
 
-	probe_item_collect(ctx, itm);
+/*
+ * Hash the next file of the batch. Called with the pool mutex locked.
+ */
+static void filehash58_batch_step (struct filehash58_pool *pool, struct filehash58_batch *batch)
+{
+	size_t i = batch->next++;
 
-	return (0);
+	if (batch->next == batch->count)
+		filehash58_queue_remove (pool, batch);
+
+	pthread_mutex_unlock (&pool->mutex);
+	filehash58_hash (batch, batch->files + i);
+	pthread_mutex_lock (&pool->mutex);
+
+	if (++batch->done == batch->count)
+		pthread_cond_signal (&batch->cond);
+}
+
+static void *filehash58_thread (void *arg)
+{
+	struct filehash58_pool *pool = arg;
+
+	pthread_mutex_lock (&pool->mutex);
+
+	while (!pool->stop) {
+		if (pool->queue == NULL)
+			pthread_cond_wait (&pool->cond, &pool->mutex);
+		else
+			filehash58_batch_step (pool, pool->queue);
+	}
+
+	pthread_mutex_unlock (&pool->mutex);
+
+	return (NULL);
+}
+
+static void filehash58_batch_run (struct filehash58_pool *pool, struct filehash58_batch *batch)
+{
+	struct filehash58_batch **tail;
+	int cstate;
+
+	if (batch->count == 0)
+		return;
+
+	batch->next = 0;
+	batch->done = 0;
+	batch->queue_next = NULL;
+
+	/* the threads refer to the batch until it's done */
+	pthread_setcancelstate (PTHREAD_CANCEL_DISABLE, &cstate);
+	pthread_mutex_lock (&pool->mutex);
+
+	for (tail = &pool->queue; *tail != NULL; tail = &(*tail)->queue_next)
+		;
+	*tail = batch;
+
+	if (batch->count > 1)
+		pthread_cond_broadcast (&pool->cond);
+
+	while (batch->next < batch->count)
+		filehash58_batch_step (pool, batch);
+	while (batch->done < batch->count)
+		pthread_cond_wait (&batch->cond, &pool->mutex);
+
+	pthread_mutex_unlock (&pool->mutex);
+	pthread_setcancelstate (cstate, NULL);
+}
+
+static void filehash58_batch_collect (struct filehash58_batch *batch, probe_ctx *ctx)
+{
+	char    hash_str[2051];
+	size_t  i;
+	int     j;
+	SEXP_t *itm;
+
+	for (i = 0; i < batch->count; ++i) {
+		struct filehash58_file *file = batch->files + i;
+		const char *p = file->ent->path, *f = file->ent->file;
+
+		for (j = 0; j < batch->alg_cnt; ++j) {
+			const char *h = batch->alg_name[j];
+
+			if (file->err > 0) {
+				itm = probe_item_create (OVAL_INDEPENDENT_FILE_HASH58, NULL,
+							"filepath", OVAL_DATATYPE_STRING, file->filepath,
+							"path",     OVAL_DATATYPE_STRING, p,
+							"filename", OVAL_DATATYPE_STRING, f,
+							"hash_type",OVAL_DATATYPE_STRING, h,
+							NULL);
+				probe_item_add_msg(itm, OVAL_MESSAGE_LEVEL_ERROR,
+					"Can't open \"%s\": errno=%d, %s.", file->filepath, file->err, strerror (file->err));
+				probe_item_setstatus(itm, SYSCHAR_STATUS_ERROR);
+			} else {
+				hash_str[0] = '\0';
+				if (file->err == 0)
+					mem2hex (file->digest[j], file->digest_len[j], hash_str, sizeof hash_str);
+
+				/*
+				 * Create and add the item
+				 */
+				itm = probe_item_create(OVAL_INDEPENDENT_FILE_HASH58, NULL,
+							"filepath", OVAL_DATATYPE_STRING, file->filepath,
+							"path",     OVAL_DATATYPE_STRING, p,
+							"filename", OVAL_DATATYPE_STRING, f,
+							"hash_type",OVAL_DATATYPE_STRING, h,
+							"hash",     OVAL_DATATYPE_STRING, hash_str,
+							NULL);
+
+				if (file->err != 0 || file->digest_len[j] == 0) {
+					probe_item_add_msg(itm, OVAL_MESSAGE_LEVEL_ERROR,
+							   "Unable to compute %s hash value of \"%s\".", h, file->filepath);
+					probe_item_setstatus(itm, SYSCHAR_STATUS_ERROR);
+				}
+			}
+
+			probe_item_collect(ctx, itm);
+		}
+
+		oval_ftsent_free(file->ent);
+	}
+
+	batch->count = 0;
 }
 
 void *probe_init (void)
 {
+	struct filehash58_pool *pool = &__filehash58_pool;
+	long cpus;
+
 	/*
 	 * Initialize crypto API
 	 */
 	if (crapi_init (NULL) != 0)
 		return (NULL);
 
+	probe_setoption(PROBEOPT_OFFLINE_MODE_SUPPORTED, PROBE_OFFLINE_CHROOT);
+
+	memset (pool, 0, sizeof *pool);
+
+	if ((errno = pthread_mutex_init (&pool->mutex, NULL)) != 0 ||
+	    (errno = pthread_cond_init (&pool->cond, NULL)) != 0) {
+		dI("Can't initialize the thread pool: errno=%u, %s.\n", errno, strerror (errno));
+		return (NULL);
+	}
+
 	/*
-	 * Initialize mutex.
+	 * Start the hashing threads. The probe worker hashes files too,
+	 * hence one thread less than the number of CPUs.
 	 */
-	switch (pthread_mutex_init (&__filehash58_probe_mutex, NULL)) {
-	case 0:
-		return ((void *)&__filehash58_probe_mutex);
-	default:
-		dI("Can't initialize mutex: errno=%u, %s.\n", errno, strerror (errno));
-	}
+	cpus = sysconf (_SC_NPROCESSORS_ONLN);
 
-	probe_setoption(PROBEOPT_OFFLINE_MODE_SUPPORTED, PROBE_OFFLINE_CHROOT);
+	if (cpus > FILEHASH58_THREADS_MAX)
+		cpus = FILEHASH58_THREADS_MAX;
 
-	return (NULL);
+	while (pool->thread_cnt < cpus - 1) {
+		if ((errno = pthread_create (&pool->threads[pool->thread_cnt], NULL,
+					     &filehash58_thread, pool)) != 0) {
+			dI("Can't start a hashing thread: errno=%u, %s.\n", errno, strerror (errno));
+			break;
+		}
+		++pool->thread_cnt;
+	}
+
+	return ((void *)pool);
 }
 
 void probe_fini (void *arg)
 {
-	_A((void *)arg == (void *)&__filehash58_probe_mutex);
+	struct filehash58_pool *pool = arg;
+	int i;
+
+	_A(pool == &__filehash58_pool);
 
 	/*
-	 * Destroy mutex.
+	 * Stop the threads.
 	 */
-	(void) pthread_mutex_destroy (&__filehash58_probe_mutex);
+	pthread_mutex_lock (&pool->mutex);
+	pool->stop = true;
+	pthread_cond_broadcast (&pool->cond);
+	pthread_mutex_unlock (&pool->mutex);
+
+	for (i = 0; i < pool->thread_cnt; ++i)
+		pthread_join (pool->threads[i], NULL);
+
+	(void) pthread_cond_destroy (&pool->cond);
+	(void) pthread_mutex_destroy (&pool->mutex);
 
 	return;
 }
 
-int probe_main(probe_ctx *ctx, void *mutex)
+int probe_main(probe_ctx *ctx, void *arg)
 {
 	SEXP_t *probe_in;
 	SEXP_t *path, *filename, *behaviors, *filepath, *hash_type;
@@ -243,11 +421,14 @@ int probe_main(probe_ctx *ctx, void *mutex)
 	OVAL_FTS    *ofts;
 	OVAL_FTSENT *ofts_ent;
 
-	if (mutex == NULL) {
+	struct filehash58_pool  *pool = arg;
+	struct filehash58_batch *batch;
+
+	if (pool == NULL) {
 		return (PROBE_EINIT);
 	}
 
-	_A(mutex == &__filehash58_probe_mutex);
+	_A(pool == &__filehash58_pool);
 
 	probe_in  = probe_ctx_getobject(ctx);
 
@@ -271,35 +452,49 @@ int probe_main(probe_ctx *ctx, void *mutex)
 
 	probe_filebehaviors_canonicalize(&behaviors);
 
-	switch (pthread_mutex_lock (&__filehash58_probe_mutex)) {
-	case 0:
-		break;
-	default:
-		dI("Can't lock mutex(%p): %u, %s.\n", &__filehash58_probe_mutex, errno, strerror (errno));
+	batch = oscap_talloc (struct filehash58_batch);
+	batch->count   = 0;
+	batch->alg_cnt = 0;
+	pthread_cond_init (&batch->cond, NULL);
+
+	/* find hash types to compare with entity, think "not satisfy" */
+	const struct oscap_string_map *p = CRAPI_ALG_MAP;
+	while (p->value != CRAPI_INVALID) {
+		SEXP_t *crapi_hash_type_sexp = SEXP_string_new(p->string, strlen(p->string));
+		if (probe_entobj_cmp(hash_type, crapi_hash_type_sexp) == OVAL_RESULT_TRUE) {
+			batch->alg[batch->alg_cnt]      = p->value;
+			batch->alg_name[batch->alg_cnt] = p->string;
+			++batch->alg_cnt;
+		}
 
-		err = PROBE_EFATAL;
-		goto cleanup;
+		SEXP_free(crapi_hash_type_sexp);
+		p++;
 	}
 
-	if ((ofts = oval_fts_open(path, filename, filepath, behaviors)) != NULL) {
+	if (batch->alg_cnt > 0 && (ofts = oval_fts_open(path, filename, filepath, behaviors)) != NULL) {
 		while ((ofts_ent = oval_fts_read(ofts)) != NULL) {
-			/* find hash types to compare with entity, think "not satisfy" */
-			const struct oscap_string_map *p = CRAPI_ALG_MAP;
-			while (p->value != CRAPI_INVALID) {
-				SEXP_t *crapi_hash_type_sexp = SEXP_string_new(p->string, strlen(p->string));
-				if (probe_entobj_cmp(hash_type, crapi_hash_type_sexp) == OVAL_RESULT_TRUE) {
-					filehash58_cb(ofts_ent->path, ofts_ent->file, p->string, ctx);
-				}
+			if (ofts_ent->file == NULL) {
+				oval_ftsent_free(ofts_ent);
+				continue;
+			}
 
-				SEXP_free(crapi_hash_type_sexp);
-				p++;
+			batch->files[batch->count++].ent = ofts_ent;
+
+			if (batch->count == FILEHASH58_BATCH_SIZE) {
+				filehash58_batch_run (pool, batch);
+				filehash58_batch_collect (batch, ctx);
 			}
-			oval_ftsent_free(ofts_ent);
 		}
 
+		filehash58_batch_run (pool, batch);
+		filehash58_batch_collect (batch, ctx);
+
 		oval_fts_close(ofts);
 	}
 
+	pthread_cond_destroy (&batch->cond);
+	oscap_free (batch);
+
 cleanup:
 	SEXP_free (behaviors);
 	SEXP_free (path);
@@ -307,14 +502,5 @@ cleanup:
 	SEXP_free (filepath);
         SEXP_free (hash_type);
 
-	switch (pthread_mutex_unlock (&__filehash58_probe_mutex)) {
-	case 0:
-		break;
-	default:
-		dI("Can't unlock mutex(%p): %u, %s.\n", &__filehash58_probe_mutex, errno, strerror (errno));
-
-		err = PROBE_EFATAL;
-	}
-
 	return err;
 }
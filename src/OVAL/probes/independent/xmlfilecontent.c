@@ -56,6 +56,10 @@
 #include <stdlib.h>
 #include <string.h>
 #include <limits.h>
+#include <stdbool.h>
+#include <pthread.h>
+#include <sys/types.h>
+#include <sys/stat.h>
 
 #include <libxml/tree.h>
 #include <libxml/parser.h>
@@ -68,12 +72,58 @@
 #include <probe/option.h>
 #include <oval_fts.h>
 #include <common/debug_priv.h>
+#include <common/trace_priv.h>
+#include "../SEAP/generic/rbt/rbt.h"
 
 #define FILE_SEPARATOR '/'
 
+/// Maximum number of parsed documents kept in the cache
+#ifndef XFC_CACHE_DOCS
+# define XFC_CACHE_DOCS 256
+#endif
+
+/*
+ * Content usually has many xmlfilecontent objects which query different
+ * XPaths in the same few files, so the parsed documents are kept for the
+ * lifetime of the probe. A cached document is used only if the file's
+ * device, inode, mtime and size didn't change since it was parsed.
+ * Files which failed to parse are remembered as well.
+ */
+struct xfc_doc {
+	pthread_mutex_t mutex; /* held while the document is parsed or evaluated */
+	bool    valid;         /* the file was parsed, doc is NULL on failure */
+	xmlDoc *doc;
+	dev_t   dev;
+	ino_t   ino;
+	time_t  mtime;
+	off_t   size;
+};
+
+/*
+ * Compiled XPath expressions are kept for the lifetime of the probe too.
+ * Evaluating a compiled expression isn't thread safe, libxml2 stores
+ * the looked up functions in the steps of the expression, so each
+ * evaluation holds the mutex of the expression.
+ */
+struct xfc_xpath {
+	pthread_mutex_t   mutex; /* held while the expression is evaluated */
+	xmlXPathCompExpr *comp;
+};
+
+struct xfc_cache {
+	pthread_mutex_t mutex; /* protects the trees and the counters */
+	rbt_t *docs;   /* path -> struct xfc_doc */
+	rbt_t *xpaths; /* XPath expression -> struct xfc_xpath */
+	unsigned long parsed;
+	unsigned long reused;
+};
+
 struct pfdata {
 	SEXP_t *filename_ent;
 	char *xpath;
+	xmlXPathCompExpr *xpath_comp;
+	struct xfc_xpath *xpath_entry; /* NULL if xpath_comp isn't cached */
+	struct xfc_cache *cache;
         probe_ctx *ctx;
 };
 
@@ -83,36 +133,222 @@ static void dummy_err_func(void * ctx, const char * msg, ...)
 
 void *probe_init(void)
 {
+	struct xfc_cache *cache;
+
 	/* init libxml */
 	//LIBXML_TEST_VERSION;
 	xmlInitParser();
 	xmlSetGenericErrorFunc(NULL, dummy_err_func);
 	probe_setoption(PROBEOPT_OFFLINE_MODE_SUPPORTED, PROBE_OFFLINE_CHROOT);
 
-	return NULL;
+	cache = oscap_talloc(struct xfc_cache);
+
+	if (pthread_mutex_init(&cache->mutex, NULL) != 0) {
+		dE("Can't initialize the document cache mutex\n");
+		oscap_free(cache);
+		return (NULL);
+	}
+
+	cache->docs   = rbt_str_new();
+	cache->xpaths = rbt_str_new();
+	cache->parsed = 0;
+	cache->reused = 0;
+
+	return (cache);
+}
+
+static void xfc_doc_free_cb(struct rbt_str_node *n)
+{
+	struct xfc_doc *entry = n->data;
+
+	if (entry->doc != NULL)
+		xmlFreeDoc(entry->doc);
+
+	pthread_mutex_destroy(&entry->mutex);
+	oscap_free(entry);
+	oscap_free(n->key);
+}
+
+static void xfc_xpath_free_cb(struct rbt_str_node *n)
+{
+	struct xfc_xpath *entry = n->data;
+
+	xmlXPathFreeCompExpr(entry->comp);
+	pthread_mutex_destroy(&entry->mutex);
+	oscap_free(entry);
+	oscap_free(n->key);
 }
 
 void probe_fini(void *arg)
 {
-        (void)arg;
+	struct xfc_cache *cache = arg;
+
+	if (cache != NULL) {
+		dI("Parsed %lu documents, reused a parsed document %lu times\n",
+		   cache->parsed, cache->reused);
+
+		rbt_str_free_cb(cache->docs, &xfc_doc_free_cb);
+		rbt_str_free_cb(cache->xpaths, &xfc_xpath_free_cb);
+		pthread_mutex_destroy(&cache->mutex);
+		oscap_free(cache);
+	}
+
 	/* deinit libxml */
 	xmlCleanupParser();
 }
 
+/*
+ * Get the compiled expression. If the expression is cached, the cache
+ * entry is returned in *entry and its mutex has to be held while the
+ * expression is evaluated, because the probe threads share it. Otherwise
+ * *entry is NULL and the caller owns the expression.
+ */
+static xmlXPathCompExpr *xfc_xpath_get(struct xfc_cache *cache, const char *xpath, struct xfc_xpath **entry)
+{
+	struct xfc_xpath *e = NULL;
+	xmlXPathCompExpr *comp;
+
+	*entry = NULL;
+
+	if (cache == NULL)
+		return xmlXPathCompile(BAD_CAST xpath);
+
+	pthread_mutex_lock(&cache->mutex);
+
+	if (rbt_str_get(cache->xpaths, xpath, (void *)&e) != 0) {
+		comp = xmlXPathCompile(BAD_CAST xpath);
+
+		if (comp == NULL) {
+			pthread_mutex_unlock(&cache->mutex);
+			return (NULL);
+		}
+
+		e = oscap_talloc(struct xfc_xpath);
+		e->comp = comp;
+		pthread_mutex_init(&e->mutex, NULL);
+
+		if (rbt_str_add(cache->xpaths, oscap_strdup(xpath), e) != 0) {
+			pthread_mutex_destroy(&e->mutex);
+			oscap_free(e);
+			pthread_mutex_unlock(&cache->mutex);
+			return (comp);
+		}
+	}
+
+	pthread_mutex_unlock(&cache->mutex);
+
+	*entry = e;
+
+	return (e->comp);
+}
+
+static xmlDoc *xfc_doc_parse(const char *path, off_t size)
+{
+	xmlDoc *doc;
+
+	oscap_trace_begin("xml_parse", path);
+	doc = xmlParseFile(path);
+	oscap_trace_end("xml_parse", path, doc != NULL, size);
+
+	return (doc);
+}
+
+/*
+ * Get the parsed document. If the document is cached, the cache entry
+ * is returned in *entry, locked, and the caller has to unlock it when
+ * done with the document. Otherwise *entry is NULL and the caller owns
+ * the document.
+ */
+static xmlDoc *xfc_doc_get(struct xfc_cache *cache, const char *path, struct xfc_doc **entry)
+{
+	struct xfc_doc *e = NULL;
+	struct stat st;
+
+	*entry = NULL;
+
+	if (cache == NULL || stat(path, &st) != 0)
+		return xfc_doc_parse(path, 0);
+
+	pthread_mutex_lock(&cache->mutex);
+
+	if (rbt_str_get(cache->docs, path, (void *)&e) != 0) {
+		if (rbt_str_size(cache->docs) >= XFC_CACHE_DOCS) {
+			++cache->parsed;
+			pthread_mutex_unlock(&cache->mutex);
+			return xfc_doc_parse(path, st.st_size);
+		}
+
+		e = oscap_talloc(struct xfc_doc);
+		e->valid = false;
+		e->doc   = NULL;
+		pthread_mutex_init(&e->mutex, NULL);
+
+		if (rbt_str_add(cache->docs, oscap_strdup(path), e) != 0) {
+			pthread_mutex_destroy(&e->mutex);
+			oscap_free(e);
+			++cache->parsed;
+			pthread_mutex_unlock(&cache->mutex);
+			return xfc_doc_parse(path, st.st_size);
+		}
+	}
+
+	pthread_mutex_unlock(&cache->mutex);
+	pthread_mutex_lock(&e->mutex);
+
+	if (e->valid &&
+	    e->dev == st.st_dev && e->ino == st.st_ino &&
+	    e->mtime == st.st_mtime && e->size == st.st_size) {
+		pthread_mutex_lock(&cache->mutex);
+		++cache->reused;
+		pthread_mutex_unlock(&cache->mutex);
+	} else {
+		if (e->doc != NULL)
+			xmlFreeDoc(e->doc);
+
+		e->doc   = xfc_doc_parse(path, st.st_size);
+		e->valid = true;
+		e->dev   = st.st_dev;
+		e->ino   = st.st_ino;
+		e->mtime = st.st_mtime;
+		e->size  = st.st_size;
+
+		pthread_mutex_lock(&cache->mutex);
+		++cache->parsed;
+		pthread_mutex_unlock(&cache->mutex);
+	}
+
+	if (e->doc == NULL) {
+		pthread_mutex_unlock(&e->mutex);
+		return (NULL);
+	}
+
+	*entry = e;
+
+	return (e->doc);
+}
+
 static int process_file(const char *path, const char *filename, void *arg)
 {
 	struct pfdata *pfd = (struct pfdata *) arg;
 	int ret = 0, path_len, filename_len;
 	char *whole_path = NULL;
 	xmlDoc *doc = NULL;
+	struct xfc_doc *doc_entry = NULL;
 	xmlXPathContext *xpath_ctx = NULL;
 	xmlXPathObject *xpath_obj = NULL;
 	SEXP_t *item = NULL;
         SEXP_t *r0;
         char filepath[PATH_MAX+1];
+	int cstate;
 
 	if (filename == NULL)
-		goto cleanup;
+		return 0;
+
+	/*
+	 * Don't let the thread be cancelled while it holds a cached
+	 * document, other threads would wait for it forever.
+	 */
+	pthread_setcancelstate(PTHREAD_CANCEL_DISABLE, &cstate);
 
 	path_len     = strlen(path);
 	filename_len = strlen(filename);
@@ -129,7 +365,7 @@ static int process_file(const char *path, const char *filename, void *arg)
 
 	/* evaluate xpath */
 
-	doc = xmlParseFile(whole_path);
+	doc = xfc_doc_get(pfd->cache, whole_path, &doc_entry);
 	if (doc == NULL) {
                 SEXP_t *msg;
                 msg = probe_msg_creatf(OVAL_MESSAGE_LEVEL_ERROR, "Can't parse '%s'.", whole_path);
@@ -153,10 +389,18 @@ static int process_file(const char *path, const char *filename, void *arg)
 		goto cleanup;
 	}
 
-	xpath_obj = xmlXPathEvalExpression(BAD_CAST pfd->xpath, xpath_ctx);
+	if (pfd->xpath_comp != NULL) {
+		if (pfd->xpath_entry != NULL)
+			pthread_mutex_lock(&pfd->xpath_entry->mutex);
+
+		xpath_obj = xmlXPathCompiledEval(pfd->xpath_comp, xpath_ctx);
+
+		if (pfd->xpath_entry != NULL)
+			pthread_mutex_unlock(&pfd->xpath_entry->mutex);
+	}
 	if (xpath_obj == NULL) {
                 SEXP_t *msg;
-                msg = probe_msg_creatf(OVAL_MESSAGE_LEVEL_ERROR, "xmlXPathEvalExpression() error");
+                msg = probe_msg_creatf(OVAL_MESSAGE_LEVEL_ERROR, "xmlXPathCompiledEval() error");
                 probe_cobj_add_msg(probe_ctx_getresult(pfd->ctx), msg);
                 SEXP_free(msg);
                 probe_cobj_set_flag(probe_ctx_getresult(pfd->ctx), SYSCHAR_FLAG_ERROR);
@@ -262,11 +506,15 @@ static int process_file(const char *path, const char *filename, void *arg)
 		xmlXPathFreeObject(xpath_obj);
 	if (xpath_ctx != NULL)
 		xmlXPathFreeContext(xpath_ctx);
-	if (doc != NULL)
+	if (doc_entry != NULL)
+		pthread_mutex_unlock(&doc_entry->mutex);
+	else if (doc != NULL)
 		xmlFreeDoc(doc);
 	if (whole_path != NULL)
 		free(whole_path);
 
+	pthread_setcancelstate(cstate, NULL);
+
 	return ret;
 }
 
@@ -278,8 +526,6 @@ int probe_main(probe_ctx *ctx, void *arg)
 	OVAL_FTS    *ofts;
 	OVAL_FTSENT *ofts_ent;
 
-        (void)arg;
-
         probe_in = probe_ctx_getobject(ctx);
 
         path_ent = probe_obj_getent(probe_in, "path", 1);
@@ -313,6 +559,8 @@ int probe_main(probe_ctx *ctx, void *arg)
 	pfd.xpath = SEXP_string_cstr(r0 = probe_ent_getval(xpath_ent));
         SEXP_free (r0);
 
+	pfd.xpath_comp = xfc_xpath_get(arg, pfd.xpath, &pfd.xpath_entry);
+	pfd.cache = arg;
 	pfd.filename_ent = filename_ent;
         pfd.ctx = ctx;
 
@@ -325,6 +573,8 @@ int probe_main(probe_ctx *ctx, void *arg)
 		oval_fts_close(ofts);
 	}
 
+        if (pfd.xpath_entry == NULL && pfd.xpath_comp != NULL)
+                xmlXPathFreeCompExpr(pfd.xpath_comp);
         oscap_free(pfd.xpath);
         SEXP_free (path_ent);
         SEXP_free (filename_ent);
@@ -225,6 +225,7 @@ bool probe_item_filtered(const SEXP_t *item, const SEXP_t *filters)
 
 	SEXP_list_foreach(filter, filters) {
 		SEXP_t *felm, *ste_res, *r0;
+		SEXP_list_cursor_t cursor;
 		oval_result_t ores;
 		oval_operator_t oopr;
 		oval_filter_action_t ofact;
@@ -235,7 +236,9 @@ bool probe_item_filtered(const SEXP_t *item, const SEXP_t *filters)
 		ste = SEXP_list_nth(filter, 2);
 		ste_res = SEXP_list_new(NULL);
 
-		SEXP_sublist_foreach(felm, ste, 2, SEXP_LIST_END) {
+		SEXP_list_cursor_init(&cursor, ste, 2);
+
+		while ((felm = SEXP_list_cursor_next(&cursor)) != NULL) {
 			SEXP_t *ielm, *elm_res;
 			char *elm_name;
 			oval_check_t ochk;
@@ -276,6 +279,7 @@ bool probe_item_filtered(const SEXP_t *item, const SEXP_t *filters)
 			}
 			SEXP_list_add(ste_res, r0 = SEXP_number_newi_32(ores));
 			SEXP_free(r0);
+			SEXP_free(felm);
 		}
 
 		r0 = probe_ent_getattrval(ste, "operator");
@@ -397,22 +401,32 @@ SEXP_t *probe_obj_new(const char *name, SEXP_t * attrs)
 		SEXP_list_add(obj, ns);
 
 	SEXP_free(ns);
+	SEXP_list_index(obj);
 
 	return (obj);
 }
 
 SEXP_t *probe_obj_getent(const SEXP_t * obj, const char *name, uint32_t n)
 {
-	SEXP_t *objents, *ent, *ent_name;
+	SEXP_t *ent, *ent_name;
+	SEXP_list_cursor_t cursor;
 
 	_A(obj != NULL);
 	_A(name != NULL);
 	_A(n > 0);
 
-	ent = NULL;
-	objents = SEXP_list_rest(obj);
+	/* objects and items built by the probe API are indexed by entity name */
+	switch (SEXP_list_index_nth(obj, name, n, &ent)) {
+	case 1:
+		return (ent);
+	case 0:
+		return (NULL);
+	}
+
+	if (SEXP_list_cursor_init(&cursor, obj, 2) != 0)
+		return (NULL);
 
-	SEXP_list_foreach(ent, objents) {
+	while ((ent = SEXP_list_cursor_next(&cursor)) != NULL) {
 		ent_name = SEXP_list_first(ent);
 
 		if (SEXP_listp(ent_name)) {
@@ -437,10 +451,9 @@ SEXP_t *probe_obj_getent(const SEXP_t * obj, const char *name, uint32_t n)
 		}
 
 		SEXP_free(ent_name);
+		SEXP_free(ent);
 	}
 
-	SEXP_free(objents);
-
 	return (ent);
 }
 
@@ -501,28 +514,26 @@ SEXP_t *probe_obj_getattrval(const SEXP_t * obj, const char *name)
 	_A(name_len < sizeof name_buf);
 
 	if (SEXP_listp(obj_name)) {
-		uint32_t i;
-		SEXP_t *attr;
+		SEXP_list_cursor_t cursor;
+		SEXP_t *attr, *val;
 
-		i = 2;
+		SEXP_list_cursor_init(&cursor, obj_name, 2);
 
-		while ((attr = SEXP_list_nth(obj_name, i)) != NULL) {
+		while ((attr = SEXP_list_cursor_next(&cursor)) != NULL) {
 			if (SEXP_stringp(attr)) {
 				if (SEXP_string_nth(attr, 1) == ':') {
-					if (SEXP_strcmp(attr, name_buf) == 0) {
-						SEXP_t *val;
+					/* the value of the attribute */
+					val = SEXP_list_cursor_next(&cursor);
 
-						val = SEXP_list_nth(obj_name, i + 1);
+					if (SEXP_strcmp(attr, name_buf) == 0) {
 						SEXP_free(attr);
 						SEXP_free(obj_name);
 
 						return (val);
 					}
 
-					++i;
+					SEXP_free(val);
 				}
-
-				++i;
 			}
 
 			SEXP_free(attr);
@@ -546,12 +557,12 @@ bool probe_obj_attrexists(const SEXP_t * obj, const char *name)
 	_A(name_len < sizeof name_buf);
 
 	if (SEXP_listp(obj_name)) {
-		uint32_t i;
+		SEXP_list_cursor_t cursor;
 		SEXP_t *attr;
 
-		i = 2;
+		SEXP_list_cursor_init(&cursor, obj_name, 2);
 
-		while ((attr = SEXP_list_nth(obj_name, i)) != NULL) {
+		while ((attr = SEXP_list_cursor_next(&cursor)) != NULL) {
 			if (SEXP_stringp(attr)) {
 				if (SEXP_string_nth(attr, 1) == ':') {
 					if (SEXP_strcmp(attr, name_buf) == 0) {
@@ -560,7 +571,8 @@ bool probe_obj_attrexists(const SEXP_t * obj, const char *name)
 
 						return (true);
 					}
-					++i;
+					/* skip the value */
+					SEXP_free(SEXP_list_cursor_next(&cursor));
 				} else {
                                     if (SEXP_strcmp(attr, name_buf + 1) == 0) {
                                         SEXP_free(attr);
@@ -568,7 +580,6 @@ bool probe_obj_attrexists(const SEXP_t * obj, const char *name)
                                         return true;
                                     }
                                 }
-				++i;
 			}
 
 			SEXP_free(attr);
@@ -1054,12 +1065,12 @@ SEXP_t *probe_ent_getattrval(const SEXP_t * ent, const char *name)
 	attrs = SEXP_list_first(ent);
 
 	if (SEXP_listp(attrs)) {
+		SEXP_list_cursor_t cursor;
 		SEXP_t *attr;
-		uint32_t i;
 
-		i = 2;
+		SEXP_list_cursor_init(&cursor, attrs, 2);
 
-		while ((attr = SEXP_list_nth(attrs, i)) != NULL) {
+		while ((attr = SEXP_list_cursor_next(&cursor)) != NULL) {
 			if (SEXP_stringp(attr)) {
 				char attr_name[32 + 1];
 				size_t attr_nlen;
@@ -1070,7 +1081,7 @@ SEXP_t *probe_ent_getattrval(const SEXP_t * ent, const char *name)
 					if (attr_name[0] == ':') {
 						if (strcmp(attr_name + 1, name) == 0) {
 							SEXP_free(attr);
-							attr = SEXP_list_nth(attrs, i + 1);
+							attr = SEXP_list_cursor_next(&cursor);
 							SEXP_free(attrs);
 							return attr;
 						}
@@ -1079,7 +1090,6 @@ SEXP_t *probe_ent_getattrval(const SEXP_t * ent, const char *name)
 			}
 
                         SEXP_free(attr);
-			++i;
 		}
 	}
 
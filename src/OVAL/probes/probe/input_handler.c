@@ -48,7 +48,8 @@ void *probe_input_handler(void *arg)
         pthread_attr_t pth_attr;
         probe_t       *probe = (probe_t *)arg;
 
-        int probe_ret, cstate; /* XXX */
+        int probe_ret, cstate, ret; /* XXX */
+        bool rcache_hit;
         SEAP_msg_t *seap_request, *seap_reply;
         SEXP_t *probe_in, *probe_out, *oid;
 
@@ -92,7 +93,8 @@ void *probe_input_handler(void *arg)
 
                 TH_CANCEL_OFF;
 
-		probe_in = SEAP_msg_get(seap_request);
+		probe_in   = SEAP_msg_get(seap_request);
+		rcache_hit = false;
 
 		if (probe_in == NULL)
 			abort();
@@ -204,7 +206,8 @@ void *probe_input_handler(void *arg)
 					/* cache hit */
 					SEXP_free(oid);
 					SEXP_free(probe_in);
-					probe_ret = 0;
+					probe_ret  = 0;
+					rcache_hit = true;
 				}
 			}
 		} else {
@@ -230,10 +233,14 @@ void *probe_input_handler(void *arg)
 			SEXP_VALIDATE(probe_out);
 
 			seap_reply = SEAP_msg_new();
-			SEAP_msg_set(seap_reply, probe_out);
+
+			if (rcache_hit)
+				SEAP_msgattr_set(seap_reply, "rcache-hit", NULL);
+
+			ret = probe_worker_reply(probe, seap_request, seap_reply, probe_out);
                         SEXP_free(probe_out);
 
-			if (SEAP_reply(probe->SEAP_ctx, probe->sd, seap_reply, seap_request) == -1) {
+			if (ret == -1) {
 				dE("An error ocured while sending SEAP message. errno=%u, %s.\n",
 				   errno, strerror(errno));
 
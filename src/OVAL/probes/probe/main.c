@@ -34,6 +34,7 @@
 #include <libgen.h>
 #include <seap.h>
 #include "common/bfind.h"
+#include "common/debug_priv.h"
 #include "probe.h"
 #include "ncache.h"
 #include "rcache.h"
@@ -74,14 +75,50 @@ static SEXP_t *probe_reset(SEXP_t *arg0, void *arg1)
          * FIXME: implement main loop locking & worker waiting
          */
 	probe_rcache_free(probe->rcache);
-        probe_ncache_free(probe->ncache);
-
         probe->rcache = probe_rcache_new();
-        probe->ncache = probe_ncache_new();
+        __sync_fetch_and_add(&probe->rcache_gen, 1);
+
+        /* The name cache of an in-process probe is owned by the library */
+        if (!(probe->flags & PROBE_FLAG_INPROCESS)) {
+                probe_ncache_free(probe->ncache);
+                probe->ncache = probe_ncache_new();
+        }
 
         return(NULL);
 }
 
+/*
+ * Commands are processed by the input handler which is started after
+ * probe_init() returns. A reply to this command therefore tells the
+ * library that the probe is initialized and ready to collect objects.
+ */
+static SEXP_t *probe_ready(SEXP_t *arg0, void *arg1)
+{
+        return (SEXP_number_newb(true));
+}
+
+/*
+ * Remove the results of objects and the states that depend on
+ * changed variable values from the result cache. The argument is
+ * a list of object and state ids.
+ */
+static SEXP_t *probe_rcache_invalidate(SEXP_t *arg0, void *arg1)
+{
+        probe_t *probe = (probe_t *)arg1;
+        SEXP_t  *id;
+        uint32_t n = 0;
+
+        SEXP_list_foreach(id, arg0) {
+                if (probe_rcache_sexp_del(probe->rcache, id) == 0)
+                        ++n;
+        }
+
+        if (n > 0)
+                __sync_fetch_and_add(&probe->rcache_gen, 1);
+
+        return (SEXP_number_newu_32(n));
+}
+
 static int probe_opthandler_varref(int option, int op, va_list args)
 {
 	bool  o_switch;
@@ -160,6 +197,64 @@ static int probe_opthandler_offlinemode(int option, int op, va_list args)
 	return 0;
 }
 
+static void probe_common_init(probe_t *probe)
+{
+	/*
+	 * Initialize result & name caching
+	 */
+	probe->rcache = probe_rcache_new();
+	probe->rcache_gen = 0;
+        probe->icache = probe_icache_new();
+
+	if (probe->flags & PROBE_FLAG_INPROCESS) {
+		/*
+		 * The element name cache is shared with the library
+		 * and all other probes running in the same process.
+		 */
+		probe->ncache = probe_ncache_libcache();
+	} else {
+		probe->ncache = probe_ncache_new();
+		OSCAP_GSYM(ncache) = probe->ncache;
+	}
+
+	/*
+	 * Initialize probe option handlers
+	 */
+#define PROBE_OPTION_INITCOUNT 3
+
+	probe->option = oscap_alloc(sizeof(probe_option_t) * PROBE_OPTION_INITCOUNT);
+	probe->optcnt = PROBE_OPTION_INITCOUNT;
+
+	probe->option[0].option  = PROBEOPT_VARREF_HANDLING;
+	probe->option[0].handler = &probe_opthandler_varref;
+	probe->option[1].option  = PROBEOPT_RESULT_CACHING;
+	probe->option[1].handler = &probe_opthandler_rcache;
+	probe->option[2].option  = PROBEOPT_OFFLINE_MODE_SUPPORTED;
+	probe->option[2].handler = &probe_opthandler_offlinemode;
+
+	OSCAP_GSYM(probe_optdef) = probe->option;
+	OSCAP_GSYM(probe_optdef_count) = probe->optcnt;
+}
+
+static void probe_common_fini(probe_t *probe)
+{
+        probe_fini(probe->probe_arg);
+
+	if (!(probe->flags & PROBE_FLAG_INPROCESS))
+		probe_ncache_free(probe->ncache);
+
+	probe_rcache_free(probe->rcache);
+        probe_icache_free(probe->icache);
+
+        rbt_i32_free(probe->workers);
+
+        if (probe->sd != -1)
+                SEAP_close(probe->SEAP_ctx, probe->sd);
+
+	SEAP_CTX_free(probe->SEAP_ctx);
+        oscap_free(probe->option);
+}
+
 int main(int argc, char *argv[])
 {
 	pthread_attr_t th_attr;
@@ -209,32 +304,14 @@ int main(int argc, char *argv[])
 	if (SEAP_cmd_register(probe.SEAP_ctx, PROBECMD_RESET, 0, &probe_reset) != 0)
 		fail(errno, "SEAP_cmd_register", __LINE__ - 1);
 
-	/*
-	 * Initialize result & name caching
-	 */
-	probe.rcache = probe_rcache_new();
-	probe.ncache = probe_ncache_new();
-        probe.icache = probe_icache_new();
-
-        OSCAP_GSYM(ncache) = probe.ncache;
-
-	/*
-	 * Initialize probe option handlers
-	 */
-#define PROBE_OPTION_INITCOUNT 3
-
-	probe.option = oscap_alloc(sizeof(probe_option_t) * PROBE_OPTION_INITCOUNT);
-	probe.optcnt = PROBE_OPTION_INITCOUNT;
+	if (SEAP_cmd_register(probe.SEAP_ctx, PROBECMD_READY, 0, &probe_ready) != 0)
+		fail(errno, "SEAP_cmd_register", __LINE__ - 1);
 
-	probe.option[0].option  = PROBEOPT_VARREF_HANDLING;
-	probe.option[0].handler = &probe_opthandler_varref;
-	probe.option[1].option  = PROBEOPT_RESULT_CACHING;
-	probe.option[1].handler = &probe_opthandler_rcache;
-	probe.option[2].option  = PROBEOPT_OFFLINE_MODE_SUPPORTED;
-	probe.option[2].handler = &probe_opthandler_offlinemode;
+	if (SEAP_cmd_register(probe.SEAP_ctx, PROBECMD_RC_DEL, SEAP_CMDREG_USEARG,
+			      &probe_rcache_invalidate, &probe) != 0)
+		fail(errno, "SEAP_cmd_register", __LINE__ - 1);
 
-	OSCAP_GSYM(probe_optdef) = probe.option;
-	OSCAP_GSYM(probe_optdef_count) = probe.optcnt;
+	probe_common_init(&probe);
 
 	/*
 	 * Create signal handler
@@ -315,19 +392,93 @@ int main(int argc, char *argv[])
 	/*
 	 * Cleanup
 	 */
-        probe_fini(probe.probe_arg);
+	probe_common_fini(&probe);
+
+	return (probe.probe_exitcode);
+}
+
+/*
+ * Entry point used when the probe is loaded into the scanner process
+ * and connected using the "mem" SEAP scheme. There's no signal handler
+ * thread: signals belong to the host process and the probe terminates
+ * when the connection is closed. Changing the root directory affects
+ * the whole process, so the offline chroot mode is refused here.
+ */
+int probe_module_main(void *chan)
+{
+	probe_t probe;
+	char   *rootdir;
+	int     ret;
+
+	if ((rootdir = getenv("OSCAP_PROBE_ROOT")) != NULL && strlen(rootdir) > 0)
+		return (EOPNOTSUPP);
+
+	if ((errno = pthread_barrier_init(&OSCAP_GSYM(th_barrier), NULL,
+	                                  1 + // input thread
+	                                  1 + // icache thread
+	                                  0)) != 0)
+	{
+		return (errno);
+	}
 
-	probe_ncache_free(probe.ncache);
-	probe_rcache_free(probe.rcache);
-        probe_icache_free(probe.icache);
+	probe.flags = PROBE_FLAG_INPROCESS;
+	probe.pid   = getpid();
+	probe.name  = (char *)"probe_module";
+        probe.probe_exitcode = 0;
+
+	probe.SEAP_ctx = SEAP_CTX_new();
+	probe.sd       = SEAP_openmem(probe.SEAP_ctx, chan, 0);
+
+	if (probe.sd < 0) {
+		ret = errno;
+		SEAP_CTX_free(probe.SEAP_ctx);
+		pthread_barrier_destroy(&OSCAP_GSYM(th_barrier));
+		return (ret);
+	}
+
+	if (SEAP_cmd_register(probe.SEAP_ctx, PROBECMD_RESET, 0, &probe_reset) != 0 ||
+	    SEAP_cmd_register(probe.SEAP_ctx, PROBECMD_READY, 0, &probe_ready) != 0 ||
+	    SEAP_cmd_register(probe.SEAP_ctx, PROBECMD_RC_DEL, SEAP_CMDREG_USEARG,
+			      &probe_rcache_invalidate, &probe) != 0) {
+		ret = errno;
+		SEAP_close(probe.SEAP_ctx, probe.sd);
+		SEAP_CTX_free(probe.SEAP_ctx);
+		pthread_barrier_destroy(&OSCAP_GSYM(th_barrier));
+		return (ret);
+	}
+
+	probe_common_init(&probe);
+
+	if (getenv("OSCAP_PROBE_RPMDB_PATH") != NULL) {
+		OSCAP_GSYM(offline_mode) |= PROBE_OFFLINE_RPMDB;
+	}
 
-        rbt_i32_free(probe.workers);
+        probe.workers   = rbt_i32_new();
+        probe.probe_arg = probe_init();
 
-        if (probe.sd != -1)
-                SEAP_close(probe.SEAP_ctx, probe.sd);
+	/*
+	 * This runs in a thread of the scanner, errors are returned to the
+	 * scanner through the channel instead of terminating the process.
+	 */
+	if ((ret = pthread_create(&probe.th_input, NULL, &probe_input_handler, &probe)) != 0) {
+		dE("pthread_create(probe_input_handler): %d, %s\n", ret, strerror(ret));
+		probe_common_fini(&probe);
+		pthread_barrier_destroy(&OSCAP_GSYM(th_barrier));
+		return (ret);
+	}
+
+	/*
+	 * The input handler exits when the connection is closed by the
+	 * scanner. Workers which are still running are canceled then.
+	 */
+	if ((ret = pthread_join(probe.th_input, NULL)) != 0) {
+		dE("pthread_join: %d, %s\n", ret, strerror(ret));
+		probe.probe_exitcode = ret;
+	}
 
-	SEAP_CTX_free(probe.SEAP_ctx);
-        oscap_free(probe.option);
+	probe_signal_cancel_workers(&probe);
+	probe_common_fini(&probe);
+	pthread_barrier_destroy(&OSCAP_GSYM(th_barrier));
 
 	return (probe.probe_exitcode);
 }
@@ -33,6 +33,7 @@
 #include "common/alloc.h"
 #include "common/bfind.h"
 #include "common/assume.h"
+#include "common/util.h"
 
 #include "ncache.h"
 
@@ -95,6 +96,31 @@ probe_ncache_t *probe_ncache_new (void)
         return (cache);
 }
 
+/*
+ * The cache itself is defined next to the other library globals
+ * in oval_probe.c.
+ */
+extern probe_ncache_t *OSCAP_GSYM(ncache);
+static pthread_mutex_t __ncache_libcache_lock = PTHREAD_MUTEX_INITIALIZER;
+
+probe_ncache_t *probe_ncache_libcache (void)
+{
+        probe_ncache_t *cache;
+
+        if (pthread_mutex_lock (&__ncache_libcache_lock) != 0)
+                abort ();
+
+        if (OSCAP_GSYM(ncache) == NULL)
+                OSCAP_GSYM(ncache) = probe_ncache_new ();
+
+        cache = OSCAP_GSYM(ncache);
+
+        if (pthread_mutex_unlock (&__ncache_libcache_lock) != 0)
+                abort ();
+
+        return (cache);
+}
+
 void probe_ncache_free (probe_ncache_t *cache)
 {
         size_t i;
@@ -46,6 +46,13 @@ typedef struct {
  */
 probe_ncache_t *probe_ncache_new (void);
 
+/**
+ * Get the element name cache of the library, create it if it doesn't
+ * exist yet. Probes loaded into the scanner process share this cache
+ * and may be started concurrently.
+ */
+probe_ncache_t *probe_ncache_libcache (void);
+
 /**
  * Free memory used by the element name cache.
  * The S-exp objects stored in the cache are
@@ -37,3 +37,8 @@ SEXP_t *probe_ctx_getresult(probe_ctx *ctx)
 {
         return (ctx->probe_out);
 }
+
+uint32_t probe_ctx_getcachegen(probe_ctx *ctx)
+{
+        return (ctx->cache_gen);
+}
@@ -36,6 +36,8 @@
 #include "option.h"
 #include "common/util.h"
 
+#define PROBE_FLAG_INPROCESS 0x00000001 /**< the probe runs inside the scanner process */
+
 typedef struct {
 	pthread_rwlock_t rwlock;
 	uint32_t         flags;
@@ -57,6 +59,7 @@ typedef struct {
         uint32_t  max_chdepth;
 
 	probe_rcache_t *rcache; /**< probe result cache */
+	uint32_t        rcache_gen; /**< incremented whenever results are dropped from the rcache */
 	probe_ncache_t *ncache; /**< probe name cache */
         probe_icache_t *icache; /**< probe item cache */
 
@@ -69,6 +72,7 @@ struct probe_ctx {
         SEXP_t         *probe_out; /**< collected object */
         SEXP_t         *filters;   /**< object filters (OVAL 5.8 and higher) */
         probe_icache_t *icache;    /**< item cache */
+        uint32_t        cache_gen; /**< generation of the result cache */
 };
 
 typedef enum {
@@ -83,4 +87,10 @@ extern probe_offline_flags OSCAP_GSYM(offline_mode);
 extern probe_offline_flags OSCAP_GSYM(offline_mode_supported);
 extern int OSCAP_GSYM(offline_mode_cobjflag);
 
+/**
+ * Entry point of a probe built as a loadable module. Called by the "mem"
+ * SEAP scheme in a new thread with the channel handle to attach to.
+ */
+int probe_module_main(void *chan);
+
 #endif /* PROBE_H */
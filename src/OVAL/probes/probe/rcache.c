@@ -84,12 +84,50 @@ int probe_rcache_cstr_add(probe_rcache_t *cache, const char *id, SEXP_t * item)
 
 int probe_rcache_sexp_del(probe_rcache_t *cache, const SEXP_t * id)
 {
-	return (-1);
+        char b[128], *k = b;
+        int  r;
+
+        if (SEXP_string_cstr_r(id, k, sizeof b) == ((size_t)-1))
+                k = SEXP_string_cstr(id);
+
+        if (k == NULL)
+                return (-1);
+
+        r = probe_rcache_cstr_del(cache, k);
+
+        if (k != b)
+                oscap_free(k);
+
+        return (r);
 }
 
 int probe_rcache_cstr_del(probe_rcache_t *cache, const char *id)
 {
-	return (-1);
+        struct rbt_str_node *node;
+        SEXP_t *r = NULL;
+        char   *k;
+
+	assume_d(cache != NULL, -1);
+	assume_d(id    != NULL, -1);
+
+        /*
+         * rbt_str_del() moves the key of another node into the node
+         * being deleted, so the key has to be saved first to be freed.
+         * Entries are only deleted by the input handler thread so the
+         * key can't be moved by someone else in the meantime.
+         */
+        if (rbt_str_getnode(cache->tree, id, &node) != 0)
+                return (1);
+
+        k = node->key;
+
+        if (rbt_str_del(cache->tree, id, (void *)&r) != 0)
+                return (-1);
+
+        SEXP_free(r);
+        oscap_free(k);
+
+        return (0);
 }
 
 SEXP_t *probe_rcache_sexp_get(probe_rcache_t *cache, const SEXP_t * id)
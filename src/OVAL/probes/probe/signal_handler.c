@@ -58,6 +58,57 @@ static int __abort_cb(void *n, void *u)
 	return (0);
 }
 
+/*
+ * Cancel all running worker threads and wait until they finish.
+ */
+void probe_signal_cancel_workers(probe_t *probe)
+{
+	__thr_collection coll;
+
+	coll.thr = NULL;
+	coll.cnt = 0;
+
+	/* collect IDs and cancel threads */
+	rbt_walk_inorder2(probe->workers, __abort_cb, &coll, 0);
+
+	/*
+	 * Wait till all threads are canceled (they may temporarily disable
+	 * cancelability), but at most 60 seconds per thread.
+	 */
+	for (; coll.cnt > 0; --coll.cnt) {
+		probe_worker_t *thr = coll.thr[coll.cnt - 1];
+#if defined(HAVE_PTHREAD_TIMEDJOIN_NP) && defined(HAVE_CLOCK_GETTIME)
+		struct timespec j_tm;
+
+		if (clock_gettime(CLOCK_REALTIME, &j_tm) == -1) {
+			dE("clock_gettime(CLOCK_REALTIME): %d, %s.\n", errno, strerror(errno));
+			continue;
+		}
+
+		j_tm.tv_sec += 60;
+
+		if ((errno = pthread_timedjoin_np(thr->tid, NULL, &j_tm)) != 0) {
+			dE("[%llu] pthread_timedjoin_np: %d, %s.\n", (uint64_t)thr->sid, errno, strerror(errno));
+			/*
+			 * Memory will be leaked here by continuing to the next thread. However, we are in the
+			 * process of shutting down the whole probe. We're just nice and gave the probe_main()
+			 * thread a chance to finish it's critical section which shouldn't take that long...
+			 */
+			continue;
+		}
+#else
+		if ((errno = pthread_join(thr->tid, NULL)) != 0) {
+			dE("pthread_join: %d, %s.\n", errno, strerror(errno));
+			continue;
+		}
+#endif
+		SEAP_msg_free(coll.thr[coll.cnt - 1]->msg);
+		oscap_free(coll.thr[coll.cnt - 1]);
+	}
+
+	oscap_free(coll.thr);
+}
+
 void *probe_signal_handler(void *arg)
 {
         probe_t  *probe = (probe_t *)arg;
@@ -109,55 +160,9 @@ void *probe_signal_handler(void *arg)
                 case SIGTERM:
                 case SIGQUIT:
                 case SIGPIPE:
-		{
-			__thr_collection coll;
-
-			coll.thr = NULL;
-			coll.cnt = 0;
-
                         pthread_cancel(probe->th_input);
-
-			/* collect IDs and cancel threads */
-			rbt_walk_inorder2(probe->workers, __abort_cb, &coll, 0);
-
-			/*
-			 * Wait till all threads are canceled (they may temporarily disable
-			 * cancelability), but at most 60 seconds per thread.
-			 */
-			for (; coll.cnt > 0; --coll.cnt) {
-				probe_worker_t *thr = coll.thr[coll.cnt - 1];
-#if defined(HAVE_PTHREAD_TIMEDJOIN_NP) && defined(HAVE_CLOCK_GETTIME)
-				struct timespec j_tm;
-
-				if (clock_gettime(CLOCK_REALTIME, &j_tm) == -1) {
-					dE("clock_gettime(CLOCK_REALTIME): %d, %s.\n", errno, strerror(errno));
-					continue;
-				}
-
-				j_tm.tv_sec += 60;
-
-				if ((errno = pthread_timedjoin_np(thr->tid, NULL, &j_tm)) != 0) {
-					dE("[%llu] pthread_timedjoin_np: %d, %s.\n", (uint64_t)thr->sid, errno, strerror(errno));
-					/*
-					 * Memory will be leaked here by continuing to the next thread. However, we are in the
-					 * process of shutting down the whole probe. We're just nice and gave the probe_main()
-					 * thread a chance to finish it's critical section which shouldn't take that long...
-					 */
-					continue;
-				}
-#else
-				if ((errno = pthread_join(thr->tid, NULL)) != 0) {
-					dE("pthread_join: %d, %s.\n", errno, strerror(errno));
-					continue;
-				}
-#endif
-				SEAP_msg_free(coll.thr[coll.cnt - 1]->msg);
-                                oscap_free(coll.thr[coll.cnt - 1]);
-			}
-
-			oscap_free(coll.thr);
+                        probe_signal_cancel_workers(probe);
 			goto exitloop;
-		}
                 case SIGUSR2:
                 case SIGHUP:
                         /* ignore */
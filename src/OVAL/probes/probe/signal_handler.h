@@ -22,6 +22,9 @@
 #ifndef SIGNAL_H
 #define SIGNAL_H
 
+#include "probe.h"
+
 void *probe_signal_handler(void *arg);
+void  probe_signal_cancel_workers(probe_t *probe);
 
 #endif /* SIGNAL_H */
@@ -29,9 +29,11 @@
 #include <string.h>
 #include <pthread.h>
 #include <errno.h>
+#include <time.h>
 
 #include "probe-api.h"
 #include "common/debug_priv.h"
+#include "common/trace_priv.h"
 #include "common/assume.h"
 #include "entcmp.h"
 
@@ -40,18 +42,146 @@
 extern bool  OSCAP_GSYM(varref_handling);
 extern void *OSCAP_GSYM(probe_arg);
 
+/*
+ * Send the collected object `cobj' as a reply to the request `req'. The
+ * attributes of the reply are taken from `reply'. If the library asked for
+ * a streamed reply (the `stream' attribute) and the object is large, the
+ * items are sent in parts of PROBE_WORKER_STREAM_CHUNK items first and the
+ * reply carries only the rest of them. That bounds the size of a single
+ * message and lets the library convert the items part by part.
+ *
+ * It doesn't bound the memory of the probe: the handler has already
+ * collected the whole object, the result cache keeps it and the item cache
+ * keeps a reference to every item, so the parts are sent only after the
+ * collection is finished and nothing is released when a part is sent.
+ */
+int probe_worker_reply(probe_t *probe, SEAP_msg_t *req, SEAP_msg_t *reply, SEXP_t *cobj)
+{
+	SEXP_t *items, *item, *chunk, *mask, *msgs, *part_cobj;
+	SEAP_msg_t *part;
+	SEXP_list_it *it;
+	oval_syschar_collection_flag_t flag;
+	size_t left, chunk_len;
+	int ret;
+
+	items = probe_cobj_get_items(cobj);
+	left  = items != NULL ? SEXP_list_length(items) : 0;
+
+	if (left <= PROBE_WORKER_STREAM_CHUNK || !SEAP_msgattr_exists(req, "stream")) {
+		SEXP_free(items);
+		SEAP_msg_set(reply, cobj);
+
+		return SEAP_reply(probe->SEAP_ctx, probe->sd, reply, req);
+	}
+
+	flag  = probe_cobj_get_flag(cobj);
+	mask  = probe_cobj_get_mask(cobj);
+	chunk = SEXP_list_new(NULL);
+	chunk_len = 0;
+	ret = 0;
+
+	it = SEXP_list_it_new(items);
+
+	while ((item = SEXP_list_it_next(it)) != NULL) {
+		SEXP_list_add(chunk, item);
+		--left;
+
+		if (++chunk_len < PROBE_WORKER_STREAM_CHUNK || left == 0)
+			continue;
+
+		part = SEAP_msg_new();
+		part_cobj = probe_cobj_new(flag, NULL, chunk, mask);
+		SEAP_msg_set(part, part_cobj);
+		SEXP_free(part_cobj);
+
+		ret = SEAP_reply_part(probe->SEAP_ctx, probe->sd, part, req);
+		SEAP_msg_free(part);
+		SEXP_free(chunk);
+
+		if (ret != 0) {
+			chunk = NULL;
+			break;
+		}
+
+		chunk = SEXP_list_new(NULL);
+		chunk_len = 0;
+	}
+
+	SEXP_list_it_free(it);
+
+	if (ret == 0) {
+		msgs = probe_cobj_get_msgs(cobj);
+		part_cobj = probe_cobj_new(flag, msgs, chunk, mask);
+		SEAP_msg_set(reply, part_cobj);
+		SEXP_vfree(part_cobj, msgs, NULL);
+
+		ret = SEAP_reply(probe->SEAP_ctx, probe->sd, reply, req);
+	}
+
+	SEXP_vfree(items, mask, NULL);
+
+	if (chunk != NULL)
+		SEXP_free(chunk);
+
+	return (ret);
+}
+
+/*
+ * A probe running in its own process exits when it can't talk to the
+ * library. An in-process probe shares the process with the scanner, it
+ * can only fail to send once the connection is closed and the input
+ * handler then shuts the probe down with the error recorded here.
+ */
+static void probe_worker_fatal(probe_t *probe, int ret)
+{
+	if (probe->flags & PROBE_FLAG_INPROCESS) {
+		probe->probe_exitcode = ret;
+		return;
+	}
+
+	exit(ret);
+}
+
 void *probe_worker_runfn(void *arg)
 {
 	probe_pwpair_t *pair = (probe_pwpair_t *)arg;
 
 	SEXP_t *probe_res, *obj, *oid;
 	int     probe_ret;
+	char    trace_id[64] = "";
+	struct timespec cpu_beg, cpu_end;
+	uint64_t cpu_usec = 0;
+	bool    profile;
 
 	dI("handling SEAP message ID %u\n", pair->pth->sid);
+
+	if (oscap_trace_enabled()) {
+		obj = SEAP_msg_get(pair->pth->msg);
+		oid = probe_obj_getattrval(obj, "id");
+
+		if (oid != NULL)
+			SEXP_string_cstr_r(oid, trace_id, sizeof trace_id);
+
+		SEXP_free(oid);
+		SEXP_free(obj);
+	}
 	//
+	oscap_trace_begin("probe_eval", trace_id);
 	probe_ret = -1;
+	/* the library asks for the handler CPU time only if it's profiling the scan */
+	profile = SEAP_msgattr_exists(pair->pth->msg, "profile");
+
+	if (profile)
+		clock_gettime(CLOCK_THREAD_CPUTIME_ID, &cpu_beg);
+
 	probe_res = pair->pth->msg_handler(pair->probe, pair->pth->msg, &probe_ret);
 	//
+	if (profile) {
+		clock_gettime(CLOCK_THREAD_CPUTIME_ID, &cpu_end);
+		cpu_usec = (uint64_t)((int64_t)(cpu_end.tv_sec - cpu_beg.tv_sec) * 1000000
+				      + (int64_t)(cpu_end.tv_nsec - cpu_beg.tv_nsec) / 1000);
+	}
+
 	dI("handler result = %p, return code = %d\n", probe_res, probe_ret);
 
 	/* Assuming that the red-black tree API is doing locking for us... */
@@ -62,6 +192,7 @@ void *probe_worker_runfn(void *arg)
 		 * here because the signal handler replied to the message
 		 */
 		arg = NULL;
+		oscap_trace_end("probe_eval", trace_id, 0, 0);
 
                 SEAP_msg_free(pair->pth->msg);
                 SEXP_free(probe_res);
@@ -79,8 +210,10 @@ void *probe_worker_runfn(void *arg)
 
                 if (items != NULL) {
                         SEXP_list_sort(items, SEXP_refcmp);
+                        oscap_trace_end("probe_eval", trace_id, SEXP_list_length(items), 0);
                         SEXP_free(items);
-                }
+                } else
+                        oscap_trace_end("probe_eval", trace_id, 0, 0);
 
 		if (probe_rcache_sexp_add(pair->probe->rcache, oid, probe_res) != 0) {
 			/* TODO */
@@ -99,27 +232,28 @@ void *probe_worker_runfn(void *arg)
 			int ret = errno;
 
 			dE("An error ocured while sending error status. errno=%u, %s.\n", errno, strerror(errno));
-			SEXP_free(probe_res);
-
-			/* FIXME */
-			exit(ret);
+			probe_worker_fatal(pair->probe, ret);
 		}
 		SEXP_free(probe_res);
 	} else {
 		SEAP_msg_t *seap_reply;
+		SEXP_t *cpu_time;
 		/*
 		 * OK, the probe actually returned something, let's send it to the library.
+		 * The CPU time spent by the handler is used by the scan profiling.
 		 */
 		seap_reply = SEAP_msg_new();
-		SEAP_msg_set(seap_reply, probe_res);
 
-		if (SEAP_reply(pair->probe->SEAP_ctx, pair->probe->sd, seap_reply, pair->pth->msg) == -1) {
-			int ret = errno;
+		if (profile) {
+			SEAP_msgattr_set(seap_reply, "cpu-time", cpu_time = SEXP_number_newu_64(cpu_usec));
+			SEXP_free(cpu_time);
+		}
 
-			SEAP_msg_free(seap_reply);
-			SEXP_free(probe_res);
+		if (probe_worker_reply(pair->probe, pair->pth->msg, seap_reply, probe_res) == -1) {
+			int ret = errno;
 
-			exit(ret);
+			dE("An error ocured while sending the result. errno=%u, %s.\n", errno, strerror(errno));
+			probe_worker_fatal(pair->probe, ret);
 		}
 
 		SEAP_msg_free(seap_reply);
@@ -334,12 +468,21 @@ static SEXP_t *probe_ste_fetch(probe_t *probe, SEXP_t *id_list)
 		_A(ste != NULL);
 
 		if (probe_rcache_sexp_add(probe->rcache, id, ste) != 0) {
+			SEXP_t *cached;
 
-			SEXP_free(res);
-			SEXP_free(ste);
-			SEXP_free(id);
+			/*
+			 * Another worker might have fetched the same
+			 * state in the meantime.
+			 */
+			if ((cached = probe_rcache_sexp_get(probe->rcache, id)) == NULL) {
+				SEXP_free(res);
+				SEXP_free(ste);
+				SEXP_free(id);
+
+				return (NULL);
+			}
 
-			return (NULL);
+			SEXP_free(cached);
 		}
 
 		SEXP_free(ste);
@@ -374,12 +517,144 @@ static SEXP_t *probe_obj_eval(probe_t *probe, SEXP_t *id)
 	return probe_rcache_sexp_get(probe->rcache, id);
 }
 
+/**
+ * Evaluate several OVAL objects using one remote synchronous SEAP
+ * command. The library evaluates the objects one after another the
+ * same way as in the case of probe_obj_eval() and the results are
+ * stored in the probe cache. They are not returned by this function.
+ * @param id_list list of ids of the OVAL objects to be evaluated
+ * @return 0 on success, -1 on failure
+ */
+static int probe_obj_eval_list(probe_t *probe, SEXP_t *id_list)
+{
+	SEXP_t *res;
+	uint32_t i_len, r_len;
+
+	i_len = SEXP_list_length(id_list);
+
+	if (i_len == 0)
+		return (0);
+
+	res = SEAP_cmd_exec(probe->SEAP_ctx, probe->sd, 0, PROBECMD_OBJ_EVAL, id_list, SEAP_CMDTYPE_SYNC, NULL, NULL);
+	r_len = SEXP_list_length(res);
+	SEXP_free(res);
+
+	return (i_len == r_len ? 0 : -1);
+}
+
+/**
+ * Add an id to a request list unless it's already there or the
+ * corresponding state or object is already in the probe cache.
+ */
+static void probe_reqlist_add(probe_t *probe, SEXP_t *req, SEXP_t *id)
+{
+	SEXP_t *r0;
+
+	SEXP_list_foreach(r0, req) {
+		if (SEXP_string_cmp(r0, id) == 0) {
+			SEXP_free(r0);
+			return;
+		}
+	}
+
+	if ((r0 = probe_rcache_sexp_get(probe->rcache, id)) != NULL) {
+		SEXP_free(r0);
+		return;
+	}
+
+	SEXP_list_add(req, id);
+}
+
+/**
+ * Collect the ids of all objects and states referenced by a set and
+ * its subsets which aren't in the probe cache.
+ */
+static void probe_set_collect(probe_t *probe, SEXP_t *set, SEXP_t *obj_req, SEXP_t *ste_req, size_t depth)
+{
+	SEXP_t *member, *id;
+	char member_name[24];
+
+	if (depth > MAX_EVAL_DEPTH)
+		return;
+
+	SEXP_sublist_foreach(member, set, 2, 1000) {
+		if (probe_ent_getname_r(member, member_name, sizeof member_name) == 0)
+			continue;
+
+		if (strcmp("set", member_name) == 0) {
+			probe_set_collect(probe, member, obj_req, ste_req, depth + 1);
+		} else if (strcmp("obj_ref", member_name) == 0 ||
+			   strcmp("filter", member_name) == 0) {
+			if ((id = probe_ent_getval(member)) == NULL)
+				continue;
+
+			probe_reqlist_add(probe, member_name[0] == 'o' ? obj_req : ste_req, id);
+			SEXP_free(id);
+		}
+	}
+}
+
+/**
+ * Fetch all states and evaluate all objects needed to evaluate a set
+ * using two batched requests instead of one request per set member.
+ * The results end up in the probe cache where probe_set_eval() finds
+ * them. This is only an optimization; anything that fails here is
+ * requested again, one id at a time, by probe_set_eval().
+ */
+static void probe_set_prefetch(probe_t *probe, SEXP_t *set)
+{
+	SEXP_t *obj_req, *ste_req, *res;
+
+	obj_req = SEXP_list_new(NULL);
+	ste_req = SEXP_list_new(NULL);
+
+	probe_set_collect(probe, set, obj_req, ste_req, 0);
+
+	dI("Prefetching %zu states and %zu objects\n",
+	   SEXP_list_length(ste_req), SEXP_list_length(obj_req));
+
+	if (SEXP_list_length(ste_req) > 0) {
+		res = probe_ste_fetch(probe, ste_req);
+
+		if (res == NULL)
+			dW("Batched state fetch failed\n");
+
+		SEXP_free(res);
+	}
+
+	if (probe_obj_eval_list(probe, obj_req) != 0)
+		dW("Batched object evaluation failed\n");
+
+	SEXP_vfree(obj_req, ste_req, NULL);
+}
+
 static SEXP_t *probe_prepare_filters(probe_t *probe, SEXP_t *obj)
 {
-	SEXP_t *filters;
+	SEXP_t *filters, *req, *res;
 	int i;
 
 	filters = SEXP_list_new(NULL);
+	req     = SEXP_list_new(NULL);
+
+	/* fetch all the uncached states at once */
+	for (i = 1; ; ++i) {
+		SEXP_t *of, *ste_id;
+
+		of = probe_obj_getent(obj, "filter", i);
+
+		if (of == NULL)
+			break;
+
+		ste_id = probe_ent_getval(of);
+
+		if (ste_id != NULL)
+			probe_reqlist_add(probe, req, ste_id);
+
+		SEXP_vfree(of, ste_id, NULL);
+	}
+
+	res = probe_ste_fetch(probe, req);
+	SEXP_vfree(req, res, NULL);
 
 	for (i = 1; ; ++i) {
 		SEXP_t *of, *f, *ste, *ste_id, *act;
@@ -908,10 +1183,14 @@ SEXP_t *probe_worker(probe_t *probe, SEAP_msg_t *msg_in, int *ret)
 		return (NULL);
 	}
 
+	/* the probe looks up the entities of the object by name */
+	SEXP_list_index(probe_in);
+
 	set = probe_obj_getent(probe_in, "set", 1);
 
 	if (set != NULL) {
 		/* set object */
+		probe_set_prefetch(probe, set);
 		probe_out = probe_set_eval(probe, set, 0);
 		SEXP_free(set);
 		// todo: in case of an internal error set probe_ret accordingly
@@ -922,6 +1201,7 @@ SEXP_t *probe_worker(probe_t *probe, SEAP_msg_t *msg_in, int *ret)
 
 		/* simple object */
                 pctx.icache  = probe->icache;
+                pctx.cache_gen = __sync_fetch_and_add(&probe->rcache_gen, 0);
 		pctx.filters = probe_prepare_filters(probe, probe_in);
                 mask = probe_obj_getmask(probe_in);
 
@@ -31,6 +31,10 @@
 # define PROBE_WORKER_DEFAULT_MAX_THREADS 64 /**< maximum number of worker threads that will be created */
 #endif
 
+#ifndef PROBE_WORKER_STREAM_CHUNK
+# define PROBE_WORKER_STREAM_CHUNK 512 /**< maximum number of items sent in one part of a streamed reply, the probe still holds all of them */
+#endif
+
 #ifndef PROBE_WORKER_DEFAULT_MAX_CHDEPTH
 # define PROBE_WORKER_DEFAULT_MAX_CHDEPTH 8 /**< maximum depth of a worker thread chain */
 #endif
@@ -50,5 +54,6 @@ typedef struct {
 probe_worker_t *probe_worker_new(void);
 void *probe_worker_runfn(void *arg);
 SEXP_t *probe_worker(probe_t *probe, SEAP_msg_t *msg_in, int *ret);
+int probe_worker_reply(probe_t *probe, SEAP_msg_t *req, SEAP_msg_t *reply, SEXP_t *cobj);
 
 #endif /* WORKER_H */
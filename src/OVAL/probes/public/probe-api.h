@@ -467,6 +467,8 @@ void probe_tfc54behaviors_canonicalize(SEXP_t **behaviors);
 #define PROBECMD_STE_FETCH 1 /**< State fetch command code */
 #define PROBECMD_OBJ_EVAL  2 /**< Object eval command code */
 #define PROBECMD_RESET     3 /**< Reset command code */
+#define PROBECMD_READY     4 /**< Readiness check command code */
+#define PROBECMD_RC_DEL    5 /**< Result cache invalidation command code */
 
 void *probe_init(void) __attribute__ ((unused));
 void probe_fini(void *) __attribute__ ((unused));
@@ -503,6 +505,14 @@ SEXP_t *probe_ctx_getobject(probe_ctx *ctx);
  */
 SEXP_t *probe_ctx_getresult(probe_ctx *ctx);
 
+/**
+ * Return the generation of the result cache of the probe. It changes
+ * whenever cached results are dropped, i.e. when the probe is reset or
+ * some results are invalidated. A probe which keeps data collected for
+ * previous objects should drop them too once the generation changes.
+ */
+uint32_t probe_ctx_getcachegen(probe_ctx *ctx);
+
 typedef struct {
         oval_datatype_t type;
         void           *value;
@@ -46,7 +46,6 @@ static int opencache (void) {
 struct dpkginfo_reply_t * dpkginfo_get_by_name(const char *name, int *err)
 {
         pkgCache &cache = *cgCache;
-        pkgRecords Recs (cache);
         struct dpkginfo_reply_t *reply = NULL;
 
         // Locate the package
@@ -64,7 +63,11 @@ struct dpkginfo_reply_t * dpkginfo_get_by_name(const char *name, int *err)
                 if (err) *err = 0;
                 return NULL;
         }
-        pkgRecords::Parser &P = Recs.Lookup(V1.FileList());
+        /*
+         * Everything needed is in the mmaped package cache, the package
+         * records (pkgRecords) would open and parse all the index files
+         * on every lookup.
+         */
 
         /* split epoch, version and release */
         string evr = V1.VerStr();
@@ -89,6 +89,7 @@
 #include <alloc.h>
 #include <common/assume.h>
 #include "common/debug_priv.h"
+#include "../../SEAP/generic/rbt/rbt.h"
 
 
 struct rpminfo_req {
@@ -107,9 +108,19 @@ struct rpminfo_rep {
 	char extended_name[1024];
 };
 
+/*
+ * All packages installed with the same name, the value type of
+ * the package index.
+ */
+struct rpminfo_pkgs {
+        size_t count;
+        struct rpminfo_rep *rep;
+};
+
 struct rpminfo_global {
         rpmts           rpmts;
         pthread_mutex_t mutex;
+        rbt_t          *index; /* name -> struct rpminfo_pkgs, built on the first lookup */
 };
 
 #define RPMINFO_LOCK	  \
@@ -201,6 +212,131 @@ static void pkgh2rep (Header h, struct rpminfo_rep *r)
         oscap_free (str);
 }
 
+static void rpminfo_rep_dup(struct rpminfo_rep *dst, const struct rpminfo_rep *src)
+{
+        dst->name = oscap_strdup(src->name);
+        dst->arch = oscap_strdup(src->arch);
+        dst->epoch = oscap_strdup(src->epoch);
+        dst->release = oscap_strdup(src->release);
+        dst->version = oscap_strdup(src->version);
+        dst->evr = oscap_strdup(src->evr);
+        dst->signature_keyid = oscap_strdup(src->signature_keyid);
+        memcpy(dst->extended_name, src->extended_name, sizeof dst->extended_name);
+}
+
+static void rpminfo_index_free_cb(struct rbt_str_node *n)
+{
+        struct rpminfo_pkgs *pkgs = n->data;
+        size_t i;
+
+        for (i = 0; i < pkgs->count; ++i)
+                __rpminfo_rep_free(pkgs->rep + i);
+
+        oscap_free(pkgs->rep);
+        oscap_free(pkgs);
+        oscap_free(n->key);
+}
+
+/*
+ * Read the whole package database once and index the packages by
+ * name. Vulnerability feeds query thousands of packages by name and
+ * a lookup in the index is much cheaper than a database query with
+ * header formatting and signature parsing for each of them.
+ *
+ * Has to be called with g_rpm.mutex locked.
+ */
+static int rpminfo_index_build(void)
+{
+        rpmdbMatchIterator match;
+        Header pkgh;
+        struct rpminfo_pkgs *pkgs;
+        struct rpminfo_rep rep;
+
+        g_rpm.index = rbt_str_new();
+        match = rpmtsInitIterator(g_rpm.rpmts, RPMDBI_PACKAGES, NULL, 0);
+
+        if (match == NULL)
+                return (0);
+
+        while ((pkgh = rpmdbNextIterator(match)) != NULL) {
+                pkgh2rep(pkgh, &rep);
+                pkgs = NULL;
+
+                if (rbt_str_get(g_rpm.index, rep.name, (void *)&pkgs) != 0 || pkgs == NULL) {
+                        pkgs = oscap_talloc(struct rpminfo_pkgs);
+                        pkgs->count = 0;
+                        pkgs->rep = NULL;
+
+                        if (rbt_str_add(g_rpm.index, oscap_strdup(rep.name), pkgs) != 0) {
+                                dE("Can't add package %s to the index\n", rep.name);
+                                oscap_free(pkgs);
+                                __rpminfo_rep_free(&rep);
+                                continue;
+                        }
+                }
+
+                pkgs->rep = oscap_realloc(pkgs->rep, sizeof(struct rpminfo_rep) * (pkgs->count + 1));
+                pkgs->rep[pkgs->count++] = rep;
+        }
+
+        match = rpmdbFreeIterator(match);
+        dI("Indexed %zu package names\n", rbt_str_size(g_rpm.index));
+
+        return (0);
+}
+
+struct rpminfo_index_walk {
+        struct rpminfo_rep **rep;
+        int count;
+};
+
+static int rpminfo_index_walk_cb(struct rbt_str_node *n, void *user)
+{
+        struct rpminfo_index_walk *w = user;
+        struct rpminfo_pkgs *pkgs = n->data;
+        size_t i;
+
+        (*w->rep) = oscap_realloc(*w->rep, sizeof(struct rpminfo_rep) * (w->count + pkgs->count));
+
+        for (i = 0; i < pkgs->count; ++i)
+                rpminfo_rep_dup((*w->rep) + w->count++, pkgs->rep + i);
+
+        return (0);
+}
+
+/*
+ * Same as get_rpminfo, but the result is taken from the package index.
+ * Has to be called with g_rpm.mutex locked.
+ */
+static int get_rpminfo_indexed(struct rpminfo_req *req, struct rpminfo_rep **rep)
+{
+        struct rpminfo_pkgs *pkgs = NULL;
+        struct rpminfo_index_walk w;
+        size_t i;
+
+        if (g_rpm.index == NULL && rpminfo_index_build() != 0)
+                return (-1);
+
+        if (req->op == OVAL_OPERATION_NOT_EQUAL) {
+                /* the names are filtered by the caller */
+                w.rep = rep;
+                w.count = 0;
+                rbt_str_walk_inorder2(g_rpm.index, rpminfo_index_walk_cb, &w, 0);
+
+                return (w.count);
+        }
+
+        if (rbt_str_get(g_rpm.index, req->name, (void *)&pkgs) != 0 || pkgs == NULL)
+                return (0);
+
+        (*rep) = oscap_realloc(*rep, sizeof(struct rpminfo_rep) * pkgs->count);
+
+        for (i = 0; i < pkgs->count; ++i)
+                rpminfo_rep_dup((*rep) + i, pkgs->rep + i);
+
+        return ((int)pkgs->count);
+}
+
 /*
  * req - Structure containing the name of the package.
  * rep - Pointer to rpminfo_rep structure pointer. An
@@ -214,38 +350,15 @@ static int get_rpminfo (struct rpminfo_req *req, struct rpminfo_rep **rep)
 {
 	rpmdbMatchIterator match;
 	Header pkgh;
-	int ret = 0, i;
+	int ret = 0;
 
         RPMINFO_LOCK;
 
-        ret = -1;
-
         switch (req->op) {
         case OVAL_OPERATION_EQUALS:
-                match = rpmtsInitIterator (g_rpm.rpmts, RPMTAG_NAME, (const void *)req->name, 0);
-
-                if (match == NULL) {
-                        ret = 0;
-                        goto ret;
-                }
-
-                ret = rpmdbGetIteratorCount (match);
-
-                break;
 	case OVAL_OPERATION_NOT_EQUAL:
-                match = rpmtsInitIterator (g_rpm.rpmts, RPMDBI_PACKAGES, NULL, 0);
-                if (match == NULL) {
-                        ret = 0;
-                        goto ret;
-                }
-
-                if (rpmdbSetIteratorRE (match, RPMTAG_NAME, RPMMIRE_GLOB, "*") != 0)
-                {
-                        ret = -1;
-                        goto ret;
-                }
-
-                break;
+                ret = get_rpminfo_indexed(req, rep);
+                goto ret;
         case OVAL_OPERATION_PATTERN_MATCH:
                 match = rpmtsInitIterator (g_rpm.rpmts, RPMDBI_PACKAGES, NULL, 0);
 
@@ -268,31 +381,10 @@ static int get_rpminfo (struct rpminfo_req *req, struct rpminfo_rep **rep)
                 goto ret;
         }
 
-        if (ret != -1) {
-                /*
-                 * We can allocate all memory needed now because we know the number
-                 * of results.
-                 */
-                (*rep) = oscap_realloc (*rep, sizeof (struct rpminfo_rep) * ret);
-
-                for (i = 0; i < ret; ++i) {
-                        pkgh = rpmdbNextIterator (match);
-
-                        if (pkgh != NULL)
-                                pkgh2rep (pkgh, (*rep) + i);
-                        else {
-                                /* XXX: emit warning */
-                                break;
-                        }
-                }
-        } else {
-                ret = 0;
-
-                while ((pkgh = rpmdbNextIterator (match)) != NULL) {
-                        (*rep) = oscap_realloc (*rep, sizeof (struct rpminfo_rep) * ++ret);
-                        assume_r (*rep != NULL, -1);
-                        pkgh2rep (pkgh, (*rep) + (ret - 1));
-                }
+        while ((pkgh = rpmdbNextIterator (match)) != NULL) {
+                (*rep) = oscap_realloc (*rep, sizeof (struct rpminfo_rep) * ++ret);
+                assume_r (*rep != NULL, -1);
+                pkgh2rep (pkgh, (*rep) + (ret - 1));
         }
 
 	match = rpmdbFreeIterator (match);
@@ -316,6 +408,7 @@ void *probe_init (void)
         }
 
         g_rpm.rpmts = rpmtsCreate();
+        g_rpm.index = NULL;
         pthread_mutex_init (&(g_rpm.mutex), NULL);
 
 	if (regcomp(&g_keyid_regex, g_keyid_regex_string, REG_EXTENDED) != 0) {
@@ -332,6 +425,9 @@ void probe_fini (void *ptr)
 {
         struct rpminfo_global *r = (struct rpminfo_global *)ptr;
 
+        if (r->index != NULL)
+                rbt_str_free_cb(r->index, rpminfo_index_free_cb);
+
         rpmtsFree(r->rpmts);
 	rpmFreeCrypto();
         rpmFreeRpmrc();
@@ -0,0 +1,1117 @@
+/**
+ * @file   systemdoffline.c
+ * @brief  offline systemd unit file resolver shared by the systemd probes
+ */
+
+/*
+ * Copyright 2026 Red Hat Inc., Durham, North Carolina.
+ * All Rights Reserved.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+/*
+ * When the probes scan a mounted image (OSCAP_PROBE_ROOT), there's no
+ * systemd to ask. The snapshot is then built from the unit files the
+ * way systemd would load them: unit files and drop-in directories are
+ * looked up in the system search path, .wants/.requires directories add
+ * dependencies and presets are evaluated for the installable units.
+ *
+ * Only the properties of the org.freedesktop.systemd1.Unit interface
+ * which can be derived from the files are computed: Id, Names,
+ * Description, Documentation, LoadState, FragmentPath, DropInPaths,
+ * UnitFileState, UnitFilePreset, the dependency and ordering lists
+ * along with their reverse ones, and the boolean unit options. Runtime
+ * properties (ActiveState, ...) are not reported.
+ */
+
+#include <stdio.h>
+#include <dirent.h>
+#include <fnmatch.h>
+#include <unistd.h>
+#include <limits.h>
+#include <sys/stat.h>
+
+#include "systemdshared.h"
+#include "systemdoffline.h"
+
+/// Maximum size of a unit file or a preset file which is read
+#ifndef SYSTEMD_OFFLINE_MAX_FILE
+# define SYSTEMD_OFFLINE_MAX_FILE (1024 * 1024)
+#endif
+
+/* system unit search path, in the order of precedence */
+static const char *systemd_unit_dirs[] = {
+	"/etc/systemd/system",
+	"/run/systemd/system",
+	"/usr/local/lib/systemd/system",
+	"/usr/lib/systemd/system",
+	"/lib/systemd/system",
+	NULL
+};
+
+/* directories where enabled units are linked */
+static const char *systemd_config_dirs[] = {
+	"/etc/systemd/system",
+	"/run/systemd/system",
+	NULL
+};
+
+static const char *systemd_preset_dirs[] = {
+	"/etc/systemd/system-preset",
+	"/run/systemd/system-preset",
+	"/usr/local/lib/systemd/system-preset",
+	"/usr/lib/systemd/system-preset",
+	"/lib/systemd/system-preset",
+	NULL
+};
+
+static const char *systemd_unit_suffixes[] = {
+	".service", ".socket", ".target", ".mount", ".automount", ".swap",
+	".path", ".timer", ".slice", ".scope", ".device",
+	NULL
+};
+
+/* [Unit] options reported as lists, an empty assignment resets the list */
+static const char *systemd_list_options[] = {
+	"Requires", "Requisite", "Wants", "BindsTo", "PartOf", "Conflicts",
+	"Before", "After", "OnFailure", "PropagatesReloadTo",
+	"ReloadPropagatedFrom", "JoinsNamespaceOf", "RequiresMountsFor",
+	"Documentation",
+	NULL
+};
+
+/* [Unit] boolean options and their defaults */
+static const struct {
+	const char *name;
+	bool value;
+} systemd_bool_options[] = {
+	{ "DefaultDependencies", true  },
+	{ "StopWhenUnneeded",    false },
+	{ "RefuseManualStart",   false },
+	{ "RefuseManualStop",    false },
+	{ "AllowIsolate",        false },
+	{ "IgnoreOnIsolate",     false },
+	{ NULL, false }
+};
+
+/* dependencies and the reverse dependencies systemd adds for them */
+static const char *systemd_reverse_deps[][2] = {
+	{ "Requires",  "RequiredBy"  },
+	{ "Requisite", "RequisiteOf" },
+	{ "Wants",     "WantedBy"    },
+	{ "BindsTo",   "BoundBy"     },
+	{ "PartOf",    "ConsistsOf"  },
+	{ "Conflicts", "ConflictedBy" },
+	{ "Before",    "After"       },
+	{ "After",     "Before"      },
+	{ NULL, NULL }
+};
+
+/* state of a unit while the unit files are being resolved */
+struct systemd_offline_unit {
+	struct systemd_unit *unit; /* NULL until the unit is loaded */
+	char *fragment;    /* unit file path, NULL if not found */
+	bool masked;
+	bool installable;  /* the unit file has an [Install] section with something to install */
+	bool enabled;      /* the unit is linked in a configuration directory */
+	size_t alias_count;
+	char **aliases;    /* other names of the unit (symlinks in the search path) */
+	size_t dep_count[2];
+	char **deps[2];    /* units from the .wants and .requires directories */
+};
+
+struct systemd_offline {
+	const char *root;
+	rbt_t *units;      /* name -> struct systemd_offline_unit */
+	rbt_t *aliases;    /* alias name -> unit name */
+};
+
+/* a drop-in or a preset file, files with the same name override each other */
+struct systemd_offline_file {
+	char *name;
+	char *path;
+};
+
+static struct systemd_property *systemd_unit_property_new(struct systemd_unit *unit, const char *name)
+{
+	struct systemd_property *prop;
+
+	if ((prop = systemd_unit_property(unit, name)) != NULL)
+		return prop;
+
+	unit->props = oscap_realloc(unit->props, sizeof(struct systemd_property) * (unit->prop_count + 1));
+	prop = unit->props + unit->prop_count++;
+	prop->name = oscap_strdup(name);
+	prop->count = 0;
+	prop->values = NULL;
+
+	return prop;
+}
+
+static void systemd_unit_property_reset(struct systemd_unit *unit, const char *name)
+{
+	struct systemd_property *prop = systemd_unit_property_new(unit, name);
+	size_t i;
+
+	for (i = 0; i < prop->count; ++i)
+		oscap_free(prop->values[i]);
+
+	oscap_free(prop->values);
+	prop->values = NULL;
+	prop->count = 0;
+}
+
+static void systemd_unit_property_set(struct systemd_unit *unit, const char *name, const char *value)
+{
+	systemd_unit_property_reset(unit, name);
+	systemd_property_add_value(systemd_unit_property_new(unit, name), oscap_strdup(value));
+}
+
+static void systemd_unit_property_append(struct systemd_unit *unit, const char *name, const char *value)
+{
+	struct systemd_property *prop = systemd_unit_property_new(unit, name);
+	size_t i;
+
+	for (i = 0; i < prop->count; ++i)
+		if (oscap_strcmp(prop->values[i], value) == 0)
+			return;
+
+	systemd_property_add_value(prop, oscap_strdup(value));
+}
+
+static bool systemd_unit_property_true(struct systemd_unit *unit, const char *name)
+{
+	struct systemd_property *prop = systemd_unit_property(unit, name);
+
+	return prop != NULL && prop->count > 0 && oscap_strcmp(prop->values[0], "true") == 0;
+}
+
+static bool systemd_name_has_suffix(const char *name, const char *suffix)
+{
+	size_t len = strlen(name), slen = strlen(suffix);
+
+	return len > slen && strcmp(name + len - slen, suffix) == 0;
+}
+
+/*
+ * Type of the unit ("service", ...), NULL if the name isn't a unit name.
+ */
+static const char *systemd_unit_type(const char *name)
+{
+	int i;
+
+	for (i = 0; systemd_unit_suffixes[i] != NULL; ++i)
+		if (systemd_name_has_suffix(name, systemd_unit_suffixes[i]))
+			return systemd_unit_suffixes[i] + 1;
+
+	return NULL;
+}
+
+static bool systemd_unit_type_is(const char *name, const char *type)
+{
+	const char *t = systemd_unit_type(name);
+
+	return t != NULL && strcmp(t, type) == 0;
+}
+
+static bool systemd_name_is_template(const char *name)
+{
+	const char *at = strchr(name, '@');
+
+	return at != NULL && at[1] == '.';
+}
+
+/*
+ * Name of the template of an instance (foo@bar.service -> foo@.service),
+ * or NULL if the name isn't an instance.
+ */
+static char *systemd_name_template(const char *name)
+{
+	const char *at = strchr(name, '@'), *dot = strrchr(name, '.');
+
+	if (at == NULL || dot == NULL || at + 1 >= dot)
+		return NULL;
+
+	return oscap_sprintf("%.*s%s", (int)(at - name + 1), name, dot);
+}
+
+static bool systemd_bool_value(const char *value)
+{
+	return strcasecmp(value, "yes") == 0 || strcasecmp(value, "true") == 0 ||
+	       strcasecmp(value, "on") == 0 || strcmp(value, "1") == 0;
+}
+
+/*
+ * Expand the specifiers which depend only on the unit name: %n, %N,
+ * %p, %i and %%. The other ones are left as they are.
+ */
+static char *systemd_expand(const char *name, const char *value)
+{
+	const char *at = strchr(name, '@'), *dot = strrchr(name, '.');
+	size_t len, i, n;
+	char *ret, *p;
+
+	if (strchr(value, '%') == NULL)
+		return oscap_strdup(value);
+
+	for (i = 0, len = 1; value[i] != '\0'; ++i)
+		len += value[i] == '%' ? strlen(name) + 2 : 1;
+
+	ret = p = oscap_alloc(len);
+
+	for (i = 0; value[i] != '\0'; ++i) {
+		if (value[i] != '%' || value[i + 1] == '\0') {
+			*p++ = value[i];
+			continue;
+		}
+
+		switch (value[++i]) {
+		case 'n':
+			n = strlen(name);
+			memcpy(p, name, n);
+			break;
+		case 'N':
+			n = dot != NULL ? (size_t)(dot - name) : strlen(name);
+			memcpy(p, name, n);
+			break;
+		case 'p':
+			n = at != NULL ? (size_t)(at - name) : dot != NULL ? (size_t)(dot - name) : strlen(name);
+			memcpy(p, name, n);
+			break;
+		case 'i':
+			if (at != NULL && dot != NULL && at < dot) {
+				n = dot - at - 1;
+				memcpy(p, at + 1, n);
+			} else
+				n = 0;
+			break;
+		case '%':
+			n = 1;
+			*p = '%';
+			break;
+		default:
+			n = 2;
+			p[0] = '%';
+			p[1] = value[i];
+			break;
+		}
+
+		p += n;
+	}
+
+	*p = '\0';
+
+	return ret;
+}
+
+static char *systemd_offline_path(struct systemd_offline *off, const char *path)
+{
+	return oscap_sprintf("%s%s", off->root, path);
+}
+
+static char *systemd_offline_read(struct systemd_offline *off, const char *path)
+{
+	char *full = systemd_offline_path(off, path), *buf;
+	struct stat st;
+	size_t len;
+	FILE *fp;
+
+	fp = fopen(full, "r");
+	oscap_free(full);
+
+	if (fp == NULL)
+		return NULL;
+
+	if (fstat(fileno(fp), &st) != 0 || st.st_size > SYSTEMD_OFFLINE_MAX_FILE) {
+		fclose(fp);
+		return NULL;
+	}
+
+	buf = oscap_alloc(st.st_size + 1);
+	len = fread(buf, 1, st.st_size, fp);
+	buf[len] = '\0';
+	fclose(fp);
+
+	return buf;
+}
+
+static int systemd_strcmp_p(const void *a, const void *b)
+{
+	return strcmp(*(char * const *)a, *(char * const *)b);
+}
+
+static void systemd_names_free(char **names, size_t count)
+{
+	size_t i;
+
+	for (i = 0; i < count; ++i)
+		oscap_free(names[i]);
+
+	oscap_free(names);
+}
+
+static void systemd_names_add(char ***names, size_t *count, const char *name)
+{
+	size_t i;
+
+	for (i = 0; i < *count; ++i)
+		if (strcmp((*names)[i], name) == 0)
+			return;
+
+	*names = oscap_realloc(*names, sizeof(char *) * (*count + 1));
+	(*names)[(*count)++] = oscap_strdup(name);
+}
+
+/*
+ * List the directory entries sorted by name, without the dot files.
+ */
+static char **systemd_offline_readdir(struct systemd_offline *off, const char *dir, size_t *count)
+{
+	char *full = systemd_offline_path(off, dir);
+	char **names = NULL;
+	struct dirent *de;
+	DIR *d;
+
+	*count = 0;
+	d = opendir(full);
+	oscap_free(full);
+
+	if (d == NULL)
+		return NULL;
+
+	while ((de = readdir(d)) != NULL) {
+		if (de->d_name[0] == '.')
+			continue;
+
+		names = oscap_realloc(names, sizeof(char *) * (*count + 1));
+		names[(*count)++] = oscap_strdup(de->d_name);
+	}
+
+	closedir(d);
+
+	if (*count > 1)
+		qsort(names, *count, sizeof(char *), &systemd_strcmp_p);
+
+	return names;
+}
+
+/*
+ * Add the files with the suffix from the directory unless a file with
+ * the same name has been already added from a directory with a higher
+ * precedence.
+ */
+static void systemd_offline_files_add(struct systemd_offline *off, const char *dir, const char *suffix,
+				      struct systemd_offline_file **files, size_t *count)
+{
+	char **names;
+	size_t n, i, j;
+
+	names = systemd_offline_readdir(off, dir, &n);
+
+	for (i = 0; i < n; ++i) {
+		if (!systemd_name_has_suffix(names[i], suffix))
+			continue;
+
+		for (j = 0; j < *count; ++j)
+			if (strcmp((*files)[j].name, names[i]) == 0)
+				break;
+
+		if (j < *count)
+			continue;
+
+		*files = oscap_realloc(*files, sizeof(struct systemd_offline_file) * (*count + 1));
+		(*files)[*count].name = oscap_strdup(names[i]);
+		(*files)[*count].path = oscap_sprintf("%s/%s", dir, names[i]);
+		++(*count);
+	}
+
+	systemd_names_free(names, n);
+}
+
+static int systemd_offline_file_cmp(const void *a, const void *b)
+{
+	return strcmp(((const struct systemd_offline_file *)a)->name, ((const struct systemd_offline_file *)b)->name);
+}
+
+static void systemd_offline_files_free(struct systemd_offline_file *files, size_t count)
+{
+	size_t i;
+
+	for (i = 0; i < count; ++i) {
+		oscap_free(files[i].name);
+		oscap_free(files[i].path);
+	}
+
+	oscap_free(files);
+}
+
+static struct systemd_offline_unit *systemd_offline_get(struct systemd_offline *off, const char *name, bool create)
+{
+	struct systemd_offline_unit *ou = NULL;
+
+	if (rbt_str_get(off->units, name, (void *)&ou) == 0 || !create)
+		return ou;
+
+	ou = oscap_talloc(struct systemd_offline_unit);
+	memset(ou, 0, sizeof(struct systemd_offline_unit));
+
+	if (rbt_str_add(off->units, oscap_strdup(name), ou) != 0) {
+		oscap_free(ou);
+		return NULL;
+	}
+
+	return ou;
+}
+
+/*
+ * Name of the unit the name refers to, aliases are resolved.
+ */
+static const char *systemd_offline_resolve(struct systemd_offline *off, const char *name)
+{
+	const char *target = NULL;
+
+	if (rbt_str_get(off->aliases, name, (void *)&target) == 0 && target != NULL)
+		return target;
+
+	return name;
+}
+
+static void systemd_offline_unit_free_cb(struct rbt_str_node *n)
+{
+	struct systemd_offline_unit *ou = n->data;
+	int k;
+
+	for (k = 0; k < 2; ++k)
+		systemd_names_free(ou->deps[k], ou->dep_count[k]);
+
+	systemd_names_free(ou->aliases, ou->alias_count);
+	oscap_free(ou->fragment);
+	oscap_free(ou);
+	oscap_free(n->key);
+}
+
+static void systemd_offline_alias_free_cb(struct rbt_str_node *n)
+{
+	oscap_free(n->data);
+	oscap_free(n->key);
+}
+
+static bool systemd_is_config_dir(const char *dir)
+{
+	int i;
+
+	for (i = 0; systemd_config_dirs[i] != NULL; ++i)
+		if (strcmp(systemd_config_dirs[i], dir) == 0)
+			return true;
+
+	return false;
+}
+
+/*
+ * Read the unit files, masks and aliases from a directory of the search
+ * path. Names found in a directory with a higher precedence win.
+ */
+static void systemd_offline_scan_units(struct systemd_offline *off, const char *dir)
+{
+	char **names, *path, *full, target[PATH_MAX];
+	struct systemd_offline_unit *ou;
+	const char *base;
+	struct stat st;
+	size_t count, i;
+	ssize_t len;
+
+	names = systemd_offline_readdir(off, dir, &count);
+
+	for (i = 0; i < count; ++i) {
+		const char *name = names[i];
+
+		if (systemd_unit_type(name) == NULL)
+			continue;
+
+		if (systemd_offline_get(off, name, false) != NULL ||
+		    rbt_str_get(off->aliases, name, (void *)&base) == 0)
+			continue;
+
+		path = oscap_sprintf("%s/%s", dir, name);
+		full = systemd_offline_path(off, path);
+
+		if (lstat(full, &st) != 0) {
+			oscap_free(full);
+			oscap_free(path);
+			continue;
+		}
+
+		if (S_ISLNK(st.st_mode) && (len = readlink(full, target, sizeof target - 1)) > 0) {
+			target[len] = '\0';
+			base = strrchr(target, '/');
+			base = base != NULL ? base + 1 : target;
+
+			if (strcmp(target, "/dev/null") == 0) {
+				ou = systemd_offline_get(off, name, true);
+				ou->masked = true;
+			} else if (strcmp(base, name) != 0 && systemd_unit_type(base) != NULL) {
+				// an alias, the unit is loaded under the name of the link target
+				rbt_str_add(off->aliases, oscap_strdup(name), oscap_strdup(base));
+			} else {
+				// a linked unit file, absolute targets are relative to the root
+				ou = systemd_offline_get(off, name, true);
+				ou->fragment = target[0] == '/' ? oscap_strdup(target) : oscap_sprintf("%s/%s", dir, target);
+			}
+		} else if (S_ISREG(st.st_mode)) {
+			ou = systemd_offline_get(off, name, true);
+			ou->fragment = oscap_strdup(path);
+		}
+
+		oscap_free(full);
+		oscap_free(path);
+	}
+
+	systemd_names_free(names, count);
+}
+
+/*
+ * Add the dependencies from the .wants and .requires directories. In
+ * the configuration directories these are the links created when the
+ * units are enabled. Aliases from the configuration directories are
+ * created when the unit is enabled too.
+ */
+static void systemd_offline_scan_links(struct systemd_offline *off, const char *dir)
+{
+	static const char *suffixes[] = { ".wants", ".requires" };
+	bool config = systemd_is_config_dir(dir);
+	struct systemd_offline_unit *ou, *dep;
+	char **names, **deps, *path, *unit_name, *template;
+	const char *target;
+	size_t count, dcount, i, j;
+	int k;
+
+	names = systemd_offline_readdir(off, dir, &count);
+
+	for (i = 0; i < count; ++i) {
+		if (rbt_str_get(off->aliases, names[i], (void *)&target) == 0 &&
+		    (ou = systemd_offline_get(off, target, true)) != NULL) {
+			systemd_names_add(&ou->aliases, &ou->alias_count, names[i]);
+			ou->enabled = ou->enabled || config;
+			continue;
+		}
+
+		for (k = 0; k < 2; ++k) {
+			if (!systemd_name_has_suffix(names[i], suffixes[k]))
+				continue;
+
+			unit_name = oscap_sprintf("%.*s", (int)(strlen(names[i]) - strlen(suffixes[k])), names[i]);
+
+			if (systemd_unit_type(unit_name) == NULL) {
+				oscap_free(unit_name);
+				continue;
+			}
+
+			path = oscap_sprintf("%s/%s", dir, names[i]);
+			deps = systemd_offline_readdir(off, path, &dcount);
+			ou = systemd_offline_get(off, systemd_offline_resolve(off, unit_name), true);
+
+			for (j = 0; j < dcount; ++j) {
+				if (systemd_unit_type(deps[j]) == NULL)
+					continue;
+
+				systemd_names_add(&ou->deps[k], &ou->dep_count[k], deps[j]);
+
+				if (!config)
+					continue;
+
+				dep = systemd_offline_get(off, systemd_offline_resolve(off, deps[j]), true);
+				dep->enabled = true;
+
+				if ((template = systemd_name_template(deps[j])) != NULL) {
+					dep = systemd_offline_get(off, template, true);
+					dep->enabled = true;
+					oscap_free(template);
+				}
+			}
+
+			systemd_names_free(deps, dcount);
+			oscap_free(path);
+			oscap_free(unit_name);
+		}
+	}
+
+	systemd_names_free(names, count);
+}
+
+static void systemd_offline_parse(struct systemd_offline *off, struct systemd_offline_unit *ou, const char *name, const char *path)
+{
+	char *buf, *line, *next, *p, *key, *value, *save, *section = NULL;
+	int i;
+
+	if ((buf = systemd_offline_read(off, path)) == NULL) {
+		dI("Can't read unit file '%s'.\n", path);
+		return;
+	}
+
+	for (line = buf; line != NULL && *line != '\0'; line = next) {
+		next = strchr(line, '\n');
+
+		// join the continuation lines
+		while (next != NULL) {
+			p = next;
+
+			while (p > line && (p[-1] == ' ' || p[-1] == '\t' || p[-1] == '\r'))
+				--p;
+
+			if (p == line || p[-1] != '\\')
+				break;
+
+			p[-1] = ' ';
+			*next = ' ';
+			next = strchr(next, '\n');
+		}
+
+		if (next != NULL)
+			*next++ = '\0';
+
+		line = oscap_trim(line);
+
+		if (*line == '\0' || *line == '#' || *line == ';')
+			continue;
+
+		if (*line == '[') {
+			section = line;
+			continue;
+		}
+
+		if (section == NULL || (p = strchr(line, '=')) == NULL)
+			continue;
+
+		*p = '\0';
+		key = oscap_trim(line);
+		value = oscap_trim(p + 1);
+
+		if (strcmp(section, "[Install]") == 0) {
+			if (*value != '\0' &&
+			    (strcmp(key, "WantedBy") == 0 || strcmp(key, "RequiredBy") == 0 ||
+			     strcmp(key, "Alias") == 0 || strcmp(key, "Also") == 0))
+				ou->installable = true;
+			continue;
+		}
+
+		if (strcmp(section, "[Unit]") != 0)
+			continue;
+
+		value = systemd_expand(name, value);
+
+		if (strcmp(key, "Description") == 0 || strcmp(key, "SourcePath") == 0)
+			systemd_unit_property_set(ou->unit, key, value);
+
+		for (i = 0; systemd_bool_options[i].name != NULL; ++i) {
+			if (strcmp(key, systemd_bool_options[i].name) == 0) {
+				systemd_unit_property_set(ou->unit, key, systemd_bool_value(value) ? "true" : "false");
+				break;
+			}
+		}
+
+		for (i = 0; systemd_list_options[i] != NULL; ++i) {
+			if (strcmp(key, systemd_list_options[i]) != 0)
+				continue;
+
+			if (*value == '\0')
+				systemd_unit_property_reset(ou->unit, key);
+
+			for (p = strtok_r(value, " \t", &save); p != NULL; p = strtok_r(NULL, " \t", &save))
+				systemd_unit_property_append(ou->unit, key, p);
+
+			break;
+		}
+
+		oscap_free(value);
+	}
+
+	oscap_free(buf);
+}
+
+/*
+ * Apply the drop-ins of the unit and of its template. A drop-in overrides
+ * the ones with the same name from the directories with a lower
+ * precedence, then they are applied in the order of their names.
+ */
+static void systemd_offline_dropins(struct systemd_offline *off, struct systemd_offline_unit *ou, const char *name)
+{
+	struct systemd_offline_file *files = NULL;
+	char *template, *dir;
+	size_t count = 0, i;
+	int d;
+
+	template = systemd_name_template(name);
+
+	for (d = 0; systemd_unit_dirs[d] != NULL; ++d) {
+		dir = oscap_sprintf("%s/%s.d", systemd_unit_dirs[d], name);
+		systemd_offline_files_add(off, dir, ".conf", &files, &count);
+		oscap_free(dir);
+	}
+
+	for (d = 0; template != NULL && systemd_unit_dirs[d] != NULL; ++d) {
+		dir = oscap_sprintf("%s/%s.d", systemd_unit_dirs[d], template);
+		systemd_offline_files_add(off, dir, ".conf", &files, &count);
+		oscap_free(dir);
+	}
+
+	if (count > 1)
+		qsort(files, count, sizeof(struct systemd_offline_file), &systemd_offline_file_cmp);
+
+	for (i = 0; i < count; ++i) {
+		systemd_offline_parse(off, ou, name, files[i].path);
+		systemd_unit_property_append(ou->unit, "DropInPaths", files[i].path);
+	}
+
+	systemd_offline_files_free(files, count);
+	oscap_free(template);
+}
+
+/*
+ * The first matching line of the preset files decides, the units which
+ * don't match any line are enabled.
+ */
+static const char *systemd_offline_preset(struct systemd_offline *off, const char *name)
+{
+	struct systemd_offline_file *files = NULL;
+	char *buf, *line, *next, *pattern;
+	const char *ret = NULL;
+	size_t count = 0, i;
+	int d;
+
+	for (d = 0; systemd_preset_dirs[d] != NULL; ++d)
+		systemd_offline_files_add(off, systemd_preset_dirs[d], ".preset", &files, &count);
+
+	if (count > 1)
+		qsort(files, count, sizeof(struct systemd_offline_file), &systemd_offline_file_cmp);
+
+	for (i = 0; i < count && ret == NULL; ++i) {
+		if ((buf = systemd_offline_read(off, files[i].path)) == NULL)
+			continue;
+
+		for (line = buf; line != NULL && ret == NULL; line = next) {
+			if ((next = strchr(line, '\n')) != NULL)
+				*next++ = '\0';
+
+			line = oscap_trim(line);
+
+			if (strncmp(line, "enable", 6) == 0 && (line[6] == ' ' || line[6] == '\t')) {
+				pattern = oscap_trim(line + 6);
+				if (fnmatch(pattern, name, 0) == 0)
+					ret = "enabled";
+			} else if (strncmp(line, "disable", 7) == 0 && (line[7] == ' ' || line[7] == '\t')) {
+				pattern = oscap_trim(line + 7);
+				if (fnmatch(pattern, name, 0) == 0)
+					ret = "disabled";
+			}
+		}
+
+		oscap_free(buf);
+	}
+
+	systemd_offline_files_free(files, count);
+
+	return ret != NULL ? ret : "enabled";
+}
+
+/*
+ * Dependencies systemd adds to the units with DefaultDependencies=yes,
+ * only for the common unit types.
+ */
+static void systemd_offline_default_deps(struct systemd_unit *unit)
+{
+	const char *type = systemd_unit_type(unit->name);
+
+	if (type == NULL || !systemd_unit_property_true(unit, "DefaultDependencies"))
+		return;
+
+	if (strcmp(type, "service") == 0 || strcmp(type, "socket") == 0 ||
+	    strcmp(type, "timer") == 0 || strcmp(type, "path") == 0) {
+		systemd_unit_property_append(unit, "Requires", "sysinit.target");
+		systemd_unit_property_append(unit, "After", "sysinit.target");
+
+		if (strcmp(type, "service") == 0)
+			systemd_unit_property_append(unit, "After", "basic.target");
+		else if (strcmp(type, "socket") == 0)
+			systemd_unit_property_append(unit, "Before", "sockets.target");
+		else if (strcmp(type, "timer") == 0)
+			systemd_unit_property_append(unit, "Before", "timers.target");
+		else
+			systemd_unit_property_append(unit, "Before", "paths.target");
+	} else if (strcmp(type, "target") != 0)
+		return;
+
+	systemd_unit_property_append(unit, "Conflicts", "shutdown.target");
+	systemd_unit_property_append(unit, "Before", "shutdown.target");
+}
+
+static void systemd_offline_load(struct systemd_offline *off, struct systemd_offline_unit *ou)
+{
+	struct systemd_unit *unit = ou->unit;
+	struct systemd_offline_unit *tou = NULL;
+	const char *fragment = ou->fragment;
+	char *template;
+	size_t i;
+	int k;
+
+	systemd_unit_property_set(unit, "Id", unit->name);
+	systemd_unit_property_append(unit, "Names", unit->name);
+
+	for (i = 0; i < ou->alias_count; ++i)
+		systemd_unit_property_append(unit, "Names", ou->aliases[i]);
+
+	if (ou->masked) {
+		systemd_unit_property_set(unit, "LoadState", "masked");
+		systemd_unit_property_set(unit, "UnitFileState", "masked");
+		return;
+	}
+
+	// instances are loaded from the unit file of their template
+	if ((template = systemd_name_template(unit->name)) != NULL)
+		tou = systemd_offline_get(off, template, false);
+
+	if (fragment == NULL && tou != NULL)
+		fragment = tou->fragment;
+
+	if (fragment == NULL) {
+		systemd_unit_property_set(unit, "LoadState", "not-found");
+		oscap_free(template);
+		return;
+	}
+
+	for (i = 0; systemd_bool_options[i].name != NULL; ++i)
+		systemd_unit_property_set(unit, systemd_bool_options[i].name,
+					  systemd_bool_options[i].value ? "true" : "false");
+
+	systemd_unit_property_set(unit, "LoadState", "loaded");
+	systemd_unit_property_set(unit, "FragmentPath", fragment);
+
+	systemd_offline_parse(off, ou, unit->name, fragment);
+	systemd_offline_dropins(off, ou, unit->name);
+
+	for (k = 0; k < 2; ++k)
+		for (i = 0; i < ou->dep_count[k]; ++i)
+			systemd_unit_property_append(unit, k == 0 ? "Wants" : "Requires", ou->deps[k][i]);
+
+	systemd_offline_default_deps(unit);
+
+	if (tou != NULL)
+		ou->installable = ou->installable || tou->installable;
+
+	if (ou->installable) {
+		systemd_unit_property_set(unit, "UnitFileState", ou->enabled ? "enabled" : "disabled");
+		systemd_unit_property_set(unit, "UnitFilePreset", systemd_offline_preset(off, template != NULL ? template : unit->name));
+	} else
+		systemd_unit_property_set(unit, "UnitFileState", "static");
+
+	oscap_free(template);
+}
+
+struct systemd_offline_pending {
+	size_t count;
+	const char **names;
+	struct systemd_offline_unit **units;
+};
+
+static int systemd_offline_pending_cb(struct rbt_str_node *n, void *user)
+{
+	struct systemd_offline_pending *p = user;
+	struct systemd_offline_unit *ou = n->data;
+
+	if (ou->unit != NULL || systemd_name_is_template(n->key))
+		return 0;
+
+	p->names = oscap_realloc(p->names, sizeof(char *) * (p->count + 1));
+	p->units = oscap_realloc(p->units, sizeof(struct systemd_offline_unit *) * (p->count + 1));
+	p->names[p->count] = n->key;
+	p->units[p->count] = ou;
+	++p->count;
+
+	return 0;
+}
+
+static int systemd_unit_cmp(const void *a, const void *b)
+{
+	return strcmp((*(struct systemd_unit * const *)a)->name, (*(struct systemd_unit * const *)b)->name);
+}
+
+/*
+ * Load the units which aren't loaded yet, the units they reference are
+ * added to the tree and loaded by the next call. Returns the number of
+ * loaded units.
+ */
+static size_t systemd_offline_load_pending(struct systemd_snapshot *snap, struct systemd_offline *off)
+{
+	struct systemd_offline_pending p = { 0, NULL, NULL };
+	struct systemd_property *prop;
+	struct systemd_unit *unit;
+	size_t i, j;
+	int k;
+
+	rbt_str_walk_inorder2(off->units, &systemd_offline_pending_cb, &p, 0);
+
+	for (i = 0; i < p.count; ++i) {
+		if ((unit = systemd_snapshot_add(snap, p.names[i], NULL)) == NULL)
+			continue;
+
+		snap->order = oscap_realloc(snap->order, sizeof(struct systemd_unit *) * (snap->count + 1));
+		snap->order[snap->count++] = unit;
+		unit->props_done = true;
+
+		p.units[i]->unit = unit;
+		systemd_offline_load(off, p.units[i]);
+
+		for (k = 0; systemd_reverse_deps[k][0] != NULL; ++k) {
+			if ((prop = systemd_unit_property(unit, systemd_reverse_deps[k][0])) == NULL)
+				continue;
+
+			for (j = 0; j < prop->count; ++j)
+				if (systemd_unit_type(prop->values[j]) != NULL && !systemd_name_is_template(prop->values[j]))
+					systemd_offline_get(off, systemd_offline_resolve(off, prop->values[j]), true);
+		}
+	}
+
+	oscap_free(p.names);
+	oscap_free(p.units);
+
+	return i;
+}
+
+/*
+ * Add the reverse dependencies, e.g. WantedBy for Wants. The edges are
+ * collected first so that the added values aren't visited again.
+ */
+static void systemd_offline_reverse_deps(struct systemd_snapshot *snap, struct systemd_offline *off)
+{
+	struct {
+		struct systemd_unit *unit;
+		const char *prop;
+		const char *value;
+	} *edges = NULL;
+	struct systemd_property *prop;
+	struct systemd_unit *unit, *dep;
+	size_t count = 0, i, j;
+	int k;
+
+	for (i = 0; i < snap->count; ++i) {
+		unit = snap->order[i];
+
+		for (k = 0; systemd_reverse_deps[k][0] != NULL; ++k) {
+			if ((prop = systemd_unit_property(unit, systemd_reverse_deps[k][0])) == NULL)
+				continue;
+
+			for (j = 0; j < prop->count; ++j) {
+				dep = systemd_snapshot_get(snap, systemd_offline_resolve(off, prop->values[j]));
+
+				if (dep == NULL || dep == unit)
+					continue;
+
+				edges = oscap_realloc(edges, sizeof(*edges) * (count + 1));
+				edges[count].unit  = dep;
+				edges[count].prop  = systemd_reverse_deps[k][1];
+				edges[count].value = unit->name;
+				++count;
+			}
+		}
+	}
+
+	for (i = 0; i < count; ++i)
+		systemd_unit_property_append(edges[i].unit, edges[i].prop, edges[i].value);
+
+	oscap_free(edges);
+}
+
+/*
+ * Targets are ordered after the units they pull in, unless these have
+ * DefaultDependencies=no.
+ */
+static void systemd_offline_target_deps(struct systemd_snapshot *snap, struct systemd_offline *off)
+{
+	static const char *props[] = { "Requires", "Requisite", "Wants", "BindsTo", NULL };
+	struct systemd_property *prop;
+	struct systemd_unit *unit, *dep;
+	size_t i, j;
+	int k;
+
+	for (i = 0; i < snap->count; ++i) {
+		unit = snap->order[i];
+
+		if (!systemd_unit_type_is(unit->name, "target") ||
+		    !systemd_unit_property_true(unit, "DefaultDependencies"))
+			continue;
+
+		for (k = 0; props[k] != NULL; ++k) {
+			// appending to After may move the properties of the unit
+			for (j = 0; (prop = systemd_unit_property(unit, props[k])) != NULL && j < prop->count; ++j) {
+				dep = systemd_snapshot_get(snap, systemd_offline_resolve(off, prop->values[j]));
+
+				if (dep != NULL && dep != unit && systemd_unit_property_true(dep, "DefaultDependencies"))
+					systemd_unit_property_append(unit, "After", dep->name);
+			}
+		}
+	}
+}
+
+/*
+ * Take the snapshot from the unit files under the root directory instead
+ * of asking systemd, unless it has been already taken. The root is a
+ * prefix of the paths, it's empty when the probe runs chrooted.
+ */
+int systemd_offline_take(struct systemd_snapshot *snap, const char *root)
+{
+	struct systemd_offline off;
+	int d, cstate;
+
+	pthread_setcancelstate(PTHREAD_CANCEL_DISABLE, &cstate);
+	pthread_mutex_lock(&snap->mutex);
+
+	if (snap->taken)
+		goto cleanup;
+
+	off.root = root;
+	off.units = rbt_str_new();
+	off.aliases = rbt_str_new();
+
+	for (d = 0; systemd_unit_dirs[d] != NULL; ++d)
+		systemd_offline_scan_units(&off, systemd_unit_dirs[d]);
+
+	for (d = 0; systemd_unit_dirs[d] != NULL; ++d)
+		systemd_offline_scan_links(&off, systemd_unit_dirs[d]);
+
+	while (systemd_offline_load_pending(snap, &off) > 0)
+		;
+
+	systemd_offline_target_deps(snap, &off);
+	systemd_offline_reverse_deps(snap, &off);
+
+	if (snap->count > 1)
+		qsort(snap->order, snap->count, sizeof(struct systemd_unit *), &systemd_unit_cmp);
+
+	rbt_str_free_cb(off.aliases, &systemd_offline_alias_free_cb);
+	rbt_str_free_cb(off.units, &systemd_offline_unit_free_cb);
+
+	dI("Resolved %zu systemd units from the unit files.\n", snap->count);
+	snap->taken = true;
+
+cleanup:
+	pthread_mutex_unlock(&snap->mutex);
+	pthread_setcancelstate(cstate, NULL);
+
+	return 0;
+}
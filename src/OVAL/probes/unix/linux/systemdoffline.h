@@ -0,0 +1,37 @@
+/**
+ * @file   systemdoffline.h
+ * @brief  offline systemd unit file resolver shared by the systemd probes
+ */
+
+/*
+ * Copyright 2026 Red Hat Inc., Durham, North Carolina.
+ * All Rights Reserved.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef SYSTEMDOFFLINE_H
+#define SYSTEMDOFFLINE_H
+
+struct systemd_snapshot;
+
+/**
+ * Take the snapshot from the unit files below root instead of asking
+ * systemd, unless it has been already taken.
+ * @return 0 on success
+ */
+int systemd_offline_take(struct systemd_snapshot *snap, const char *root);
+
+#endif /* SYSTEMDOFFLINE_H */
@@ -30,8 +30,19 @@
 #include <config.h>
 #endif
 
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <pthread.h>
 #include <dbus/dbus.h>
 #include "common/debug_priv.h"
+#include "alloc.h"
+#include "../../SEAP/generic/rbt/rbt.h"
+
+/// Maximum number of GetAll calls in flight while taking the snapshot
+#ifndef SYSTEMD_PIPELINE_DEPTH
+# define SYSTEMD_PIPELINE_DEPTH 64
+#endif
 
 // Old versions of libdbus API don't have DBusBasicValue and DBus8ByteStruct
 // as a public typedefs.
@@ -134,98 +145,6 @@ cleanup:
 	return ret;
 }
 
-static int get_all_systemd_units(DBusConnection* conn, int(*callback)(const char *, void *), void *cbarg)
-{
-	DBusMessage *msg = NULL;
-	DBusPendingCall *pending = NULL;
-	char ret = 1;
-
-	msg = dbus_message_new_method_call(
-		"org.freedesktop.systemd1",
-		"/org/freedesktop/systemd1",
-		"org.freedesktop.systemd1.Manager",
-		"ListUnits"
-	);
-	if (msg == NULL) {
-		dI("Failed to create dbus_message via dbus_message_new_method_call!\n");
-		goto cleanup;
-	}
-
-	DBusMessageIter args, unit_iter;
-
-	// the args should be empty for this call
-	dbus_message_iter_init_append(msg, &args);
-
-	if (!dbus_connection_send_with_reply(conn, msg, &pending, -1)) {
-		dI("Failed to send message via dbus!\n");
-		goto cleanup;
-	}
-	if (pending == NULL) {
-		dI("Invalid dbus pending call!\n");
-		goto cleanup;
-	}
-
-	dbus_connection_flush(conn);
-	dbus_message_unref(msg); msg = NULL;
-
-	dbus_pending_call_block(pending);
-	msg = dbus_pending_call_steal_reply(pending);
-	if (msg == NULL) {
-		dI("Failed to steal dbus pending call reply.\n");
-		goto cleanup;
-	}
-	dbus_pending_call_unref(pending); pending = NULL;
-
-	if (!dbus_message_iter_init(msg, &args)) {
-		dI("Failed to initialize iterator over received dbus message.\n");
-		goto cleanup;
-	}
-
-	if (dbus_message_iter_get_arg_type(&args) != DBUS_TYPE_ARRAY) {
-		dI("Expected array of structs in reply. Instead received: %s.\n", dbus_message_type_to_string(dbus_message_iter_get_arg_type(&args)));
-		goto cleanup;
-	}
-
-	dbus_message_iter_recurse(&args, &unit_iter);
-	do {
-		if (dbus_message_iter_get_arg_type(&unit_iter) != DBUS_TYPE_STRUCT) {
-			dI("Expected unit struct as elements in returned array. Instead received: %s.\n", dbus_message_type_to_string(dbus_message_iter_get_arg_type(&unit_iter)));
-			goto cleanup;
-		}
-
-		DBusMessageIter unit_name;
-		dbus_message_iter_recurse(&unit_iter, &unit_name);
-
-		if (dbus_message_iter_get_arg_type(&unit_name) != DBUS_TYPE_STRING) {
-			dI("Expected string as the first element in the unit struct. Instead received: %s.\n", dbus_message_type_to_string(dbus_message_iter_get_arg_type(&unit_name)));
-			goto cleanup;
-		}
-
-		_DBusBasicValue value;
-		dbus_message_iter_get_basic(&unit_name, &value);
-		char *unit_name_s = oscap_strdup(value.str);
-		int cbret = callback(unit_name_s, cbarg);
-		oscap_free(unit_name_s);
-		if (cbret != 0) {
-			goto cleanup;
-		}
-	}
-	while (dbus_message_iter_next(&unit_iter));
-
-	dbus_message_unref(msg); msg = NULL;
-
-	ret = 0;
-
-cleanup:
-	if (pending != NULL)
-		dbus_pending_call_unref(pending);
-
-	if (msg != NULL)
-		dbus_message_unref(msg);
-
-	return ret;
-}
-
 static char *dbus_value_to_string(DBusMessageIter *iter)
 {
 	const int arg_type = dbus_message_iter_get_arg_type(iter);
@@ -352,3 +271,567 @@ static void disconnect_dbus(DBusConnection *conn)
 	// Connections retrieved via dbus_bus_get shall not be destroyed,
 	// these connections are shared.
 }
+
+/*
+ * The probes used to ask systemd for every (unit, property) pair with
+ * a synchronous call. Instead, they take a snapshot of all the units
+ * and their properties: ListUnits followed by GetAll for every unit,
+ * pipelined, and answer all the objects from it. The snapshot is taken
+ * again once the probe is reset or its cached results are invalidated.
+ */
+struct systemd_property {
+	char *name;
+	size_t count;  /* number of values, arrays have one value per element */
+	char **values; /* a value of a non-array property may be NULL */
+};
+
+struct systemd_unit {
+	char *name;
+	char *path;
+	size_t prop_count;
+	struct systemd_property *props;
+	bool props_done;
+
+	/* dependency closure, computed by systemdunitdependency on demand */
+	bool closure_done;
+	size_t closure_count;
+	char **closure;
+};
+
+struct systemd_snapshot {
+	pthread_mutex_t mutex;
+	unsigned int refs;           /* protected by the mutex of struct systemd_probe_data */
+	bool taken;
+	bool offline;                /* resolved from the unit files, see systemdoffline.c */
+	rbt_t *units;                /* name -> struct systemd_unit */
+	size_t count;
+	struct systemd_unit **order; /* units in the order returned by ListUnits, by name offline */
+};
+
+static struct systemd_snapshot *systemd_snapshot_new(void)
+{
+	struct systemd_snapshot *snap = oscap_talloc(struct systemd_snapshot);
+
+	if (pthread_mutex_init(&snap->mutex, NULL) != 0) {
+		oscap_free(snap);
+		return NULL;
+	}
+
+	snap->refs = 1;
+	snap->taken = false;
+	snap->offline = false;
+	snap->units = rbt_str_new();
+	snap->count = 0;
+	snap->order = NULL;
+
+	return snap;
+}
+
+static void systemd_unit_free(struct systemd_unit *unit)
+{
+	size_t i, j;
+
+	for (i = 0; i < unit->prop_count; ++i) {
+		for (j = 0; j < unit->props[i].count; ++j)
+			oscap_free(unit->props[i].values[j]);
+		oscap_free(unit->props[i].values);
+		oscap_free(unit->props[i].name);
+	}
+
+	for (i = 0; i < unit->closure_count; ++i)
+		oscap_free(unit->closure[i]);
+
+	oscap_free(unit->closure);
+	oscap_free(unit->props);
+	oscap_free(unit->path);
+	oscap_free(unit->name);
+	oscap_free(unit);
+}
+
+static void systemd_unit_free_cb(struct rbt_str_node *n)
+{
+	systemd_unit_free(n->data);
+	/* the key is the unit's name */
+}
+
+static void systemd_snapshot_free(struct systemd_snapshot *snap)
+{
+	if (snap == NULL)
+		return;
+
+	rbt_str_free_cb(snap->units, &systemd_unit_free_cb);
+	pthread_mutex_destroy(&snap->mutex);
+	oscap_free(snap->order);
+	oscap_free(snap);
+}
+
+/*
+ * The data of the probe: the snapshot the objects are answered from.
+ * An object collected after the result cache was dropped gets a new
+ * snapshot, the objects being collected keep using the old one.
+ */
+struct systemd_probe_data {
+	pthread_mutex_t mutex;
+	bool offline;
+	uint32_t cache_gen;           /* generation of the result cache the snapshot belongs to */
+	struct systemd_snapshot *snap;
+};
+
+static struct systemd_probe_data *systemd_probe_data_new(bool offline)
+{
+	struct systemd_probe_data *data = oscap_talloc(struct systemd_probe_data);
+
+	if (pthread_mutex_init(&data->mutex, NULL) != 0) {
+		oscap_free(data);
+		return NULL;
+	}
+
+	data->offline = offline;
+	data->cache_gen = 0;
+	data->snap = NULL;
+
+	return data;
+}
+
+static void systemd_probe_data_free(struct systemd_probe_data *data)
+{
+	if (data == NULL)
+		return;
+
+	/* the probe doesn't collect any objects anymore */
+	systemd_snapshot_free(data->snap);
+	pthread_mutex_destroy(&data->mutex);
+	oscap_free(data);
+}
+
+/*
+ * Get a reference to the snapshot of the given result cache generation,
+ * the snapshot of an older one is dropped. Release it by systemd_snapshot_put.
+ */
+static struct systemd_snapshot *systemd_snapshot_get_current(struct systemd_probe_data *data, uint32_t cache_gen)
+{
+	struct systemd_snapshot *snap, *stale = NULL;
+	int cstate;
+
+	pthread_setcancelstate(PTHREAD_CANCEL_DISABLE, &cstate);
+	pthread_mutex_lock(&data->mutex);
+
+	if (data->snap != NULL && data->cache_gen != cache_gen) {
+		dI("The result cache was dropped, dropping the snapshot of systemd units.\n");
+
+		if (--data->snap->refs == 0)
+			stale = data->snap;
+
+		data->snap = NULL;
+	}
+
+	if (data->snap == NULL && (data->snap = systemd_snapshot_new()) != NULL) {
+		data->snap->offline = data->offline;
+		data->cache_gen = cache_gen;
+	}
+
+	if ((snap = data->snap) != NULL)
+		++snap->refs;
+
+	pthread_mutex_unlock(&data->mutex);
+	systemd_snapshot_free(stale);
+	pthread_setcancelstate(cstate, NULL);
+
+	return snap;
+}
+
+static void systemd_snapshot_put(struct systemd_probe_data *data, struct systemd_snapshot *snap)
+{
+	bool last;
+	int cstate;
+
+	pthread_setcancelstate(PTHREAD_CANCEL_DISABLE, &cstate);
+	pthread_mutex_lock(&data->mutex);
+	last = --snap->refs == 0;
+	pthread_mutex_unlock(&data->mutex);
+
+	if (last)
+		systemd_snapshot_free(snap);
+
+	pthread_setcancelstate(cstate, NULL);
+}
+
+static struct systemd_unit *systemd_snapshot_add(struct systemd_snapshot *snap, const char *name, const char *path)
+{
+	struct systemd_unit *unit = oscap_talloc(struct systemd_unit);
+
+	memset(unit, 0, sizeof(struct systemd_unit));
+	unit->name = oscap_strdup(name);
+	unit->path = oscap_strdup(path);
+
+	if (rbt_str_add(snap->units, unit->name, unit) != 0) {
+		dI("Duplicate unit '%s' in the snapshot.\n", name);
+		systemd_unit_free(unit);
+		return NULL;
+	}
+
+	return unit;
+}
+
+static struct systemd_unit *systemd_snapshot_get(struct systemd_snapshot *snap, const char *name)
+{
+	struct systemd_unit *unit = NULL;
+
+	if (rbt_str_get(snap->units, name, (void *)&unit) != 0)
+		return NULL;
+
+	return unit;
+}
+
+static struct systemd_property *systemd_unit_property(struct systemd_unit *unit, const char *name)
+{
+	size_t i;
+
+	for (i = 0; i < unit->prop_count; ++i)
+		if (strcmp(unit->props[i].name, name) == 0)
+			return unit->props + i;
+
+	return NULL;
+}
+
+static void systemd_property_add_value(struct systemd_property *prop, char *value)
+{
+	prop->values = oscap_realloc(prop->values, sizeof(char *) * (prop->count + 1));
+	prop->values[prop->count++] = value;
+}
+
+/*
+ * Store the properties from a GetAll reply in the unit.
+ */
+static int systemd_unit_set_properties(struct systemd_unit *unit, DBusMessage *msg)
+{
+	DBusMessageIter args, property_iter;
+
+	unit->props_done = true;
+
+	if (!dbus_message_iter_init(msg, &args)) {
+		dI("Failed to initialize iterator over received dbus message.\n");
+		return 1;
+	}
+
+	if (dbus_message_iter_get_arg_type(&args) != DBUS_TYPE_ARRAY && dbus_message_iter_get_element_type(&args) != DBUS_TYPE_DICT_ENTRY) {
+		dI("Expected array of dict_entry argument in reply. Instead received: %s.\n", dbus_message_type_to_string(dbus_message_iter_get_arg_type(&args)));
+		return 1;
+	}
+
+	dbus_message_iter_recurse(&args, &property_iter);
+	do {
+		DBusMessageIter dict_entry, value_variant;
+		dbus_message_iter_recurse(&property_iter, &dict_entry);
+
+		if (dbus_message_iter_get_arg_type(&dict_entry) != DBUS_TYPE_STRING) {
+			dI("Expected string as key in dict_entry. Instead received: %s.\n", dbus_message_type_to_string(dbus_message_iter_get_arg_type(&dict_entry)));
+			return 1;
+		}
+
+		_DBusBasicValue value;
+		dbus_message_iter_get_basic(&dict_entry, &value);
+
+		if (dbus_message_iter_next(&dict_entry) == false) {
+			dW("Expected another field in dict_entry.");
+			return 1;
+		}
+
+		if (dbus_message_iter_get_arg_type(&dict_entry) != DBUS_TYPE_VARIANT) {
+			dI("Expected variant as value in dict_entry. Instead received: %s.\n", dbus_message_type_to_string(dbus_message_iter_get_arg_type(&dict_entry)));
+			return 1;
+		}
+
+		unit->props = oscap_realloc(unit->props, sizeof(struct systemd_property) * (unit->prop_count + 1));
+
+		struct systemd_property *prop = unit->props + unit->prop_count++;
+
+		prop->name = oscap_strdup(value.str);
+		prop->count = 0;
+		prop->values = NULL;
+
+		dbus_message_iter_recurse(&dict_entry, &value_variant);
+
+		// DBUS_TYPE_ARRAY is a special case, each element is one value
+		if (dbus_message_iter_get_arg_type(&value_variant) == DBUS_TYPE_ARRAY) {
+			DBusMessageIter array;
+			dbus_message_iter_recurse(&value_variant, &array);
+
+			do {
+				char *element = dbus_value_to_string(&array);
+				if (element == NULL)
+					continue;
+
+				systemd_property_add_value(prop, element);
+			}
+			while (dbus_message_iter_next(&array));
+		}
+		else
+			systemd_property_add_value(prop, dbus_value_to_string(&value_variant));
+	}
+	while (dbus_message_iter_next(&property_iter));
+
+	return 0;
+}
+
+static DBusPendingCall *systemd_getall_send(DBusConnection *conn, const char *unit_path)
+{
+	DBusMessage *msg;
+	DBusPendingCall *pending = NULL;
+	DBusMessageIter args;
+	const char *interface = "org.freedesktop.systemd1.Unit";
+
+	msg = dbus_message_new_method_call(
+		"org.freedesktop.systemd1",
+		unit_path,
+		"org.freedesktop.DBus.Properties",
+		"GetAll"
+	);
+	if (msg == NULL) {
+		dI("Failed to create dbus_message via dbus_message_new_method_call!\n");
+		return NULL;
+	}
+
+	dbus_message_iter_init_append(msg, &args);
+	if (!dbus_message_iter_append_basic(&args, DBUS_TYPE_STRING, &interface)) {
+		dI("Failed to append interface '%s' string parameter to dbus message!\n", interface);
+		dbus_message_unref(msg);
+		return NULL;
+	}
+
+	if (!dbus_connection_send_with_reply(conn, msg, &pending, -1) || pending == NULL)
+		dI("Failed to send message via dbus!\n");
+
+	dbus_message_unref(msg);
+
+	return pending;
+}
+
+static DBusMessage *systemd_reply_wait(DBusPendingCall *pending)
+{
+	DBusMessage *msg;
+
+	dbus_pending_call_block(pending);
+	msg = dbus_pending_call_steal_reply(pending);
+	dbus_pending_call_unref(pending);
+
+	if (msg == NULL) {
+		dI("Failed to steal dbus pending call reply.\n");
+		return NULL;
+	}
+
+	if (dbus_message_get_type(msg) == DBUS_MESSAGE_TYPE_ERROR) {
+		dI("Received dbus error reply: %s.\n", dbus_message_get_error_name(msg));
+		dbus_message_unref(msg);
+		return NULL;
+	}
+
+	return msg;
+}
+
+/*
+ * Get the properties of the units. Up to SYSTEMD_PIPELINE_DEPTH calls
+ * are in flight, so the replies are processed while systemd handles
+ * the following calls.
+ */
+static void systemd_units_get_properties(DBusConnection *conn, struct systemd_unit **units, size_t count)
+{
+	DBusPendingCall *pending[SYSTEMD_PIPELINE_DEPTH];
+	DBusMessage *msg;
+	size_t sent = 0, done = 0;
+
+	while (done < count) {
+		while (sent < count && sent - done < SYSTEMD_PIPELINE_DEPTH) {
+			pending[sent % SYSTEMD_PIPELINE_DEPTH] = systemd_getall_send(conn, units[sent]->path);
+			++sent;
+		}
+
+		dbus_connection_flush(conn);
+
+		if (pending[done % SYSTEMD_PIPELINE_DEPTH] != NULL &&
+		    (msg = systemd_reply_wait(pending[done % SYSTEMD_PIPELINE_DEPTH])) != NULL) {
+			systemd_unit_set_properties(units[done], msg);
+			dbus_message_unref(msg);
+		}
+
+		units[done]->props_done = true;
+		++done;
+	}
+}
+
+static int systemd_list_units(struct systemd_snapshot *snap, DBusConnection *conn)
+{
+	DBusMessage *msg = NULL;
+	DBusPendingCall *pending = NULL;
+	DBusMessageIter args, unit_iter;
+	int ret = 1;
+
+	msg = dbus_message_new_method_call(
+		"org.freedesktop.systemd1",
+		"/org/freedesktop/systemd1",
+		"org.freedesktop.systemd1.Manager",
+		"ListUnits"
+	);
+	if (msg == NULL) {
+		dI("Failed to create dbus_message via dbus_message_new_method_call!\n");
+		return 1;
+	}
+
+	if (!dbus_connection_send_with_reply(conn, msg, &pending, -1) || pending == NULL) {
+		dI("Failed to send message via dbus!\n");
+		dbus_message_unref(msg);
+		return 1;
+	}
+
+	dbus_connection_flush(conn);
+	dbus_message_unref(msg);
+
+	if ((msg = systemd_reply_wait(pending)) == NULL)
+		return 1;
+
+	if (!dbus_message_iter_init(msg, &args)) {
+		dI("Failed to initialize iterator over received dbus message.\n");
+		goto cleanup;
+	}
+
+	if (dbus_message_iter_get_arg_type(&args) != DBUS_TYPE_ARRAY) {
+		dI("Expected array of structs in reply. Instead received: %s.\n", dbus_message_type_to_string(dbus_message_iter_get_arg_type(&args)));
+		goto cleanup;
+	}
+
+	dbus_message_iter_recurse(&args, &unit_iter);
+
+	if (dbus_message_iter_get_arg_type(&unit_iter) == DBUS_TYPE_INVALID) {
+		ret = 0;
+		goto cleanup;
+	}
+
+	do {
+		DBusMessageIter field;
+		_DBusBasicValue name, path;
+		int i;
+
+		if (dbus_message_iter_get_arg_type(&unit_iter) != DBUS_TYPE_STRUCT) {
+			dI("Expected unit struct as elements in returned array. Instead received: %s.\n", dbus_message_type_to_string(dbus_message_iter_get_arg_type(&unit_iter)));
+			goto cleanup;
+		}
+
+		dbus_message_iter_recurse(&unit_iter, &field);
+
+		if (dbus_message_iter_get_arg_type(&field) != DBUS_TYPE_STRING) {
+			dI("Expected string as the first element in the unit struct. Instead received: %s.\n", dbus_message_type_to_string(dbus_message_iter_get_arg_type(&field)));
+			goto cleanup;
+		}
+
+		dbus_message_iter_get_basic(&field, &name);
+
+		// the unit object path is the 7th element of the struct
+		for (i = 0; i < 6; ++i)
+			dbus_message_iter_next(&field);
+
+		if (dbus_message_iter_get_arg_type(&field) != DBUS_TYPE_OBJECT_PATH) {
+			dI("Expected object path as the 7th element in the unit struct. Instead received: %s.\n", dbus_message_type_to_string(dbus_message_iter_get_arg_type(&field)));
+			goto cleanup;
+		}
+
+		dbus_message_iter_get_basic(&field, &path);
+
+		struct systemd_unit *unit = systemd_snapshot_add(snap, name.str, path.str);
+
+		if (unit != NULL) {
+			snap->order = oscap_realloc(snap->order, sizeof(struct systemd_unit *) * (snap->count + 1));
+			snap->order[snap->count++] = unit;
+		}
+	}
+	while (dbus_message_iter_next(&unit_iter));
+
+	ret = 0;
+
+cleanup:
+	dbus_message_unref(msg);
+
+	return ret;
+}
+
+/*
+ * Take the snapshot unless it has been already taken. Properties are
+ * fetched only for the units accepted by the filter (all if it's NULL),
+ * the others can be fetched later by systemd_snapshot_load.
+ */
+static int systemd_snapshot_take(struct systemd_snapshot *snap, DBusConnection *conn, bool (*filter)(const char *unit))
+{
+	struct systemd_unit **units;
+	size_t i, count;
+	int ret = 0, cstate;
+
+	pthread_setcancelstate(PTHREAD_CANCEL_DISABLE, &cstate);
+	pthread_mutex_lock(&snap->mutex);
+
+	if (snap->taken)
+		goto cleanup;
+
+	if (systemd_list_units(snap, conn) != 0) {
+		ret = 1;
+		goto cleanup;
+	}
+
+	units = oscap_alloc(sizeof(struct systemd_unit *) * (snap->count + 1));
+
+	for (i = count = 0; i < snap->count; ++i)
+		if (filter == NULL || filter(snap->order[i]->name))
+			units[count++] = snap->order[i];
+
+	systemd_units_get_properties(conn, units, count);
+	oscap_free(units);
+
+	dI("Taken a snapshot of %zu systemd units, %zu with properties.\n", snap->count, count);
+	snap->taken = true;
+
+cleanup:
+	pthread_mutex_unlock(&snap->mutex);
+	pthread_setcancelstate(cstate, NULL);
+
+	return ret;
+}
+
+/*
+ * Get a unit with its properties, loading it if it isn't in the snapshot,
+ * e.g. because it's not active. Has to be called with snap->mutex locked.
+ * Without a connection, only the units in the snapshot are returned.
+ */
+static struct systemd_unit *systemd_snapshot_load(struct systemd_snapshot *snap, DBusConnection *conn, const char *name)
+{
+	struct systemd_unit *unit;
+	DBusPendingCall *pending;
+	DBusMessage *msg;
+	char *path;
+
+	if ((unit = systemd_snapshot_get(snap, name)) == NULL) {
+		if (conn == NULL)
+			return NULL;
+
+		if ((path = get_path_by_unit(conn, name)) == NULL)
+			return NULL;
+
+		unit = systemd_snapshot_add(snap, name, path);
+		oscap_free(path);
+
+		if (unit == NULL)
+			return NULL;
+	}
+
+	if (!unit->props_done && conn != NULL) {
+		if ((pending = systemd_getall_send(conn, unit->path)) != NULL) {
+			dbus_connection_flush(conn);
+
+			if ((msg = systemd_reply_wait(pending)) != NULL) {
+				systemd_unit_set_properties(unit, msg);
+				dbus_message_unref(msg);
+			}
+		}
+
+		unit->props_done = true;
+	}
+
+	return unit;
+}
@@ -32,91 +32,17 @@
 
 #include <probe-api.h>
 #include "probe/entcmp.h"
+#include "probe/probe.h"
+#include "probe/option.h"
 #include "systemdshared.h"
-#include "common/list.h"
+#include "systemdoffline.h"
 #include <string.h>
 
-static char *get_property_by_unit_path(DBusConnection *conn, const char *unit_path, const char *property)
-{
-	DBusMessage *msg = NULL;
-	DBusPendingCall *pending = NULL;
-	char *ret = NULL;
-
-	msg = dbus_message_new_method_call(
-		"org.freedesktop.systemd1",
-		unit_path,
-		"org.freedesktop.DBus.Properties",
-		"Get"
-	);
-	if (msg == NULL) {
-		dI("Failed to create dbus_message via dbus_message_new_method_call!\n");
-		goto cleanup;
-	}
-
-	DBusMessageIter args, value_iter;
-
-	const char *interface = "org.freedesktop.systemd1.Unit";
-
-	dbus_message_iter_init_append(msg, &args);
-	if (!dbus_message_iter_append_basic(&args, DBUS_TYPE_STRING, &interface)) {
-		dI("Failed to append interface '%s' string parameter to dbus message!\n", interface);
-		goto cleanup;
-	}
-	if (!dbus_message_iter_append_basic(&args, DBUS_TYPE_STRING, &property)) {
-		dI("Failed to append property '%s' string parameter to dbus message!\n", property);
-		goto cleanup;
-	}
-
-	if (!dbus_connection_send_with_reply(conn, msg, &pending, -1)) {
-		dI("Failed to send message via dbus!\n");
-		goto cleanup;
-	}
-	if (pending == NULL) {
-		dI("Invalid dbus pending call!\n");
-		goto cleanup;
-	}
-
-	dbus_connection_flush(conn);
-	dbus_message_unref(msg); msg = NULL;
-
-	dbus_pending_call_block(pending);
-	msg = dbus_pending_call_steal_reply(pending);
-	if (msg == NULL) {
-		dI("Failed to steal dbus pending call reply.\n");
-		goto cleanup;
-	}
-	dbus_pending_call_unref(pending); pending = NULL;
-
-	if (!dbus_message_iter_init(msg, &args)) {
-		dI("Failed to initialize iterator over received dbus message.\n");
-		goto cleanup;
-	}
-
-	if (dbus_message_iter_get_arg_type(&args) != DBUS_TYPE_VARIANT)
-	{
-		dI("Expected variant argument in reply. Instead received: %s.\n", dbus_message_type_to_string(dbus_message_iter_get_arg_type(&args)));
-		goto cleanup;
-	}
-
-	dbus_message_iter_recurse(&args, &value_iter);
-	ret = dbus_value_to_string(&value_iter);
-
-	dbus_message_unref(msg); msg = NULL;
-
-cleanup:
-	if (pending != NULL)
-		dbus_pending_call_unref(pending);
-
-	if (msg != NULL)
-		dbus_message_unref(msg);
-
-	return ret;
-}
-
 struct unit_callback_vars {
 	DBusConnection *dbus_conn;
 	probe_ctx *ctx;
 	SEXP_t *unit_entity;
+	struct systemd_snapshot *snap;
 };
 
 static bool is_unit_name_a_target(const char *unit)
@@ -134,8 +60,24 @@ static bool is_unit_name_a_target(const char *unit)
 	return strncmp(unit + len - suffix_len, suffix, suffix_len) == 0;
 }
 
-static void get_all_dependencies_by_unit(DBusConnection *conn, const char *unit, int(*callback)(const char *, void *), void *cbarg, bool include_requires, bool include_wants)
+static void closure_add(struct systemd_unit *unit, const char *dependency)
 {
+	unit->closure = oscap_realloc(unit->closure, sizeof(char *) * (unit->closure_count + 1));
+	unit->closure[unit->closure_count++] = oscap_strdup(dependency);
+}
+
+/*
+ * Add the dependencies of the unit and recursively the dependencies of
+ * the targets among them to the closure of the root unit. Every unit is
+ * added once, which also stops the recursion on dependency cycles.
+ */
+static void get_all_dependencies_by_unit(struct unit_callback_vars *vars, struct systemd_unit *root, const char *unit, rbt_t *seen)
+{
+	static const char *dependency_props[] = { "Requires", "Wants", NULL };
+	struct systemd_unit *u;
+	struct systemd_property *prop;
+	size_t i, j;
+
 	if (!unit || strcmp(unit, "(null)") == 0)
 		return;
 
@@ -143,96 +85,108 @@ static void get_all_dependencies_by_unit(DBusConnection *conn, const char *unit,
 	if (!is_unit_name_a_target(unit))
 		return;
 
-	char *path = get_path_by_unit(conn, unit);
-
-	if (include_requires) {
-		char *requires_s = get_property_by_unit_path(conn, path, "Requires");
-		if (requires_s) {
-			char **requires = oscap_split(requires_s, ", ");
-			for (int i = 0; requires[i] != NULL; ++i) {
-				if (oscap_strcmp(requires[i], "") == 0)
-					continue;
-
-				if (callback(requires[i], cbarg) == 0) {
-					get_all_dependencies_by_unit(conn, requires[i],
-									callback, cbarg,
-									include_requires, include_wants);
-				} else {
-					oscap_free(requires);
-					oscap_free(requires_s);
-					oscap_free(path);
-					return;
-				}
-			}
-			oscap_free(requires);
-		}
-		oscap_free(requires_s);
-	}
+	if ((u = systemd_snapshot_load(vars->snap, vars->dbus_conn, unit)) == NULL)
+		return;
+
+	for (i = 0; dependency_props[i] != NULL; ++i) {
+		if ((prop = systemd_unit_property(u, dependency_props[i])) == NULL)
+			continue;
+
+		for (j = 0; j < prop->count; ++j) {
+			const char *dependency = prop->values[j];
+
+			if (dependency == NULL || oscap_strcmp(dependency, "") == 0)
+				continue;
 
-	if (include_wants) {
-		char *wants_s = get_property_by_unit_path(conn, path, "Wants");
-		if (wants_s)
-		{
-			char **wants = oscap_split(wants_s, ", ");
-			for (int i = 0; wants[i] != NULL; ++i) {
-				if (oscap_strcmp(wants[i], "") == 0)
-					continue;
-
-				if (callback(wants[i], cbarg) == 0) {
-					get_all_dependencies_by_unit(conn, wants[i],
-									callback, cbarg,
-									include_requires, include_wants);
-				} else {
-					oscap_free(wants);
-					oscap_free(wants_s);
-					oscap_free(path);
-					return;
-				}
-			}
-			oscap_free(wants);
+			if (rbt_str_add(seen, (char *)dependency, NULL) != 0)
+				continue;
+
+			closure_add(root, dependency);
+			get_all_dependencies_by_unit(vars, root, dependency, seen);
 		}
-		oscap_free(wants_s);
 	}
+}
 
-	oscap_free(path);
+static void seen_free_cb(struct rbt_str_node *n)
+{
+	/* the keys are owned by the snapshot */
 }
 
-static int dependency_callback(const char *dependency, void *cbarg)
+/*
+ * Get the dependency closure of the unit, it's computed once and kept
+ * in the snapshot.
+ */
+static void unit_closure(struct unit_callback_vars *vars, struct systemd_unit *unit)
 {
-	SEXP_t *item = (SEXP_t *)cbarg;
-	SEXP_t *se_dependency = SEXP_string_new(dependency, strlen(dependency));
-	probe_item_ent_add(item, "dependency", NULL, se_dependency);
-	return 0;
+	int cstate;
+
+	pthread_setcancelstate(PTHREAD_CANCEL_DISABLE, &cstate);
+	pthread_mutex_lock(&vars->snap->mutex);
+
+	if (!unit->closure_done) {
+		rbt_t *seen = rbt_str_new();
+
+		get_all_dependencies_by_unit(vars, unit, unit->name, seen);
+		rbt_str_free_cb(seen, &seen_free_cb);
+		unit->closure_done = true;
+	}
+
+	pthread_mutex_unlock(&vars->snap->mutex);
+	pthread_setcancelstate(cstate, NULL);
 }
 
-static int unit_callback(const char *unit, void *cbarg)
+static void unit_collect(struct systemd_unit *unit, struct unit_callback_vars *vars)
 {
-	struct unit_callback_vars *vars = (struct unit_callback_vars *)cbarg;
-	SEXP_t *se_unit = SEXP_string_new(unit, strlen(unit));
+	SEXP_t *se_unit = SEXP_string_new(unit->name, strlen(unit->name));
+	size_t i;
 
 	if (probe_entobj_cmp(vars->unit_entity, se_unit) != OVAL_RESULT_TRUE) {
 		/* Do nothing, continue with the next unit */
 		SEXP_free(se_unit);
-		return 0;
+		return;
 	}
 
 	SEXP_t *item = probe_item_create(OVAL_LINUX_SYSTEMDUNITDEPENDENCY, NULL,
 					 "unit", OVAL_DATATYPE_SEXP, se_unit,
 					 NULL);
 
-	get_all_dependencies_by_unit(vars->dbus_conn, unit,
-				     dependency_callback, item, true, true);
+	unit_closure(vars, unit);
+
+	for (i = 0; i < unit->closure_count; ++i) {
+		SEXP_t *se_dependency = SEXP_string_new(unit->closure[i], strlen(unit->closure[i]));
+		probe_item_ent_add(item, "dependency", NULL, se_dependency);
+		SEXP_free(se_dependency);
+	}
 
 	probe_item_collect(vars->ctx, item);
 	SEXP_free(se_unit);
+}
+
+void *probe_init(void)
+{
+	probe_offline_flags offline_mode = PROBE_OFFLINE_NONE;
 
-	return 0;
+	probe_setoption(PROBEOPT_OFFLINE_MODE_SUPPORTED, PROBE_OFFLINE_CHROOT);
+	probe_getoption(PROBEOPT_OFFLINE_MODE_SUPPORTED, NULL, &offline_mode);
+
+	return systemd_probe_data_new((offline_mode & PROBE_OFFLINE_CHROOT) != 0);
+}
+
+void probe_fini(void *probe_arg)
+{
+	systemd_probe_data_free(probe_arg);
 }
 
 int probe_main(probe_ctx *ctx, void *probe_arg)
 {
+	struct systemd_probe_data *data = probe_arg;
+	struct systemd_snapshot *snap;
 	SEXP_t *unit_entity, *probe_in;
 	oval_version_t oval_version;
+	size_t i;
+
+	if (data == NULL)
+		return PROBE_EINIT;
 
 	probe_in = probe_ctx_getobject(ctx);
 	oval_version = probe_obj_get_schema_version(probe_in);
@@ -242,15 +196,20 @@ int probe_main(probe_ctx *ctx, void *probe_arg)
 		return PROBE_EOPNOTSUPP;
 	}
 
-	DBusError dbus_error;
-	DBusConnection *dbus_conn;
+	DBusConnection *dbus_conn = NULL;
+
+	if (!data->offline) {
+		dbus_conn = connect_dbus();
+
+		if (dbus_conn == NULL)
+			return PROBE_ESYSTEM;
+	}
 
-	dbus_error_init(&dbus_error);
-	dbus_conn = connect_dbus();
+	if ((snap = systemd_snapshot_get_current(data, probe_ctx_getcachegen(ctx))) == NULL) {
+		if (dbus_conn != NULL)
+			disconnect_dbus(dbus_conn);
 
-	if (dbus_conn == NULL) {
-		dbus_error_free(&dbus_error);
-		return PROBE_ESYSTEM;
+		return PROBE_ENOMEM;
 	}
 
 	unit_entity = probe_obj_getent(probe_in, "unit", 1);
@@ -260,12 +219,20 @@ int probe_main(probe_ctx *ctx, void *probe_arg)
 	vars.dbus_conn = dbus_conn;
 	vars.ctx = ctx;
 	vars.unit_entity = unit_entity;
+	vars.snap = snap;
 
-	get_all_systemd_units(dbus_conn, unit_callback, &vars);
+	// only targets have their dependencies reported
+	if ((snap->offline ? systemd_offline_take(snap, "") : systemd_snapshot_take(snap, dbus_conn, is_unit_name_a_target)) == 0) {
+		for (i = 0; i < snap->count; ++i)
+			unit_collect(snap->order[i], &vars);
+	}
 
 	SEXP_free(unit_entity);
-	dbus_error_free(&dbus_error);
-	disconnect_dbus(dbus_conn);
+
+	systemd_snapshot_put(data, snap);
+
+	if (dbus_conn != NULL)
+		disconnect_dbus(dbus_conn);
 
         return 0;
 }
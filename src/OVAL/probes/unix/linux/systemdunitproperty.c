@@ -33,228 +33,87 @@
 #include <probe-api.h>
 #include <string.h>
 #include "probe/entcmp.h"
+#include "probe/probe.h"
+#include "probe/option.h"
 #include "systemdshared.h"
+#include "systemdoffline.h"
 
-static int get_all_properties_by_unit_path(DBusConnection *conn, const char *unit_path, int(*callback)(const char *name, const char *value, void *arg), void *cbarg)
-{
-	int ret = 1;
-	DBusMessage *msg = NULL;
-	DBusPendingCall *pending = NULL;
-
-	msg = dbus_message_new_method_call(
-		"org.freedesktop.systemd1",
-		unit_path,
-		"org.freedesktop.DBus.Properties",
-		"GetAll"
-	);
-	if (msg == NULL) {
-		dI("Failed to create dbus_message via dbus_message_new_method_call!\n");
-		goto cleanup;
-	}
-
-	DBusMessageIter args, property_iter;
-
-	const char *interface = "org.freedesktop.systemd1.Unit";
-
-	dbus_message_iter_init_append(msg, &args);
-	if (!dbus_message_iter_append_basic(&args, DBUS_TYPE_STRING, &interface)) {
-		dI("Failed to append interface '%s' string parameter to dbus message!\n", interface);
-		goto cleanup;
-	}
-
-	if (!dbus_connection_send_with_reply(conn, msg, &pending, -1)) {
-		dI("Failed to send message via dbus!\n");
-		goto cleanup;
-	}
-	if (pending == NULL) {
-		dI("Invalid dbus pending call!\n");
-		goto cleanup;
-	}
-
-	dbus_connection_flush(conn);
-	dbus_message_unref(msg); msg = NULL;
-
-	dbus_pending_call_block(pending);
-	msg = dbus_pending_call_steal_reply(pending);
-	if (msg == NULL) {
-		dI("Failed to steal dbus pending call reply.\n");
-		goto cleanup;
-	}
-	dbus_pending_call_unref(pending); pending = NULL;
+struct unit_callback_vars {
+	probe_ctx *ctx;
+	SEXP_t *unit_entity;
+	SEXP_t *property_entity;
+};
 
-	if (!dbus_message_iter_init(msg, &args)) {
-		dI("Failed to initialize iterator over received dbus message.\n");
-		goto cleanup;
-	}
+static void unit_collect(struct systemd_unit *unit, struct unit_callback_vars *vars)
+{
+	SEXP_t *se_unit = SEXP_string_new(unit->name, strlen(unit->name));
+	size_t i, j;
 
-	if (dbus_message_iter_get_arg_type(&args) != DBUS_TYPE_ARRAY && dbus_message_iter_get_element_type(&args) != DBUS_TYPE_DICT_ENTRY) {
-		dI("Expected array of dict_entry argument in reply. Instead received: %s.\n", dbus_message_type_to_string(dbus_message_iter_get_arg_type(&args)));
-		goto cleanup;
+	if (probe_entobj_cmp(vars->unit_entity, se_unit) != OVAL_RESULT_TRUE) {
+		/* Do nothing, continue with the next unit */
+		SEXP_free(se_unit);
+		return;
 	}
 
-	dbus_message_iter_recurse(&args, &property_iter);
-	do {
-		DBusMessageIter dict_entry, value_variant;
-		dbus_message_iter_recurse(&property_iter, &dict_entry);
-
-		if (dbus_message_iter_get_arg_type(&dict_entry) != DBUS_TYPE_STRING) {
-			dI("Expected string as key in dict_entry. Instead received: %s.\n", dbus_message_type_to_string(dbus_message_iter_get_arg_type(&dict_entry)));
-			goto cleanup;
-		}
+	for (i = 0; i < unit->prop_count; ++i) {
+		struct systemd_property *prop = unit->props + i;
 
-		_DBusBasicValue value;
-		dbus_message_iter_get_basic(&dict_entry, &value);
-		char *property_name = oscap_strdup(value.str);
+		// properties with an empty array value have no items
+		if (prop->count == 0)
+			continue;
 
-		if (dbus_message_iter_next(&dict_entry) == false) {
-			dW("Expected another field in dict_entry.");
-			oscap_free(property_name);
-			goto cleanup;
-		}
+		SEXP_t *se_property = SEXP_string_new(prop->name, strlen(prop->name));
 
-		if (dbus_message_iter_get_arg_type(&dict_entry) != DBUS_TYPE_VARIANT) {
-			dI("Expected variant as value in dict_entry. Instead received: %s.\n", dbus_message_type_to_string(dbus_message_iter_get_arg_type(&dict_entry)));
-			oscap_free(property_name);
-			goto cleanup;
+		if (probe_entobj_cmp(vars->property_entity, se_property) != OVAL_RESULT_TRUE) {
+			SEXP_free(se_property);
+			continue;
 		}
 
-		dbus_message_iter_recurse(&dict_entry, &value_variant);
-
-		int cbret = 0;
-		const int arg_type = dbus_message_iter_get_arg_type(&value_variant);
-		// DBUS_TYPE_ARRAY is a special case, we report each element as one value entry
-		if (arg_type == DBUS_TYPE_ARRAY) {
-			DBusMessageIter array;
-			dbus_message_iter_recurse(&value_variant, &array);
-
-			do {
-				char *element = dbus_value_to_string(&array);
-				if (element == NULL)
-					continue;
+		SEXP_t *item = probe_item_create(OVAL_LINUX_SYSTEMDUNITPROPERTY, NULL,
+						 "unit", OVAL_DATATYPE_SEXP, se_unit,
+						 "property", OVAL_DATATYPE_SEXP, se_property,
+						 "value", OVAL_DATATYPE_STRING, prop->values[0],
+						 NULL);
 
-				const int elementcbret = callback(property_name, element, cbarg);
-				if (elementcbret > cbret)
-					cbret = elementcbret;
-
-				oscap_free(element);
-			}
-			while (dbus_message_iter_next(&array));
-		}
-		else {
-			char *property_value = dbus_value_to_string(&value_variant);
-			cbret = callback(property_name, property_value, cbarg);
-			oscap_free(property_value);
-		}
-
-		oscap_free(property_name);
-		if (cbret != 0) {
-			goto cleanup;
-		}
-	}
-	while (dbus_message_iter_next(&property_iter));
-
-	dbus_message_unref(msg); msg = NULL;
-	ret = 0;
-
-cleanup:
-	if (pending != NULL)
-		dbus_pending_call_unref(pending);
-
-	if (msg != NULL)
-		dbus_message_unref(msg);
-
-	return ret;
-}
-
-struct unit_callback_vars {
-	DBusConnection *dbus_conn;
-	probe_ctx *ctx;
-	SEXP_t *unit_entity;
-	SEXP_t *property_entity;
-	SEXP_t *se_unit;
-	SEXP_t *se_property;
-	SEXP_t *item;
-};
-
-static int property_callback(const char *property, const char *value, void *cbarg)
-{
-	struct unit_callback_vars *vars = (struct unit_callback_vars *)cbarg;
-
-	if (vars->se_property != NULL) {
-		//
-		// Compare the previously matched entity to the current one
-		// If they are the same, continue to fill the current item
-		// with property values. If not, collect the item and create
-		// a new one for the current property.
-		//
-		if (SEXP_strcmp(vars->se_property, property) == 0) {
-			SEXP_t *se_value = SEXP_string_new(value, strlen(value));
-			probe_item_ent_add(vars->item, "value", NULL, se_value);
+		// every element of an array is reported as one value entity
+		for (j = 1; j < prop->count; ++j) {
+			SEXP_t *se_value = SEXP_string_new(prop->values[j], strlen(prop->values[j]));
+			probe_item_ent_add(item, "value", NULL, se_value);
 			SEXP_free(se_value);
-			return 0;
-		} else {
-			probe_item_collect(vars->ctx, vars->item);
-			vars->item = NULL;
-			SEXP_free(vars->se_property);
-			vars->se_property = NULL;
 		}
-	}
-
-	SEXP_t *se_property = SEXP_string_new(property, strlen(property));
 
-	if (probe_entobj_cmp(vars->property_entity, se_property) != OVAL_RESULT_TRUE) {
+		probe_item_collect(vars->ctx, item);
 		SEXP_free(se_property);
-		return 0;
 	}
 
-	vars->se_property = se_property;
-	vars->item = probe_item_create(OVAL_LINUX_SYSTEMDUNITPROPERTY, NULL,
-				       "unit", OVAL_DATATYPE_SEXP, vars->se_unit,
-				       "property", OVAL_DATATYPE_SEXP, vars->se_property,
-				       "value", OVAL_DATATYPE_STRING, value,
-				       NULL);
-	return 0;
+	SEXP_free(se_unit);
 }
 
-static int unit_callback(const char *unit, void *cbarg)
+void *probe_init(void)
 {
-	struct unit_callback_vars *vars = (struct unit_callback_vars *)cbarg;
-	SEXP_t *se_unit = SEXP_string_new(unit, strlen(unit));
+	probe_offline_flags offline_mode = PROBE_OFFLINE_NONE;
 
-	if (probe_entobj_cmp(vars->unit_entity, se_unit) != OVAL_RESULT_TRUE) {
-		/* Do nothing, continue with the next unit */
-		SEXP_free(se_unit);
-		return 0;
-	}
-
-	vars->se_unit = se_unit;
-	vars->se_property = NULL;
-	vars->item = NULL;
+	probe_setoption(PROBEOPT_OFFLINE_MODE_SUPPORTED, PROBE_OFFLINE_CHROOT);
+	probe_getoption(PROBEOPT_OFFLINE_MODE_SUPPORTED, NULL, &offline_mode);
 
-	char *unit_path = get_path_by_unit(vars->dbus_conn, unit);
-
-	if (unit_path == NULL) {
-		return 1;
-	}
-
-	get_all_properties_by_unit_path(vars->dbus_conn, unit_path,
-					property_callback, vars);
-
-	if (vars->item != NULL) {
-		probe_item_collect(vars->ctx, vars->item);
-		vars->item = NULL;
-		SEXP_free(vars->se_property);
-		vars->se_property = NULL;
-	}
+	return systemd_probe_data_new((offline_mode & PROBE_OFFLINE_CHROOT) != 0);
+}
 
-	SEXP_free(se_unit);
-	return 0;
+void probe_fini(void *probe_arg)
+{
+	systemd_probe_data_free(probe_arg);
 }
 
 int probe_main(probe_ctx *ctx, void *probe_arg)
 {
+	struct systemd_probe_data *data = probe_arg;
+	struct systemd_snapshot *snap;
 	SEXP_t *unit_entity, *probe_in, *property_entity;
 	oval_version_t oval_version;
+	size_t i;
+
+	if (data == NULL)
+		return PROBE_EINIT;
 
 	probe_in = probe_ctx_getobject(ctx);
 	oval_version = probe_obj_get_schema_version(probe_in);
@@ -264,35 +123,44 @@ int probe_main(probe_ctx *ctx, void *probe_arg)
 		return PROBE_EOPNOTSUPP;
 	}
 
-	unit_entity = probe_obj_getent(probe_in, "unit", 1);
-	property_entity = probe_obj_getent(probe_in, "property", 1);
+	DBusConnection *dbus_conn = NULL;
+
+	if (!data->offline) {
+		dbus_conn = connect_dbus();
 
-	DBusError dbus_error;
-	DBusConnection *dbus_conn;
+		if (dbus_conn == NULL)
+			return PROBE_ESYSTEM;
+	}
 
-	dbus_error_init(&dbus_error);
-	dbus_conn = connect_dbus();
+	if ((snap = systemd_snapshot_get_current(data, probe_ctx_getcachegen(ctx))) == NULL) {
+		if (dbus_conn != NULL)
+			disconnect_dbus(dbus_conn);
 
-	if (dbus_conn == NULL) {
-		dbus_error_free(&dbus_error);
-		SEXP_free(property_entity);
-		SEXP_free(unit_entity);
-		return PROBE_ESYSTEM;
+		return PROBE_ENOMEM;
 	}
 
+	unit_entity = probe_obj_getent(probe_in, "unit", 1);
+	property_entity = probe_obj_getent(probe_in, "property", 1);
+
 	struct unit_callback_vars vars;
 
-	vars.dbus_conn = dbus_conn;
 	vars.ctx = ctx;
 	vars.unit_entity = unit_entity;
 	vars.property_entity = property_entity;
 
-	get_all_systemd_units(dbus_conn, unit_callback, &vars);
+	// the units listed by ListUnits are never modified after the snapshot is taken
+	if ((snap->offline ? systemd_offline_take(snap, "") : systemd_snapshot_take(snap, dbus_conn, NULL)) == 0) {
+		for (i = 0; i < snap->count; ++i)
+			unit_collect(snap->order[i], &vars);
+	}
 
 	SEXP_free(unit_entity);
 	SEXP_free(property_entity);
-	dbus_error_free(&dbus_error);
-	disconnect_dbus(dbus_conn);
+
+	systemd_snapshot_put(data, snap);
+
+	if (dbus_conn != NULL)
+		disconnect_dbus(dbus_conn);
 
 	return 0;
 }
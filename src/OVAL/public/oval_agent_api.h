@@ -72,6 +72,15 @@ struct oval_definition_model* oval_agent_get_definition_model(oval_agent_session
  */
 void oval_agent_set_product_name(oval_agent_session_t *, char *);
 
+/**
+ * Set the callback which is given the startup time of each probe started
+ * for the agent session before the evaluation.
+ * @param ag_sess agent session
+ * @param reporter startup time callback or NULL
+ * @param arg user pointer passed to the reporter
+ */
+void oval_agent_set_probe_startup_reporter(oval_agent_session_t *ag_sess, oval_probe_startup_reporter reporter, void *arg);
+
 /**
  * Probe the system and evaluate specified definition
  * @return 0 on success; -1 error; 1 warning
@@ -95,6 +104,14 @@ struct oval_result_definition * oval_agent_get_result_definition(oval_agent_sess
  */
 int oval_agent_reset_session(oval_agent_session_t * ag_sess);
 
+/**
+ * Stop the probes of the agent session, e.g. before the environment of the
+ * probes (OSCAP_PROBE_ROOT) changes. New probes are started on demand and
+ * the system information is queried again before the next definition is
+ * evaluated.
+ */
+int oval_agent_reset_probes(oval_agent_session_t *ag_sess);
+
 /**
  * Abort a running probe session
  */
@@ -34,6 +34,15 @@ typedef struct oval_probe_session oval_probe_session_t;
 
 #include "oval_probe_handler.h"
 #include "oval_system_characteristics.h"
+#include "oval_definitions.h"
+
+/**
+ * Probe startup time callback.
+ * @param probe_name name of the probe
+ * @param seconds time from the start of the probe until it was ready to process requests
+ * @param arg user pointer passed to oval_probe_session_prespawn
+ */
+typedef void (*oval_probe_startup_reporter)(const char *probe_name, double seconds, void *arg);
 
 /**
  * Create and initialize a new probe session
@@ -84,5 +93,20 @@ int oval_probe_session_sethandler(oval_probe_session_t *sess, oval_subtype_t typ
  */
 struct oval_syschar_model *oval_probe_session_getmodel(oval_probe_session_t *sess);
 
+/**
+ * Start the probes needed to collect the objects of a definition model
+ * before the evaluation. The probes are started together and initialize
+ * in parallel; the function returns when all of them are ready. Probes
+ * that fail to start are left to be started (and to report the error)
+ * on their first use.
+ * @param sess pointer to the probe session structure
+ * @param model definition model to be evaluated
+ * @param reporter startup time callback, called once for each started probe, or NULL
+ * @param arg user pointer passed to the reporter
+ * @return number of started probes or -1 on error
+ */
+int oval_probe_session_prespawn(oval_probe_session_t *sess, struct oval_definition_model *model,
+                                oval_probe_startup_reporter reporter, void *arg);
+
 #endif /* OVAL_PROBE_SESSION */
 /// @}
@@ -75,6 +75,19 @@ oval_result_t oval_evr_string_cmp(const char *state, const char *sys, oval_opera
 	return OVAL_RESULT_ERROR;
 }
 
+/* EVR strings shorter than this are parsed on the stack */
+#define EVR_BUFFER_SIZE 128
+
+static inline char *evr_copy(const char *evr, char *buffer, size_t size)
+{
+	size_t len = strlen(evr);
+
+	if (len >= size)
+		return oscap_strdup(evr);
+
+	return memcpy(buffer, evr, len + 1);
+}
+
 static inline int rpmevrcmp(const char *a, const char *b)
 {
 	/* This mimics rpmevrcmp which is not exported by rpmlib version 4.
@@ -82,11 +95,14 @@ static inline int rpmevrcmp(const char *a, const char *b)
 	 */
 	const char *a_epoch, *a_version, *a_release;
 	const char *b_epoch, *b_version, *b_release;
+	char a_buffer[EVR_BUFFER_SIZE], b_buffer[EVR_BUFFER_SIZE];
 	char *a_copy, *b_copy;
 	int result;
 
-	a_copy = oscap_strdup(a);
-	b_copy = oscap_strdup(b);
+	/* Bulk evaluation of patch feeds compares EVRs a lot, don't
+	 * allocate for the usual short ones */
+	a_copy = evr_copy(a, a_buffer, sizeof a_buffer);
+	b_copy = evr_copy(b, b_buffer, sizeof b_buffer);
 	parseEVR(a_copy, &a_epoch, &a_version, &a_release);
 	parseEVR(b_copy, &b_epoch, &b_version, &b_release);
 
@@ -97,8 +113,10 @@ static inline int rpmevrcmp(const char *a, const char *b)
 			result = compare_values(a_release, b_release);
 	}
 
-	oscap_free(a_copy);
-	oscap_free(b_copy);
+	if (a_copy != a_buffer)
+		oscap_free(a_copy);
+	if (b_copy != b_buffer)
+		oscap_free(b_copy);
 	return result;
 }
 
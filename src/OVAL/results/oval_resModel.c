@@ -165,6 +165,7 @@ int oval_results_model_import_source(struct oval_results_model *model, struct os
 	context.results_model = model;
 	context.definition_model = oval_results_model_get_definition_model(model);
 	context.user_data = NULL;
+	context.filter = NULL;
 	oscap_setxmlerr(xmlGetLastError());
 	/* jump into document */
 	xmlTextReaderRead(context.reader);
@@ -42,6 +42,7 @@
 #include "public/oval_agent_api.h"
 #include "common/util.h"
 #include "common/debug_priv.h"
+#include "common/metrics_priv.h"
 
 typedef struct oval_result_definition {
 	struct oval_definition *definition;
@@ -150,9 +151,13 @@ oval_result_t oval_result_definition_eval(struct oval_result_definition * defini
 
 	if (definition->result == OVAL_RESULT_NOT_EVALUATED) {
 		struct oval_result_criteria_node *criteria = oval_result_definition_get_criteria(definition);
+		struct oscap_metrics_sample stats;
 
+		oscap_metrics_start(&stats);
 		definition->result = (criteria == NULL)
 		    ? OVAL_RESULT_ERROR : oval_result_criteria_node_eval(criteria);
+		oscap_metrics_stop(&stats);
+		oscap_metrics_add(OSCAP_METRICS_DEFINITION, oval_result_definition_get_id(definition), &stats);
 	}
 	return definition->result;
 }
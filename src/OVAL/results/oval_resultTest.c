@@ -45,6 +45,7 @@
 #include "common/util.h"
 #include "common/debug_priv.h"
 #include "common/_error.h"
+#include "common/metrics_priv.h"
 
 typedef struct oval_result_test {
 	struct oval_result_system *system;
@@ -963,6 +964,10 @@ oval_result_t oval_result_test_eval(struct oval_result_test *rtest)
 	__attribute__nonnull__(rtest);
 
 	if (rtest->result == OVAL_RESULT_NOT_EVALUATED) {
+		struct oscap_metrics_sample stats;
+
+		oscap_metrics_start(&stats);
+
 		if ((oval_independent_subtype_t)oval_test_get_subtype(oval_result_test_get_test(rtest)) != OVAL_INDEPENDENT_UNKNOWN ) {
 			struct oval_string_map *tmp_map = oval_string_map_new();
 			void *args[] = { rtest->system, rtest, tmp_map };
@@ -975,6 +980,9 @@ oval_result_t oval_result_test_eval(struct oval_result_test *rtest)
 		}
 		else
 			rtest->result = OVAL_RESULT_UNKNOWN;
+
+		oscap_metrics_stop(&stats);
+		oscap_metrics_add(OSCAP_METRICS_TEST, oval_result_test_get_id(rtest), &stats);
 	}
 
         dI("\t%s => %s\n", oval_result_test_get_id(rtest), oval_result_get_text(rtest->result));
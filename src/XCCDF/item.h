@@ -167,6 +167,7 @@ struct xccdf_profile_item {
 	struct oscap_list *refine_values;
 	struct oscap_list *refine_rules;
 	bool tailoring;
+	unsigned int values_rev; ///< incremented when set-values or refine-values are added
 };
 
 struct xccdf_tailoring {
@@ -480,12 +480,26 @@ void xccdf_profile_free(struct xccdf_item *prof)
 	}
 }
 
+/* The adders of set-values and refine-values bump the revision, a policy
+ * keeps its own index of them and rebuilds it when the revision changes. */
+bool xccdf_profile_add_setvalue(struct xccdf_profile *profile, struct xccdf_setvalue *setvalue)
+{
+	++XITEM(profile)->sub.profile.values_rev;
+	return oscap_list_add(XITEM(profile)->sub.profile.setvalues, setvalue);
+}
+
+bool xccdf_profile_add_refine_value(struct xccdf_profile *profile, struct xccdf_refine_value *refine_value)
+{
+	++XITEM(profile)->sub.profile.values_rev;
+	return oscap_list_add(XITEM(profile)->sub.profile.refine_values, refine_value);
+}
+
 XCCDF_STATUS_CURRENT(profile)
 XCCDF_ACCESSOR_STRING(profile, note_tag)
 XCCDF_ACCESSOR_SIMPLE(profile, bool, tailoring)
 XCCDF_LISTMANIP(profile, select, selects)
-XCCDF_LISTMANIP(profile, setvalue, setvalues)
-XCCDF_LISTMANIP(profile, refine_value, refine_values)
+XCCDF_IGETTER(profile, setvalue, setvalues)
+XCCDF_IGETTER(profile, refine_value, refine_values)
 XCCDF_LISTMANIP(profile, refine_rule, refine_rules)
 XCCDF_ITERATOR_GEN_S(profile_note)
 XCCDF_ITERATOR_GEN_S(refine_value)
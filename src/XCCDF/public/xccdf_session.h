@@ -33,6 +33,7 @@
 #define XCCDF_SESSION_H_
 
 #include "xccdf_policy.h"
+#include "oval_probe_session.h"
 
 /**
  * Type of the function used to report progress of download.
@@ -224,6 +225,31 @@ void xccdf_session_set_check_engine_plugins_results_export(struct xccdf_session
  */
 OSCAP_DEPRECATED(void xccdf_session_set_sce_results_export(struct xccdf_session *session, bool to_export_sce_results));
 
+/**
+ * Set whether only the OVAL definitions referenced by the selected profile shall be
+ * loaded. The OVAL files are then parsed by @ref xccdf_session_evaluate, once the
+ * profile is known, and only the definitions referenced from the selected rules
+ * (and the tests, objects, states and variables they depend on) are built. The
+ * exported OVAL results then contain only those definitions. This function shall
+ * be called before OVAL files are loaded.
+ * @memberof xccdf_session
+ * @param session XCCDF Session
+ * @param lazy_loading whether to load only the referenced definitions
+ */
+void xccdf_session_set_oval_lazy_loading(struct xccdf_session *session, bool lazy_loading);
+
+/**
+ * Set the callback which is given the startup time of each probe started
+ * before the OVAL checks of the session are evaluated. The probes needed
+ * by an OVAL file are started together, before its first definition is
+ * evaluated.
+ * @memberof xccdf_session
+ * @param session XCCDF Session
+ * @param reporter startup time callback or NULL
+ * @param arg user pointer passed to the reporter
+ */
+void xccdf_session_set_probe_startup_reporter(struct xccdf_session *session, oval_probe_startup_reporter reporter, void *arg);
+
 /**
  * Set whether the OVAL variables files shall be exported.
  * @memberof xccdf_session
@@ -373,6 +399,17 @@ int xccdf_session_load_tailoring(struct xccdf_session *session);
  */
 int xccdf_session_evaluate(struct xccdf_session *session);
 
+/**
+ * Stop the probes of the session before the system to evaluate changes, e.g.
+ * before OSCAP_PROBE_ROOT is set for another target. The system information
+ * is queried again and the CPE platforms are evaluated again by new probes
+ * on the next @ref xccdf_session_evaluate.
+ * @memberof xccdf_session
+ * @param session XCCDF Session
+ * @returns zero on success
+ */
+int xccdf_session_reset_probes(struct xccdf_session *session);
+
 /**
  * Export XCCDF file.
  * @memberof xccdf_session
@@ -468,6 +505,18 @@ unsigned int xccdf_session_get_cpe_oval_agents_count(const struct xccdf_session
  */
 bool xccdf_session_contains_fail_result(const struct xccdf_session *session);
 
+/**
+ * Set the maximal number of fixes executed concurrently by @ref xccdf_session_remediate.
+ * The fixes which need a reboot or are highly disruptive are always executed alone,
+ * the fixes with the same system and strategy and the fixes of the rules which
+ * require or conflict with each other are executed in the document order.
+ * Defaults to 1, which executes all the fixes one by one.
+ * @memberof xccdf_session
+ * @param session XCCDF Session
+ * @param jobs number of concurrently executed fixes
+ */
+void xccdf_session_set_remediation_jobs(struct xccdf_session *session, unsigned int jobs);
+
 /**
  * Run XCCDF Remediation. It uses XCCDF Policy and XCCDF TestResult from the session
  * and modifies the TestResult. This also drops and recreate OVAL Agent Session, thus
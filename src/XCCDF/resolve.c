@@ -259,6 +259,7 @@ static void xccdf_resolve_profile(struct xccdf_item *child, struct xccdf_item *p
 	xccdf_resolve_appendlist(&child->sub.profile.setvalues,     parent->sub.profile.setvalues,     xccdf_setvalue_idcmp,     (oscap_clone_func)xccdf_setvalue_clone, false);
 	xccdf_resolve_appendlist(&child->sub.profile.refine_rules,  parent->sub.profile.refine_rules,  xccdf_refine_rule_idcmp,  (oscap_clone_func)xccdf_refine_rule_clone, false);
 	xccdf_resolve_appendlist(&child->sub.profile.refine_values, parent->sub.profile.refine_values, xccdf_refine_value_idcmp, (oscap_clone_func)xccdf_refine_value_clone, false);
+	++child->sub.profile.values_rev;
 }
 
 static struct xccdf_item *xccdf_resolve_copy_item(struct xccdf_item *src)
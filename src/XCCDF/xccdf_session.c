@@ -39,11 +39,14 @@
 #include "common/list.h"
 #include "common/oscapxml.h"
 #include "common/_error.h"
+#include "common/trace_priv.h"
 #include "CPE/cpe_session_priv.h"
 #include "DS/public/scap_ds.h"
 #include "DS/public/ds_sds_session.h"
+#include "DS/ds_image_priv.h"
 #include "DS/ds_sds_session_priv.h"
 #include "DS/rds_priv.h"
+#include "OVAL/oval_definitions_impl.h"
 #include "OVAL/results/oval_results_impl.h"
 #include "source/xslt_priv.h"
 #include "XCCDF/xccdf_impl.h"
@@ -74,6 +77,7 @@ struct xccdf_session {
 	} xccdf;
 	struct {
 		struct ds_sds_session *session;         ///< SDS Registry abstract structure
+		struct ds_image *image;                 ///< Content image (if the session file is one)
 		char *user_datastream_id;		///< Datastream id requested by user (only applicable for sds).
 		char *user_component_id;		///< Component id requested by user (only applicable for sds).
 		char *user_benchmark_id;		///< Benchmark id requested by user (only applicable for sds).
@@ -87,6 +91,10 @@ struct xccdf_session {
 		xccdf_policy_engine_eval_fn user_eval_fn;///< Custom OVAL engine callback
 		char *product_cpe;			///< CPE of scanner product.
 		struct oscap_htable *result_sources;    ///< mapping 'filepath' to oscap_source for OVAL results
+		bool lazy_loading;			///< Load only the definitions needed by the selected profile
+		bool pending;				///< OVAL files were located but they are loaded on evaluation
+		oval_probe_startup_reporter startup_reporter;///< Callback given the startup time of each probe
+		void *startup_arg;			///< User pointer passed to the startup_reporter
 	} oval;
 	struct {
 		char *arf_file;				///< Path to ARF file to export
@@ -103,6 +111,7 @@ struct xccdf_session {
 	} tailoring;
 	bool validate;					///< False value indicates to skip any XSD validation.
 	bool full_validation;				///< True value indicates that every possible step will be validated by XSD.
+	unsigned int remediation_jobs;			///< Maximal number of fixes executed concurrently.
 
 	struct oscap_list *check_engine_plugins; ///< Extra non-OVAL check engines that may or may not have been loaded
 };
@@ -111,6 +120,7 @@ static int _xccdf_session_autonegotiate_tailoring_file(struct xccdf_session *ses
 static void _oval_content_resources_free(struct oval_content_resource **resources);
 static void _xccdf_session_free_oval_agents(struct xccdf_session *session);
 static void _xccdf_session_free_oval_result_sources(struct xccdf_session *session);
+static int _xccdf_session_load_oval_models(struct xccdf_session *session);
 
 static const char *oscap_productname = "cpe:/a:open-scap:oscap";
 static const char *oval_sysname = "http://oval.mitre.org/XMLSchema/oval-definitions-5";
@@ -119,8 +129,17 @@ struct xccdf_session *xccdf_session_new(const char *filename)
 {
 	struct xccdf_session *session = (struct xccdf_session *) oscap_calloc(1, sizeof(struct xccdf_session));
 
-	session->source = oscap_source_new_from_file(filename);
-	if (oscap_source_get_scap_type(session->source) == 0) {
+	if (ds_image_detect(filename)) {
+		session->ds.image = ds_image_open(filename);
+		if (session->ds.image == NULL) {
+			xccdf_session_free(session);
+			return NULL;
+		}
+		session->source = ds_image_get_collection_source(session->ds.image);
+	}
+	else
+		session->source = oscap_source_new_from_file(filename);
+	if (session->source == NULL || oscap_source_get_scap_type(session->source) == 0) {
 		xccdf_session_free(session);
 		return NULL;
 	}
@@ -134,6 +153,7 @@ struct xccdf_session *xccdf_session_new(const char *filename)
 		return NULL;
 	}
 	session->validate = true;
+	session->remediation_jobs = 1;
 	session->xccdf.base_score = 0;
 	session->check_engine_plugins = oscap_list_new();
 
@@ -217,6 +237,7 @@ void xccdf_session_free(struct xccdf_session *session)
 	oscap_free(session->ds.user_component_id);
 	oscap_free(session->ds.user_benchmark_id);
 	ds_sds_session_free(session->ds.session);
+	ds_image_free(session->ds.image);
 	if (session->temp_dir != NULL)
 		oscap_acquire_cleanup_dir((char **) &(session->temp_dir));
 	oscap_source_free(session->source);
@@ -325,6 +346,21 @@ void xccdf_session_set_oval_results_export(struct xccdf_session *session, bool t
 	session->export.oval_results = to_export_oval_results;
 }
 
+void xccdf_session_set_oval_lazy_loading(struct xccdf_session *session, bool lazy_loading)
+{
+	session->oval.lazy_loading = lazy_loading;
+}
+
+void xccdf_session_set_probe_startup_reporter(struct xccdf_session *session, oval_probe_startup_reporter reporter, void *arg)
+{
+	session->oval.startup_reporter = reporter;
+	session->oval.startup_arg = arg;
+	if (session->oval.agents != NULL) {
+		for (int i = 0; session->oval.agents[i]; i++)
+			oval_agent_set_probe_startup_reporter(session->oval.agents[i], reporter, arg);
+	}
+}
+
 void xccdf_session_set_oval_variables_export(struct xccdf_session *session, bool to_export_oval_variables)
 {
 	session->export.oval_variables = to_export_oval_variables;
@@ -381,6 +417,11 @@ static struct ds_sds_session *xccdf_session_get_ds_sds_session(struct xccdf_sess
 		return NULL;
 	if (session->ds.session == NULL) {
 		session->ds.session = ds_sds_session_new_from_source(session->source);
+		if (session->ds.session != NULL && session->ds.image != NULL &&
+				ds_image_load_session(session->ds.image, session->ds.session) != 0) {
+			ds_sds_session_free(session->ds.session);
+			session->ds.session = NULL;
+		}
 	}
 	return session->ds.session;
 }
@@ -431,7 +472,8 @@ int xccdf_session_load_xccdf(struct xccdf_session *session)
 	session->xccdf.source = NULL;
 
 	if (xccdf_session_is_sds(session)) {
-		if (session->validate) {
+		// The components of an image have been validated when it was written
+		if (session->validate && session->ds.image == NULL) {
 			if (oscap_source_validate(session->source, _reporter, NULL)) {
 				oscap_seterr(OSCAP_EFAMILY_OSCAP, "Invalid %s (%s) content in %s",
 						oscap_document_type_to_string(oscap_source_get_scap_type(session->source)),
@@ -502,17 +544,25 @@ int xccdf_session_load_cpe(struct xccdf_session *session)
 	}
 
 	if (xccdf_session_is_sds(session)) {
-		struct ds_sds_index *sds_idx = xccdf_session_get_sds_idx(session);
-		if (sds_idx == NULL) {
-			return -1;
+		struct oscap_string_iterator* cpe_it;
+
+		if (session->ds.image != NULL) {
+			// The dictionaries are already registered by the image
+			cpe_it = ds_image_get_dictionaries(session->ds.image);
+		}
+		else {
+			struct ds_sds_index *sds_idx = xccdf_session_get_sds_idx(session);
+			if (sds_idx == NULL) {
+				return -1;
+			}
+			struct ds_stream_index* stream_idx = ds_sds_index_get_stream(sds_idx, xccdf_session_get_datastream_id(session));
+			cpe_it = ds_stream_index_get_dictionaries(stream_idx);
 		}
-		struct ds_stream_index* stream_idx = ds_sds_index_get_stream(sds_idx, xccdf_session_get_datastream_id(session));
-		struct oscap_string_iterator* cpe_it = ds_stream_index_get_dictionaries(stream_idx);
 
 		// This potentially allows us to skip yet another decompose if we are sure
 		// there are no CPE dictionaries or language models inside the datastream.
 		if (oscap_string_iterator_has_more(cpe_it)) {
-			if (ds_sds_session_register_component_with_dependencies(xccdf_session_get_ds_sds_session(session),
+			if (session->ds.image == NULL && ds_sds_session_register_component_with_dependencies(xccdf_session_get_ds_sds_session(session),
 					"dictionaries", NULL, NULL) != 0) {
 				oscap_seterr(OSCAP_EFAMILY_OSCAP, "Can't decompose CPE dictionaries from datastream '%s' "
 						"from file '%s'!\n", xccdf_session_get_datastream_id(session),
@@ -741,9 +791,33 @@ int xccdf_session_load_oval(struct xccdf_session *session)
 		}
 	}
 
+	/* The profile isn't known yet, it's selected after the session is loaded */
+	if (session->oval.lazy_loading) {
+		session->oval.pending = true;
+		return 0;
+	}
+	return _xccdf_session_load_oval_models(session);
+}
+
+static int _xccdf_session_load_oval_models(struct xccdf_session *session)
+{
+	struct oval_content_resource **contents = session->oval.custom_resources != NULL ?
+		session->oval.custom_resources : session->oval.resources;
+	struct xccdf_policy *policy = NULL;
+
+	session->oval.pending = false;
+	if (session->oval.lazy_loading && (policy = xccdf_session_get_xccdf_policy(session)) == NULL)
+		return 1;
+
 	for (int idx=0; contents[idx]; idx++) {
 		/* file -> def_model */
-		struct oval_definition_model *tmp_def_model = oval_definition_model_import_source(contents[idx]->source);
+		struct oscap_stringlist *names = NULL;
+		if (policy != NULL)
+			names = xccdf_policy_get_check_content_names(policy, oval_sysname, contents[idx]->href);
+		oscap_trace_begin("oval_load", contents[idx]->href);
+		struct oval_definition_model *tmp_def_model = oval_definition_model_import_source_filtered(contents[idx]->source, names);
+		oscap_trace_end("oval_load", contents[idx]->href, names != NULL ? oscap_list_get_itemcount((struct oscap_list *) names) : 0, 0);
+		oscap_stringlist_free(names);
 		if (tmp_def_model == NULL) {
 			oscap_seterr(OSCAP_EFAMILY_OSCAP, "Failed to create OVAL definition model from: '%s'.",
 				oscap_source_readable_origin(contents[idx]->source));
@@ -761,6 +835,7 @@ int xccdf_session_load_oval(struct xccdf_session *session)
 		/* store our name in the generated documents */
 		oval_agent_set_product_name(tmp_sess, session->oval.product_cpe != NULL ?
 				session->oval.product_cpe : (char *) oscap_productname);
+		oval_agent_set_probe_startup_reporter(tmp_sess, session->oval.startup_reporter, session->oval.startup_arg);
 
 		/* remember sessions */
 		session->oval.agents = realloc(session->oval.agents, (idx + 2) * sizeof(struct oval_agent_session *));
@@ -885,6 +960,8 @@ int xccdf_session_evaluate(struct xccdf_session *session)
 		oscap_seterr(OSCAP_EFAMILY_OSCAP, "Cannot build xccdf_policy.");
 		return 1;
 	}
+	if (session->oval.pending && _xccdf_session_load_oval_models(session) != 0)
+		return 1;
 
 	session->xccdf.result = xccdf_policy_evaluate(policy);
 	if (session->xccdf.result == NULL)
@@ -916,6 +993,18 @@ int xccdf_session_evaluate(struct xccdf_session *session)
 	return 0;
 }
 
+int xccdf_session_reset_probes(struct xccdf_session *session)
+{
+	if (session->oval.agents != NULL) {
+		for (int i = 0; session->oval.agents[i]; i++)
+			if (oval_agent_reset_probes(session->oval.agents[i]) != 0)
+				return 1;
+	}
+	if (session->xccdf.policy_model != NULL)
+		cpe_session_reset_checks(xccdf_policy_model_get_cpe_session(session->xccdf.policy_model));
+	return 0;
+}
+
 static size_t _paramlist_size(const char **p) { size_t s = 0; if (!p) return s; while (p[s]) s += 2; return s; }
 
 static size_t _paramlist_cpy(const char **to, const char **p) {
@@ -1366,6 +1455,11 @@ bool xccdf_session_contains_fail_result(const struct xccdf_session *session)
 	return false;
 }
 
+void xccdf_session_set_remediation_jobs(struct xccdf_session *session, unsigned int jobs)
+{
+	session->remediation_jobs = jobs > 0 ? jobs : 1;
+}
+
 int xccdf_session_remediate(struct xccdf_session *session)
 {
 	int res = 0;
@@ -1380,11 +1474,14 @@ int xccdf_session_remediate(struct xccdf_session *session)
 	xccdf_policy_model_unregister_engines(session->xccdf.policy_model, oval_sysname);
 	if ((res = xccdf_session_load_oval(session)) != 0)
 		return res;
+	if (session->oval.pending && (res = _xccdf_session_load_oval_models(session)) != 0)
+		return res;
 	struct xccdf_benchmark *benchmark = xccdf_policy_get_benchmark(xccdf_session_get_xccdf_policy(session));
 	xccdf_result_set_version(session->xccdf.result,
 			benchmark != NULL ? xccdf_benchmark_get_version(benchmark) : NULL);
 	xccdf_result_fill_sysinfo(session->xccdf.result);
-	return xccdf_policy_remediate(xccdf_session_get_xccdf_policy(session), session->xccdf.result);
+	return xccdf_policy_remediate(xccdf_session_get_xccdf_policy(session), session->xccdf.result,
+			session->remediation_jobs);
 }
 
 int xccdf_session_build_policy_from_testresult(struct xccdf_session *session, const char *testresult_id)
@@ -51,6 +51,7 @@
 #include "common/debug_priv.h"
 #include "common/assume.h"
 #include "common/text_priv.h"
+#include "common/metrics_priv.h"
 #include "XCCDF/result_scoring_priv.h"
 
 /**
@@ -67,6 +68,7 @@ struct xccdf_policy_model {
 	struct oscap_list       * engines;      ///< Callbacks for checking engines (see xccdf_policy_engine)
 
 	struct cpe_session *cpe;
+	struct xccdf_text_templates *templates; ///< Compiled substitutable texts
 };
 /* Macros to generate iterators, getters and setters */
 OSCAP_GETTER(struct xccdf_benchmark *, xccdf_policy_model, benchmark)
@@ -93,6 +95,21 @@ struct xccdf_policy {
 	struct oscap_htable		*selected_internal;
 	/** A hash which for given item defines final selection */
 	struct oscap_htable		*selected_final;
+	/** Tailoring of Values by the profile, Value ID -> struct xccdf_policy_value.
+	 * Built on first use, rebuilt when the profile changes its set-values or refine-values. */
+	struct oscap_htable		*value_table;
+	unsigned int			value_table_rev;          ///< Revision of the profile values the table was built from
+	int				value_table_setvalues;    ///< Number of set-values the table was built from
+	int				value_table_refine_values; ///< Number of refine-values the table was built from
+};
+
+/**
+ * Set-value and refine-values of the profile which apply to one Value
+ */
+struct xccdf_policy_value {
+	struct xccdf_setvalue       *setvalue;             ///< The last set-value
+	struct xccdf_refine_value   *refine_value;         ///< The last refine-value
+	struct xccdf_refine_value   *first_refine_value;   ///< The first refine-value
 };
 
 /* Macros to generate iterators, getters and setters */
@@ -131,6 +148,8 @@ OSCAP_GETTER(xccdf_operator_t, xccdf_value_binding, operator)
  * elements has to call parent element's 
  */
 static struct xccdf_refine_rule * xccdf_policy_get_refine_rules_by_rule(struct xccdf_policy * policy, struct xccdf_item * item);
+static bool _xccdf_policy_model_item_is_applicable(struct xccdf_policy_model *model, struct xccdf_item *item, bool record);
+static void xccdf_policy_resolve_platforms(struct xccdf_policy *policy);
 
 /**
  * Filter function returning true if the item is selected, false otherwise
@@ -196,10 +215,23 @@ char *xccdf_policy_get_readable_item_description(struct xccdf_policy *policy, st
 	return plaintext;
 }
 
+static struct xccdf_policy_value *xccdf_policy_value_table_add(struct oscap_htable *table, const char *id)
+{
+	struct xccdf_policy_value *entry = oscap_htable_get(table, id);
+
+	if (entry == NULL) {
+		entry = oscap_calloc(1, sizeof(struct xccdf_policy_value));
+		oscap_htable_add(table, id, entry);
+	}
+	return entry;
+}
+
 /**
- * Get last setvalue from policy that match specified id
+ * Get the set-value and refine-values of the policy profile for the Value
+ * of given ID. The profile is indexed once instead of being searched on
+ * every lookup, tailored profiles may have thousands of values.
  */
-static struct xccdf_setvalue * xccdf_policy_get_setvalue(struct xccdf_policy * policy, const char * id)
+static struct xccdf_policy_value *xccdf_policy_get_value_tailoring(struct xccdf_policy *policy, const char *id)
 {
     /* return NULL if id or policy is NULL but don't use
      * __attribute_not_null__ here, it will cause abort
@@ -208,9 +240,7 @@ static struct xccdf_setvalue * xccdf_policy_get_setvalue(struct xccdf_policy * p
     if (id == NULL) return NULL;
     if (policy == NULL) return NULL;
 
-    struct xccdf_setvalue_iterator  * s_value_it;
-    struct xccdf_setvalue           * s_value;
-    struct xccdf_profile            * profile = xccdf_policy_get_profile(policy);;
+    struct xccdf_profile * profile = xccdf_policy_get_profile(policy);
 
     /* If profile is NULL we don't have setvalue's
      * and we return NULL, otherwise we could cause SIGSEG
@@ -218,55 +248,61 @@ static struct xccdf_setvalue * xccdf_policy_get_setvalue(struct xccdf_policy * p
      */
     if (profile == NULL) return NULL;
 
-    /* We need to return *LAST* setvalue in Profile.
-     * and iterate to the end of setvalue list
-     */
-    struct xccdf_setvalue * final = NULL;
-    s_value_it = xccdf_profile_get_setvalues(profile);
-    while (xccdf_setvalue_iterator_has_more(s_value_it)) {
-        s_value = xccdf_setvalue_iterator_next(s_value_it);
-        if (!strcmp(id, xccdf_setvalue_get_item(s_value))) {
-            final = s_value;
+    const struct xccdf_profile_item *profile_item = &((struct xccdf_item *) profile)->sub.profile;
+    int setvalues = oscap_list_get_itemcount(profile_item->setvalues);
+    int refine_values = oscap_list_get_itemcount(profile_item->refine_values);
+
+    /* Adding a value bumps the revision of the profile. Removing one through
+     * an iterator does not, but it always changes the number of items. */
+    if (policy->value_table == NULL || policy->value_table_rev != profile_item->values_rev
+            || policy->value_table_setvalues != setvalues
+            || policy->value_table_refine_values != refine_values) {
+        oscap_htable_free(policy->value_table, oscap_free);
+        policy->value_table = oscap_htable_new1((oscap_compare_func) strcmp, setvalues + refine_values > 127 ? (setvalues + refine_values) | 1 : 127);
+        policy->value_table_rev = profile_item->values_rev;
+        policy->value_table_setvalues = setvalues;
+        policy->value_table_refine_values = refine_values;
+
+        /* The *LAST* setvalue in Profile wins */
+        struct xccdf_setvalue_iterator *s_value_it = xccdf_profile_get_setvalues(profile);
+        while (xccdf_setvalue_iterator_has_more(s_value_it)) {
+            struct xccdf_setvalue *s_value = xccdf_setvalue_iterator_next(s_value_it);
+            xccdf_policy_value_table_add(policy->value_table, xccdf_setvalue_get_item(s_value))->setvalue = s_value;
+        }
+        xccdf_setvalue_iterator_free(s_value_it);
+
+        struct xccdf_refine_value_iterator *r_value_it = xccdf_profile_get_refine_values(profile);
+        while (xccdf_refine_value_iterator_has_more(r_value_it)) {
+            struct xccdf_refine_value *r_value = xccdf_refine_value_iterator_next(r_value_it);
+            struct xccdf_policy_value *entry = xccdf_policy_value_table_add(policy->value_table, xccdf_refine_value_get_item(r_value));
+            if (entry->first_refine_value == NULL)
+                entry->first_refine_value = r_value;
+            entry->refine_value = r_value;
         }
+        xccdf_refine_value_iterator_free(r_value_it);
     }
-    xccdf_setvalue_iterator_free(s_value_it);
 
-    return final;
+    return oscap_htable_get(policy->value_table, id);
 }
 
-static struct xccdf_refine_value * xccdf_policy_get_refine_value(struct xccdf_policy * policy, const char * id)
+/**
+ * Get last setvalue from policy that match specified id
+ */
+static struct xccdf_setvalue * xccdf_policy_get_setvalue(struct xccdf_policy * policy, const char * id)
 {
-    /* return NULL if id or policy is NULL but don't use
-     * __attribute_not_null__ here, it will cause abort
-     * which is not desired
-     */
-    if (id == NULL) return NULL;
-    if (policy == NULL) return NULL;
-
-    struct xccdf_refine_value_iterator  * r_value_it;
-    struct xccdf_refine_value           * r_value;
-    struct xccdf_profile            * profile = xccdf_policy_get_profile(policy);;
+    struct xccdf_policy_value *tailoring = xccdf_policy_get_value_tailoring(policy, id);
 
-    /* If profile is NULL we don't have setvalue's
-     * and we return NULL, otherwise we could cause SIGSEG
-     * with accessing NULL structure
-     */
-    if (profile == NULL) return NULL;
+    return tailoring != NULL ? tailoring->setvalue : NULL;
+}
 
-    /* We need to return *LAST* setvalue in Profile.
-     * and iterate to the end of setvalue list
-     */
-    struct xccdf_refine_value * final = NULL;
-    r_value_it = xccdf_profile_get_refine_values(profile);
-    while (xccdf_refine_value_iterator_has_more(r_value_it)) {
-        r_value = xccdf_refine_value_iterator_next(r_value_it);
-        if (!strcmp(id, xccdf_refine_value_get_item(r_value))) {
-            final = r_value;
-        }
-    }
-    xccdf_refine_value_iterator_free(r_value_it);
+/**
+ * Get last refine value from policy that match specified id
+ */
+static struct xccdf_refine_value * xccdf_policy_get_refine_value(struct xccdf_policy * policy, const char * id)
+{
+    struct xccdf_policy_value *tailoring = xccdf_policy_get_value_tailoring(policy, id);
 
-    return final;
+    return tailoring != NULL ? tailoring->refine_value : NULL;
 }
 
 /**
@@ -669,6 +705,86 @@ int xccdf_policy_get_selected_rules_count(struct xccdf_policy *policy)
 	return ret;
 }
 
+/* Returns false if the whole content is referenced. */
+static bool _xccdf_check_collect_content_names(const struct xccdf_check *check, const char *system, const char *href, struct oscap_stringlist *names)
+{
+	bool ret = true;
+
+	if (xccdf_check_get_complex(check)) {
+		struct xccdf_check_iterator *child_it = xccdf_check_get_children(check);
+		while (ret && xccdf_check_iterator_has_more(child_it))
+			ret = _xccdf_check_collect_content_names(xccdf_check_iterator_next(child_it), system, href, names);
+		xccdf_check_iterator_free(child_it);
+		return ret;
+	}
+
+	if (oscap_strcmp(xccdf_check_get_system(check), system))
+		return true;
+
+	struct xccdf_check_content_ref_iterator *content_it = xccdf_check_get_content_refs(check);
+	while (ret && xccdf_check_content_ref_iterator_has_more(content_it)) {
+		struct xccdf_check_content_ref *content = xccdf_check_content_ref_iterator_next(content_it);
+		const char *name = xccdf_check_content_ref_get_name(content);
+
+		if (oscap_strcmp(xccdf_check_content_ref_get_href(content), href))
+			continue;
+		if (name == NULL)
+			ret = false;
+		else
+			oscap_stringlist_add_string(names, name);
+	}
+	xccdf_check_content_ref_iterator_free(content_it);
+	return ret;
+}
+
+struct oscap_stringlist *xccdf_policy_get_check_content_names(struct xccdf_policy *policy, const char *system, const char *href)
+{
+	struct xccdf_benchmark *benchmark = xccdf_policy_get_benchmark(policy);
+	struct oscap_stringlist *names = oscap_stringlist_new();
+	bool partial = true;
+
+	xccdf_policy_resolve_platforms(policy);
+
+	struct oscap_htable_iterator *it = oscap_htable_iterator_new(policy->selected_final);
+
+	while (partial && oscap_htable_iterator_has_more(it)) {
+		const char *key = NULL;
+		void *value = NULL;
+
+		oscap_htable_iterator_next_kv(it, &key, &value);
+		if (!value || !*(bool*)value || !key)
+			continue;
+
+		struct xccdf_item *item = xccdf_benchmark_get_member(benchmark, XCCDF_ITEM, key);
+		if (!item || xccdf_item_get_type(item) != XCCDF_RULE)
+			continue;
+
+		/* Inapplicable rules, and the rules of inapplicable groups,
+		 * are reported without evaluating their checks. */
+		if (!_xccdf_policy_model_item_is_applicable(policy->model, item, false))
+			continue;
+
+		/* The check to be evaluated is selected only once the engines are
+		 * registered, so consider all the checks of the rule. */
+		struct xccdf_check_iterator *check_it = xccdf_rule_get_complex_checks(item);
+		while (partial && xccdf_check_iterator_has_more(check_it))
+			partial = _xccdf_check_collect_content_names(xccdf_check_iterator_next(check_it), system, href, names);
+		xccdf_check_iterator_free(check_it);
+
+		check_it = xccdf_rule_get_checks((struct xccdf_rule *) item);
+		while (partial && xccdf_check_iterator_has_more(check_it))
+			partial = _xccdf_check_collect_content_names(xccdf_check_iterator_next(check_it), system, href, names);
+		xccdf_check_iterator_free(check_it);
+	}
+	oscap_htable_iterator_free(it);
+
+	if (!partial) {
+		oscap_stringlist_free(names);
+		return NULL;
+	}
+	return names;
+}
+
 static struct xccdf_rule_result * _xccdf_rule_result_new_from_rule(const struct xccdf_rule *rule,
 								  struct xccdf_check *check,
 								  xccdf_test_result_type_t eval_result,
@@ -838,123 +954,86 @@ static bool _xccdf_policy_cpe_dict_cb(struct cpe_name* name, void* usr)
 	return ret;
 }
 
-static bool xccdf_policy_model_platforms_are_applicable_dict(struct xccdf_policy_model *model, struct cpe_dict_model *dict, struct oscap_string_iterator *platforms)
+static bool xccdf_policy_model_platform_is_applicable_dict(struct xccdf_policy_model *model, struct cpe_dict_model *dict, const char *platform)
 {
-	// at this point we know that the item has 1 or more platforms specified
-	bool ret = false;
-
-	while (oscap_string_iterator_has_more(platforms))
-	{
-		const char* platform = oscap_string_iterator_next(platforms);
-		// Platform could be a reference to CPE2 platform, skip the ones
-		// that aren't valid CPE names.
-		if (!cpe_name_check(platform))
-			continue;
-
-		struct cpe_name* name = cpe_name_new(platform);
-
-		struct cpe_check_cb_usr* usr = oscap_alloc(sizeof(struct cpe_check_cb_usr));
-		usr->model = model;
-		usr->dict = dict;
-		usr->lang_model = NULL;
-		const bool applicable = cpe_name_applicable_dict(name, dict, (cpe_check_fn) _xccdf_policy_cpe_check_cb, usr);
-		oscap_free(usr);
+	// Platform could be a reference to CPE2 platform, skip the ones
+	// that aren't valid CPE names.
+	if (!cpe_name_check(platform))
+		return false;
 
-		cpe_name_free(name);
+	struct cpe_name* name = cpe_name_new(platform);
 
-		if (applicable)
-		{
-			ret = true;
+	struct cpe_check_cb_usr* usr = oscap_alloc(sizeof(struct cpe_check_cb_usr));
+	usr->model = model;
+	usr->dict = dict;
+	usr->lang_model = NULL;
+	const bool applicable = cpe_name_applicable_dict(name, dict, (cpe_check_fn) _xccdf_policy_cpe_check_cb, usr);
+	oscap_free(usr);
 
-			if (oscap_htable_get(model->cpe->applicable_platforms, platform) == NULL) {
-				oscap_htable_add(model->cpe->applicable_platforms, platform, 0);
-			}
-		}
-	}
-	oscap_string_iterator_reset(platforms);
+	cpe_name_free(name);
 
-	return ret;
+	return applicable;
 }
 
-static bool xccdf_policy_model_platforms_are_applicable_lang_model(struct xccdf_policy_model *model, struct cpe_lang_model *lang_model, struct oscap_string_iterator *platforms)
+static bool xccdf_policy_model_platform_is_applicable_lang_model(struct xccdf_policy_model *model, struct cpe_lang_model *lang_model, const char *platform)
 {
-	// at this point we know that the item has 1 or more platforms specified
-	bool ret = false;
+	// Specification says that platform should begin with "#" if it is
+	// a reference to a CPE2 platform. However content exists where this
+	// is not strictly followed so we support both with and without "#"
+	// references.
 
-	while (oscap_string_iterator_has_more(platforms))
+	const char* platform_shifted = platform;
+	if (strlen(platform_shifted) >= 1 && *platform_shifted == '#')
 	{
-		const char* platform = oscap_string_iterator_next(platforms);
-		// Specification says that platform should begin with "#" if it is
-		// a reference to a CPE2 platform. However content exists where this
-		// is not strictly followed so we support both with and without "#"
-		// references.
-
-		const char* platform_shifted = platform;
-		if (strlen(platform_shifted) >= 1 && *platform_shifted == '#')
-		{
-			// skip the "#" character
-			platform_shifted++;
-		}
-
-		struct cpe_check_cb_usr* usr = oscap_alloc(sizeof(struct cpe_check_cb_usr));
-		usr->model = model;
-		usr->dict = NULL;
-		usr->lang_model = lang_model;
-		const bool applicable = cpe_platform_applicable_lang_model(platform_shifted, lang_model, (cpe_check_fn)_xccdf_policy_cpe_check_cb, (cpe_dict_fn)_xccdf_policy_cpe_dict_cb, usr);
-		oscap_free(usr);
-
-		if (applicable)
-		{
-			ret = true;
-
-			if (oscap_htable_get(model->cpe->applicable_platforms, platform) == NULL) {
-				oscap_htable_add(model->cpe->applicable_platforms, platform, 0);
-			}
-		}
+		// skip the "#" character
+		platform_shifted++;
 	}
-	oscap_string_iterator_reset(platforms);
 
-	return ret;
+	struct cpe_check_cb_usr* usr = oscap_alloc(sizeof(struct cpe_check_cb_usr));
+	usr->model = model;
+	usr->dict = NULL;
+	usr->lang_model = lang_model;
+	const bool applicable = cpe_platform_applicable_lang_model(platform_shifted, lang_model, (cpe_check_fn)_xccdf_policy_cpe_check_cb, (cpe_dict_fn)_xccdf_policy_cpe_dict_cb, usr);
+	oscap_free(usr);
+
+	return applicable;
 }
 
-bool xccdf_policy_model_platforms_are_applicable(struct xccdf_policy_model *model, struct oscap_string_iterator *platforms)
+static bool xccdf_policy_model_platform_evaluate(struct xccdf_policy_model *model, const char *platform)
 {
-	// we have to check whether the item has any platforms at all, if it has none
-	// it should be applicable to all platforms
-	if (!oscap_string_iterator_has_more(platforms))
-		return true;
-
 	bool ret = false;
-	// We do not check whether the platform entries are valid platform refs
-	// or CPE names. We let the policy_model methods do that instead.
+	// We do not check whether the platform entry is a valid platform ref
+	// or CPE name. We let the policy_model methods do that instead.
 	// Therefore we check all 4 (!) places where a platform may match.
 	// CPE2 takes precedence over CPE1 in this implementation. This is not
 	// dictated by the specification, it's an arbitrary choice.
+	// All the places are checked even if the platform already matched,
+	// the CPE OVAL results report every check that applies to it.
 	struct xccdf_benchmark* benchmark = xccdf_policy_model_get_benchmark(model);
 	struct cpe_lang_model *embedded_lang_model = xccdf_benchmark_get_cpe_lang_model(benchmark);
 	if (embedded_lang_model != NULL) {
-		if (xccdf_policy_model_platforms_are_applicable_lang_model(model, embedded_lang_model, platforms))
+		if (xccdf_policy_model_platform_is_applicable_lang_model(model, embedded_lang_model, platform))
 			ret = true;
 	}
 
 	struct oscap_iterator *lang_models = oscap_iterator_new(model->cpe->lang_models);
 	while (oscap_iterator_has_more(lang_models)) {
 		struct cpe_lang_model *lang_model = (struct cpe_lang_model *) oscap_iterator_next(lang_models);
-		if (xccdf_policy_model_platforms_are_applicable_lang_model(model, lang_model, platforms))
+		if (xccdf_policy_model_platform_is_applicable_lang_model(model, lang_model, platform))
 			ret = true;
 	}
 	oscap_iterator_free(lang_models);
 
 	struct cpe_dict_model *embedded_dict = xccdf_benchmark_get_cpe_list(benchmark);
 	if (embedded_dict != NULL) {
-		if (xccdf_policy_model_platforms_are_applicable_dict(model, embedded_dict, platforms))
+		if (xccdf_policy_model_platform_is_applicable_dict(model, embedded_dict, platform))
 			ret = true;
 	}
 
 	struct oscap_iterator *dicts = oscap_iterator_new(model->cpe->dicts);
 	while (oscap_iterator_has_more(dicts)) {
 		struct cpe_dict_model *dict = (struct cpe_dict_model *) oscap_iterator_next(dicts);
-		if (xccdf_policy_model_platforms_are_applicable_dict(model, dict, platforms))
+		if (xccdf_policy_model_platform_is_applicable_dict(model, dict, platform))
 			ret = true;
 	}
 	oscap_iterator_free(dicts);
@@ -962,13 +1041,64 @@ bool xccdf_policy_model_platforms_are_applicable(struct xccdf_policy_model *mode
 	return ret;
 }
 
-bool xccdf_policy_model_item_is_applicable(struct xccdf_policy_model *model, struct xccdf_item *item)
+/**
+ * Look the platform up in the verdict table of the CPE session, evaluate
+ * it only if it hasn't been seen yet. Both verdicts are recorded, many
+ * items share an inapplicable platform as well.
+ */
+static bool xccdf_policy_model_platform_verdict(struct xccdf_policy_model *model, const char *platform)
+{
+	static bool applicable_verdict = true;
+	static bool notapplicable_verdict = false;
+
+	const bool *verdict = (const bool *) oscap_htable_get(model->cpe->platform_verdicts, platform);
+	if (verdict != NULL)
+		return *verdict;
+
+	const bool applicable = xccdf_policy_model_platform_evaluate(model, platform);
+	oscap_htable_add(model->cpe->platform_verdicts, platform, applicable ? &applicable_verdict : &notapplicable_verdict);
+
+	return applicable;
+}
+
+/* With record set, the applicable platforms are reported in the TestResult */
+static bool _xccdf_policy_model_platforms_are_applicable(struct xccdf_policy_model *model, struct oscap_string_iterator *platforms, bool record)
+{
+	// we have to check whether the item has any platforms at all, if it has none
+	// it should be applicable to all platforms
+	if (!oscap_string_iterator_has_more(platforms))
+		return true;
+
+	bool ret = false;
+	while (oscap_string_iterator_has_more(platforms))
+	{
+		const char* platform = oscap_string_iterator_next(platforms);
+		if (!xccdf_policy_model_platform_verdict(model, platform))
+			continue;
+
+		ret = true;
+
+		if (record && oscap_htable_get(model->cpe->applicable_platforms, platform) == NULL) {
+			oscap_htable_add(model->cpe->applicable_platforms, platform, 0);
+		}
+	}
+	oscap_string_iterator_reset(platforms);
+
+	return ret;
+}
+
+bool xccdf_policy_model_platforms_are_applicable(struct xccdf_policy_model *model, struct oscap_string_iterator *platforms)
+{
+	return _xccdf_policy_model_platforms_are_applicable(model, platforms, true);
+}
+
+static bool _xccdf_policy_model_item_is_applicable(struct xccdf_policy_model *model, struct xccdf_item *item, bool record)
 {
 	struct xccdf_item* parent = xccdf_item_get_parent(item);
-	if (!parent || xccdf_policy_model_item_is_applicable(model, parent))
+	if (!parent || _xccdf_policy_model_item_is_applicable(model, parent, record))
 	{
 		struct oscap_string_iterator* platforms = xccdf_item_get_platforms(item);
-		bool ret = xccdf_policy_model_platforms_are_applicable(model, platforms);
+		bool ret = _xccdf_policy_model_platforms_are_applicable(model, platforms, record);
 		oscap_string_iterator_free(platforms);
 
 		return ret;
@@ -980,6 +1110,56 @@ bool xccdf_policy_model_item_is_applicable(struct xccdf_policy_model *model, str
 	}
 }
 
+bool xccdf_policy_model_item_is_applicable(struct xccdf_policy_model *model, struct xccdf_item *item)
+{
+	return _xccdf_policy_model_item_is_applicable(model, item, true);
+}
+
+static void xccdf_policy_resolve_item_platforms(struct xccdf_policy *policy, struct xccdf_item *item)
+{
+	struct xccdf_item_iterator *child_it;
+
+	if (xccdf_item_get_type(item) != XCCDF_BENCHMARK && !xccdf_policy_is_item_selected(policy, xccdf_item_get_id(item)))
+		return;
+
+	struct oscap_string_iterator *platforms = xccdf_item_get_platforms(item);
+	const bool applicable = _xccdf_policy_model_platforms_are_applicable(policy->model, platforms, false);
+	oscap_string_iterator_free(platforms);
+
+	// the platforms below an inapplicable item are never looked at
+	if (!applicable)
+		return;
+
+	switch (xccdf_item_get_type(item)) {
+	case XCCDF_BENCHMARK:
+		child_it = xccdf_benchmark_get_content(xccdf_item_to_benchmark(item));
+		break;
+	case XCCDF_GROUP:
+		child_it = xccdf_group_get_content(xccdf_item_to_group(item));
+		break;
+	default:
+		return;
+	}
+
+	while (xccdf_item_iterator_has_more(child_it))
+		xccdf_policy_resolve_item_platforms(policy, xccdf_item_iterator_next(child_it));
+	xccdf_item_iterator_free(child_it);
+}
+
+/**
+ * Applicability pre-pass. Evaluate the distinct platforms of the selected
+ * items once, one after another, so that the CPE OVAL checks run together
+ * on the same CPE OVAL sessions, and record the verdicts in the CPE session.
+ * Rules and groups then only consult the verdict table.
+ */
+static void xccdf_policy_resolve_platforms(struct xccdf_policy *policy)
+{
+	struct xccdf_benchmark *benchmark = xccdf_policy_get_benchmark(policy);
+
+	if (benchmark != NULL)
+		xccdf_policy_resolve_item_platforms(policy, xccdf_benchmark_to_item(benchmark));
+}
+
 /**
  * Evaluate given check which is immediate child of the rule.
  * A possibe child checks will be evaluated by xccdf_policy_check_evaluate.
@@ -1116,7 +1296,14 @@ static int xccdf_policy_item_evaluate(struct xccdf_policy * policy, struct xccdf
 
     switch (itype) {
         case XCCDF_RULE:{
-			return _xccdf_policy_rule_evaluate(policy, (struct xccdf_rule *) item, result);
+			struct oscap_metrics_sample stats;
+
+			oscap_metrics_start(&stats);
+			ret = _xccdf_policy_rule_evaluate(policy, (struct xccdf_rule *) item, result);
+			oscap_metrics_stop(&stats);
+			oscap_metrics_add(OSCAP_METRICS_RULE, xccdf_item_get_id(item), &stats);
+
+			return ret;
         } break;
 
         case XCCDF_GROUP:{
@@ -1545,6 +1732,11 @@ struct cpe_session *xccdf_policy_model_get_cpe_session(struct xccdf_policy_model
 	return model->cpe;
 }
 
+struct xccdf_text_templates *xccdf_policy_model_get_text_templates(struct xccdf_policy_model *model)
+{
+	return model->templates;
+}
+
 /**
  * Get ID of XCCDF Profile that belongs to XCCDF Policy
  */
@@ -1657,6 +1849,10 @@ struct xccdf_policy_model * xccdf_policy_model_new(struct xccdf_benchmark * benc
 	model->engines = oscap_list_new();
 
 	model->cpe = cpe_session_new();
+	/* Without templates every text goes through the DOM walk, the tests
+	 * compare the output of both ways. */
+	if (getenv("OSCAP_XCCDF_NO_TEXT_TEMPLATES") == NULL)
+		model->templates = xccdf_text_templates_new();
 
         /* Resolve document */
         xccdf_benchmark_resolve(benchmark);
@@ -2077,6 +2273,9 @@ struct xccdf_result * xccdf_policy_evaluate(struct xccdf_policy * policy)
 
     oscap_free(id);
 
+	/* Evaluate the platforms of the selected items up front */
+	xccdf_policy_resolve_platforms(policy);
+
 	/** We need to process document top-down order.
 	 * See conflicts/requires and Item Processing Algorithm */
 	struct xccdf_item_iterator *item_it = xccdf_benchmark_get_content(benchmark);
@@ -2136,33 +2335,17 @@ static struct xccdf_refine_rule * xccdf_policy_get_refine_rules_by_rule(struct x
 
 const char *xccdf_policy_get_value_of_item(struct xccdf_policy * policy, struct xccdf_item * item)
 {
-    struct xccdf_profile * profile = xccdf_policy_get_profile(policy);
+	struct xccdf_policy_value *tailoring = xccdf_policy_get_value_tailoring(policy, xccdf_value_get_id((struct xccdf_value *) item));
 	const char *selector = NULL;
 
-	if (profile != NULL) {
+	if (tailoring != NULL) {
 		/* Get set_value for this item */
-		struct xccdf_setvalue *s_value = NULL;
-		struct xccdf_setvalue *last_s_value = NULL;
-		struct xccdf_setvalue_iterator *s_value_it = xccdf_profile_get_setvalues(profile);
-		while (xccdf_setvalue_iterator_has_more(s_value_it)) {
-			s_value = xccdf_setvalue_iterator_next(s_value_it);
-			if (strcmp(xccdf_setvalue_get_item(s_value), xccdf_value_get_id((struct xccdf_value *) item)) == 0)
-				last_s_value = s_value;
-		}
-		xccdf_setvalue_iterator_free(s_value_it);
-		if (last_s_value != NULL)
-			return xccdf_setvalue_get_value(last_s_value);
+		if (tailoring->setvalue != NULL)
+			return xccdf_setvalue_get_value(tailoring->setvalue);
 
 		/* We don't have set-value in profile, look for refine-value */
-		struct xccdf_refine_value_iterator *r_value_it = xccdf_profile_get_refine_values(profile);
-		while (xccdf_refine_value_iterator_has_more(r_value_it)) {
-			struct xccdf_refine_value *r_value = xccdf_refine_value_iterator_next(r_value_it);
-			if (!strcmp(xccdf_refine_value_get_item(r_value), xccdf_value_get_id((struct xccdf_value *) item))) {
-				selector = xccdf_refine_value_get_selector(r_value);
-				break;
-			}
-		}
-		xccdf_refine_value_iterator_free(r_value_it);
+		if (tailoring->first_refine_value != NULL)
+			selector = xccdf_refine_value_get_selector(tailoring->first_refine_value);
 	}
 
 	struct xccdf_value_instance *instance = xccdf_value_get_instance_by_selector((struct xccdf_value *) item, selector);
@@ -2177,21 +2360,9 @@ const char *xccdf_policy_get_value_of_item(struct xccdf_policy * policy, struct
 
 static int xccdf_policy_get_refine_value_oper(struct xccdf_policy * policy, struct xccdf_item * item)
 {
-    struct xccdf_refine_value * r_value = NULL;
-    struct xccdf_profile * profile = xccdf_policy_get_profile(policy);
-    if (profile == NULL) return -1;
-
-    /* We don't have set-value in profile, look for refine-value */
-    struct xccdf_refine_value_iterator * r_value_it = xccdf_profile_get_refine_values(profile);
-    while (xccdf_refine_value_iterator_has_more(r_value_it)) {
-        r_value = xccdf_refine_value_iterator_next(r_value_it);
-        if (!strcmp(xccdf_refine_value_get_item(r_value), xccdf_value_get_id((struct xccdf_value *) item)))
-            break;
-        else r_value = NULL;
-    }
-    xccdf_refine_value_iterator_free(r_value_it);
-    if (r_value != NULL) {
-        return xccdf_refine_value_get_oper(r_value);
+    struct xccdf_policy_value *tailoring = xccdf_policy_get_value_tailoring(policy, xccdf_value_get_id((struct xccdf_value *) item));
+    if (tailoring != NULL && tailoring->first_refine_value != NULL) {
+        return xccdf_refine_value_get_oper(tailoring->first_refine_value);
     }
     return -1;
 }
@@ -2295,6 +2466,7 @@ void xccdf_policy_model_free(struct xccdf_policy_model * model) {
 	xccdf_tailoring_free(model->tailoring);
         xccdf_benchmark_free(model->benchmark);
 	cpe_session_free(model->cpe);
+	xccdf_text_templates_free(model->templates);
         oscap_free(model);
 }
 
@@ -2312,6 +2484,7 @@ void xccdf_policy_free(struct xccdf_policy * policy) {
 	oscap_list_free(policy->results, (oscap_destruct_func) xccdf_result_free);
 	oscap_htable_free0(policy->selected_internal);
 	oscap_htable_free0(policy->selected_final);
+	oscap_htable_free(policy->value_table, oscap_free);
         oscap_free(policy);
 }
 
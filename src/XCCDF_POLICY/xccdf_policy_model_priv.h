@@ -69,6 +69,14 @@ bool xccdf_policy_model_item_is_applicable(struct xccdf_policy_model *model, str
  */
 struct cpe_session *xccdf_policy_model_get_cpe_session(struct xccdf_policy_model *model);
 
+/**
+ * Get the cache of compiled text substitution templates of the XCCDF Policy Model
+ * @memberof xccdf_policy_model
+ * @param model XCCDF Policy Model
+ * @returns cache of the templates
+ */
+struct xccdf_text_templates *xccdf_policy_model_get_text_templates(struct xccdf_policy_model *model);
+
 OSCAP_HIDDEN_END;
 
 #endif
@@ -42,6 +42,22 @@ OSCAP_HIDDEN_START;
  */
 int xccdf_policy_resolve_fix_substitution(struct xccdf_policy *policy, struct xccdf_fix *fix, struct xccdf_rule_result *rule_result, struct xccdf_result *test_result);
 
+/**
+ * Cache of substitutable texts compiled into templates, it's shared
+ * by all the policies of an XCCDF policy model.
+ */
+struct xccdf_text_templates;
+
+/**
+ * Create an empty cache of text substitution templates.
+ */
+struct xccdf_text_templates *xccdf_text_templates_new(void);
+
+/**
+ * Free the cache of text substitution templates.
+ */
+void xccdf_text_templates_free(struct xccdf_text_templates *templates);
+
 /**
  * Execute fix element for a given rule-result. Or find suitable (most appropriate) fix
  * in the policy, assign it to the rule-result and execute.
@@ -66,11 +82,14 @@ int xccdf_policy_check_evaluate(struct xccdf_policy * policy, struct xccdf_check
 
 /**
  * Remediate all rule-results in the given result, with settings of given policy.
+ * The fixes are executed first, up to the given number of them concurrently,
+ * and the remedied rules are verified afterwards.
  * @memberof xccdf_policy
  * @param policy XCCDF Policy
  * @param result TestResult containing rule-results to remediate
+ * @param jobs maximal number of fixes executed at once
  */
-int xccdf_policy_remediate(struct xccdf_policy *policy, struct xccdf_result *result);
+int xccdf_policy_remediate(struct xccdf_policy *policy, struct xccdf_result *result, unsigned int jobs);
 
 /**
  * Report given "rule" to all callbacks with given sysname registered with the policy.
@@ -90,6 +109,18 @@ int xccdf_policy_report_cb(struct xccdf_policy *policy, const char *sysname, voi
  */
 struct xccdf_benchmark *xccdf_policy_get_benchmark(const struct xccdf_policy *policy);
 
+/**
+ * Get names of the check-content-refs to the given href from checks of all
+ * the selected rules. Checks of all the systems except the given one are ignored.
+ * @memberof xccdf_policy
+ * @param policy XCCDF Policy
+ * @param system checking system URI
+ * @param href the referred content
+ * @returns list of names or NULL if the whole content is referenced
+ * (at least one of the check-content-refs has no name).
+ */
+struct oscap_stringlist *xccdf_policy_get_check_content_names(struct xccdf_policy *policy, const char *system, const char *href);
+
 OSCAP_HIDDEN_END;
 
 #endif
@@ -23,8 +23,12 @@
 
 #include <string.h>
 #include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/resource.h>
 #include <sys/stat.h>
 #include <sys/wait.h>
+#include <time.h>
 #include <unistd.h>
 
 #include <libxml/tree.h>
@@ -33,6 +37,7 @@
 #include "common/_error.h"
 #include "common/assume.h"
 #include "common/debug_priv.h"
+#include "common/metrics_priv.h"
 #include "common/oscap_acquire.h"
 #include "xccdf_policy_priv.h"
 #include "xccdf_policy_model_priv.h"
@@ -265,55 +270,95 @@ static inline int _xccdf_fix_decode_xml(struct xccdf_fix *fix, char **result)
 	return 0;
 }
 
-static inline int _xccdf_fix_execute(struct xccdf_rule_result *rr, struct xccdf_fix *fix)
+/*
+ * A fix to be executed during the remediation. The fixes are executed
+ * by a pool of processes, see _fix_jobs_run(), and the rules are
+ * verified afterwards, see _fix_job_verify().
+ */
+struct _fix_job {
+	struct xccdf_rule_result *rr;
+	struct xccdf_rule *rule;	///< NULL if the rule couldn't be found
+	struct xccdf_check *check;	///< check used to verify the fix
+	struct xccdf_fix *fix;		///< fix with the substitutions resolved, owned by rr
+	const char *interpret;
+	char *temp_dir;
+	char *temp_file;
+	pid_t pid;
+	int fd;				///< read end of the pipe with the output of the fix
+	char *output;
+	size_t output_len;
+	enum {
+		_FIX_JOB_WAITING,
+		_FIX_JOB_RUNNING,
+		_FIX_JOB_DONE
+	} state;
+	int result;			///< zero if the fix was executed
+	size_t *deps;			///< jobs which have to be done before this one starts
+	size_t dep_count;
+	struct timespec started;	///< monotonic time the fix was started at
+	struct oscap_metrics_sample stats;
+};
+
+/*
+ * Decode the fix and write it into a temporary file.
+ */
+static int _xccdf_fix_prepare(struct _fix_job *job)
 {
-	const char *interpret = NULL;
-	char *temp_dir = NULL;
-	char *temp_file = NULL;
 	char *fix_text = NULL;
 	int fd;
-	int result = 1;
-	if (fix == NULL || rr == NULL || oscap_streq(xccdf_fix_get_content(fix), NULL))
-		return 1;
 
-	if ((interpret = _get_supported_interpret(xccdf_fix_get_system(fix), NULL)) == NULL) {
-		_rule_add_info_message(rr, "Not supported xccdf:fix/@system='%s' or missing interpreter.",
-				xccdf_fix_get_system(fix) == NULL ? "" : xccdf_fix_get_system(fix));
+	if ((job->interpret = _get_supported_interpret(xccdf_fix_get_system(job->fix), NULL)) == NULL) {
+		_rule_add_info_message(job->rr, "Not supported xccdf:fix/@system='%s' or missing interpreter.",
+				xccdf_fix_get_system(job->fix) == NULL ? "" : xccdf_fix_get_system(job->fix));
 		return 1;
 	}
 
-	if (_xccdf_fix_decode_xml(fix, &fix_text) != 0) {
-		_rule_add_info_message(rr, "Fix element contains unresolved child elements.");
+	if (_xccdf_fix_decode_xml(job->fix, &fix_text) != 0) {
+		_rule_add_info_message(job->rr, "Fix element contains unresolved child elements.");
 		return 1;
 	}
 
-	temp_dir = oscap_acquire_temp_dir();
-	if (temp_dir == NULL)
-		goto cleanup;
+	job->temp_dir = oscap_acquire_temp_dir();
+	if (job->temp_dir == NULL) {
+		oscap_free(fix_text);
+		return 1;
+	}
 	// TODO: Directory and files shall be labeled with SELinux to prevent
 	// confined processes with less priviledges to transit to oscap domain
 	// and become basically unconfined.
-	fd = oscap_acquire_temp_file(temp_dir, "fix-XXXXXXXX", &temp_file);
+	fd = oscap_acquire_temp_file(job->temp_dir, "fix-XXXXXXXX", &job->temp_file);
 	if (fd == -1) {
-		_rule_add_info_message(rr, "mkstemp failed: %s", strerror(errno));
-		goto cleanup;
+		_rule_add_info_message(job->rr, "mkstemp failed: %s", strerror(errno));
+		oscap_free(fix_text);
+		return 1;
 	}
 
 	if (_write_text_to_fd_and_free(fd, fix_text) != 0) {
-		_rule_add_info_message(rr, "Could not write to the temp file: %s", strerror(errno));
+		_rule_add_info_message(job->rr, "Could not write to the temp file: %s", strerror(errno));
 		(void) close(fd);
-		goto cleanup;
+		return 1;
 	}
 
 	if (close(fd) != 0)
-		_rule_add_info_message(rr, "Could not close temp file: %s", strerror(errno));
+		_rule_add_info_message(job->rr, "Could not close temp file: %s", strerror(errno));
+	return 0;
+}
 
+/*
+ * Fork the interpreter of the fix, its output is read from job->fd.
+ */
+static int _xccdf_fix_spawn(struct _fix_job *job)
+{
 	int pipefd[2];
 	if (pipe(pipefd) == -1) {
-		_rule_add_info_message(rr, "Could not create pipe: %s", strerror(errno));
-		goto cleanup;
+		_rule_add_info_message(job->rr, "Could not create pipe: %s", strerror(errno));
+		return 1;
 	}
+	/* Do not leak the pipe into the fixes executed concurrently. */
+	(void) fcntl(pipefd[0], F_SETFD, FD_CLOEXEC);
 
+	oscap_metrics_start(&job->stats);
+	clock_gettime(CLOCK_MONOTONIC, &job->started);
 	int fork_result = fork();
 	if (fork_result >= 0) {
 		/* fork succeded */
@@ -325,52 +370,252 @@ static inline int _xccdf_fix_execute(struct xccdf_rule_result *rr, struct xccdf_
 			close(pipefd[1]);
 
 			char *const argvp[3] = {
-				(char *)interpret,
-				temp_file,
+				(char *)job->interpret,
+				job->temp_file,
 				NULL
 			};
 
-			execve(interpret, argvp, NULL);
+			execve(job->interpret, argvp, NULL);
 			/* Wow, execve returned. In this special case, we failed to execute the fix
 			 * and we return 0 from function. At least the following error message will
 			 * indicate the problem in xccdf:message. */
 			printf("Error while executing fix script: execve returned: %s\n", strerror(errno));
 			exit(42);
-		} else {
-			oscap_free(temp_file);
-			close(pipefd[1]);
-			const char *stdout_buff = oscap_acquire_pipe_to_string(pipefd[0]);
-			int wstatus;
-			waitpid(fork_result, &wstatus, 0);
-			_rule_add_info_message(rr, "Fix execution completed and returned: %d", WEXITSTATUS(wstatus));
-			if (stdout_buff != NULL && stdout_buff[0] != '\0')
-				_rule_add_info_message(rr, stdout_buff);
-			oscap_free(stdout_buff);
-			/* We return zero to indicate success. Rather than returning the exit code. */
-			result = 0;
 		}
-	} else {
-		_rule_add_info_message(rr, "Failed to fork. %s", strerror(errno));
-		oscap_free(temp_file);
+		close(pipefd[1]);
+		job->pid = fork_result;
+		job->fd = pipefd[0];
+		return 0;
 	}
+	_rule_add_info_message(job->rr, "Failed to fork. %s", strerror(errno));
+	close(pipefd[0]);
+	close(pipefd[1]);
+	return 1;
+}
 
-cleanup:
-	oscap_acquire_cleanup_dir(&temp_dir);
-	return result;
+/*
+ * Read the available output of the fix, returns false once all of it was read.
+ */
+static bool _xccdf_fix_read_output(struct _fix_job *job)
+{
+	char buffer[4096];
+	ssize_t len = read(job->fd, buffer, sizeof(buffer));
+
+	if (len < 0)
+		return errno == EINTR || errno == EAGAIN;
+	if (len == 0)
+		return false;
+
+	job->output = oscap_realloc(job->output, job->output_len + len + 1);
+	memcpy(job->output + job->output_len, buffer, len);
+	job->output_len += len;
+	job->output[job->output_len] = '\0';
+	return true;
 }
 
-int xccdf_policy_rule_result_remediate(struct xccdf_policy *policy, struct xccdf_rule_result *rr, struct xccdf_fix *fix, struct xccdf_result *test_result)
+/*
+ * Reap the finished fix and record its outcome in the rule-result.
+ */
+static void _xccdf_fix_reap(struct _fix_job *job)
 {
-	if (policy == NULL || rr == NULL)
-		return 1;
+	struct rusage usage;
+	struct timespec finished;
+	double wall, cpu;
+	int wstatus = 0;
+
+	close(job->fd);
+	while (wait4(job->pid, &wstatus, 0, &usage) == -1 && errno == EINTR)
+		;
+	clock_gettime(CLOCK_MONOTONIC, &finished);
+	wall = (finished.tv_sec - job->started.tv_sec) + (finished.tv_nsec - job->started.tv_nsec) / 1000000000.0;
+	/* The CPU time of the interpreter, rather than the one of the waiting thread. */
+	cpu = usage.ru_utime.tv_sec + usage.ru_utime.tv_usec / 1000000.0 +
+		usage.ru_stime.tv_sec + usage.ru_stime.tv_usec / 1000000.0;
+
+	oscap_metrics_stop(&job->stats);
+	if (job->stats.active) {
+		job->stats.cpu = cpu;
+		oscap_metrics_add(OSCAP_METRICS_FIX, xccdf_rule_result_get_idref(job->rr), &job->stats);
+	}
+
+	_rule_add_info_message(job->rr, "Fix execution completed and returned: %d", WEXITSTATUS(wstatus));
+	_rule_add_info_message(job->rr, "Fix execution took %.3f s of wall clock time and %.3f s of CPU time", wall, cpu);
+	if (job->output != NULL && job->output[0] != '\0')
+		_rule_add_info_message(job->rr, job->output);
+	/* We return zero to indicate success. Rather than returning the exit code. */
+	job->result = 0;
+}
+
+static void _fix_job_done(struct _fix_job *job)
+{
+	if (job->result != 0)
+		_rule_add_info_message(job->rr, "Fix was not executed. Execution was aborted.");
+	oscap_free(job->output);
+	job->output = NULL;
+	oscap_free(job->temp_file);
+	job->temp_file = NULL;
+	oscap_acquire_cleanup_dir(&job->temp_dir);
+	job->state = _FIX_JOB_DONE;
+}
+
+static bool _fix_job_is_ready(const struct _fix_job *jobs, size_t i)
+{
+	for (size_t j = 0; j < jobs[i].dep_count; ++j)
+		if (jobs[jobs[i].deps[j]].state != _FIX_JOB_DONE)
+			return false;
+	return true;
+}
+
+/*
+ * Execute the fixes, up to max_running of them at once. A fix is started
+ * once all the fixes it depends on are done, the ready fixes are started
+ * in the document order. So with max_running equal to one the fixes are
+ * executed one by one in the document order.
+ */
+static void _fix_jobs_run(struct _fix_job *jobs, size_t count, unsigned int max_running)
+{
+	struct pollfd *pfds = oscap_calloc(max_running, sizeof(struct pollfd));
+	size_t *running = oscap_calloc(max_running, sizeof(size_t));
+	size_t running_count = 0, done_count = 0;
+
+	while (done_count < count) {
+		for (size_t i = 0; i < count && running_count < max_running; ++i) {
+			struct _fix_job *job = &jobs[i];
+
+			if (job->state != _FIX_JOB_WAITING || !_fix_job_is_ready(jobs, i))
+				continue;
+			if (_xccdf_fix_prepare(job) != 0 || _xccdf_fix_spawn(job) != 0) {
+				_fix_job_done(job);
+				++done_count;
+				continue;
+			}
+			job->state = _FIX_JOB_RUNNING;
+			running[running_count++] = i;
+		}
+		if (running_count == 0)
+			break;
+
+		for (size_t r = 0; r < running_count; ++r) {
+			pfds[r].fd = jobs[running[r]].fd;
+			pfds[r].events = POLLIN;
+			pfds[r].revents = 0;
+		}
+		if (poll(pfds, running_count, -1) == -1) {
+			if (errno == EINTR)
+				continue;
+			dE("poll failed: %s\n", strerror(errno));
+			/* Fall back to reading the fixes one by one. */
+			for (size_t r = 0; r < running_count; ++r)
+				pfds[r].revents = POLLIN;
+		}
+
+		for (size_t r = running_count; r-- > 0;) {
+			struct _fix_job *job = &jobs[running[r]];
+
+			if (pfds[r].revents == 0 || _xccdf_fix_read_output(job))
+				continue;
+			_xccdf_fix_reap(job);
+			_fix_job_done(job);
+			++done_count;
+			running[r] = running[--running_count];
+		}
+	}
+
+	oscap_free(running);
+	oscap_free(pfds);
+}
+
+static bool _rule_is_in(const struct xccdf_rule *rule, const char *idref)
+{
+	/* The idref may refer to the rule or to any of its groups. */
+	for (const struct xccdf_item *item = (const struct xccdf_item *) rule; item != NULL; item = xccdf_item_get_parent(item))
+		if (oscap_streq(xccdf_item_get_id(item), idref))
+			return true;
+	return false;
+}
+
+static bool _rule_requires(const struct xccdf_rule *rule, const struct xccdf_rule *required)
+{
+	bool ret = false;
+	struct oscap_stringlist_iterator *requires_it = xccdf_rule_get_requires(rule);
+	while (!ret && oscap_stringlist_iterator_has_more(requires_it)) {
+		struct oscap_string_iterator *idref_it = oscap_stringlist_get_strings(oscap_stringlist_iterator_next(requires_it));
+		while (!ret && oscap_string_iterator_has_more(idref_it))
+			ret = _rule_is_in(required, oscap_string_iterator_next(idref_it));
+		oscap_string_iterator_free(idref_it);
+	}
+	oscap_stringlist_iterator_free(requires_it);
+	return ret;
+}
+
+static bool _rule_conflicts(const struct xccdf_rule *rule, const struct xccdf_rule *other)
+{
+	bool ret = false;
+	struct oscap_string_iterator *conflicts_it = xccdf_rule_get_conflicts(rule);
+	while (!ret && oscap_string_iterator_has_more(conflicts_it))
+		ret = _rule_is_in(other, oscap_string_iterator_next(conflicts_it));
+	oscap_string_iterator_free(conflicts_it);
+	return ret;
+}
+
+static inline bool _fix_is_exclusive(const struct xccdf_fix *fix)
+{
+	return xccdf_fix_get_reboot(fix) || xccdf_fix_get_disruption(fix) == XCCDF_HIGH;
+}
+
+/*
+ * Shall the later job wait for the earlier one? Fixes of the same
+ * @system and @strategy are executed in the document order, so are the
+ * fixes of the rules which require or conflict with each other. Fixes
+ * which need a reboot or are highly disruptive are executed alone.
+ */
+static bool _fix_job_depends(const struct _fix_job *later, const struct _fix_job *earlier)
+{
+	if (_fix_is_exclusive(later->fix) || _fix_is_exclusive(earlier->fix))
+		return true;
+	if (xccdf_fix_get_strategy(later->fix) != XCCDF_STRATEGY_UNKNOWN &&
+			xccdf_fix_get_strategy(later->fix) == xccdf_fix_get_strategy(earlier->fix) &&
+			oscap_streq(xccdf_fix_get_system(later->fix), xccdf_fix_get_system(earlier->fix)))
+		return true;
+	if (later->rule == NULL || earlier->rule == NULL)
+		return false;
+	return _rule_requires(later->rule, earlier->rule) ||
+		_rule_conflicts(later->rule, earlier->rule) || _rule_conflicts(earlier->rule, later->rule);
+}
+
+/*
+ * A job only depends on the jobs before it, which keeps the dependencies
+ * acyclic and the document order for the fixes which are not independent.
+ */
+static void _fix_jobs_order(struct _fix_job *jobs, size_t count)
+{
+	for (size_t i = 1; i < count; ++i) {
+		for (size_t j = 0; j < i; ++j) {
+			if (!_fix_job_depends(&jobs[i], &jobs[j]))
+				continue;
+			jobs[i].deps = oscap_realloc(jobs[i].deps, sizeof(size_t) * (jobs[i].dep_count + 1));
+			jobs[i].deps[jobs[i].dep_count++] = j;
+		}
+	}
+}
+
+/*
+ * Find the fix of the rule-result and resolve its substitutions. Returns
+ * true if the fix shall be executed, *ret is the result of the
+ * remediation of the rule-result otherwise.
+ */
+static bool _fix_job_init(struct _fix_job *job, struct xccdf_policy *policy, struct xccdf_rule_result *rr, struct xccdf_fix *fix, struct xccdf_result *test_result, int *ret)
+{
+	memset(job, 0, sizeof(struct _fix_job));
+	*ret = 0;
 	if (xccdf_rule_result_get_result(rr) != XCCDF_RESULT_FAIL)
-		return 0;
+		return false;
 
 	if (fix == NULL) {
 		fix = _find_suitable_fix(policy, rr);
 		if (fix == NULL)
 			// We may want to append xccdf:message about missing fix.
-			return 0;
+			return false;
 	}
 
 	struct xccdf_check *check = NULL;
@@ -380,7 +625,7 @@ int xccdf_policy_rule_result_remediate(struct xccdf_policy *policy, struct xccdf
 	xccdf_check_iterator_free(check_it);
 	if (check != NULL && xccdf_check_get_multicheck(check))
 		// Do not try to apply fix for multi-check.
-		return 0;
+		return false;
 
 	/* Initialize the fix. */
 	struct xccdf_fix *cfix = xccdf_fix_clone(fix);
@@ -388,35 +633,44 @@ int xccdf_policy_rule_result_remediate(struct xccdf_policy *policy, struct xccdf
 	xccdf_rule_result_add_fix(rr, cfix);
 	if (res != 0) {
 		_rule_add_info_message(rr, "Fix execution was aborted: Text substitution failed.");
-		return res;
+		*ret = res;
+		return false;
 	}
 
-	/* Execute the fix. */
-	res = _xccdf_fix_execute(rr, cfix);
-	if (res != 0) {
-		_rule_add_info_message(rr, "Fix was not executed. Execution was aborted.");
-		return res;
-	}
+	job->rr = rr;
+	job->rule = _lookup_rule_by_rule_result(policy, rr);
+	job->check = check;
+	job->fix = cfix;
+	job->fd = -1;
+	job->result = 1;
+	return true;
+}
+
+/*
+ * Verify the executed fix by calling the checking engine again.
+ */
+static int _fix_job_verify(struct xccdf_policy *policy, struct _fix_job *job)
+{
+	struct xccdf_rule_result *rr = job->rr;
 
 	/* We report rule during remediation only when the fix was actually executed */
 	int report = 0;
-	struct xccdf_rule *rule = _lookup_rule_by_rule_result(policy, rr);
-	if (rule == NULL) {
+	if (job->rule == NULL) {
 		// Sadly, we cannot handle this since b9d123d53140c6e369b7f2206e4e3e63dc556fd1.
 		oscap_seterr(OSCAP_EFAMILY_OSCAP, "Could not find xccdf:Rule/@id=%s.", xccdf_rule_result_get_idref(rr));
 	}
 	else {
-		report = xccdf_policy_report_cb(policy, XCCDF_POLICY_OUTCB_START, (void *) rule);
+		report = xccdf_policy_report_cb(policy, XCCDF_POLICY_OUTCB_START, (void *) job->rule);
 		if (report != 0)
 			return report;
 	}
 
 	/* Verify applied fix by calling OVAL again */
-	if (check == NULL) {
+	if (job->check == NULL) {
 		xccdf_rule_result_set_result(rr, XCCDF_RESULT_ERROR);
 		_rule_add_info_message(rr, "Failed to verify applied fix: Missing xccdf:check.");
 	} else {
-		int new_result = xccdf_policy_check_evaluate(policy, check);
+		int new_result = xccdf_policy_check_evaluate(policy, job->check);
 		if (new_result == XCCDF_RESULT_PASS)
 			xccdf_rule_result_set_result(rr, XCCDF_RESULT_FIXED);
 		else {
@@ -427,18 +681,58 @@ int xccdf_policy_rule_result_remediate(struct xccdf_policy *policy, struct xccdf
 	}
 
 	xccdf_rule_result_set_time_current(rr);
-	return rule == NULL ? 0 : xccdf_policy_report_cb(policy, XCCDF_POLICY_OUTCB_END, (void *) rr);
+	return job->rule == NULL ? 0 : xccdf_policy_report_cb(policy, XCCDF_POLICY_OUTCB_END, (void *) rr);
+}
+
+int xccdf_policy_rule_result_remediate(struct xccdf_policy *policy, struct xccdf_rule_result *rr, struct xccdf_fix *fix, struct xccdf_result *test_result)
+{
+	struct _fix_job job;
+	int ret;
+
+	if (policy == NULL || rr == NULL)
+		return 1;
+	if (!_fix_job_init(&job, policy, rr, fix, test_result, &ret))
+		return ret;
+
+	/* Execute the fix. */
+	_fix_jobs_run(&job, 1, 1);
+	if (job.result != 0)
+		return job.result;
+
+	return _fix_job_verify(policy, &job);
 }
 
-int xccdf_policy_remediate(struct xccdf_policy *policy, struct xccdf_result *result)
+int xccdf_policy_remediate(struct xccdf_policy *policy, struct xccdf_result *result, unsigned int jobs)
 {
 	__attribute__nonnull__(result);
-	struct xccdf_rule_result_iterator *rr_it = xccdf_result_get_rule_results(result);
-	while (xccdf_rule_result_iterator_has_more(rr_it)) {
-		struct xccdf_rule_result *rr = xccdf_rule_result_iterator_next(rr_it);
-		xccdf_policy_rule_result_remediate(policy, rr, NULL, result);
+	struct _fix_job *fix_jobs = NULL;
+	size_t count = 0;
+	int ret;
+
+	if (policy != NULL) {
+		struct xccdf_rule_result_iterator *rr_it = xccdf_result_get_rule_results(result);
+		while (xccdf_rule_result_iterator_has_more(rr_it)) {
+			struct xccdf_rule_result *rr = xccdf_rule_result_iterator_next(rr_it);
+			fix_jobs = oscap_realloc(fix_jobs, sizeof(struct _fix_job) * (count + 1));
+			if (_fix_job_init(&fix_jobs[count], policy, rr, NULL, result, &ret))
+				++count;
+		}
+		xccdf_rule_result_iterator_free(rr_it);
 	}
-	xccdf_rule_result_iterator_free(rr_it);
+
+	/* All the fixes are executed first and the rules are verified at once
+	 * afterwards. No object is thus collected before all of the fixes,
+	 * which may change it, are done. */
+	_fix_jobs_order(fix_jobs, count);
+	_fix_jobs_run(fix_jobs, count, jobs > 0 ? jobs : 1);
+
+	for (size_t i = 0; i < count; ++i) {
+		if (fix_jobs[i].result == 0)
+			_fix_job_verify(policy, &fix_jobs[i]);
+		oscap_free(fix_jobs[i].deps);
+	}
+	oscap_free(fix_jobs);
+
 	xccdf_result_set_end_time_current(result);
 	return 0;
 }
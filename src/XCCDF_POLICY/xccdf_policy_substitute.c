@@ -22,9 +22,11 @@
 #endif
 
 #include <string.h>
+#include <pthread.h>
 #include <libxml/tree.h>
 
 #include "util.h"
+#include "list.h"
 #include "xml_iterate.h"
 #include "debug_priv.h"
 #include "assume.h"
@@ -32,6 +34,7 @@
 #include "XCCDF/elements.h"
 #include "XCCDF/xccdf_impl.h"
 #include "xccdf_policy_priv.h"
+#include "xccdf_policy_model_priv.h"
 #include "public/xccdf_policy.h"
 
 struct _xccdf_text_substitution_data {
@@ -51,6 +54,111 @@ static bool _xhtml_is_supported_namespace(xmlNs *ns)
 	return ns != NULL && oscap_streq((const char *) ns->href, (const char *) XCCDF_XHTML_NAMESPACE);
 }
 
+/*
+ * Resolve xccdf:sub/@idref, NULL if it can't be resolved.
+ */
+static const char *_xccdf_sub_resolve(struct _xccdf_text_substitution_data *data, struct xccdf_benchmark *benchmark,
+		const char *sub_idref, const char *sub_use)
+{
+	// Sub element may refer to xccdf:Value or to xccdf:plain-text
+	struct xccdf_item *value = xccdf_benchmark_get_item(benchmark, sub_idref);
+
+	const char *result = NULL;
+	if (value != NULL && xccdf_item_get_type(value) == XCCDF_VALUE) {
+		// When the <xccdf:sub> element's @idref attribute holds the id of an <xccdf:Value>
+		// element, the <xccdf:sub> element's @use attribute MUST be consulted.
+		if (oscap_streq(sub_use, NULL) || oscap_streq(sub_use, "legacy")) {
+			// If the value of the @use attribute is "legacy", then during Tailoring,
+			// process the <xccdf:sub> element as if @use was set to "title". but
+			// during Document Generation or Assessment, process the <xccdf:sub>
+			// element as if @use was set to "value".
+			sub_use = (data->processing_type & _TAILORING_TYPE) ? "title" : "value";
+		}
+
+		if (oscap_streq(sub_use, "title")) {
+			// TODO: @xml:lang
+			struct oscap_text_iterator *title_it = xccdf_item_get_title(value);
+			if (oscap_text_iterator_has_more(title_it))
+				result = oscap_text_get_text(oscap_text_iterator_next(title_it));
+			oscap_text_iterator_free(title_it);
+		} else {
+			if (!oscap_streq(sub_use, "value"))
+				dW("xccdf:sub/@idref='%s' has incorrect @use='%s'! Using @use='value' instead.\n", sub_idref, sub_use);
+			result = xccdf_policy_get_value_of_item(data->policy, value);
+		}
+	} else { // This xccdf:sub probably refers to the xccdf:plain-text
+		result = xccdf_benchmark_get_plain_text(benchmark, sub_idref);
+	}
+	return result;
+}
+
+/*
+ * Resolve xhtml:object/@data of the #xccdf:value: or #xccdf:title: form.
+ */
+static const char *_xccdf_object_resolve(struct _xccdf_text_substitution_data *data, struct xccdf_benchmark *benchmark,
+		const char *object_data)
+{
+	const char *result = NULL;
+	if (strncmp(object_data, "#xccdf:value:", strlen("#xccdf:value:")) == 0) {
+		const char *value_id = object_data + strlen("#xccdf:value:");
+
+		struct xccdf_item *item = xccdf_benchmark_get_item(benchmark, value_id);
+		if (item != NULL && xccdf_item_get_type(item) == XCCDF_VALUE) {
+			result = xccdf_policy_get_value_of_item(data->policy, item);
+		} else {
+			result = xccdf_benchmark_get_plain_text(benchmark, value_id);
+			if (result == NULL) {
+				dW("Text substitution for xccdf:fact is not supported!\n"); // TODO.
+			}
+		}
+	}
+	else if (strncmp(object_data, "#xccdf:title:", strlen("#xccdf:title:")) == 0) {
+		const char *title_id = object_data + strlen("#xccdf:title:");
+
+		struct xccdf_item *item = xccdf_benchmark_get_item(benchmark, title_id);
+		if (item != NULL) {
+			// TODO: @xml:lang
+			struct oscap_text_iterator *title_it = xccdf_item_get_title(item);
+			if (oscap_text_iterator_has_more(title_it))
+				result = oscap_text_get_text(oscap_text_iterator_next(title_it));
+			oscap_text_iterator_free(title_it);
+		}
+	}
+	return result;
+}
+
+static bool _xccdf_object_is_supported(const char *object_data)
+{
+	return strncmp(object_data, "#xccdf:value:", strlen("#xccdf:value:")) == 0 ||
+		strncmp(object_data, "#xccdf:title:", strlen("#xccdf:title:")) == 0;
+}
+
+/*
+ * Resolve xccdf:instance, returns 1 if there is no instance to use.
+ */
+static int _xccdf_instance_resolve(struct _xccdf_text_substitution_data *data, const char **result)
+{
+	if (data->rule_result == NULL)
+		return 1;
+	struct xccdf_instance_iterator *instances = xccdf_rule_result_get_instances(data->rule_result);
+	if (!xccdf_instance_iterator_has_more(instances)) {
+		dW("The xccdf:rule-result/xccdf:instance element was not found.\n");
+		xccdf_instance_iterator_free(instances);
+		return 1;
+	}
+	*result = xccdf_instance_get_content(xccdf_instance_iterator_next(instances));
+	xccdf_instance_iterator_free(instances);
+	return 0;
+}
+
+static void _xccdf_node_replace_by_text(xmlNode **node, const char *text)
+{
+	xmlNode *new_node = xmlNewText(BAD_CAST text);
+	xmlReplaceNode(*node, new_node);
+	xmlFreeNode(*node);
+	*node = new_node;
+}
+
 static int _xccdf_text_substitution_cb(xmlNode **node, void *user_data)
 {
 	struct _xccdf_text_substitution_data *data = (struct _xccdf_text_substitution_data *) user_data;
@@ -66,41 +174,14 @@ static int _xccdf_text_substitution_cb(xmlNode **node, void *user_data)
 			free(sub_idref); // It may be an empty string.
 			return 2;
 		}
-		// Sub element may refer to xccdf:Value or to xccdf:plain-text
 
 		struct xccdf_benchmark *benchmark = xccdf_policy_get_benchmark(data->policy);
 		if (benchmark == NULL)
 			return 1;
-		struct xccdf_item *value = xccdf_benchmark_get_item(benchmark, sub_idref);
 
-		const char *result = NULL;
-		if (value != NULL && xccdf_item_get_type(value) == XCCDF_VALUE) {
-			// When the <xccdf:sub> element's @idref attribute holds the id of an <xccdf:Value>
-			// element, the <xccdf:sub> element's @use attribute MUST be consulted.
-			const char *sub_use = (const char *) xmlGetProp(*node, BAD_CAST "use");
-			if (oscap_streq(sub_use, NULL) || oscap_streq(sub_use, "legacy")) {
-				// If the value of the @use attribute is "legacy", then during Tailoring,
-				// process the <xccdf:sub> element as if @use was set to "title". but
-				// during Document Generation or Assessment, process the <xccdf:sub>
-				// element as if @use was set to "value".
-				sub_use = strdup((data->processing_type & _TAILORING_TYPE) ? "title" : "value");
-			}
-
-			if (oscap_streq(sub_use, "title")) {
-				// TODO: @xml:lang
-				struct oscap_text_iterator *title_it = xccdf_item_get_title(value);
-				if (oscap_text_iterator_has_more(title_it))
-					result = oscap_text_get_text(oscap_text_iterator_next(title_it));
-				oscap_text_iterator_free(title_it);
-			} else {
-				if (!oscap_streq(sub_use, "value"))
-					dW("xccdf:sub/@idref='%s' has incorrect @use='%s'! Using @use='value' instead.\n", sub_idref, sub_use);
-				result = xccdf_policy_get_value_of_item(data->policy, value);
-			}
-			oscap_free(sub_use);
-		} else { // This xccdf:sub probably refers to the xccdf:plain-text
-			result = xccdf_benchmark_get_plain_text(benchmark, sub_idref);
-		}
+		char *sub_use = (char *) xmlGetProp(*node, BAD_CAST "use");
+		const char *result = _xccdf_sub_resolve(data, benchmark, sub_idref, sub_use);
+		oscap_free(sub_use);
 
 		if (result == NULL) {
 			oscap_seterr(OSCAP_EFAMILY_XCCDF, "Could not resolve xccdf:sub/@idref='%s'!", sub_idref);
@@ -109,10 +190,7 @@ static int _xccdf_text_substitution_cb(xmlNode **node, void *user_data)
 		}
 		oscap_free(sub_idref);
 
-		xmlNode *new_node = xmlNewText(BAD_CAST result);
-		xmlReplaceNode(*node, new_node);
-		xmlFreeNode(*node);
-		*node = new_node;
+		_xccdf_node_replace_by_text(node, result);
 		return 0;
 	} else if (oscap_streq((const char *) (*node)->name, "object") && _xhtml_is_supported_namespace((*node)->ns)) {
 		char *object_data = (char *) xmlGetProp(*node, BAD_CAST "data");
@@ -125,71 +203,317 @@ static int _xccdf_text_substitution_cb(xmlNode **node, void *user_data)
 		if (benchmark == NULL)
 			return 1;
 
-		const char *result = NULL;
-		if (strncmp(object_data, "#xccdf:value:", strlen("#xccdf:value:")) == 0) {
-			const char *value_id = object_data + strlen("#xccdf:value:");
-
-			struct xccdf_item *item = xccdf_benchmark_get_item(benchmark, value_id);
-			if (item != NULL && xccdf_item_get_type(item) == XCCDF_VALUE) {
-				result = xccdf_policy_get_value_of_item(data->policy, item);
-			} else {
-				result = xccdf_benchmark_get_plain_text(benchmark, value_id);
-				if (result == NULL) {
-					dW("Text substitution for xccdf:fact is not supported!\n"); // TODO.
-				}
-			}
-		}
-		else if (strncmp(object_data, "#xccdf:title:", strlen("#xccdf:title:")) == 0) {
-			const char *title_id = object_data + strlen("#xccdf:title:");
-
-			struct xccdf_item *item = xccdf_benchmark_get_item(benchmark, title_id);
-			if (item != NULL) {
-				// TODO: @xml:lang
-				struct oscap_text_iterator *title_it = xccdf_item_get_title(item);
-				if (oscap_text_iterator_has_more(title_it))
-					result = oscap_text_get_text(oscap_text_iterator_next(title_it));
-				oscap_text_iterator_free(title_it);
-			}
-		}
-		else {
+		if (!_xccdf_object_is_supported(object_data)) {
 			// Let's not consider this as an error. Since in similar cases NISTIR-7275r4
 			// suggests to retain the <object> element.
 			dW("Unsupported XCCDF uri: xhtml:object/@data='%s'\n", object_data);
 			free(object_data);
 			return 0;
 		}
+		const char *result = _xccdf_object_resolve(data, benchmark, object_data);
 		free(object_data);
-		xmlNode *new_node = xmlNewText(BAD_CAST result);
-		xmlReplaceNode(*node, new_node);
-		xmlFreeNode(*node);
-		*node = new_node;
+		_xccdf_node_replace_by_text(node, result);
 		return 0;
 	} else if (oscap_streq((const char *) (*node)->name, "instance") && xccdf_is_supported_namespace((*node)->ns)) {
-		const char *result;
+		const char *result = NULL;
 		// <instance> elements
 		if ((*node)->children != NULL)
 			dW("The xccdf:instance element SHALL NOT have any content.\n");
-		if (data->rule_result == NULL)
+		if (_xccdf_instance_resolve(data, &result) != 0)
 			return 1;
-		struct xccdf_instance_iterator *instances = xccdf_rule_result_get_instances(data->rule_result);
-		if (xccdf_instance_iterator_has_more(instances)) {
-			struct xccdf_instance *instance = xccdf_instance_iterator_next(instances);
-			result = xccdf_instance_get_content(instance);
-		}
-		else {
-			dW("The xccdf:rule-result/xccdf:instance element was not found.\n");
-			return 1;
-		}
-		xmlNode *new_node = xmlNewText(BAD_CAST result);
-		xmlReplaceNode(*node, new_node);
-		xmlFreeNode(*node);
-		*node = new_node;
+		_xccdf_node_replace_by_text(node, result);
 		return 0;
 	} else {
 		return 0;
 	}
 }
 
+/*
+ * Text substitution templates
+ *
+ * The same texts (fixes, titles, descriptions) get substituted over and
+ * over, e.g. while generating a fix script or a report. Each distinct
+ * text is parsed only once per policy model: the elements to substitute
+ * are replaced by numbered markers and the serialized document is split
+ * at the markers. Rendering a template then only concatenates the
+ * literal segments with the resolved values, escaped the same way the
+ * text nodes of the substituted document are serialized, so the output
+ * is identical to the one of the DOM walk above.
+ */
+
+#define _XCCDF_TEMPLATE_MARKER "@@xccdf-template-marker:"
+
+enum _xccdf_text_token_type {
+	_XCCDF_TOKEN_LITERAL,
+	_XCCDF_TOKEN_SUB,
+	_XCCDF_TOKEN_OBJECT,
+	_XCCDF_TOKEN_INSTANCE
+};
+
+struct _xccdf_text_token {
+	enum _xccdf_text_token_type type;
+	char *text;	///< literal text, sub/@idref or object/@data
+	char *use;	///< sub/@use
+};
+
+struct _xccdf_text_template {
+	/* The text isn't compiled, e.g. because it isn't well-formed,
+	 * and has to go through xml_iterate_dfs() every time. */
+	bool fallback;
+	size_t count;
+	struct _xccdf_text_token *tokens;
+};
+
+struct xccdf_text_templates {
+	pthread_mutex_t mutex;
+	struct oscap_htable *templates; ///< text -> struct _xccdf_text_template
+};
+
+static void _xccdf_text_template_free(struct _xccdf_text_template *tmpl)
+{
+	if (tmpl == NULL)
+		return;
+	for (size_t i = 0; i < tmpl->count; ++i) {
+		oscap_free(tmpl->tokens[i].text);
+		oscap_free(tmpl->tokens[i].use);
+	}
+	oscap_free(tmpl->tokens);
+	oscap_free(tmpl);
+}
+
+static void _xccdf_text_template_add(struct _xccdf_text_template *tmpl, enum _xccdf_text_token_type type, char *text, char *use)
+{
+	tmpl->tokens = oscap_realloc(tmpl->tokens, sizeof(struct _xccdf_text_token) * (tmpl->count + 1));
+	tmpl->tokens[tmpl->count].type = type;
+	tmpl->tokens[tmpl->count].text = text;
+	tmpl->tokens[tmpl->count].use = use;
+	tmpl->count++;
+}
+
+/*
+ * Replace the elements the callback would substitute by markers, in the
+ * same order, and record them as tokens. The literal tokens are added
+ * later, the tokens are in the order of the markers meanwhile.
+ */
+static void _xccdf_text_template_walk(xmlNode *parent, struct _xccdf_text_template *subs)
+{
+	for (xmlNode *node = parent->children; node != NULL; node = node->next) {
+		enum _xccdf_text_token_type type;
+		char *text = NULL, *use = NULL;
+
+		if (oscap_streq((const char *) node->name, "sub") && xccdf_is_supported_namespace(node->ns)) {
+			if (node->children != NULL)
+				dW("The xccdf:sub element SHALL NOT have any content.\n");
+			type = _XCCDF_TOKEN_SUB;
+			text = (char *) xmlGetProp(node, BAD_CAST "idref");
+			use = (char *) xmlGetProp(node, BAD_CAST "use");
+		} else if (oscap_streq((const char *) node->name, "object") && _xhtml_is_supported_namespace(node->ns)) {
+			text = (char *) xmlGetProp(node, BAD_CAST "data");
+			if (text == NULL || !_xccdf_object_is_supported(text)) {
+				if (text != NULL && strncmp(text, "#xccdf:", strlen("#xccdf:")) == 0)
+					dW("Unsupported XCCDF uri: xhtml:object/@data='%s'\n", text);
+				free(text);
+				_xccdf_text_template_walk(node, subs);
+				continue;
+			}
+			type = _XCCDF_TOKEN_OBJECT;
+		} else if (oscap_streq((const char *) node->name, "instance") && xccdf_is_supported_namespace(node->ns)) {
+			if (node->children != NULL)
+				dW("The xccdf:instance element SHALL NOT have any content.\n");
+			type = _XCCDF_TOKEN_INSTANCE;
+		} else {
+			_xccdf_text_template_walk(node, subs);
+			continue;
+		}
+
+		char *marker = oscap_sprintf(_XCCDF_TEMPLATE_MARKER "%zu@@", subs->count);
+		_xccdf_node_replace_by_text(&node, marker);
+		oscap_free(marker);
+		_xccdf_text_template_add(subs, type, text, use);
+	}
+}
+
+static struct _xccdf_text_template *_xccdf_text_template_compile(const char *text)
+{
+	struct _xccdf_text_template *tmpl = oscap_calloc(1, sizeof(struct _xccdf_text_template));
+	struct _xccdf_text_template subs = { false, 0, NULL };
+
+	if (strstr(text, _XCCDF_TEMPLATE_MARKER) != NULL) {
+		tmpl->fallback = true;
+		return tmpl;
+	}
+
+	char *input_document = oscap_sprintf("<x xmlns='http://www.w3.org/1999/xhtml'>%s</x>", text);
+	xmlDoc *doc = xmlParseMemory(input_document, strlen(input_document));
+	oscap_free(input_document);
+	xmlNode *root = doc != NULL ? xmlDocGetRootElement(doc) : NULL;
+	if (root == NULL) {
+		// Let xml_iterate_dfs() report it, every time, as it always did.
+		if (doc != NULL)
+			xmlFreeDoc(doc);
+		tmpl->fallback = true;
+		return tmpl;
+	}
+
+	_xccdf_text_template_walk(root, &subs);
+
+	// Serialize the same way xml_iterate_dfs() does.
+	xmlBuffer *buff = xmlBufferCreate();
+	for (xmlNode *child = root->children; child != NULL; child = child->next)
+		xmlNodeDump(buff, doc, child, 0, 0);
+	xmlFreeDoc(doc);
+
+	const char *p = (const char *) xmlBufferContent(buff);
+	for (size_t i = 0; i < subs.count; ++i) {
+		char *marker = oscap_sprintf(_XCCDF_TEMPLATE_MARKER "%zu@@", i);
+		const char *m = strstr(p, marker);
+
+		if (m == NULL) {
+			dW("Marker of the text substitution #%zu not found in the serialized text.\n", i);
+			oscap_free(marker);
+			tmpl->fallback = true;
+			break;
+		}
+		if (m > p)
+			_xccdf_text_template_add(tmpl, _XCCDF_TOKEN_LITERAL, oscap_sprintf("%.*s", (int) (m - p), p), NULL);
+		_xccdf_text_template_add(tmpl, subs.tokens[i].type, subs.tokens[i].text, subs.tokens[i].use);
+		subs.tokens[i].text = subs.tokens[i].use = NULL;
+		p = m + strlen(marker);
+		oscap_free(marker);
+	}
+	if (!tmpl->fallback && *p != '\0')
+		_xccdf_text_template_add(tmpl, _XCCDF_TOKEN_LITERAL, oscap_strdup(p), NULL);
+
+	xmlBufferFree(buff);
+	for (size_t i = 0; i < subs.count; ++i) {
+		oscap_free(subs.tokens[i].text);
+		oscap_free(subs.tokens[i].use);
+	}
+	oscap_free(subs.tokens);
+	return tmpl;
+}
+
+/*
+ * Append the value escaped the way the text node replacing the element
+ * would be serialized.
+ */
+static void _xccdf_text_append_escaped(xmlBuffer *buff, const char *value)
+{
+	xmlNode *text = xmlNewText(BAD_CAST value);
+	xmlNodeDump(buff, NULL, text, 0, 0);
+	xmlFreeNode(text);
+}
+
+/*
+ * Render the template, returns the same values as the callback would.
+ * The callback leaves the elements it can't resolve in place, these
+ * results are never used, so NULL is returned for them instead.
+ */
+static int _xccdf_text_template_render(const struct _xccdf_text_template *tmpl, struct _xccdf_text_substitution_data *data, char **output_text)
+{
+	struct xccdf_benchmark *benchmark = xccdf_policy_get_benchmark(data->policy);
+	xmlBuffer *buff = xmlBufferCreate();
+	const char *result;
+	int res = 0;
+
+	for (size_t i = 0; i < tmpl->count; ++i) {
+		const struct _xccdf_text_token *token = &tmpl->tokens[i];
+
+		switch (token->type) {
+		case _XCCDF_TOKEN_LITERAL:
+			xmlBufferCat(buff, BAD_CAST token->text);
+			continue;
+		case _XCCDF_TOKEN_SUB:
+			if (oscap_streq(token->text, NULL)) {
+				oscap_seterr(OSCAP_EFAMILY_XCCDF, "The xccdf:sub MUST have a single @idref attribute.");
+				res = 2;
+				continue;
+			}
+			if (benchmark == NULL) {
+				res = 1;
+				goto cleanup;
+			}
+			result = _xccdf_sub_resolve(data, benchmark, token->text, token->use);
+			if (result == NULL) {
+				oscap_seterr(OSCAP_EFAMILY_XCCDF, "Could not resolve xccdf:sub/@idref='%s'!", token->text);
+				res = 2;
+				continue;
+			}
+			break;
+		case _XCCDF_TOKEN_OBJECT:
+			if (benchmark == NULL) {
+				res = 1;
+				goto cleanup;
+			}
+			result = _xccdf_object_resolve(data, benchmark, token->text);
+			break;
+		case _XCCDF_TOKEN_INSTANCE:
+			if (_xccdf_instance_resolve(data, &result) != 0) {
+				res = 1;
+				goto cleanup;
+			}
+			break;
+		}
+		_xccdf_text_append_escaped(buff, result);
+	}
+
+cleanup:
+	*output_text = res == 0 ? oscap_strdup((const char *) xmlBufferContent(buff)) : NULL;
+	xmlBufferFree(buff);
+	return res;
+}
+
+struct xccdf_text_templates *xccdf_text_templates_new(void)
+{
+	struct xccdf_text_templates *templates = oscap_calloc(1, sizeof(struct xccdf_text_templates));
+	pthread_mutex_init(&templates->mutex, NULL);
+	templates->templates = oscap_htable_new1((oscap_compare_func) strcmp, 4093);
+	return templates;
+}
+
+void xccdf_text_templates_free(struct xccdf_text_templates *templates)
+{
+	if (templates == NULL)
+		return;
+	oscap_htable_free(templates->templates, (oscap_destruct_func) _xccdf_text_template_free);
+	pthread_mutex_destroy(&templates->mutex);
+	oscap_free(templates);
+}
+
+static const struct _xccdf_text_template *_xccdf_text_template_get(struct xccdf_policy *policy, const char *text)
+{
+	struct xccdf_policy_model *model = xccdf_policy_get_model(policy);
+	struct xccdf_text_templates *templates = model != NULL ? xccdf_policy_model_get_text_templates(model) : NULL;
+	struct _xccdf_text_template *tmpl;
+
+	if (templates == NULL || text == NULL)
+		return NULL;
+
+	pthread_mutex_lock(&templates->mutex);
+	if ((tmpl = oscap_htable_get(templates->templates, text)) == NULL) {
+		tmpl = _xccdf_text_template_compile(text);
+		oscap_htable_add(templates->templates, text, tmpl);
+	}
+	pthread_mutex_unlock(&templates->mutex);
+
+	// Templates are never modified once compiled.
+	return tmpl;
+}
+
+/*
+ * Substitute the text through its template, or through xml_iterate_dfs()
+ * if there's no usable template.
+ */
+static int _xccdf_text_substitute(const char *text, char **output_text, struct _xccdf_text_substitution_data *data)
+{
+	const struct _xccdf_text_template *tmpl = _xccdf_text_template_get(data->policy, text);
+
+	if (tmpl == NULL || tmpl->fallback)
+		return xml_iterate_dfs(text, output_text, _xccdf_text_substitution_cb, data);
+
+	return _xccdf_text_template_render(tmpl, data, output_text);
+}
+
 int xccdf_policy_resolve_fix_substitution(struct xccdf_policy *policy, struct xccdf_fix *fix, struct xccdf_rule_result *rule_result, struct xccdf_result *test_result)
 {
 	struct _xccdf_text_substitution_data data;
@@ -198,7 +522,7 @@ int xccdf_policy_resolve_fix_substitution(struct xccdf_policy *policy, struct xc
 	data.rule_result = rule_result;
 
 	char *result = NULL;
-	int res = xml_iterate_dfs(xccdf_fix_get_content(fix), &result, _xccdf_text_substitution_cb, &data);
+	int res = _xccdf_text_substitute(xccdf_fix_get_content(fix), &result, &data);
 	if (res == 0)
 		xccdf_fix_set_content(fix, result);
 	oscap_free(result);
@@ -213,7 +537,7 @@ char* xccdf_policy_substitute(const char *text, struct xccdf_policy *policy) {
 	data.processing_type = _DOCUMENT_GENERATION_TYPE | _ASSESSMENT_TYPE;
 
 	char *resolved_text = NULL;
-	if (xml_iterate_dfs(text, &resolved_text, _xccdf_text_substitution_cb, &data) != 0) {
+	if (_xccdf_text_substitute(text, &resolved_text, &data) != 0) {
 		// Either warning or error occured. Since prototype of this function
 		// does not make possible warning notification -> We better scratch that.
 		free(resolved_text);
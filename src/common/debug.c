@@ -86,6 +86,13 @@ static void __oscap_vdlprintf(int level, const char *file, const char *fn, size_
 	char  l;
 	const char *f;
 
+	/*
+	 * The level doesn't change once it's known, don't take the lock
+	 * just to find out that the message isn't going to be logged.
+	 */
+	if (__debuglog_level != -1 && __debuglog_level < level)
+		return;
+
 	__LOCK_FP;
 
 	if (__debuglog_level == -1) {
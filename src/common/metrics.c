@@ -0,0 +1,310 @@
+/*
+ * Copyright 2026 Red Hat Inc., Durham, North Carolina.
+ * All Rights Reserved.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <pthread.h>
+#include <sys/resource.h>
+
+#include "alloc.h"
+#include "list.h"
+#include "util.h"
+#include "_error.h"
+#include "metrics_priv.h"
+
+struct oscap_metrics_entry {
+	char *id;
+	struct oscap_metrics_sample total;
+};
+
+/*
+ * Entries are looked up by their ID in a hash table and also kept in
+ * an array, which is sorted when the profile is exported.
+ */
+struct oscap_metrics_table {
+	struct oscap_htable *index;
+	struct oscap_metrics_entry **entries;
+	size_t count;
+	size_t size;
+};
+
+static const char *oscap_metrics_kind_names[OSCAP_METRICS_KINDS] = {
+	"object", "test", "definition", "rule", "fix", "probe", "load"
+};
+
+volatile bool __oscap_metrics_enabled = false;
+
+static pthread_mutex_t __metrics_mutex = PTHREAD_MUTEX_INITIALIZER;
+static struct oscap_metrics_table __metrics[OSCAP_METRICS_KINDS];
+
+static double oscap_metrics_clock(clockid_t clock)
+{
+	struct timespec ts;
+
+	if (clock_gettime(clock, &ts) != 0)
+		return (0.0);
+
+	return ((double)ts.tv_sec + (double)ts.tv_nsec / 1000000000.0);
+}
+
+void oscap_metrics_enable(void)
+{
+	__oscap_metrics_enabled = true;
+}
+
+bool oscap_metrics_enabled(void)
+{
+	return (__oscap_metrics_enabled);
+}
+
+void oscap_metrics_reset(void)
+{
+	struct oscap_metrics_table *tbl;
+	size_t k, i;
+
+	pthread_mutex_lock(&__metrics_mutex);
+
+	for (k = 0; k < OSCAP_METRICS_KINDS; ++k) {
+		tbl = &__metrics[k];
+
+		for (i = 0; i < tbl->count; ++i) {
+			oscap_free(tbl->entries[i]->id);
+			oscap_free(tbl->entries[i]);
+		}
+
+		oscap_free(tbl->entries);
+		oscap_htable_free(tbl->index, NULL);
+		memset(tbl, 0, sizeof(struct oscap_metrics_table));
+	}
+
+	pthread_mutex_unlock(&__metrics_mutex);
+}
+
+void oscap_metrics_start(struct oscap_metrics_sample *sample)
+{
+	memset(sample, 0, sizeof(struct oscap_metrics_sample));
+
+	if (!__oscap_metrics_enabled)
+		return;
+
+	sample->active = true;
+	sample->calls  = 1;
+	sample->wall   = oscap_metrics_clock(CLOCK_MONOTONIC);
+	sample->cpu    = oscap_metrics_clock(CLOCK_THREAD_CPUTIME_ID);
+}
+
+void oscap_metrics_stop(struct oscap_metrics_sample *sample)
+{
+	if (!sample->active)
+		return;
+
+	sample->wall = oscap_metrics_clock(CLOCK_MONOTONIC) - sample->wall;
+	sample->cpu  = oscap_metrics_clock(CLOCK_THREAD_CPUTIME_ID) - sample->cpu;
+}
+
+void oscap_metrics_max_rss(struct oscap_metrics_sample *sample)
+{
+	struct rusage ru;
+
+	if (!sample->active || getrusage(RUSAGE_SELF, &ru) != 0)
+		return;
+
+	/* ru_maxrss is in kilobytes on Linux */
+	sample->max_rss_kb = (uint64_t)ru.ru_maxrss;
+}
+
+void oscap_metrics_add(oscap_metrics_kind_t kind, const char *id, const struct oscap_metrics_sample *sample)
+{
+	struct oscap_metrics_table *tbl;
+	struct oscap_metrics_entry *entry;
+
+	if (!sample->active || id == NULL || kind >= OSCAP_METRICS_KINDS)
+		return;
+
+	pthread_mutex_lock(&__metrics_mutex);
+
+	tbl = &__metrics[kind];
+
+	if (tbl->index == NULL)
+		tbl->index = oscap_htable_new();
+
+	entry = oscap_htable_get(tbl->index, id);
+
+	if (entry == NULL) {
+		entry = oscap_talloc(struct oscap_metrics_entry);
+		memset(entry, 0, sizeof(struct oscap_metrics_entry));
+		entry->id = oscap_strdup(id);
+
+		if (tbl->count == tbl->size) {
+			tbl->size = tbl->size > 0 ? tbl->size * 2 : 64;
+			tbl->entries = oscap_realloc(tbl->entries, tbl->size * sizeof(struct oscap_metrics_entry *));
+		}
+
+		tbl->entries[tbl->count++] = entry;
+		oscap_htable_add(tbl->index, entry->id, entry);
+	}
+
+	entry->total.calls      += sample->calls;
+	entry->total.wall       += sample->wall;
+	entry->total.cpu        += sample->cpu;
+	entry->total.probe_cpu  += sample->probe_cpu;
+	entry->total.items      += sample->items;
+	entry->total.bytes_in   += sample->bytes_in;
+	entry->total.bytes_out  += sample->bytes_out;
+	entry->total.cache_hits += sample->cache_hits;
+
+	if (sample->max_rss_kb > entry->total.max_rss_kb)
+		entry->total.max_rss_kb = sample->max_rss_kb;
+
+	pthread_mutex_unlock(&__metrics_mutex);
+}
+
+void oscap_metrics_add_probe_startup(const char *probe_name, double seconds, void *arg)
+{
+	struct oscap_metrics_sample sample;
+	(void)arg;
+
+	oscap_metrics_start(&sample);
+	sample.wall = seconds;
+	sample.cpu  = 0.0;
+
+	oscap_metrics_add(OSCAP_METRICS_PROBE, probe_name, &sample);
+}
+
+static int oscap_metrics_entry_cmp(const void *a, const void *b)
+{
+	const struct oscap_metrics_entry *ea = *(const struct oscap_metrics_entry **)a;
+	const struct oscap_metrics_entry *eb = *(const struct oscap_metrics_entry **)b;
+
+	if (ea->total.wall != eb->total.wall)
+		return (ea->total.wall < eb->total.wall ? 1 : -1);
+
+	return strcmp(ea->id, eb->id);
+}
+
+static void oscap_metrics_json_string(FILE *fp, const char *str)
+{
+	fputc('"', fp);
+
+	for (; *str != '\0'; ++str) {
+		if (*str == '"' || *str == '\\')
+			fprintf(fp, "\\%c", *str);
+		else if ((unsigned char)*str < 0x20)
+			fprintf(fp, "\\u%04x", (unsigned char)*str);
+		else
+			fputc(*str, fp);
+	}
+
+	fputc('"', fp);
+}
+
+static void oscap_metrics_write(FILE *fp, bool csv)
+{
+	struct oscap_metrics_table *tbl;
+	struct oscap_metrics_sample *s;
+	double total, cumulative;
+	size_t k, i;
+
+	if (csv)
+		fprintf(fp, "kind,id,calls,wall_s,cpu_s,probe_cpu_s,items,bytes_in,bytes_out,cache_hits,max_rss_kb,cumulative_share\n");
+	else
+		fprintf(fp, "{");
+
+	for (k = 0; k < OSCAP_METRICS_KINDS; ++k) {
+		tbl = &__metrics[k];
+
+		if (tbl->count > 0)
+			qsort(tbl->entries, tbl->count, sizeof(struct oscap_metrics_entry *), &oscap_metrics_entry_cmp);
+
+		for (total = 0.0, i = 0; i < tbl->count; ++i)
+			total += tbl->entries[i]->total.wall;
+
+		if (!csv)
+			fprintf(fp, "%s\n\"%ss\": [", k > 0 ? "," : "", oscap_metrics_kind_names[k]);
+		/*
+		 * The cumulative share of the wall time makes it easy to see
+		 * how many entries are responsible for most of the scan time.
+		 */
+		for (cumulative = 0.0, i = 0; i < tbl->count; ++i) {
+			s = &tbl->entries[i]->total;
+			cumulative += s->wall;
+
+			if (csv) {
+				fprintf(fp, "%s,%s,", oscap_metrics_kind_names[k], tbl->entries[i]->id);
+			} else {
+				fprintf(fp, "%s\n  {\"id\": ", i > 0 ? "," : "");
+				oscap_metrics_json_string(fp, tbl->entries[i]->id);
+				fprintf(fp, ", ");
+			}
+
+			fprintf(fp, csv ?
+				"%u,%.6f,%.6f,%.6f,%llu,%llu,%llu,%llu,%llu,%.4f\n" :
+				"\"calls\": %u, \"wall_s\": %.6f, \"cpu_s\": %.6f, \"probe_cpu_s\": %.6f, "
+				"\"items\": %llu, \"bytes_in\": %llu, \"bytes_out\": %llu, \"cache_hits\": %llu, "
+				"\"max_rss_kb\": %llu, \"cumulative_share\": %.4f}",
+				s->calls, s->wall, s->cpu, s->probe_cpu,
+				(unsigned long long)s->items, (unsigned long long)s->bytes_in,
+				(unsigned long long)s->bytes_out, (unsigned long long)s->cache_hits,
+				(unsigned long long)s->max_rss_kb,
+				total > 0.0 ? cumulative / total : 0.0);
+		}
+
+		if (!csv)
+			fprintf(fp, "%s]", tbl->count > 0 ? "\n" : "");
+	}
+
+	if (!csv)
+		fprintf(fp, "\n}\n");
+}
+
+int oscap_metrics_export(const char *filename)
+{
+	size_t len;
+	bool csv;
+	FILE *fp;
+
+	if (filename == NULL)
+		return (-1);
+
+	if ((fp = fopen(filename, "w")) == NULL) {
+		oscap_seterr(OSCAP_EFAMILY_GLIBC, "Can't open %s: %s", filename, strerror(errno));
+		return (-1);
+	}
+
+	len = strlen(filename);
+	csv = len > 4 && strcmp(filename + len - 4, ".csv") == 0;
+
+	pthread_mutex_lock(&__metrics_mutex);
+	oscap_metrics_write(fp, csv);
+	pthread_mutex_unlock(&__metrics_mutex);
+
+	if (fclose(fp) != 0) {
+		oscap_seterr(OSCAP_EFAMILY_GLIBC, "Can't write %s: %s", filename, strerror(errno));
+		return (-1);
+	}
+
+	return (0);
+}
@@ -0,0 +1,93 @@
+/**
+ * @file metrics_priv.h
+ * @brief Scan profile collection
+ */
+/*
+ * Copyright 2026 Red Hat Inc., Durham, North Carolina.
+ * All Rights Reserved.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#pragma once
+#ifndef OSCAP_METRICS_PRIV_H_
+#define OSCAP_METRICS_PRIV_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "util.h"
+#include "public/oscap_metrics.h"
+
+OSCAP_HIDDEN_START;
+
+typedef enum {
+	OSCAP_METRICS_OBJECT = 0,
+	OSCAP_METRICS_TEST,
+	OSCAP_METRICS_DEFINITION,
+	OSCAP_METRICS_RULE,
+	OSCAP_METRICS_FIX,
+	OSCAP_METRICS_PROBE,
+	OSCAP_METRICS_LOAD,
+	OSCAP_METRICS_KINDS
+} oscap_metrics_kind_t;
+
+/**
+ * One measurement. Samples added for the same entity are summed up,
+ * so partial samples (e.g. only the probe side of an object query)
+ * can be added separately.
+ */
+struct oscap_metrics_sample {
+	bool     active;     ///< set by oscap_metrics_start if the profile is being collected
+	uint32_t calls;      ///< number of evaluations
+	double   wall;       ///< wall clock time in seconds
+	double   cpu;        ///< CPU time of the calling thread in seconds
+	double   probe_cpu;  ///< CPU time spent in the probe in seconds
+	uint64_t items;      ///< number of collected items
+	uint64_t bytes_in;   ///< bytes received from the probe
+	uint64_t bytes_out;  ///< bytes sent to the probe
+	uint64_t cache_hits; ///< results served from a cache
+	uint64_t max_rss_kb; ///< peak resident set size of the process in KiB, the samples keep the maximum
+};
+
+extern volatile bool __oscap_metrics_enabled;
+
+/**
+ * Initialize the sample and start measuring one call. Does nothing
+ * but clearing the sample if the profile isn't being collected.
+ */
+void oscap_metrics_start(struct oscap_metrics_sample *sample);
+
+/**
+ * Stop measuring: wall and cpu are set to the time elapsed since
+ * oscap_metrics_start.
+ */
+void oscap_metrics_stop(struct oscap_metrics_sample *sample);
+
+/**
+ * Set max_rss_kb to the peak resident set size the process has reached so
+ * far. Call it after oscap_metrics_stop to record the memory peak of the
+ * measured call.
+ */
+void oscap_metrics_max_rss(struct oscap_metrics_sample *sample);
+
+/**
+ * Add the sample to the totals of the given entity. Does nothing if the
+ * sample isn't active.
+ */
+void oscap_metrics_add(oscap_metrics_kind_t kind, const char *id, const struct oscap_metrics_sample *sample);
+
+OSCAP_HIDDEN_END;
+
+#endif
@@ -0,0 +1,75 @@
+/**
+ * @file oscap_metrics.h
+ * @brief Scan profile: time and resources spent per object, test, definition and rule
+ */
+/*
+ * Copyright 2026 Red Hat Inc., Durham, North Carolina.
+ * All Rights Reserved.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#pragma once
+#ifndef OSCAP_METRICS_H_
+#define OSCAP_METRICS_H_
+
+#include <stdbool.h>
+
+/**
+ * Start collecting the scan profile. The collection is process-wide
+ * and covers everything evaluated after this call:
+ *  - OVAL objects: wall time, CPU time of the library and of the probe,
+ *    number of collected items, bytes sent to and received from the probe
+ *    and the number of answers served from the library and probe caches
+ *  - OVAL tests and definitions: wall and CPU time of the evaluation
+ *  - XCCDF rules: wall and CPU time including the checks
+ *  - XCCDF fixes executed by the remediation: wall time and CPU time
+ *    of the interpreter, identified by the rule
+ *  - probes: startup time, as given to oscap_metrics_add_probe_startup
+ *  - OVAL definition loads: wall and CPU time, number of loaded definitions
+ *    and the peak resident set size of the process when the load finished
+ */
+void oscap_metrics_enable(void);
+
+/**
+ * Check whether the scan profile is being collected.
+ */
+bool oscap_metrics_enabled(void);
+
+/**
+ * Drop everything collected so far.
+ */
+void oscap_metrics_reset(void);
+
+/**
+ * Add the startup time of a probe to the scan profile. The signature
+ * matches oval_probe_startup_reporter, so the function can be set as the
+ * probe startup reporter of an evaluation session.
+ * @param probe_name name of the probe
+ * @param seconds time from the start of the probe until it was ready
+ * @param arg unused
+ */
+void oscap_metrics_add_probe_startup(const char *probe_name, double seconds, void *arg);
+
+/**
+ * Write the scan profile to a file. Entries are sorted by the wall
+ * time, most expensive first. The file is written in the CSV format
+ * if its name ends with ".csv", in JSON otherwise.
+ * @param filename path of the output file
+ * @return 0 on success, -1 on error
+ */
+int oscap_metrics_export(const char *filename);
+
+#endif
@@ -0,0 +1,208 @@
+/*
+ * Copyright 2026 Red Hat Inc., Durham, North Carolina.
+ * All Rights Reserved.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <stdint.h>
+#include <string.h>
+
+#include "alloc.h"
+#include "strpool_priv.h"
+
+/// Size of the blocks the strings are packed into
+#ifndef OSCAP_STRPOOL_BLOCK_SIZE
+# define OSCAP_STRPOOL_BLOCK_SIZE 65536
+#endif
+
+/// Initial number of hash table slots, must be a power of 2
+#ifndef OSCAP_STRPOOL_SLOTS
+# define OSCAP_STRPOOL_SLOTS 1024
+#endif
+
+struct oscap_strpool_block {
+	struct oscap_strpool_block *next;
+	size_t size;
+	size_t used;
+	char data[];
+};
+
+/*
+ * Open addressing with linear probing. The hash is stored along with
+ * the string so that most of the mismatching slots are skipped without
+ * touching the string and so that growing doesn't rehash anything.
+ */
+struct oscap_strpool_slot {
+	uint32_t hash;
+	const char *str;
+};
+
+struct oscap_strpool {
+	struct oscap_strpool_slot *slots;
+	size_t mask;
+	struct oscap_strpool_block *blocks;
+	struct oscap_strpool_stats stats;
+};
+
+static uint32_t oscap_strpool_hash(const char *str, size_t *len)
+{
+	const unsigned char *p = (const unsigned char *)str;
+	uint32_t h = 2166136261U;
+
+	while (*p != '\0') {
+		h ^= *p++;
+		h *= 16777619U;
+	}
+
+	*len = (const char *)p - str;
+
+	return (h);
+}
+
+struct oscap_strpool *oscap_strpool_new(void)
+{
+	struct oscap_strpool *pool;
+
+	pool = oscap_talloc(struct oscap_strpool);
+	memset(pool, 0, sizeof(struct oscap_strpool));
+
+	pool->slots = oscap_calloc(OSCAP_STRPOOL_SLOTS, sizeof(struct oscap_strpool_slot));
+	pool->mask  = OSCAP_STRPOOL_SLOTS - 1;
+
+	return (pool);
+}
+
+static void oscap_strpool_grow(struct oscap_strpool *pool)
+{
+	struct oscap_strpool_slot *slots;
+	size_t i, j, mask;
+
+	mask  = (pool->mask << 1) | 1;
+	slots = oscap_calloc(mask + 1, sizeof(struct oscap_strpool_slot));
+
+	for (i = 0; i <= pool->mask; ++i) {
+		if (pool->slots[i].str == NULL)
+			continue;
+
+		for (j = pool->slots[i].hash & mask; slots[j].str != NULL; j = (j + 1) & mask)
+			;
+
+		slots[j] = pool->slots[i];
+	}
+
+	oscap_free(pool->slots);
+	pool->slots = slots;
+	pool->mask  = mask;
+}
+
+static char *oscap_strpool_store(struct oscap_strpool *pool, const char *str, size_t len)
+{
+	struct oscap_strpool_block *block;
+	size_t size;
+	char *copy;
+
+	block = pool->blocks;
+
+	if (block == NULL || block->size - block->used < len + 1) {
+		/*
+		 * Long strings get a block of their own and the current block
+		 * stays in use, so they don't waste the rest of it.
+		 */
+		size  = len + 1 > OSCAP_STRPOOL_BLOCK_SIZE / 4 ? len + 1 : OSCAP_STRPOOL_BLOCK_SIZE;
+		block = oscap_alloc(sizeof(struct oscap_strpool_block) + size);
+		block->size = size;
+		block->used = 0;
+
+		if (pool->blocks != NULL && size != OSCAP_STRPOOL_BLOCK_SIZE) {
+			block->next = pool->blocks->next;
+			pool->blocks->next = block;
+		} else {
+			block->next  = pool->blocks;
+			pool->blocks = block;
+		}
+	}
+
+	copy = block->data + block->used;
+	memcpy(copy, str, len + 1);
+	block->used += len + 1;
+
+	return (copy);
+}
+
+const char *oscap_strpool_intern(struct oscap_strpool *pool, const char *str)
+{
+	struct oscap_strpool_slot *slot;
+	uint32_t hash;
+	size_t i, len;
+
+	if (str == NULL)
+		return (NULL);
+
+	hash = oscap_strpool_hash(str, &len);
+
+	for (i = hash & pool->mask;; i = (i + 1) & pool->mask) {
+		slot = pool->slots + i;
+
+		if (slot->str == NULL)
+			break;
+
+		if (slot->hash == hash && strcmp(slot->str, str) == 0) {
+			++pool->stats.hits;
+			return (slot->str);
+		}
+	}
+
+	slot->hash = hash;
+	slot->str  = oscap_strpool_store(pool, str, len);
+
+	++pool->stats.misses;
+	++pool->stats.count;
+	pool->stats.bytes += len + 1;
+
+	if (pool->stats.count * 4 > (pool->mask + 1) * 3) {
+		const char *copy = slot->str;
+
+		oscap_strpool_grow(pool);
+		return (copy);
+	}
+
+	return (slot->str);
+}
+
+void oscap_strpool_stats(const struct oscap_strpool *pool, struct oscap_strpool_stats *stats)
+{
+	*stats = pool->stats;
+}
+
+void oscap_strpool_free(struct oscap_strpool *pool)
+{
+	struct oscap_strpool_block *block, *next;
+
+	if (pool == NULL)
+		return;
+
+	for (block = pool->blocks; block != NULL; block = next) {
+		next = block->next;
+		oscap_free(block);
+	}
+
+	oscap_free(pool->slots);
+	oscap_free(pool);
+}
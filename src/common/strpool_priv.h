@@ -0,0 +1,62 @@
+/**
+ * @file strpool_priv.h
+ * @brief Pool of interned strings
+ */
+/*
+ * Copyright 2026 Red Hat Inc., Durham, North Carolina.
+ * All Rights Reserved.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#pragma once
+#ifndef OSCAP_STRPOOL_PRIV_H_
+#define OSCAP_STRPOOL_PRIV_H_
+
+#include <stddef.h>
+#include "util.h"
+
+OSCAP_HIDDEN_START;
+
+/*
+ * Every distinct string is stored only once in the pool and lives as long
+ * as the pool itself. The strings are packed into large blocks, so
+ * interning a string which isn't in the pool yet doesn't cost an extra
+ * allocation either. The pool is not thread-safe.
+ */
+struct oscap_strpool;
+
+struct oscap_strpool_stats {
+	size_t count;  ///< number of distinct strings
+	size_t bytes;  ///< bytes used by the strings, including the terminators
+	size_t hits;   ///< lookups which found the string in the pool
+	size_t misses; ///< lookups which added the string to the pool
+};
+
+struct oscap_strpool *oscap_strpool_new(void);
+
+/**
+ * Get the pooled copy of a string, adding it to the pool if needed.
+ * The returned string must not be modified or freed.
+ */
+const char *oscap_strpool_intern(struct oscap_strpool *pool, const char *str);
+
+void oscap_strpool_stats(const struct oscap_strpool *pool, struct oscap_strpool_stats *stats);
+
+void oscap_strpool_free(struct oscap_strpool *pool);
+
+OSCAP_HIDDEN_END;
+
+#endif
@@ -0,0 +1,353 @@
+/*
+ * Copyright 2026 Red Hat Inc., Durham, North Carolina.
+ * All Rights Reserved.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <time.h>
+#include <pthread.h>
+
+#include "trace_priv.h"
+
+/*
+ * Every thread owns a ring buffer. The thread is the only producer,
+ * the flusher thread is the only consumer, so the head and tail
+ * indexes are enough for synchronization. Rings of exited threads
+ * are freed by the flusher once they're drained.
+ */
+struct oscap_trace_ring {
+	struct oscap_trace_event ev[OSCAP_TRACE_RING_SIZE];
+	volatile uint32_t head;
+	volatile uint32_t tail;
+	volatile uint32_t dropped;
+	uint32_t reported;
+	uint32_t tid;
+	volatile bool detached;
+	struct oscap_trace_ring *next;
+};
+
+int __oscap_trace_state = -1;
+
+static pthread_mutex_t __trace_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t  __trace_cond  = PTHREAD_COND_INITIALIZER;
+static pthread_key_t   __trace_key;
+static pthread_t       __trace_flusher;
+static bool            __trace_stop  = false;
+static bool            __trace_atfork = false;
+static struct oscap_trace_ring *__trace_rings = NULL;
+static uint32_t __trace_next_tid = 0;
+static uint32_t __trace_pid = 0;
+static int      __trace_fd = -1;
+
+static uint64_t oscap_trace_now(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return ((uint64_t)ts.tv_sec * 1000000000 + (uint64_t)ts.tv_nsec);
+}
+
+static void oscap_trace_write(const void *buf, size_t len)
+{
+	const char *p = buf;
+	ssize_t n;
+
+	while (len > 0) {
+		n = write(__trace_fd, p, len);
+
+		if (n < 0) {
+			if (errno == EINTR)
+				continue;
+			return;
+		}
+
+		p   += n;
+		len -= (size_t)n;
+	}
+}
+
+static void oscap_trace_fill(struct oscap_trace_event *ev, uint32_t tid, char phase,
+			     const char *name, const char *arg, uint64_t count, uint64_t bytes)
+{
+	ev->ts    = oscap_trace_now();
+	ev->count = count;
+	ev->bytes = bytes;
+	ev->pid   = __trace_pid;
+	ev->tid   = tid;
+	ev->phase = phase;
+
+	strncpy(ev->name, name, sizeof ev->name - 1);
+	ev->name[sizeof ev->name - 1] = '\0';
+
+	if (arg != NULL) {
+		strncpy(ev->arg, arg, sizeof ev->arg - 1);
+		ev->arg[sizeof ev->arg - 1] = '\0';
+	} else
+		ev->arg[0] = '\0';
+}
+
+/*
+ * Write out the events buffered in the ring. Called with __trace_mutex
+ * locked, which only serializes the consumers.
+ */
+static void oscap_trace_drain(struct oscap_trace_ring *ring)
+{
+	uint32_t head, tail, beg, end, dropped;
+	struct oscap_trace_event ev;
+
+	head = ring->head;
+	__sync_synchronize();
+	tail = ring->tail;
+
+	while (tail != head) {
+		beg = tail % OSCAP_TRACE_RING_SIZE;
+		end = head % OSCAP_TRACE_RING_SIZE;
+
+		if (end <= beg)
+			end = OSCAP_TRACE_RING_SIZE;
+
+		oscap_trace_write(ring->ev + beg, (end - beg) * sizeof(struct oscap_trace_event));
+		tail += end - beg;
+	}
+
+	__sync_synchronize();
+	ring->tail = tail;
+
+	dropped = ring->dropped;
+
+	if (dropped != ring->reported) {
+		oscap_trace_fill(&ev, ring->tid, OSCAP_TRACE_INSTANT, "trace_dropped", NULL,
+				 dropped - ring->reported, 0);
+		oscap_trace_write(&ev, sizeof ev);
+		ring->reported = dropped;
+	}
+}
+
+static void oscap_trace_flush(void)
+{
+	struct oscap_trace_ring *ring, **prev;
+	bool detached;
+
+	prev = &__trace_rings;
+
+	while ((ring = *prev) != NULL) {
+		/*
+		 * The owner doesn't produce any events after it's marked
+		 * as detached, so check that before draining the ring.
+		 */
+		detached = ring->detached;
+		__sync_synchronize();
+		oscap_trace_drain(ring);
+
+		if (detached) {
+			*prev = ring->next;
+			free(ring);
+		} else
+			prev = &ring->next;
+	}
+}
+
+static void *oscap_trace_flusher(void *arg)
+{
+	struct timespec deadline;
+
+	pthread_mutex_lock(&__trace_mutex);
+
+	while (!__trace_stop) {
+		clock_gettime(CLOCK_REALTIME, &deadline);
+
+		deadline.tv_nsec += OSCAP_TRACE_FLUSH_MS * 1000000L;
+		deadline.tv_sec  += deadline.tv_nsec / 1000000000L;
+		deadline.tv_nsec %= 1000000000L;
+
+		pthread_cond_timedwait(&__trace_cond, &__trace_mutex, &deadline);
+		oscap_trace_flush();
+	}
+
+	pthread_mutex_unlock(&__trace_mutex);
+
+	return (NULL);
+}
+
+static void oscap_trace_ring_detach(void *arg)
+{
+	struct oscap_trace_ring *ring = arg;
+
+	__sync_synchronize();
+	ring->detached = true;
+}
+
+static void oscap_trace_exit(void)
+{
+	pthread_mutex_lock(&__trace_mutex);
+
+	if (__oscap_trace_state <= 0 || __trace_stop) {
+		pthread_mutex_unlock(&__trace_mutex);
+		return;
+	}
+
+	__trace_stop = true;
+	pthread_cond_signal(&__trace_cond);
+	pthread_mutex_unlock(&__trace_mutex);
+
+	pthread_join(__trace_flusher, NULL);
+
+	pthread_mutex_lock(&__trace_mutex);
+	oscap_trace_flush();
+	close(__trace_fd);
+	__trace_fd = -1;
+	__oscap_trace_state = 0;
+	pthread_mutex_unlock(&__trace_mutex);
+}
+
+/*
+ * The flusher thread doesn't survive fork(). Tracing is initialized
+ * again in the child, with its own trace file. Rings inherited from
+ * the parent are abandoned; the threads that owned them don't exist
+ * in the child anyway.
+ */
+static void oscap_trace_atfork_child(void)
+{
+	pthread_mutex_init(&__trace_mutex, NULL);
+	pthread_cond_init(&__trace_cond, NULL);
+
+	if (__oscap_trace_state > 0) {
+		close(__trace_fd);
+		__trace_fd    = -1;
+		__trace_rings = NULL;
+		__trace_stop  = false;
+		__trace_next_tid = 0;
+		pthread_setspecific(__trace_key, NULL);
+		__oscap_trace_state = -1;
+	}
+}
+
+bool __oscap_trace_init(void)
+{
+	struct oscap_trace_header hdr;
+	char *prefix, path[4096];
+
+	pthread_mutex_lock(&__trace_mutex);
+
+	if (__oscap_trace_state >= 0)
+		goto out;
+
+	__oscap_trace_state = 0;
+
+	if (!__trace_atfork) {
+		pthread_key_create(&__trace_key, &oscap_trace_ring_detach);
+		pthread_atfork(NULL, NULL, &oscap_trace_atfork_child);
+		atexit(&oscap_trace_exit);
+		__trace_atfork = true;
+	}
+
+	if ((prefix = getenv(OSCAP_TRACE_FILE_ENV)) == NULL || *prefix == '\0')
+		goto out;
+
+	if (snprintf(path, sizeof path, "%s.%u", prefix,
+		     (unsigned int)getpid()) >= (signed int) sizeof path)
+		goto out;
+
+	if ((__trace_fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0600)) < 0)
+		goto out;
+
+	memset(&hdr, 0, sizeof hdr);
+	memcpy(hdr.magic, OSCAP_TRACE_MAGIC, sizeof hdr.magic);
+	hdr.event_size = sizeof(struct oscap_trace_event);
+	hdr.pid = __trace_pid = (uint32_t)getpid();
+	oscap_trace_write(&hdr, sizeof hdr);
+
+	__trace_stop = false;
+
+	if (pthread_create(&__trace_flusher, NULL, &oscap_trace_flusher, NULL) != 0) {
+		close(__trace_fd);
+		__trace_fd = -1;
+		goto out;
+	}
+
+	__oscap_trace_state = 1;
+out:
+	pthread_mutex_unlock(&__trace_mutex);
+
+	return (__oscap_trace_state > 0);
+}
+
+static struct oscap_trace_ring *oscap_trace_ring_get(void)
+{
+	struct oscap_trace_ring *ring;
+
+	if ((ring = pthread_getspecific(__trace_key)) != NULL)
+		return (ring);
+
+	ring = malloc(sizeof(struct oscap_trace_ring));
+
+	if (ring == NULL)
+		return (NULL);
+
+	ring->head = 0;
+	ring->tail = 0;
+	ring->dropped  = 0;
+	ring->reported = 0;
+	ring->detached = false;
+
+	pthread_mutex_lock(&__trace_mutex);
+	ring->tid  = __trace_next_tid++;
+	ring->next = __trace_rings;
+	__trace_rings = ring;
+	pthread_mutex_unlock(&__trace_mutex);
+
+	pthread_setspecific(__trace_key, ring);
+
+	return (ring);
+}
+
+void __oscap_trace_event(char phase, const char *name, const char *arg, uint64_t count, uint64_t bytes)
+{
+	struct oscap_trace_ring *ring;
+	uint32_t head;
+
+	if ((ring = oscap_trace_ring_get()) == NULL)
+		return;
+
+	head = ring->head;
+
+	switch (head - ring->tail) {
+	case OSCAP_TRACE_RING_SIZE:
+		++ring->dropped;
+		return;
+	case OSCAP_TRACE_RING_SIZE / 2:
+		/* wake up the flusher early, it may miss it, but it's cheap */
+		pthread_cond_signal(&__trace_cond);
+		break;
+	}
+
+	oscap_trace_fill(ring->ev + head % OSCAP_TRACE_RING_SIZE, ring->tid,
+			 phase, name, arg, count, bytes);
+
+	__sync_synchronize();
+	ring->head = head + 1;
+}
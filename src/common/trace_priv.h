@@ -0,0 +1,123 @@
+/**
+ * @file trace_priv.h
+ * @brief Low-overhead structured tracing
+ */
+/*
+ * Copyright 2026 Red Hat Inc., Durham, North Carolina.
+ * All Rights Reserved.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#pragma once
+#ifndef OSCAP_TRACE_PRIV_H_
+#define OSCAP_TRACE_PRIV_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/*
+ * Unlike the debug log, tracing is compiled in unconditionally and
+ * costs a single branch when it's disabled. When enabled, events are
+ * stored in per-thread ring buffers without any locking and written
+ * to the trace file by a background thread. If a ring buffer is full,
+ * the event is dropped and counted instead of blocking the caller.
+ *
+ * The trace file consists of a header (struct oscap_trace_header)
+ * followed by fixed-size records (struct oscap_trace_event). All
+ * integers are in host byte order. Timestamps are taken from the
+ * monotonic clock, so the traces of the library and of the probes
+ * can be merged.
+ */
+
+/**
+ * Name of the environment variable which enables tracing. The value
+ * is used as a path prefix, the process ID is appended to it.
+ */
+#ifndef OSCAP_TRACE_FILE_ENV
+# define OSCAP_TRACE_FILE_ENV "OSCAP_TRACE_FILE"
+#endif
+
+#define OSCAP_TRACE_MAGIC "OSCAPTR1"
+
+/// Number of events buffered per thread, must be a power of 2
+#ifndef OSCAP_TRACE_RING_SIZE
+# define OSCAP_TRACE_RING_SIZE 1024
+#endif
+
+/// How often the background thread flushes the buffers (in milliseconds)
+#ifndef OSCAP_TRACE_FLUSH_MS
+# define OSCAP_TRACE_FLUSH_MS 100
+#endif
+
+/*
+ * The phase values are the ones used by the Chrome trace event format.
+ */
+#define OSCAP_TRACE_BEGIN   'B'
+#define OSCAP_TRACE_END     'E'
+#define OSCAP_TRACE_INSTANT 'i'
+
+struct oscap_trace_header {
+	char     magic[8];
+	uint32_t event_size;
+	uint32_t pid;
+};
+
+struct oscap_trace_event {
+	uint64_t ts;       ///< monotonic time in nanoseconds
+	uint64_t count;    ///< e.g. the number of collected items
+	uint64_t bytes;    ///< e.g. the number of bytes sent or received
+	uint32_t pid;
+	uint32_t tid;      ///< sequential thread number within the process
+	char     phase;
+	char     name[23]; ///< event name, truncated
+	char     arg[72];  ///< event argument (object ID, ...), truncated
+};
+
+extern int __oscap_trace_state;
+
+void __oscap_trace_event(char phase, const char *name, const char *arg, uint64_t count, uint64_t bytes);
+bool __oscap_trace_init(void);
+
+/**
+ * Check whether tracing is enabled. Use this to avoid computing
+ * arguments of trace events when nobody's going to see them.
+ */
+#define oscap_trace_enabled() \
+	(__oscap_trace_state > 0 || (__oscap_trace_state < 0 && __oscap_trace_init()))
+
+#define oscap_trace(phase, name, arg, count, bytes)				\
+	do {									\
+		if (oscap_trace_enabled())					\
+			__oscap_trace_event((phase), (name), (arg), (count), (bytes)); \
+	} while (0)
+
+/**
+ * Begin a span. Spans must be properly nested within a thread.
+ * @param name static event name
+ * @param arg  argument, e.g. an object ID, or NULL
+ */
+#define oscap_trace_begin(name, arg) oscap_trace(OSCAP_TRACE_BEGIN, (name), (arg), 0, 0)
+
+/**
+ * End the span started by oscap_trace_begin.
+ * @param count number of processed things (items, objects, ...)
+ * @param bytes number of processed bytes
+ */
+#define oscap_trace_end(name, arg, count, bytes) oscap_trace(OSCAP_TRACE_END, (name), (arg), (count), (bytes))
+
+#define oscap_trace_instant(name, arg, count, bytes) oscap_trace(OSCAP_TRACE_INSTANT, (name), (arg), (count), (bytes))
+
+#endif
@@ -29,6 +29,7 @@
 
 #include <bzlib.h>
 #include <libxml/tree.h>
+#include <libxml/xmlreader.h>
 #include <stdlib.h>
 #include <string.h>
 
@@ -104,6 +105,15 @@ xmlDoc *bz2_file_read_doc(const char *filepath)
 	return xmlReadIO((xmlInputReadCallback) bz2_file_read, bz2_file_close, bzfile, "url", NULL, XML_PARSE_PEDANTIC);
 }
 
+xmlTextReader *bz2_file_reader(const char *filepath)
+{
+	struct bz2_file *bzfile = bz2_file_open(filepath);
+	if (bzfile == NULL) {
+		return NULL;
+	}
+	return xmlReaderForIO((xmlInputReadCallback) bz2_file_read, bz2_file_close, bzfile, "url", NULL, XML_PARSE_PEDANTIC);
+}
+
 struct bz2_mem {
 	bz_stream *stream;
 	bool eof;
@@ -178,6 +188,15 @@ xmlDoc *bz2_mem_read_doc(const char *buffer, size_t size)
 	return xmlReadIO((xmlInputReadCallback) bz2_mem_read, bz2_mem_close, bzmem, "url", NULL, XML_PARSE_PEDANTIC);
 }
 
+xmlTextReader *bz2_mem_reader(const char *buffer, size_t size)
+{
+	struct bz2_mem *bzmem = bz2_mem_open(buffer, size);
+	if (bzmem == NULL) {
+		return NULL;
+	}
+	return xmlReaderForIO((xmlInputReadCallback) bz2_mem_read, bz2_mem_close, bzmem, "url", NULL, XML_PARSE_PEDANTIC);
+}
+
 bool bz2_file_is_bzip(const char *filepath)
 {
 	int offset = strlen(filepath) - strlen(".xml.bz2");
@@ -30,6 +30,7 @@
 #include "common/public/oscap.h"
 #include "common/util.h"
 #include <libxml/tree.h>
+#include <libxml/xmlreader.h>
 
 OSCAP_HIDDEN_START;
 
@@ -48,6 +49,22 @@ xmlDoc *bz2_file_read_doc(const char *filepath);
  */
 xmlDoc *bz2_mem_read_doc(const char *buffer, size_t size);
 
+/**
+ * Create a streaming reader of *.xml.bz2 file, the file is
+ * decompressed as the reader advances.
+ * @param filepath The path to *.xml.bz2 file
+ * @returns xmlTextReader to be disposed by the caller
+ */
+xmlTextReader *bz2_file_reader(const char *filepath);
+
+/**
+ * Create a streaming reader of bzip2ed memory.
+ * @param buffer data in memory to process (contains bzip2ed XML)
+ * @param size length of data
+ * @returns xmlTextReader to be disposed by the caller
+ */
+xmlTextReader *bz2_mem_reader(const char *buffer, size_t size);
+
 /**
  * Recognize whether the file can be parsed by this
  * bz2 parser.
@@ -24,6 +24,8 @@
 #include <config.h>
 #endif
 
+#include <errno.h>
+#include <stdio.h>
 #include <string.h>
 #include <libxml/parser.h>
 #include <libxml/xmlreader.h>
@@ -136,10 +138,81 @@ xmlTextReader *oscap_source_get_xmlTextReader(struct oscap_source *source)
 	return reader;
 }
 
+// xmlInputReadCallback
+static int oscap_source_file_read(void *context, char *buffer, int len)
+{
+	size_t n = fread(buffer, 1, len, (FILE *) context);
+	if (n == 0 && ferror((FILE *) context))
+		return -1;
+	return (int) n;
+}
+
+// xmlInputCloseCallback
+static int oscap_source_file_close(void *context)
+{
+	return fclose((FILE *) context) == 0 ? 0 : -1;
+}
+
+xmlTextReader *oscap_source_get_streaming_xmlTextReader(struct oscap_source *source)
+{
+	xmlTextReader *reader;
+
+	if (source->xml.doc != NULL) {
+		// The DOM has been built already, don't parse the content again
+		return oscap_source_get_xmlTextReader(source);
+	}
+	if (source->origin.memory != NULL) {
+#ifdef HAVE_BZ2
+		if (bz2_file_is_bzip(source->origin.filepath))
+			reader = bz2_mem_reader(source->origin.memory, source->origin.memory_size);
+		else
+#endif
+			reader = xmlReaderForMemory(source->origin.memory, source->origin.memory_size, NULL, NULL, 0);
+	}
+	else {
+#ifdef HAVE_BZ2
+		if (bz2_file_is_bzip(source->origin.filepath))
+			reader = bz2_file_reader(source->origin.filepath);
+		else
+#endif
+		{
+			FILE *fp = fopen(source->origin.filepath, "rb");
+			if (fp == NULL) {
+				oscap_seterr(OSCAP_EFAMILY_GLIBC, "Unable to open file: '%s': %s",
+						oscap_source_readable_origin(source), strerror(errno));
+				return NULL;
+			}
+			// The reader closes the file, also when it fails to be created
+			reader = xmlReaderForIO(oscap_source_file_read, oscap_source_file_close,
+					fp, source->origin.filepath, NULL, 0);
+		}
+	}
+	if (reader == NULL) {
+		oscap_seterr(OSCAP_EFAMILY_XML, "Unable to create xmlTextReader for %s", oscap_source_readable_origin(source));
+		oscap_setxmlerr(xmlGetLastError());
+	}
+	return reader;
+}
+
 oscap_document_type_t oscap_source_get_scap_type(struct oscap_source *source)
 {
 	if (source->scap_type == OSCAP_DOCUMENT_UNKNOWN) {
-		xmlTextReader *reader = oscap_source_get_xmlTextReader(source);
+		xmlTextReader *reader;
+		bool plain_memory = source->xml.doc == NULL && source->origin.memory != NULL;
+#ifdef HAVE_BZ2
+		plain_memory = plain_memory && !bz2_file_is_bzip(source->origin.filepath);
+#endif
+		if (plain_memory) {
+			// Only the root element is needed, don't build the DOM of the whole buffer yet
+			reader = xmlReaderForMemory(source->origin.memory, source->origin.memory_size, NULL, NULL, 0);
+			if (reader == NULL) {
+				oscap_seterr(OSCAP_EFAMILY_XML, "Unable to create xmlTextReader for %s", oscap_source_readable_origin(source));
+				oscap_setxmlerr(xmlGetLastError());
+				return OSCAP_DOCUMENT_UNKNOWN;
+			}
+		}
+		else
+			reader = oscap_source_get_xmlTextReader(source);
 		if (reader == NULL) {
 			// the oscap error is already set
 			return OSCAP_DOCUMENT_UNKNOWN;
@@ -1,9 +1,19 @@
 
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
 #include <cvss_score.h>
 #include <cve_nvd.h>
 
+static int count_entry(struct cve_entry *entry, void *user)
+{
+	(*(int *) user)++;
+	cve_entry_free(entry);
+	return 0;
+}
+
 int main(int argc, char **argv)
 {
 	struct cve_model *model;
@@ -61,12 +71,93 @@ int main(int argc, char **argv)
 		return 0;
 	}
 
+	else if (argc == 3 && !strcmp(argv[1], "--test-stream")) {
+		int imported = 0, streamed = 0;
+
+		model = cve_model_import(argv[2]);
+		if (!model)
+			return 1;
+		entry_it = cve_model_get_entries(model);
+		while (cve_entry_iterator_has_more(entry_it)) {
+			cve_entry_iterator_next(entry_it);
+			imported++;
+		}
+		cve_entry_iterator_free(entry_it);
+		cve_model_free(model);
+
+		if (cve_model_import_stream(argv[2], count_entry, &streamed) != 0)
+			return 1;
+
+		printf("Imported: %d\tStreamed: %d\n", imported, streamed);
+		return imported == streamed ? 0 : 1;
+	}
+
+	else if (argc == 4 && !strcmp(argv[1], "--test-index")) {
+		struct cve_index *index;
+		int ret = 0;
+
+		if (cve_index_build(argv[2], argv[3]) != 0)
+			return 1;
+		index = cve_index_load(argv[3], argv[2]);
+		if (!index)
+			return 1;
+
+		/* every entry of the model has to be found through the index */
+		model = cve_model_import(argv[2]);
+		if (!model)
+			return 1;
+		entry_it = cve_model_get_entries(model);
+		while (cve_entry_iterator_has_more(entry_it)) {
+			const char *id = cve_entry_get_id(cve_entry_iterator_next(entry_it));
+
+			entry = cve_index_find_entry(index, id);
+			if (!entry || strcmp(cve_entry_get_id(entry), id)) {
+				printf("CVE %s not found through index\n", id);
+				ret = 1;
+			}
+			if (entry)
+				cve_entry_free(entry);
+		}
+		cve_entry_iterator_free(entry_it);
+		cve_model_free(model);
+
+		if (cve_index_find_entry(index, "CVE-0000-0000") != NULL)
+			ret = 1;
+
+		cve_index_free(index);
+		return ret;
+	}
+
+	else if (argc == 4 && !strcmp(argv[1], "--test-stream-memory")) {
+		struct rusage usage;
+		struct stat st;
+		int streamed = 0;
+
+		/* nothing else has been loaded by this process, so the peak
+		 * resident size is what streaming of the feed needed */
+		if (stat(argv[2], &st) != 0)
+			return 1;
+		if (cve_model_import_stream(argv[2], count_entry, &streamed) != 0)
+			return 1;
+		if (getrusage(RUSAGE_SELF, &usage) != 0)
+			return 1;
+
+		printf("Streamed: %d\tFeed: %ld kB\tMax RSS: %ld kB\n",
+			streamed, (long) (st.st_size / 1024), usage.ru_maxrss);
+		if (streamed != atoi(argv[3]))
+			return 1;
+		return usage.ru_maxrss < st.st_size / 1024 ? 0 : 1;
+	}
+
 	fprintf(stdout,
 		"Usage: \n\n"
 		"  %s --help\n"
 		"  %s --export-all input.xml output.xml\n"
-		"  %s --test-cvss input.xml\n",
-		argv[0], argv[0], argv[0]);
+		"  %s --test-cvss input.xml\n"
+		"  %s --test-stream input.xml\n"
+		"  %s --test-index input.xml index\n"
+		"  %s --test-stream-memory input.xml entries\n",
+		argv[0], argv[0], argv[0], argv[0], argv[0], argv[0]);
 
 	return 0;
 }
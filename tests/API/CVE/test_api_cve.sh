@@ -31,8 +31,37 @@ function test_api_cve_export {
     return $ret_val
 }
 
+function test_api_cve_stream {
+    ./test_api_cve --test-stream $srcdir/nvdcve-2.0-recent.xml
+}
+
+# The feed is far bigger than what streaming it may take, a DOM of the
+# feed would take several times its size.
+function test_api_cve_stream_memory {
+    local ret_val=0
+    local feed=$(mktemp -t nvdcve-large.XXXXXX)
+    local entries=$(grep -c '<entry ' $srcdir/nvdcve-2.0-recent.xml)
+
+    sed -n '1,2p' $srcdir/nvdcve-2.0-recent.xml > $feed
+    for i in $(seq 64); do
+        sed '1,2d;$d' $srcdir/nvdcve-2.0-recent.xml >> $feed
+    done
+    echo '</nvd>' >> $feed
+
+    ./test_api_cve --test-stream-memory $feed $((entries * 64)) || ret_val=1
+    rm -f $feed
+    return $ret_val
+}
+
+function test_api_cve_index {
+    ./test_api_cve --test-index $srcdir/nvdcve-2.0-recent.xml nvdcve-2.0-recent.out.index
+}
+
 test_init "test_api_cve.log"
 test_run "test_api_cve_cvss" test_api_cve_cvss
 test_run "test_api_cve_export" test_api_cve_export
+test_run "test_api_cve_stream" test_api_cve_stream
+test_run "test_api_cve_stream_memory" test_api_cve_stream_memory
+test_run "test_api_cve_index" test_api_cve_index
 test_exit
 
@@ -0,0 +1,56 @@
+#!/bin/bash
+
+# Check that the scan profile written by --profile-report lists every
+# evaluated definition, test and object, in both supported formats.
+
+. ../../../test_common.sh
+
+set -e -o pipefail
+
+function profile_report_json() {
+	name="profile_report"
+	report=$(mktemp ${name}.XXXXXX.json)
+	stderr=$(mktemp ${name}.stderr.XXXXXX)
+
+	echo "Profile report: $report"
+	echo "Stderr dump from oscap: $stderr"
+
+	$OSCAP oval eval --profile-report $report $srcdir/${name}.xml > $stderr 2>&1
+
+	for key in '"objects"' '"tests"' '"definitions"' '"rules"' '"probes"' '"loads"' \
+		'"id": "family"' '"id": "oval:x:obj:1"' '"id": "oval:x:tst:1"' '"id": "oval:x:tst:2"' \
+		'"id": "oval:x:def:1"' '"id": "oval:x:def:2"'; do
+		grep -q "$key" $report
+	done
+
+	# The second test uses the object collected for the first one
+	grep '"id": "oval:x:obj:1"' $report | grep -qv '"cache_hits": 0,'
+
+	rm $report $stderr
+}
+
+function profile_report_csv() {
+	name="profile_report"
+	report=$(mktemp ${name}.XXXXXX.csv)
+	stderr=$(mktemp ${name}.stderr.XXXXXX)
+
+	$OSCAP oval eval --profile-report $report $srcdir/${name}.xml > $stderr 2>&1
+
+	head -n 1 $report | grep -q '^kind,id,calls,wall_s,cpu_s,'
+	[ "$(grep -c '^object,oval:x:obj:1,' $report)" == "1" ]
+	[ "$(grep -c '^test,' $report)" == "2" ]
+	[ "$(grep -c '^definition,' $report)" == "2" ]
+	# the probe is started once, before the evaluation
+	[ "$(grep -c '^probe,family,1,' $report)" == "1" ]
+	# the definitions are loaded once
+	[ "$(grep -c '^load,.*profile_report.xml,1,' $report)" == "1" ]
+
+	rm $report $stderr
+}
+
+test_init "test_profile_report.log"
+
+test_run "oval eval --profile-report (JSON)" profile_report_json
+test_run "oval eval --profile-report (CSV)" profile_report_csv
+
+test_exit
@@ -490,9 +490,12 @@ test_run "test_api_seap_split"                  test_api_seap_split
 test_run "test_api_seap_concurency"             test_api_seap_concurency
 test_run "test_api_seap_spb"                  ./test_api_seap_spb
 test_run "test_api_seap_list"                 ./test_api_seap_list
+test_run "test_api_seap_mem"                  ./test_api_seap_mem
+test_run "test_api_seap_reply"                ./test_api_seap_reply
 test_run "test_api_seap_number_expression"    ./test_api_seap_number
 test_run "test_api_seap_string_expression"    ./test_api_seap_string
 test_run "test_api_SEXP_deepcmp"              ./test_api_SEXP_deepcmp
 test_run "test_api_strto"                     ./test_api_strto
+test_run "test_api_sexp_index"                ./test_api_sexp_index
 
 test_exit
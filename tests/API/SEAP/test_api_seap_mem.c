@@ -0,0 +1,96 @@
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <stdio.h>
+#include <string.h>
+#include <seap.h>
+
+#define TEST_MSG_COUNT 64
+
+/*
+ * In-process peer for the "mem" scheme. The URI "mem://" resolves
+ * this symbol in the test program itself (linked with -export-dynamic).
+ * Every received S-exp is sent back until the connection is closed.
+ */
+int probe_module_main(void *chan)
+{
+	SEAP_CTX_t *ctx;
+	SEXP_t *sexp;
+	int sd;
+
+	ctx = SEAP_CTX_new();
+	sd  = SEAP_openmem(ctx, chan, 0);
+
+	if (sd < 0) {
+		SEAP_CTX_free(ctx);
+		return (1);
+	}
+
+	while (SEAP_recvsexp(ctx, sd, &sexp) == 0) {
+		if (SEAP_sendsexp(ctx, sd, sexp) != 0) {
+			SEXP_free(sexp);
+			break;
+		}
+		SEXP_free(sexp);
+	}
+
+	SEAP_close(ctx, sd);
+	SEAP_CTX_free(ctx);
+
+	return (0);
+}
+
+int main(void)
+{
+	SEAP_CTX_t *ctx;
+	SEXP_t *s_out, *s_in, *s_num, *s_str;
+	int sd, i;
+
+	setbuf(stdout, NULL);
+
+	ctx = SEAP_CTX_new();
+	sd  = SEAP_connect(ctx, "mem://", 0);
+
+	if (sd < 0) {
+		printf("SEAP_connect failed\n");
+		return (1);
+	}
+
+	for (i = 0; i < TEST_MSG_COUNT; ++i) {
+		s_num = SEXP_number_newu(i);
+		s_str = SEXP_string_newf("message %d", i);
+		s_out = SEXP_list_new(s_num, s_str, NULL);
+		SEXP_vfree(s_num, s_str, NULL);
+
+		if (SEAP_sendsexp(ctx, sd, s_out) != 0) {
+			printf("SEAP_sendsexp failed: %d\n", i);
+			return (1);
+		}
+
+		if (SEAP_recvsexp(ctx, sd, &s_in) != 0) {
+			printf("SEAP_recvsexp failed: %d\n", i);
+			return (1);
+		}
+
+		if (!SEXP_deepcmp(s_out, s_in)) {
+			printf("S-exp mismatch: %d\n", i);
+			SEXP_fprintfa(stdout, s_out);
+			printf("\n");
+			SEXP_fprintfa(stdout, s_in);
+			printf("\n");
+			return (1);
+		}
+
+		SEXP_vfree(s_out, s_in, NULL);
+	}
+
+	if (SEAP_close(ctx, sd) != 0) {
+		printf("SEAP_close failed\n");
+		return (1);
+	}
+
+	SEAP_CTX_free(ctx);
+
+	return (0);
+}
@@ -0,0 +1,139 @@
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <stdio.h>
+#include <string.h>
+#include <seap.h>
+
+#define TEST_PART_COUNT 4
+
+/*
+ * In-process peer for the "mem" scheme. Every request is answered with
+ * TEST_PART_COUNT parts followed by the reply itself.
+ */
+int probe_module_main(void *chan)
+{
+	SEAP_CTX_t *ctx;
+	SEAP_msg_t *req, *rep;
+	SEXP_t *sexp;
+	int sd, i;
+
+	ctx = SEAP_CTX_new();
+	sd  = SEAP_openmem(ctx, chan, 0);
+
+	if (sd < 0) {
+		SEAP_CTX_free(ctx);
+		return (1);
+	}
+
+	while (SEAP_recvmsg(ctx, sd, &req) == 0) {
+		for (i = 0; i < TEST_PART_COUNT; ++i) {
+			rep  = SEAP_msg_new();
+			sexp = SEXP_number_newu(i);
+			SEAP_msg_set(rep, sexp);
+			SEXP_free(sexp);
+
+			if (SEAP_reply_part(ctx, sd, rep, req) != 0)
+				return (1);
+
+			SEAP_msg_free(rep);
+		}
+
+		rep  = SEAP_msg_new();
+		sexp = SEXP_string_newf("done");
+		SEAP_msg_set(rep, sexp);
+		SEAP_msgattr_set(rep, "cpu-time", sexp);
+		SEXP_free(sexp);
+
+		if (SEAP_reply(ctx, sd, rep, req) != 0)
+			return (1);
+
+		SEAP_msg_free(rep);
+		SEAP_msg_free(req);
+	}
+
+	SEAP_close(ctx, sd);
+	SEAP_CTX_free(ctx);
+
+	return (0);
+}
+
+int main(void)
+{
+	SEAP_CTX_t *ctx;
+	SEAP_msg_t *req, *rep;
+	SEXP_t *sexp, *attr;
+	int sd, i;
+
+	setbuf(stdout, NULL);
+
+	ctx = SEAP_CTX_new();
+	sd  = SEAP_connect(ctx, "mem://", 0);
+
+	if (sd < 0) {
+		printf("SEAP_connect failed\n");
+		return (1);
+	}
+
+	req  = SEAP_msg_new();
+	sexp = SEXP_string_newf("request");
+	SEAP_msg_set(req, sexp);
+	SEXP_free(sexp);
+
+	if (SEAP_sendmsg(ctx, sd, req) != 0) {
+		printf("SEAP_sendmsg failed\n");
+		return (1);
+	}
+
+	for (i = 0; i <= TEST_PART_COUNT; ++i) {
+		if (SEAP_recvmsg(ctx, sd, &rep) != 0) {
+			printf("SEAP_recvmsg failed: %d\n", i);
+			return (1);
+		}
+
+		attr = SEAP_msgattr_get(rep, i < TEST_PART_COUNT ? "part-of" : "reply-id");
+
+		if (attr == NULL || SEXP_number_getu_32(attr) != SEAP_msg_id(req)) {
+			printf("missing or wrong part-of/reply-id: %d\n", i);
+			return (1);
+		}
+
+		SEXP_free(attr);
+		sexp = SEAP_msg_get(rep);
+
+		if (i < TEST_PART_COUNT) {
+			if (SEXP_number_getu(sexp) != (unsigned int)i) {
+				printf("unexpected part: %d\n", i);
+				return (1);
+			}
+		} else {
+			if (SEAP_msgattr_exists(rep, "part-of") ||
+			    (attr = SEAP_msgattr_get(rep, "cpu-time")) == NULL) {
+				printf("unexpected reply attributes\n");
+				return (1);
+			}
+
+			if (!SEXP_deepcmp(sexp, attr)) {
+				printf("attribute value mismatch\n");
+				return (1);
+			}
+
+			SEXP_free(attr);
+		}
+
+		SEXP_free(sexp);
+		SEAP_msg_free(rep);
+	}
+
+	SEAP_msg_free(req);
+
+	if (SEAP_close(ctx, sd) != 0) {
+		printf("SEAP_close failed\n");
+		return (1);
+	}
+
+	SEAP_CTX_free(ctx);
+
+	return (0);
+}
@@ -0,0 +1,178 @@
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <sexp.h>
+#include <stdio.h>
+#include <string.h>
+
+#define CHECK(cond) do {						\
+		if (!(cond)) {						\
+			fprintf(stderr, "%s:%d: %s\n", __FILE__, __LINE__, #cond); \
+			return (1);					\
+		}							\
+	} while (0)
+
+static SEXP_t *entity_new(const char *name, unsigned int val, int with_attrs)
+{
+	SEXP_t *ent, *ns, *nl, *vs, *as, *av;
+
+	ns = SEXP_string_newf("%s", name);
+	vs = SEXP_number_newu(val);
+
+	if (with_attrs) {
+		as = SEXP_string_newf(":datatype");
+		av = SEXP_string_newf("int");
+		nl = SEXP_list_new(ns, as, av, NULL);
+		ent = SEXP_list_new(nl, vs, NULL);
+		SEXP_vfree(as, av, nl, NULL);
+	} else
+		ent = SEXP_list_new(ns, vs, NULL);
+
+	SEXP_vfree(ns, vs, NULL);
+
+	return (ent);
+}
+
+/* the n-th member named name, the way the probe API looks for it without an index */
+static SEXP_t *scan_nth(const SEXP_t *list, const char *name, uint32_t n)
+{
+	SEXP_t *memb, *ename;
+	uint32_t i;
+
+	for (i = 2; (memb = SEXP_list_nth(list, i)) != NULL; ++i) {
+		ename = SEXP_list_first(memb);
+
+		if (SEXP_listp(ename)) {
+			SEXP_t *r0 = SEXP_list_first(ename);
+			SEXP_free(ename);
+			ename = r0;
+		}
+
+		if (SEXP_stringp(ename) && SEXP_strcmp(ename, name) == 0 && --n == 0) {
+			SEXP_free(ename);
+			return (memb);
+		}
+
+		SEXP_vfree(ename, memb, NULL);
+	}
+
+	return (NULL);
+}
+
+static int check_lookups(const SEXP_t *list, unsigned int names)
+{
+	SEXP_t *a, *b;
+	char name[16];
+	unsigned int i;
+	uint32_t n;
+
+	for (i = 0; i <= names; ++i) {
+		snprintf(name, sizeof name, "ent%u", i);
+
+		for (n = 1; n < 64; ++n) {
+			CHECK(SEXP_list_index_nth(list, name, n, &a) >= 0);
+			b = scan_nth(list, name, n);
+			CHECK(a == NULL ? b == NULL : (b != NULL && SEXP_deepcmp(a, b)));
+			SEXP_vfree(a, b, NULL);
+
+			if (b == NULL)
+				break;
+		}
+	}
+
+	return (0);
+}
+
+int main(void)
+{
+	SEXP_t *list, *head, *ent, *memb, *rest, *r0;
+	SEXP_list_cursor_t cursor;
+	char name[16];
+	unsigned int i;
+
+	setbuf(stdout, NULL);
+
+	head = SEXP_string_newf("test_item");
+	list = SEXP_list_new(head, NULL);
+	SEXP_free(head);
+
+	CHECK(SEXP_list_index(list) == 0);
+
+	/* short lists are searched by the caller */
+	CHECK(SEXP_list_index_nth(list, "ent0", 1, &memb) == -1);
+
+	for (i = 0; i < 200; ++i) {
+		snprintf(name, sizeof name, "ent%u", i % 13);
+		ent = entity_new(name, i, i % 2);
+		SEXP_list_add(list, ent);
+		SEXP_free(ent);
+	}
+
+	if (check_lookups(list, 13) != 0)
+		return (1);
+
+	/* the head isn't indexed */
+	CHECK(SEXP_list_index_nth(list, "test_item", 1, &memb) == 0);
+
+	/* a member replaced by one of the same name keeps the index */
+	ent = entity_new("ent3", 1000, 1);
+	r0 = SEXP_list_replace(list, 5, ent);
+	SEXP_vfree(r0, ent, NULL);
+	CHECK(SEXP_list_index_nth(list, "ent3", 1, &memb) == 1);
+	SEXP_free(memb);
+
+	if (check_lookups(list, 13) != 0)
+		return (1);
+
+	/* a shared list is copied on add, the copy is indexed too */
+	r0 = SEXP_ref(list);
+	ent = entity_new("ent99", 99, 0);
+	SEXP_list_add(list, ent);
+	SEXP_free(ent);
+	CHECK(SEXP_list_index_nth(list, "ent99", 1, &memb) == 1);
+	SEXP_free(memb);
+	CHECK(SEXP_list_index_nth(r0, "ent99", 1, &memb) == 0);
+	SEXP_free(r0);
+
+	/* renaming a member drops the index */
+	ent = entity_new("other", 0, 0);
+	r0 = SEXP_list_replace(list, 7, ent);
+	SEXP_vfree(r0, ent, NULL);
+	CHECK(SEXP_list_index_nth(list, "ent0", 1, &memb) == -1);
+
+	/* the rest of a list is another list value without an index */
+	rest = SEXP_list_rest(list);
+	CHECK(SEXP_list_index_nth(rest, "ent0", 1, &memb) == -1);
+
+	/* the cursor returns the same members as SEXP_list_nth */
+	CHECK(SEXP_list_cursor_init(&cursor, list, 1) == 0);
+
+	for (i = 1; (memb = SEXP_list_cursor_next(&cursor)) != NULL; ++i) {
+		r0 = SEXP_list_nth(list, i);
+		CHECK(r0 != NULL && SEXP_deepcmp(memb, r0));
+		SEXP_vfree(memb, r0, NULL);
+	}
+
+	CHECK(i == SEXP_list_length(list) + 1);
+
+	CHECK(SEXP_list_cursor_init(&cursor, rest, 150) == 0);
+	memb = SEXP_list_cursor_next(&cursor);
+	r0 = SEXP_list_nth(list, 151);
+	CHECK(memb != NULL && SEXP_deepcmp(memb, r0));
+	SEXP_vfree(memb, r0, NULL);
+
+	CHECK(SEXP_list_cursor_init(&cursor, list, 1000) == 0);
+	CHECK(SEXP_list_cursor_next(&cursor) == NULL);
+
+	SEXP_vfree(rest, list, NULL);
+
+	list = SEXP_list_new(NULL);
+	CHECK(SEXP_list_cursor_init(&cursor, list, 1) == 0);
+	CHECK(SEXP_list_cursor_next(&cursor) == NULL);
+	SEXP_free(list);
+
+	printf("OK\n");
+
+	return (0);
+}
@@ -73,6 +73,7 @@ function test_api_xccdf_embedded_cpe_eval {
 test_init "test_api_xccdf_applicability.log"
 
 test_run "Populate TestResult/platform sub element" $srcdir/test_platform_element.sh
+test_run "Skip the rules of an inapplicable group" $srcdir/test_notapplicable_group.sh
 test_run "test_api_xccdf_applicability_cpe_applicable_rule" test_api_xccdf_cpe_eval applicable-rule-xccdf.xml cpe-dict.xml 0
 test_run "test_api_xccdf_applicability_cpe_applicable_embedded_rule" test_api_xccdf_embedded_cpe_eval applicable-rule-embedded-xccdf.xml 0
 test_run "test_api_xccdf_applicability_cpe_applicable_benchmark" test_api_xccdf_cpe_eval applicable-benchmark-xccdf.xml cpe-dict.xml 0
@@ -82,6 +83,7 @@ test_run "test_api_xccdf_applicability_cpe2_applicable_embedded_rule" test_api_x
 test_run "test_api_xccdf_applicability_cpe2_negated_applicable_embedded_rule" test_api_xccdf_embedded_cpe_eval cpe2-negated-applicable-rule-embedded-xccdf.xml 1
 test_run "test_api_xccdf_applicability_cpe2_and_embedded_rule" test_api_xccdf_embedded_cpe_eval cpe2-and-rule-embedded-xccdf.xml 2
 test_run "test_api_xccdf_applicability_cpe2_or_embedded_rule" test_api_xccdf_embedded_cpe_eval cpe2-or-rule-embedded-xccdf.xml 0
+test_run "test_api_xccdf_applicability_cpe2_notapplicable_embedded_group" test_api_xccdf_embedded_cpe_eval cpe2-group-notapplicable-embedded-xccdf.xml 4
 
 test_run "test_api_xccdf_applicability_cpe2_applicable_embedded_rule_with_cpe_dict" test_api_xccdf_cpe_eval cpe2-applicable-rule-embedded-xccdf-combined.xml cpe-dict.xml 0
 test_run "test_api_xccdf_applicability_cpe2_not_applicable_embedded_rule_with_cpe_dict" test_api_xccdf_cpe_eval cpe2-notapplicable-rule-embedded-xccdf-combined.xml cpe-dict.xml 1
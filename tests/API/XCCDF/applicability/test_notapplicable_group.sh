@@ -0,0 +1,50 @@
+#!/bin/bash
+
+# Rules of an inapplicable group are neither evaluated nor loaded with
+# --lazy-oval and each CPE platform is evaluated only once.
+
+set -e
+set -o pipefail
+
+name=$(basename $0 .sh)
+
+result=$(mktemp -t ${name}.out.XXXXXX)
+stdout=$(mktemp -t ${name}.out.XXXXXX)
+stderr=$(mktemp -t ${name}.out.XXXXXX)
+tmpdir=$(mktemp -d -t ${name}.out.XXXXXX)
+report=$tmpdir/${name}.csv
+
+cp $srcdir/cpe2-group-notapplicable-embedded-xccdf.xml $srcdir/cpe2-group-notapplicable-oval.xml \
+	$srcdir/cpe-oval.xml $tmpdir
+pushd $tmpdir
+$OSCAP xccdf eval --lazy-oval --oval-results --profile-report $report \
+	--results $result cpe2-group-notapplicable-embedded-xccdf.xml > $stdout 2> $stderr
+popd
+
+echo "Stdout file = $stdout"
+echo "Stderr file = $stderr"
+echo "Result file = $result"
+[ -f $stderr ]; [ ! -s $stderr ]; rm $stderr
+rm $stdout
+
+assert_exists 4 '//rule-result[result/text()="notapplicable"]'
+assert_exists 1 '//rule-result[@idref="xccdf_moc.elpmaxe.www_rule_5"][result/text()="pass"]'
+rm $result
+
+# Only the definition of the applicable rule is in the OVAL results
+result=$tmpdir/cpe2-group-notapplicable-oval.xml.result.xml
+$OSCAP oval validate-xml --results $result
+
+assert_exists 1 '/oval_results/oval_definitions/definitions/definition'
+assert_exists 1 '/oval_results/oval_definitions/definitions/definition[@id="oval:y:def:5"]'
+assert_exists 1 '/oval_results/results/system/definitions/definition'
+assert_exists 1 '/oval_results/results/system/definitions/definition[@definition_id="oval:y:def:5"][@result="true"]'
+
+# Each of the two CPE definitions was evaluated once, the object is
+# queried by each of their two tests. It is collected once, then served
+# from the system characteristics.
+[ "$(awk -F, '$1 == "definition" && $2 ~ /^oval:x:def:/' $report | wc -l)" == "2" ]
+[ "$(awk -F, '$1 == "definition" && $2 ~ /^oval:x:def:/ { n += $3 } END { print n }' $report)" == "2" ]
+[ "$(awk -F, '$1 == "object" && $2 == "oval:x:obj:1" { print $3 + $10 }' $report)" == "4" ]
+
+rm -rf $tmpdir
@@ -13,6 +13,7 @@ test_run "xccdf:complex-check -- single negation" ./test_xccdf_shall_pass $srcdi
 test_run "Certain id's of xccdf_items may overlap" ./test_xccdf_shall_pass $srcdir/test_xccdf_overlaping_IDs.xccdf.xml
 test_run "Test Abstract data types." ./test_oscap_common
 test_run "xccdf_rule_result_override" $srcdir/test_xccdf_overrides.sh
+test_run "Duplicate set-values and refine-values of a Value" ./test_xccdf_profile_values $srcdir/test_xccdf_profile_values.xccdf.xml
 
 test_run "Assert for environment" [ ! -x $srcdir/not_executable ]
 test_run "Assert for environment better" $OSCAP oval eval --id oval:moc.elpmaxe.www:def:1 $srcdir/test_xccdf_check_content_ref_without_name_attr.oval.xml
@@ -52,6 +53,8 @@ test_run "default selector for xccdf value" $srcdir/test_default_selector.sh
 test_run "inherit selector for xccdf value" $srcdir/test_inherit_selector.sh
 test_run "incorrect selector for xccdf value" $srcdir/test_xccdf_refine_value_bad.sh
 test_run "XCCDF Substitute within Title" $srcdir/test_xccdf_sub_title.sh
+test_run "Load only OVAL definitions needed by the profile" $srcdir/test_xccdf_lazy_oval.sh
+test_run "Evaluate offline targets concurrently" $srcdir/test_xccdf_targets.sh
 
 test_run "libxml errors handled correctly" $srcdir/test_unfinished.sh
 
@@ -60,12 +63,14 @@ test_run "libxml errors handled correctly" $srcdir/test_unfinished.sh
 #
 test_run "XCCDF Remediation Simple Test" $srcdir/test_remediation_simple.sh
 test_run "XCCDF Remediation Bad Fix Fails to Remedy" $srcdir/test_remediation_bad_fix.sh
+test_run "XCCDF Remediation Concurrent Fixes" $srcdir/test_remediation_jobs.sh
 test_run "XCCDF Remediation Substitute Simple plain-text" $srcdir/test_remediation_subs_plain_text.sh
 test_run "XCCDF Remediation Substitute Empty plain-text" $srcdir/test_remediation_subs_plain_text_empty.sh
 test_run "XCCDF Remediation Substitute Value by refine-value" $srcdir/test_remediation_subs_value_refine_value.sh
 test_run "XCCDF Remediation Substitute Value by first value" $srcdir/test_remediation_subs_value_take_first.sh
 test_run "XCCDF Remediation Substitute Value by empty selector" $srcdir/test_remediation_subs_value_without_selector.sh
 test_run "XCCDF Remediation Substitute Value by its title" $srcdir/test_remediation_subs_value_title.sh
+test_run "XCCDF Remediation Substitute shared fix text" $srcdir/test_remediation_subs_template.sh
 test_run "XCCDF Remediation &amp; decoding" $srcdir/test_remediation_amp_escaping.sh
 test_run "XCCDF Remediation bypass XML Comments" $srcdir/test_remediation_xml_comments.sh
 test_run "XCCDF Remediation understands <[CDATA[." $srcdir/test_remediation_cdata.sh
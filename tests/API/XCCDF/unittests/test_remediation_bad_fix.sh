@@ -38,8 +38,8 @@ assert_exists 1 '//rule-result'
 assert_exists 1 '//rule-result/result'
 assert_exists 1 '//rule-result/result[text()="error"]'
 assert_exists 1 '//rule-result/fix'
-assert_exists 3 '//rule-result/message'
-assert_exists 3 '//rule-result/message[@severity="info"]'
+assert_exists 4 '//rule-result/message'
+assert_exists 4 '//rule-result/message[@severity="info"]'
 assert_exists 1 '//rule-result/message[text()="Fix execution completed and returned: 0"]'
 assert_exists 1 '//rule-result/message[text()="Failed to verify applied fix: Checking engine returns: fail"]'
 assert_exists 1 '//score'
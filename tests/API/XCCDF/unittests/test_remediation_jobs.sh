@@ -0,0 +1,54 @@
+#!/bin/bash
+
+# Fixes executed concurrently keep the order required by their
+# fix/@strategy and by the rule dependencies, independent fixes overlap.
+
+set -e
+set -o pipefail
+
+name=$(basename $0 .sh)
+result=$(mktemp -t ${name}.out.XXXXXX)
+stderr=$(mktemp -t ${name}.out.XXXXXX)
+
+echo "Stderr file = $stderr"
+echo "Result file = $result"
+
+$OSCAP xccdf eval --jobs 4 --results $result $srcdir/${name}.xccdf.xml 2> $stderr && exit 1
+grep -q "requires --targets or --remediate" $stderr
+:> $stderr
+
+rm -f test_file test_file.order
+$OSCAP xccdf eval --remediate --jobs 4 --results $result $srcdir/${name}.xccdf.xml 2> $stderr
+[ -f $stderr ]; [ ! -s $stderr ]; rm $stderr
+
+$OSCAP xccdf validate-xml $result
+
+assert_exists 4 '//rule-result'
+assert_exists 4 '//rule-result/result[text()="fixed"]'
+assert_exists 4 '//rule-result/fix'
+assert_exists 9 '//rule-result/message'
+assert_exists 4 '//rule-result/message[text()="Fix execution completed and returned: 0"]'
+assert_exists 4 '//rule-result/message[starts-with(text(), "Fix execution took ")]'
+assert_exists 1 '//rule-result[@idref="xccdf_moc.elpmaxe.www_rule_4"]/message[contains(text(), "fix output")]'
+
+[ "$(cat test_file.order | tr -d '\n')" == "123" ]
+
+rm test_file test_file.order
+
+# Each of the two independent fixes waits for the other one to start, so
+# both of them succeed only if they are executed at the same time.
+rm -f test_file test_file.overlap test_file.overlap_1 test_file.overlap_2
+$OSCAP xccdf eval --remediate --jobs 2 --results $result $srcdir/${name}_overlap.xccdf.xml 2> $stderr
+[ -f $stderr ]; [ ! -s $stderr ]
+
+[ "$(sort test_file.overlap | tr -d '\n')" == "12" ]
+
+# One by one, the first fix gives up waiting for the second one.
+rm -f test_file test_file.overlap test_file.overlap_1 test_file.overlap_2
+$OSCAP xccdf eval --remediate --jobs 1 --results $result $srcdir/${name}_overlap.xccdf.xml 2> $stderr
+[ -f $stderr ]; [ ! -s $stderr ]; rm $stderr
+
+[ "$(cat test_file.overlap | tr -d '\n')" == "2" ]
+
+rm test_file test_file.overlap test_file.overlap_1 test_file.overlap_2
+rm $result
@@ -36,9 +36,10 @@ assert_exists 1 '//rule-result'
 assert_exists 1 '//rule-result/result'
 assert_exists 1 '//rule-result/result[text()="fixed"]'
 assert_exists 1 '//rule-result/fix'
-assert_exists 1 '//rule-result/message'
-assert_exists 1 '//rule-result/message[@severity="info"]'
+assert_exists 2 '//rule-result/message'
+assert_exists 2 '//rule-result/message[@severity="info"]'
 assert_exists 1 '//rule-result/message[text()="Fix execution completed and returned: 0"]'
+assert_exists 1 '//rule-result/message[starts-with(text(), "Fix execution took ")]'
 assert_exists 1 '//score'
 assert_exists 1 '//score[text()="0.000000"]'
 
@@ -48,8 +48,8 @@ assert_exists 1 '//rule-result/fix[@system="urn:xccdf:fix:script:sh"]'
 assert_exists 1 '//rule-result/fix[contains(text(), " touch test_file")]'
 assert_exists 1 '//rule-result/fix[contains(text(), " chmod a-x test_file")]'
 assert_exists 0 '//rule-result/fix/sub'
-assert_exists 1 '//rule-result/message'
-assert_exists 1 '//rule-result/message[@severity="info"]'
+assert_exists 2 '//rule-result/message'
+assert_exists 2 '//rule-result/message[@severity="info"]'
 assert_exists 1 '//rule-result/message[text()="Fix execution completed and returned: 0"]'
 assert_exists 1 '//score'
 assert_exists 1 '//score[text()="0.000000"]'
@@ -0,0 +1,51 @@
+#!/bin/bash
+
+# The same fix text shared by several rules is substituted through one
+# compiled template, the result has to be the same for every rule and
+# byte for byte the same as the one of the DOM walk (xml_iterate_dfs).
+
+set -e
+set -o pipefail
+
+name=$(basename $0 .sh)
+result=$(mktemp -t ${name}.out.XXXXXX)
+stderr=$(mktemp -t ${name}.out.XXXXXX)
+
+echo "Stderr file = $stderr"
+echo "Result file = $result"
+
+rm -f test_file test_file.log
+$OSCAP xccdf eval --profile xccdf_moc.elpmaxe.www_profile_1 \
+	--remediate --results $result $srcdir/${name}.xccdf.xml 2> $stderr
+[ -f $stderr ]; [ ! -s $stderr ]; rm $stderr
+
+$OSCAP xccdf validate-xml $result
+
+assert_exists 2 '/Benchmark/Rule/fix'
+assert_exists 8 '/Benchmark/Rule/fix/sub'
+assert_exists 2 '//rule-result'
+assert_exists 2 '//rule-result/result[text()="fixed"]'
+assert_exists 2 '//rule-result/fix'
+assert_exists 0 '//rule-result/fix/sub'
+assert_exists 2 '//rule-result/fix[contains(text(), "touch test_file && echo")]'
+assert_exists 2 '//rule-result/fix[contains(text(), "a & b <c>")]'
+assert_exists 2 '//rule-result/fix[contains(text(), "> test_file.log")]'
+assert_exists 2 '//rule-result/fix[contains(text(), "chmod a-x test_file")]'
+
+grep -q '^a & b <c>$' test_file.log
+rm test_file test_file.log
+
+# The same substitutions without the templates
+result_dfs=$(mktemp -t ${name}.out.XXXXXX)
+OSCAP_XCCDF_NO_TEXT_TEMPLATES=1 $OSCAP xccdf eval --profile xccdf_moc.elpmaxe.www_profile_1 \
+	--remediate --results $result_dfs $srcdir/${name}.xccdf.xml
+rm test_file test_file.log
+
+# The fixes as they are serialized in the results
+sed -n '/<fix /,/<\/fix>/p' $result > ${result}.fix
+sed -n '/<fix /,/<\/fix>/p' $result_dfs > ${result_dfs}.fix
+[ "$(grep -c '<fix ' ${result}.fix)" == "4" ]
+cmp ${result}.fix ${result_dfs}.fix
+
+rm ${result}.fix ${result_dfs}.fix
+rm $result $result_dfs
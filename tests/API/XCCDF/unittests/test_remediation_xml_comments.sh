@@ -46,8 +46,8 @@ assert_exists 1 '//rule-result/fix[@system="urn:xccdf:fix:script:sh"]'
 assert_exists 0 '//rule-result/fix[contains(text(), "exit")]'
 grep '<!-- exit 9 -->' $result
 assert_exists 1 '//rule-result/fix/text()[contains(., "chmod a-x test_file")]' # note that comment breaks text() into two nodes
-assert_exists 1 '//rule-result/message'
-assert_exists 1 '//rule-result/message[@severity="info"]'
+assert_exists 2 '//rule-result/message'
+assert_exists 2 '//rule-result/message[@severity="info"]'
 assert_exists 1 '//rule-result/message[text()="Fix execution completed and returned: 0"]'
 assert_exists 1 '//score'
 assert_exists 1 '//score[text()="0.000000"]'
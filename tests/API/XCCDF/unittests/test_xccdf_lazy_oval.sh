@@ -0,0 +1,53 @@
+#!/bin/bash
+
+set -e
+set -o pipefail
+
+name=$(basename $0 .sh)
+
+result=$(mktemp -t ${name}.out.XXXXXX)
+stdout=$(mktemp -t ${name}.out.XXXXXX)
+stderr=$(mktemp -t ${name}.out.XXXXXX)
+tmpdir=$(mktemp -d -t ${name}.out.XXXXXX)
+
+cp $srcdir/${name}.xccdf.xml $srcdir/${name}.oval.xml $tmpdir
+pushd $tmpdir
+$OSCAP xccdf eval --profile xccdf_moc.elpmaxe.www_profile_1 --lazy-oval --oval-results \
+	--profile-report profile.csv --results $result ${name}.xccdf.xml > $stdout 2> $stderr
+popd
+
+echo "Stdout file = $stdout"
+echo "Stderr file = $stderr"
+echo "Result file = $result"
+[ -f $stderr ]; [ ! -s $stderr ]; rm $stderr
+grep '^Result.*pass$' $stdout
+! grep '^Result.*fail$' $stdout
+rm $stdout
+
+# The load of the OVAL file is profiled: one call, two definitions and the memory peak
+load=$(grep "^load,.*${name}.oval.xml," $tmpdir/profile.csv)
+[ "$(echo "$load" | wc -l)" == "1" ]
+[ "$(echo "$load" | cut -d, -f3)" == "1" ]
+[ "$(echo "$load" | cut -d, -f7)" == "2" ]
+[ "$(echo "$load" | cut -d, -f11)" -gt 0 ]
+
+$OSCAP xccdf validate-xml $result
+
+assert_exists 1 '//rule-result[@idref="xccdf_moc.elpmaxe.www_rule_1"][result/text()="pass"]'
+assert_exists 1 '//rule-result[@idref="xccdf_moc.elpmaxe.www_rule_2"][result/text()="notselected"]'
+rm $result
+
+# Only the definitions the selected rule depends on are in the OVAL results
+result=$tmpdir/${name}.oval.xml.result.xml
+$OSCAP oval validate-xml --results $result
+
+assert_exists 2 '/oval_results/oval_definitions/definitions/definition'
+assert_exists 1 '/oval_results/oval_definitions/definitions/definition[@id="oval:x:def:3"]'
+assert_exists 0 '/oval_results/oval_definitions/definitions/definition[@id="oval:x:def:2"]'
+assert_exists 2 '/oval_results/oval_definitions/tests/*'
+assert_exists 2 '/oval_results/oval_definitions/objects/*'
+assert_exists 0 '/oval_results/oval_definitions/objects/*[@id="oval:x:obj:2"]'
+assert_exists 2 '/oval_results/oval_definitions/states/*'
+assert_exists 2 '/oval_results/oval_definitions/variables/*'
+assert_exists 1 '/oval_results/results/system/definitions/definition[@definition_id="oval:x:def:1"][@result="true"]'
+rm -rf $tmpdir
@@ -0,0 +1,122 @@
+/*
+ * Copyright 2026 Red Hat Inc., Durham, North Carolina.
+ * All Rights Reserved.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include <xccdf_benchmark.h>
+#include <xccdf_policy.h>
+
+#include "unit_helper.h"
+#include <../../../assume.h>
+
+/*
+ * The profile has two set-values and two refine-values of the same
+ * Values. The last set-value wins everywhere, exports take the last
+ * refine-value while the value of the item and the tailored operator
+ * come from the first one.
+ */
+
+#define PROFILE_ID "xccdf_moc.elpmaxe.www_profile_1"
+#define VALUE_SET_ID "xccdf_moc.elpmaxe.www_value_set"
+#define VALUE_REFINE_ID "xccdf_moc.elpmaxe.www_value_refine"
+
+static int bindings_seen = 0;
+
+static xccdf_test_result_type_t _check_exports(struct xccdf_policy *policy, const char *rule_id, const char *id,
+		const char *href, struct xccdf_value_binding_iterator *value_binding_it,
+		struct xccdf_check_import_iterator *check_import_it, void *usr)
+{
+	while (xccdf_value_binding_iterator_has_more(value_binding_it)) {
+		struct xccdf_value_binding *binding = xccdf_value_binding_iterator_next(value_binding_it);
+		const char *name = xccdf_value_binding_get_name(binding);
+
+		if (strcmp(name, "set") == 0) {
+			assume(strcmp(xccdf_value_binding_get_setvalue(binding), "last") == 0);
+			++bindings_seen;
+		} else if (strcmp(name, "refine") == 0) {
+			assume(xccdf_value_binding_get_setvalue(binding) == NULL);
+			assume(strcmp(xccdf_value_binding_get_value(binding), "value two") == 0);
+			assume(xccdf_value_binding_get_operator(binding) == XCCDF_OPERATOR_PATTERN_MATCH);
+			++bindings_seen;
+		}
+	}
+	return XCCDF_RESULT_PASS;
+}
+
+static struct xccdf_setvalue *_new_set_value(const char *value)
+{
+	struct xccdf_setvalue *setvalue = xccdf_setvalue_new();
+	xccdf_setvalue_set_item(setvalue, VALUE_SET_ID);
+	xccdf_setvalue_set_value(setvalue, value);
+	return setvalue;
+}
+
+static void _remove_set_value(struct xccdf_profile *profile, const char *value)
+{
+	struct xccdf_setvalue_iterator *it = xccdf_profile_get_setvalues(profile);
+	while (xccdf_setvalue_iterator_has_more(it)) {
+		struct xccdf_setvalue *setvalue = xccdf_setvalue_iterator_next(it);
+		if (strcmp(xccdf_setvalue_get_value(setvalue), value) == 0)
+			xccdf_setvalue_iterator_remove(it);
+	}
+	xccdf_setvalue_iterator_free(it);
+}
+
+int main(int argc, char *argv[])
+{
+	assume(argc == 2);
+	struct xccdf_policy_model *policy_model = uh_load_xccdf(argv[1]);
+	struct xccdf_benchmark *benchmark = xccdf_policy_model_get_benchmark(policy_model);
+	struct xccdf_policy *policy = xccdf_policy_model_get_policy_by_id(policy_model, PROFILE_ID);
+	assume(policy != NULL);
+	xccdf_policy_model_register_engine_and_query_callback(policy_model,
+			"http://check-engine.test/exports", _check_exports, NULL, NULL);
+
+	struct xccdf_item *value_set = xccdf_benchmark_get_item(benchmark, VALUE_SET_ID);
+	struct xccdf_item *value_refine = xccdf_benchmark_get_item(benchmark, VALUE_REFINE_ID);
+	assume(value_set != NULL && value_refine != NULL);
+
+	assume(strcmp(xccdf_policy_get_value_of_item(policy, value_set), "last") == 0);
+	assume(strcmp(xccdf_policy_get_value_of_item(policy, value_refine), "value one") == 0);
+
+	struct xccdf_result *ritem = xccdf_policy_evaluate(policy);
+	assume(ritem != NULL);
+	assume(bindings_seen == 2);
+
+	struct xccdf_item *tailored = xccdf_policy_tailor_item(policy, value_refine);
+	assume(tailored != NULL);
+	assume(xccdf_value_get_oper(xccdf_item_to_value(value_refine)) == XCCDF_OPERATOR_NOT_EQUAL);
+	xccdf_item_free(tailored);
+
+	/* The lookups follow the changes of the profile, also when a set-value
+	 * is replaced and the number of set-values stays the same. */
+	struct xccdf_profile *profile = xccdf_policy_get_profile(policy);
+	assume(xccdf_profile_add_setvalue(profile, _new_set_value("added")));
+	assume(strcmp(xccdf_policy_get_value_of_item(policy, value_set), "added") == 0);
+	struct xccdf_setvalue *replaced = _new_set_value("replaced");
+	_remove_set_value(profile, "added");
+	assume(xccdf_profile_add_setvalue(profile, replaced));
+	assume(strcmp(xccdf_policy_get_value_of_item(policy, value_set), "replaced") == 0);
+	_remove_set_value(profile, "replaced");
+	assume(strcmp(xccdf_policy_get_value_of_item(policy, value_set), "last") == 0);
+
+	xccdf_policy_model_free(policy_model);
+	return 0;
+}
@@ -0,0 +1,75 @@
+#!/bin/bash
+
+# Two offline targets evaluated concurrently from one content load, the
+# marker file exists only in the first one. Each target gets its own ARF
+# and its own result line, the exit status aggregates both of them.
+
+set -e
+set -o pipefail
+
+name=$(basename $0 .sh)
+
+if [ "$(id -u)" -ne 0 ]; then
+	echo "Offline targets are evaluated in a chroot, you need to be root"
+	exit 255
+fi
+
+stdout=$(mktemp -t ${name}.out.XXXXXX)
+stderr=$(mktemp -t ${name}.out.XXXXXX)
+tmpdir=$(mktemp -d -t ${name}.out.XXXXXX)
+targets=$tmpdir/targets
+
+mkdir $tmpdir/root_pass $tmpdir/root_fail
+touch $tmpdir/root_pass/oscap_target_marker
+cat > $targets <<EOF
+# root  ARF
+$tmpdir/root_pass	$tmpdir/arf_pass.xml
+$tmpdir/root_fail	$tmpdir/arf_fail.xml
+EOF
+
+echo "Stdout file = $stdout"
+echo "Stderr file = $stderr"
+
+$OSCAP xccdf eval --targets $targets --results $tmpdir/results.xml \
+	$srcdir/${name}.xccdf.xml 2> $stderr && exit 1
+grep -q "Only per-target ARF results" $stderr
+:> $stderr
+
+for jobs in abc 0 -1 2x; do
+	$OSCAP xccdf eval --targets $targets --jobs $jobs \
+		$srcdir/${name}.xccdf.xml 2> $stderr && exit 1
+	grep -q "The --jobs option requires a positive number" $stderr
+	:> $stderr
+done
+
+# system_info reports these in the offline mode
+ret=0
+OSCAP_PROBE_OS_NAME="Linux" OSCAP_PROBE_OS_VERSION="target" \
+OSCAP_PROBE_ARCHITECTURE="$(uname -m)" OSCAP_PROBE_PRIMARY_HOST_NAME="target" \
+$OSCAP xccdf eval --targets $targets --jobs 2 \
+	$srcdir/${name}.xccdf.xml > $stdout 2> $stderr || ret=$?
+
+[ $ret -eq 2 ]
+[ -f $stderr ]; [ ! -s $stderr ]; rm $stderr
+[ "$(grep -c '^Target ' $stdout)" == "2" ]
+grep -q "^Target $tmpdir/root_pass: pass$" $stdout
+grep -q "^Target $tmpdir/root_fail: fail$" $stdout
+rm $stdout
+
+result=$tmpdir/arf_pass.xml
+$OSCAP ds rds-validate $result
+assert_exists 1 '//rule-result[@idref="xccdf_moc.elpmaxe.www_rule_1"]/result[text()="pass"]'
+assert_exists 1 '//oval_results//definition[@definition_id="oval:moc.elpmaxe.www:def:1"][@result="true"]'
+# the system information comes from the target, not from the host
+assert_exists 1 '//oval_results//system_info/os_version[text()="target"]'
+assert_exists 1 '//oval_results//system_info/primary_host_name[text()="target"]'
+
+result=$tmpdir/arf_fail.xml
+$OSCAP ds rds-validate $result
+assert_exists 1 '//rule-result[@idref="xccdf_moc.elpmaxe.www_rule_1"]/result[text()="fail"]'
+assert_exists 1 '//oval_results//definition[@definition_id="oval:moc.elpmaxe.www:def:1"][@result="false"]'
+# the system information comes from the target, not from the host
+assert_exists 1 '//oval_results//system_info/os_version[text()="target"]'
+assert_exists 1 '//oval_results//system_info/primary_host_name[text()="target"]'
+
+rm -rf $tmpdir
@@ -182,6 +182,30 @@ function test_eval_benchmark_id {
     echo "$OUT" | grep $3 > /dev/null
 }
 
+function test_image {
+    local name=${FUNCNAME}
+    local image=$(mktemp -t ${name}.img.XXXXXX)
+    local expected=$(mktemp -t ${name}.out.XXXXXX)
+    local result=$(mktemp -t ${name}.out.XXXXXX)
+
+    $OSCAP ds sds-image --xccdf-id $2 "${srcdir}/$1" $image || return 1
+    $OSCAP xccdf eval --xccdf-id $2 "${srcdir}/$1" > $expected
+    $OSCAP xccdf eval $image > $result || return 1
+    diff $expected $result || return 1
+    # the image holds just the selected checklist
+    $OSCAP xccdf eval --xccdf-id scap_org.open-scap_cref_nonexistent $image && return 1
+    # a damaged entry table is refused, it follows the 40 bytes of the header
+    printf '\377' | dd of=$image bs=1 seek=44 conv=notrunc 2>/dev/null
+    $OSCAP xccdf eval $image 2> $result && return 1
+    grep -q "is corrupted" $result || return 1
+    # so is damaged component data, at the end of the image
+    $OSCAP ds sds-image --xccdf-id $2 "${srcdir}/$1" $image || return 1
+    printf 'X' | dd of=$image bs=1 seek=$(( $(stat -c %s $image) - 16 )) conv=notrunc 2>/dev/null
+    $OSCAP xccdf eval $image 2> $result && return 1
+    grep -q "is corrupted" $result || return 1
+    rm $image $expected $result
+}
+
 function test_eval_complex()
 {
 	local name=${FUNCNAME}
@@ -332,6 +356,71 @@ function test_rds_split {
     return 0
 }
 
+function test_rds_store {
+    local ARF="${srcdir}/$1"
+    local HOST="$2"
+    local RULE="$3"
+    local DIR="`mktemp -d`"
+    local STORE="$DIR/store"
+
+    # the same results of another host
+    sed "s|<ai:fqdn>$HOST</ai:fqdn>|<ai:fqdn>other.example.org</ai:fqdn>|" "$ARF" > "$DIR/other.xml"
+
+    local ids=$($OSCAP ds rds-store-import "$STORE" "$ARF" "$DIR/other.xml")
+    [ "`echo "$ids" | sort -u | wc -l`" == "2" ]
+    local id=$(echo "$ids" | head -n 1)
+    local other=$(echo "$ids" | tail -n 1)
+
+    # importing again changes nothing
+    [ "`$OSCAP ds rds-store-import "$STORE" "$ARF"`" == "$id" ]
+    $OSCAP ds rds-store-info "$STORE" | grep -q "^Result datastreams: 2$"
+
+    # the datastream and the definitions are stored once
+    local arf_size=$(stat -c %s "$ARF")
+    local blob_size=$(find "$STORE/blobs" -type f -printf "%s\n" | awk '{ s += $1 } END { print s }')
+    [ $blob_size -lt $((arf_size * 3 / 2)) ]
+
+    $OSCAP ds rds-store-export "$STORE" $id "$DIR/export.xml"
+    cmp "$ARF" "$DIR/export.xml"
+    $OSCAP ds rds-store-export "$STORE" $other "$DIR/export.xml"
+    cmp "$DIR/other.xml" "$DIR/export.xml"
+
+    [ "`$OSCAP ds rds-store-list "$STORE" | wc -l`" == "2" ]
+    $OSCAP ds rds-store-list --host "$HOST" "$STORE" | grep -q "^$id	$HOST	"
+    [ "`$OSCAP ds rds-store-list --host other.example.org "$STORE" | cut -f 1`" == "$other" ]
+    [ "`$OSCAP ds rds-store-list --rule "$RULE" "$STORE" | cut -f 4 | sort -u`" != "" ]
+    [ "`$OSCAP ds rds-store-list --rule nonexistent "$STORE"`" == "" ]
+
+    # the rule results are kept apart from the index, one file per ARF
+    grep -q "^rule	" "$STORE/index" && return 1
+    [ -s "$STORE/rules/${id:0:2}/$id" ]
+
+    # concurrent imports don't interleave their records in the index
+    local STORE2="$DIR/store2" i
+    for i in `seq 1 8`; do
+        sed "s|<ai:fqdn>$HOST</ai:fqdn>|<ai:fqdn>host$i.example.org</ai:fqdn>|" "$ARF" > "$DIR/host$i.xml"
+    done
+    for i in `seq 1 8`; do
+        $OSCAP ds rds-store-import "$STORE2" "$DIR/host$i.xml" > /dev/null &
+    done
+    wait
+    [ "`grep -c "^arf	" "$STORE2/index"`" == "8" ]
+    grep -qv "^\(arf\|host\|profile\)	[0-9a-f-]*	" "$STORE2/index" && return 1
+    for i in `seq 1 8`; do
+        [ "`$OSCAP ds rds-store-list --host host$i.example.org "$STORE2" | wc -l`" == "1" ]
+    done
+
+    # corrupted blobs are detected
+    find "$STORE/blobs" -type f -size +1M -exec sh -c 'echo >> "$1"' _ {} \;
+    $OSCAP ds rds-store-export "$STORE" $id "$DIR/export.xml" && return 1
+    [ ! -f "$DIR/export.xml" ]
+
+    # only result datastreams can be imported
+    $OSCAP ds rds-store-import "$STORE" "${srcdir}/eval_simple/sds.xml" && return 1
+
+    rm -r "$DIR"
+}
+
 # Testing.
 test_init "test_ds.log"
 
@@ -354,6 +443,7 @@ test_run "eval_xccdf_id1" test_eval_id eval_xccdf_id/sds.xml scap_org.open-scap_
 test_run "eval_xccdf_id2" test_eval_id eval_xccdf_id/sds.xml scap_org.open-scap_datastream_tst scap_org.open-scap_cref_second-xccdf.xml second
 test_run "eval_benchmark_id1" test_eval_benchmark_id eval_xccdf_id/sds.xml xccdf_moc.elpmaxe.www_benchmark_first first
 test_run "eval_benchmark_id2" test_eval_benchmark_id eval_xccdf_id/sds.xml xccdf_moc.elpmaxe.www_benchmark_second second
+test_run "image_xccdf_id" test_image eval_xccdf_id/sds.xml scap_org.open-scap_cref_second-xccdf.xml
 test_run "eval_benchmark_id_conflict" test_eval_benchmark_id eval_benchmark_id_conflict/sds.xml xccdf_moc.elpmaxe.www_benchmark_first first
 test_run "eval_just_oval" test_oval_eval eval_just_oval/sds.xml
 test_run "eval_oval_id1" test_oval_eval_id eval_oval_id/sds.xml scap_org.open-scap_datastream_just_oval scap_org.open-scap_cref_scap-oval1.xml "oval:x:def:1"
@@ -365,6 +455,7 @@ test_run "rds_simple" test_rds rds_simple/sds.xml rds_simple/results-xccdf.xml r
 test_run "rds_testresult" test_rds rds_testresult/sds.xml rds_testresult/results-xccdf.xml rds_testresult/results-oval.xml
 test_run "rds_index_simple" test_rds_index rds_index_simple/arf.xml "asset0 asset1" "report0" "collection0"
 test_run "rds_split_simple" test_rds_split rds_split_simple report-request.xml report.xml 0
+test_run "rds_store" test_rds_store rds_index_simple/arf.xml some.target.somewhere.org xccdf_cdf_rule_rule-2.1.1.1.1.a
 
 test_run "test_eval_complex" test_eval_complex
 test_run "sds_add_multiple_oval_twice_in_row" sds_add_multiple_twice
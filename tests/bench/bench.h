@@ -0,0 +1,54 @@
+/*
+ * Copyright 2026 Red Hat Inc., Durham, North Carolina.
+ * All Rights Reserved.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef BENCH_H
+#define BENCH_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+/*
+ * Helpers shared by the benchmark programs. Every benchmark prints
+ * exactly one JSON object to stdout; bench_run adds the time, RSS
+ * and allocation counts of the whole process.
+ */
+
+static inline double bench_now(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return ((double)ts.tv_sec + (double)ts.tv_nsec / 1000000000.0);
+}
+
+static inline unsigned long bench_arg(int argc, char *argv[], int i, unsigned long def)
+{
+	return (argc > i ? strtoul(argv[i], NULL, 10) : def);
+}
+
+#define bench_fail(...)					\
+	do {						\
+		fprintf(stderr, __VA_ARGS__);		\
+		fprintf(stderr, "\n");			\
+		exit(1);				\
+	} while (0)
+
+#endif /* BENCH_H */
@@ -0,0 +1,95 @@
+#!/usr/bin/env bash
+
+# Copyright 2026 Red Hat Inc., Durham, North Carolina.
+# All Rights Reserved.
+#
+# Runs the benchmark suite and prints the results as a JSON array.
+# The array is also written to $BENCH_OUT (bench-results.json).
+#
+# Environment:
+#   BENCH_COUNT  number of generated definitions and files (10000)
+#   BENCH_DIRS   number of directories the files are spread over (64)
+#   BENCH_HOSTS  number of hosts with ARFs imported into the results store (16)
+#   BENCH_OUT    output file
+
+set -e -o pipefail
+
+. ../test_common.sh
+
+BENCH_COUNT=${BENCH_COUNT:-10000}
+BENCH_DIRS=${BENCH_DIRS:-64}
+BENCH_HOSTS=${BENCH_HOSTS:-16}
+BENCH_OUT=${BENCH_OUT:-bench-results.json}
+
+# A random MALLOC_PERTURB_ (set by the run script) makes the numbers
+# of different runs incomparable.
+unset MALLOC_PERTURB_
+
+if [ -f .libs/bench_alloc.so ]; then
+	export BENCH_ALLOC_LIB=$(pwd)/.libs/bench_alloc.so
+fi
+
+srcdir=${srcdir:-.}
+tmpdir=$(mktemp -t -d bench.XXXXXX)
+trap 'rm -rf "$tmpdir"' EXIT
+
+echo "Generating content: $BENCH_COUNT items in $tmpdir" >&2
+"$srcdir/gen_content.sh" "$tmpdir" "$BENCH_COUNT" "$BENCH_DIRS"
+
+pushd "$tmpdir" >/dev/null
+$OSCAP ds sds-compose xccdf.xml ds.xml >&2
+$OSCAP ds sds-image ds.xml ds.img >&2
+# ARFs of hosts scanned with the same content, they differ in the asset
+$OSCAP xccdf eval --profile xccdf_org.open-scap_profile_half --results-arf arf.xml ds.xml >/dev/null || true
+for ((i = 0; i < BENCH_HOSTS; i++)); do
+	sed "s|<ai:hostname>[^<]*</ai:hostname>|<ai:hostname>host-$i</ai:hostname>|" arf.xml > arf-$i.xml
+done
+popd >/dev/null
+
+results=()
+
+# bench NAME COMMAND [ARGS...]
+function bench {
+	local name=$1 result
+	shift
+
+	echo "Running $name" >&2
+	# oscap exits with 2 if some rules fail, which is expected here,
+	# the exit status is part of the result.
+	result=$(./bench_run "$name" "$@") || true
+	[ -n "$result" ] || result="{\"name\": \"$name\", \"status\": -1, \"result\": null}"
+	results+=("$result")
+}
+
+bench sexp        ./bench_sexp "$BENCH_COUNT" 20
+bench seap        ./bench_seap 10000 16
+bench probe-api   ./bench_probe_api 2000 20
+bench fts         ./bench_fts "$tmpdir/files" 5
+bench oval-import ./bench_oval import "$tmpdir/env-oval.xml"
+bench oval-eval   ./bench_oval eval "$tmpdir/env-oval.xml" "$tmpdir/env-syschar.xml"
+bench syschar-import ./bench_oval syschar "$tmpdir/env-oval.xml" "$tmpdir/file-syschar.xml"
+bench ds-load     ./bench_ds "$tmpdir/ds.xml"
+bench ds-load-image ./bench_ds "$tmpdir/ds.img"
+bench rds-store   ./bench_rds_store "$tmpdir/store" "$tmpdir"/arf-*.xml
+bench oval-files  $OSCAP oval eval --results "$tmpdir/file-results.xml" "$tmpdir/file-oval.xml"
+bench oval-filehash $OSCAP oval eval --results "$tmpdir/hash-results.xml" "$tmpdir/hash-oval.xml"
+bench oval-xmlfile $OSCAP oval eval --results "$tmpdir/xml-results.xml" "$tmpdir/xml-oval.xml"
+bench xccdf-eval  $OSCAP xccdf eval --results "$tmpdir/xccdf-results.xml" "$tmpdir/ds.xml"
+bench xccdf-eval-profile \
+	$OSCAP xccdf eval --profile xccdf_org.open-scap_profile_half \
+	--results "$tmpdir/xccdf-results.xml" "$tmpdir/ds.xml"
+bench xccdf-eval-profile-lazy \
+	$OSCAP xccdf eval --profile xccdf_org.open-scap_profile_half --lazy-oval \
+	--results "$tmpdir/xccdf-results.xml" "$tmpdir/ds.xml"
+bench xccdf-eval-values \
+	$OSCAP xccdf eval --profile xccdf_org.open-scap_profile_values \
+	--results "$tmpdir/values-results.xml" "$tmpdir/values-xccdf.xml"
+
+{
+	echo "["
+	for ((i = 0; i < ${#results[@]}; i++)); do
+		[ $i -eq $((${#results[@]} - 1)) ] && sep="" || sep=","
+		echo "  ${results[$i]}$sep"
+	done
+	echo "]"
+} | tee "$BENCH_OUT"
@@ -0,0 +1,110 @@
+/*
+ * Copyright 2026 Red Hat Inc., Durham, North Carolina.
+ * All Rights Reserved.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/*
+ * Allocation counter preloaded into the benchmarked process by
+ * bench_run. The counts are appended to the file named by
+ * BENCH_ALLOC_OUT when the process exits; forked children (probes)
+ * append their own line and bench_run sums them up. Processes killed
+ * by a signal don't report anything.
+ */
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+extern void *__libc_malloc(size_t size);
+extern void *__libc_calloc(size_t nmemb, size_t size);
+extern void *__libc_realloc(void *ptr, size_t size);
+extern void *__libc_memalign(size_t alignment, size_t size);
+
+/* glibc declares memalign() in <malloc.h> only */
+void *memalign(size_t alignment, size_t size);
+
+static unsigned long bench_allocs = 0;
+static unsigned long bench_alloc_bytes = 0;
+
+#define bench_count(size)						\
+	do {								\
+		__sync_fetch_and_add(&bench_allocs, 1);			\
+		__sync_fetch_and_add(&bench_alloc_bytes, (size));	\
+	} while (0)
+
+void *malloc(size_t size)
+{
+	bench_count(size);
+	return __libc_malloc(size);
+}
+
+void *calloc(size_t nmemb, size_t size)
+{
+	bench_count(nmemb * size);
+	return __libc_calloc(nmemb, size);
+}
+
+void *realloc(void *ptr, size_t size)
+{
+	bench_count(size);
+	return __libc_realloc(ptr, size);
+}
+
+int posix_memalign(void **memptr, size_t alignment, size_t size)
+{
+	void *ptr;
+
+	bench_count(size);
+
+	if ((ptr = __libc_memalign(alignment, size)) == NULL)
+		return (12); /* ENOMEM */
+
+	*memptr = ptr;
+	return (0);
+}
+
+void *memalign(size_t alignment, size_t size)
+{
+	bench_count(size);
+	return __libc_memalign(alignment, size);
+}
+
+static void __attribute__((destructor)) bench_alloc_report(void)
+{
+	const char *path;
+	char buf[64];
+	int fd, n;
+
+	if ((path = getenv("BENCH_ALLOC_OUT")) == NULL)
+		return;
+
+	if ((fd = open(path, O_WRONLY | O_APPEND)) < 0)
+		return;
+
+	n = snprintf(buf, sizeof buf, "%lu %lu\n", bench_allocs, bench_alloc_bytes);
+
+	/* a short write only loses the counts of this process */
+	if (write(fd, buf, (size_t)n) != n)
+		n = 0;
+
+	close(fd);
+}
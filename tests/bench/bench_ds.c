@@ -0,0 +1,63 @@
+/*
+ * Copyright 2026 Red Hat Inc., Durham, North Carolina.
+ * All Rights Reserved.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <stdio.h>
+#include <oscap_error.h>
+#include <xccdf_session.h>
+
+#include "bench.h"
+
+/*
+ * Loading of a source data stream, or of an image written from it
+ * by "oscap ds sds-image": validation, component lookup and
+ * parsing of the XCCDF benchmark and of the OVAL checks it refers to.
+ *
+ * Usage: bench_ds DATASTREAM
+ */
+int main(int argc, char *argv[])
+{
+	struct xccdf_session *session;
+	double t0, t_new, t_load;
+
+	if (argc < 2)
+		bench_fail("Usage: %s DATASTREAM", argv[0]);
+
+	t0 = bench_now();
+
+	if ((session = xccdf_session_new(argv[1])) == NULL)
+		bench_fail("Failed to open %s: %s", argv[1], oscap_err_desc());
+
+	t_new = bench_now() - t0;
+	t0 = bench_now();
+
+	if (xccdf_session_load(session) != 0)
+		bench_fail("Failed to load %s: %s", argv[1], oscap_err_desc());
+
+	t_load = bench_now() - t0;
+
+	xccdf_session_free(session);
+
+	printf("{\"open_s\": %.6f, \"load_s\": %.6f}\n", t_new, t_load);
+
+	return (0);
+}
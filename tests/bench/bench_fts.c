@@ -0,0 +1,107 @@
+/*
+ * Copyright 2026 Red Hat Inc., Durham, North Carolina.
+ * All Rights Reserved.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <stdio.h>
+#include <string.h>
+#include "sexp.h"
+#include "oval_fts.h"
+
+#include "bench.h"
+
+/*
+ * File system traversal as done by the file-based probes: every
+ * regular file matching ".*" under ROOT, recursing downwards.
+ *
+ * Usage: bench_fts ROOT [iterations]
+ */
+static SEXP_t *bench_fts_sexp(SEXP_psetup_t *psetup, const char *fmt, const char *arg)
+{
+	SEXP_pstate_t *pstate = NULL;
+	SEXP_t *s_exp, *s_first;
+	char buf[4096];
+	int n;
+
+	n = snprintf(buf, sizeof buf, fmt, arg);
+	s_exp = SEXP_parse(psetup, buf, (size_t)n, &pstate);
+
+	if (s_exp == NULL)
+		bench_fail("SEXP_parse(%s) failed", buf);
+
+	if (pstate != NULL)
+		SEXP_pstate_free(pstate);
+
+	s_first = SEXP_list_first(s_exp);
+	SEXP_free(s_exp);
+
+	return (s_first);
+}
+
+int main(int argc, char *argv[])
+{
+	OVAL_FTS    *ofts;
+	OVAL_FTSENT *ofts_ent;
+	SEXP_psetup_t *psetup;
+	SEXP_t *path, *filename, *behaviors;
+	unsigned long iters, i, entries;
+	double t0, t_walk;
+
+	if (argc < 2)
+		bench_fail("Usage: %s ROOT [iterations]", argv[0]);
+
+	iters  = bench_arg(argc, argv, 2, 5);
+	psetup = SEXP_psetup_new();
+
+	path      = bench_fts_sexp(psetup, "((path :operation 5) \"%s\")", argv[1]);
+	filename  = bench_fts_sexp(psetup, "((filename :operation 11) \"%s\")", ".");
+	behaviors = bench_fts_sexp(psetup, "((behaviors :max_depth \"-1\" :recurse \"%s\" "
+				   ":recurse_direction \"down\" :recurse_file_system \"all\"))",
+				   "symlinks and directories");
+	t_walk  = 0.0;
+	entries = 0;
+
+	for (i = 0; i < iters; ++i) {
+		entries = 0;
+		t0 = bench_now();
+
+		if ((ofts = oval_fts_open(path, filename, NULL, behaviors)) == NULL)
+			bench_fail("oval_fts_open(%s) failed", argv[1]);
+
+		while ((ofts_ent = oval_fts_read(ofts)) != NULL) {
+			++entries;
+			oval_ftsent_free(ofts_ent);
+		}
+
+		oval_fts_close(ofts);
+		t_walk += bench_now() - t0;
+	}
+
+	SEXP_free(path);
+	SEXP_free(filename);
+	SEXP_free(behaviors);
+	SEXP_psetup_free(psetup);
+
+	printf("{\"entries\": %lu, \"iterations\": %lu, \"walk_s\": %.6f, \"entries_per_s\": %.1f}\n",
+	       entries, iters, t_walk, (double)entries * iters / t_walk);
+
+	return (0);
+}
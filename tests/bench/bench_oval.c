@@ -0,0 +1,120 @@
+/*
+ * Copyright 2026 Red Hat Inc., Durham, North Carolina.
+ * All Rights Reserved.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <stdio.h>
+#include <string.h>
+#include <oscap_error.h>
+#include <oscap_source.h>
+#include <oval_definitions.h>
+#include <oval_system_characteristics.h>
+#include <oval_results.h>
+
+#include "bench.h"
+
+/*
+ * OVAL content loading and evaluation.
+ *
+ * Usage: bench_oval import DEFINITIONS
+ *        bench_oval syschar DEFINITIONS SYSCHAR
+ *        bench_oval eval DEFINITIONS SYSCHAR
+ *
+ * "syschar" only imports the system characteristics. "eval" evaluates
+ * every definition against previously collected system characteristics,
+ * so no probes are involved.
+ */
+static struct oval_definition_model *bench_oval_import(const char *path)
+{
+	struct oval_definition_model *def_model;
+	struct oscap_source *source;
+
+	source    = oscap_source_new_from_file(path);
+	def_model = oval_definition_model_import_source(source);
+	oscap_source_free(source);
+
+	if (def_model == NULL)
+		bench_fail("Failed to import %s: %s", path, oscap_err_desc());
+
+	return (def_model);
+}
+
+int main(int argc, char *argv[])
+{
+	struct oval_definition_model *def_model;
+	struct oval_syschar_model *sys_model, *sys_models[2];
+	struct oval_results_model *res_model;
+	struct oscap_source *source;
+	double t0, t_import, t_syschar, t_eval;
+
+	if (argc < 3 || (strcmp(argv[1], "import") != 0 && argc < 4))
+		bench_fail("Usage: %s import DEFINITIONS | syschar|eval DEFINITIONS SYSCHAR", argv[0]);
+
+	t0 = bench_now();
+	def_model = bench_oval_import(argv[2]);
+	t_import = bench_now() - t0;
+
+	if (strcmp(argv[1], "import") == 0) {
+		oval_definition_model_free(def_model);
+		printf("{\"import_s\": %.6f}\n", t_import);
+		return (0);
+	}
+
+	if (strcmp(argv[1], "eval") != 0 && strcmp(argv[1], "syschar") != 0)
+		bench_fail("Unknown mode: %s", argv[1]);
+
+	t0 = bench_now();
+	sys_model = oval_syschar_model_new(def_model);
+	source    = oscap_source_new_from_file(argv[3]);
+
+	if (oval_syschar_model_import_source(sys_model, source) != 0)
+		bench_fail("Failed to import %s: %s", argv[3], oscap_err_desc());
+
+	oscap_source_free(source);
+	t_syschar = bench_now() - t0;
+
+	if (strcmp(argv[1], "syschar") == 0) {
+		oval_syschar_model_free(sys_model);
+		oval_definition_model_free(def_model);
+		printf("{\"import_s\": %.6f, \"syschar_import_s\": %.6f}\n", t_import, t_syschar);
+		return (0);
+	}
+
+	sys_models[0] = sys_model;
+	sys_models[1] = NULL;
+
+	t0 = bench_now();
+	res_model = oval_results_model_new(def_model, sys_models);
+
+	if (oval_results_model_eval(res_model) != 0)
+		bench_fail("Evaluation failed: %s", oscap_err_desc());
+
+	t_eval = bench_now() - t0;
+
+	oval_results_model_free(res_model);
+	oval_syschar_model_free(sys_model);
+	oval_definition_model_free(def_model);
+
+	printf("{\"import_s\": %.6f, \"syschar_import_s\": %.6f, \"eval_s\": %.6f}\n",
+	       t_import, t_syschar, t_eval);
+
+	return (0);
+}
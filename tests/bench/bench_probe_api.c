@@ -0,0 +1,116 @@
+/*
+ * Copyright 2026 Red Hat Inc., Durham, North Carolina.
+ * All Rights Reserved.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <stdio.h>
+#include <string.h>
+#include <sexp.h>
+#include <probe-api.h>
+
+#include "bench.h"
+
+/*
+ * Entity and attribute lookups on wide probe items.
+ *
+ * Usage: bench_probe_api [entities] [iterations]
+ *
+ * The item has ENTITIES entities of distinct names followed by as many
+ * entities of one name, like the dependency entities of a systemd unit.
+ * Every entity is looked up by name and position, once in the item as
+ * built by the probe API and once in a copy without the entity index.
+ */
+static double bench_lookups(const SEXP_t *item, unsigned long ents, unsigned long iters)
+{
+	SEXP_t *ent, *val;
+	char name[32];
+	unsigned long i, j;
+	double t0;
+
+	t0 = bench_now();
+
+	for (i = 0; i < iters; ++i) {
+		for (j = 0; j < ents; ++j) {
+			snprintf(name, sizeof name, "entity_%lu", j);
+
+			if ((ent = probe_obj_getent(item, name, 1)) == NULL)
+				bench_fail("entity %s not found", name);
+
+			if ((val = probe_ent_getattrval(ent, "datatype")) == NULL)
+				bench_fail("no datatype of %s", name);
+
+			SEXP_vfree(val, ent, NULL);
+
+			if ((ent = probe_obj_getent(item, "dependency", j + 1)) == NULL)
+				bench_fail("dependency %lu not found", j + 1);
+
+			SEXP_free(ent);
+		}
+	}
+
+	return (bench_now() - t0);
+}
+
+int main(int argc, char *argv[])
+{
+	SEXP_t *item, *copy, *empty, *attrs, *val, *r0;
+	char name[32];
+	unsigned long ents, iters, j;
+	double t0, t_build, t_index, t_scan;
+
+	ents  = bench_arg(argc, argv, 1, 1000);
+	iters = bench_arg(argc, argv, 2, 10);
+
+	t0 = bench_now();
+
+	item = probe_item_new("bench_item", NULL);
+
+	for (j = 0; j < ents; ++j) {
+		snprintf(name, sizeof name, "entity_%lu", j);
+		attrs = probe_attr_creat("datatype", r0 = SEXP_string_newf("string"), NULL);
+		val   = SEXP_string_newf("value %lu", j);
+		probe_item_ent_add(item, name, attrs, val);
+		SEXP_vfree(attrs, val, r0, NULL);
+	}
+
+	for (j = 0; j < ents; ++j) {
+		val = SEXP_string_newf("unit%lu.service", j);
+		probe_item_ent_add(item, "dependency", NULL, val);
+		SEXP_free(val);
+	}
+
+	t_build = bench_now() - t0;
+
+	/* a joined list is a new list value which has no index */
+	empty = SEXP_list_new(NULL);
+	copy  = SEXP_list_join(item, empty);
+
+	t_index = bench_lookups(item, ents, iters);
+	t_scan  = bench_lookups(copy, ents, iters);
+
+	SEXP_vfree(item, copy, empty, NULL);
+
+	printf("{\"entities\": %lu, \"iterations\": %lu, \"build_s\": %.6f, "
+	       "\"lookup_indexed_s\": %.6f, \"lookup_scan_s\": %.6f, \"speedup\": %.2f}\n",
+	       2 * ents, iters, t_build, t_index, t_scan, t_scan / t_index);
+
+	return (0);
+}
@@ -0,0 +1,94 @@
+/*
+ * Copyright 2026 Red Hat Inc., Durham, North Carolina.
+ * All Rights Reserved.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <string.h>
+#include <oscap_error.h>
+#include <ds_rds_store.h>
+
+#include "bench.h"
+
+/*
+ * Import of result DataStreams into a results store and their export
+ * back to files, the ARFs are expected to share the DataStream and the
+ * OVAL definitions, as ARFs of one scan of many hosts do.
+ *
+ * Usage: bench_rds_store STORE ARF...
+ */
+int main(int argc, char *argv[])
+{
+	struct ds_rds_store *store;
+	char **ids, *target;
+	uint64_t arf_bytes, blob_bytes;
+	double t0, t_import, t_export;
+	int i, count;
+
+	if (argc < 3)
+		bench_fail("Usage: %s STORE ARF...", argv[0]);
+
+	count = argc - 2;
+	ids = calloc(count, sizeof(char *));
+
+	if ((store = ds_rds_store_open(argv[1])) == NULL)
+		bench_fail("Failed to open %s: %s", argv[1], oscap_err_desc());
+
+	t0 = bench_now();
+
+	for (i = 0; i < count; ++i) {
+		if ((ids[i] = ds_rds_store_import(store, argv[i + 2])) == NULL)
+			bench_fail("Failed to import %s: %s", argv[i + 2], oscap_err_desc());
+	}
+
+	t_import = bench_now() - t0;
+	t0 = bench_now();
+
+	target = malloc(strlen(argv[1]) + sizeof "/export.xml");
+	sprintf(target, "%s/export.xml", argv[1]);
+	for (i = 0; i < count; ++i) {
+		if (ds_rds_store_export(store, ids[i], target) != 0)
+			bench_fail("Failed to export %s: %s", ids[i], oscap_err_desc());
+	}
+
+	t_export = bench_now() - t0;
+
+	ds_rds_store_get_usage(store, NULL, &arf_bytes, &blob_bytes);
+	ds_rds_store_free(store);
+
+	for (i = 0; i < count; ++i)
+		free(ids[i]);
+	free(ids);
+	remove(target);
+	free(target);
+
+	printf("{\"arfs\": %d, \"arf_bytes\": %" PRIu64 ", \"blob_bytes\": %" PRIu64 ", "
+		"\"dedup_ratio\": %.3f, \"import_s\": %.6f, \"export_s\": %.6f, "
+		"\"import_mb_s\": %.1f, \"export_mb_s\": %.1f}\n",
+		count, arf_bytes, blob_bytes,
+		blob_bytes > 0 ? (double)arf_bytes / blob_bytes : 1.0,
+		t_import, t_export,
+		arf_bytes / 1048576.0 / (t_import > 0 ? t_import : 1e-9),
+		arf_bytes / 1048576.0 / (t_export > 0 ? t_export : 1e-9));
+
+	return 0;
+}
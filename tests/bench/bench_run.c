@@ -0,0 +1,190 @@
+/*
+ * Copyright 2026 Red Hat Inc., Durham, North Carolina.
+ * All Rights Reserved.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/time.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+
+#include "bench.h"
+
+/*
+ * Runs one benchmark and reports its resource usage.
+ *
+ * Usage: bench_run NAME COMMAND [ARGS...]
+ *
+ * The command runs with bench_alloc preloaded (BENCH_ALLOC_LIB) and
+ * its stdout is captured. The output is a single JSON object with the
+ * wall clock and CPU time, the peak RSS and the allocation counts of
+ * the command and all of its children. If the command printed a JSON
+ * object itself, it's embedded as "result".
+ */
+
+#define BENCH_OUTPUT_MAX (1 << 20)
+
+static char *bench_read_all(int fd)
+{
+	char *buf;
+	size_t len = 0;
+	ssize_t n;
+
+	buf = malloc(BENCH_OUTPUT_MAX + 1);
+
+	while (len < BENCH_OUTPUT_MAX) {
+		n = read(fd, buf + len, BENCH_OUTPUT_MAX - len);
+
+		if (n < 0 && errno == EINTR)
+			continue;
+		if (n <= 0)
+			break;
+
+		len += (size_t)n;
+	}
+
+	/* drain whatever doesn't fit so that the child doesn't block */
+	while (len == BENCH_OUTPUT_MAX) {
+		char sink[4096];
+
+		if (read(fd, sink, sizeof sink) <= 0)
+			break;
+	}
+
+	while (len > 0 && (buf[len - 1] == '\n' || buf[len - 1] == ' '))
+		--len;
+
+	buf[len] = '\0';
+
+	return (buf);
+}
+
+static void bench_alloc_sum(const char *path, unsigned long *allocs, unsigned long *bytes)
+{
+	unsigned long a, b;
+	FILE *fp;
+
+	*allocs = 0;
+	*bytes  = 0;
+
+	if ((fp = fopen(path, "r")) == NULL)
+		return;
+
+	while (fscanf(fp, "%lu %lu", &a, &b) == 2) {
+		*allocs += a;
+		*bytes  += b;
+	}
+
+	fclose(fp);
+}
+
+static void bench_setup_env(char *alloc_out)
+{
+	const char *lib, *preload;
+	char *value;
+	size_t len;
+
+	if ((lib = getenv("BENCH_ALLOC_LIB")) == NULL || *lib == '\0')
+		return;
+
+	setenv("BENCH_ALLOC_OUT", alloc_out, 1);
+
+	if ((preload = getenv("LD_PRELOAD")) == NULL || *preload == '\0') {
+		setenv("LD_PRELOAD", lib, 1);
+		return;
+	}
+
+	len   = strlen(lib) + strlen(preload) + 2;
+	value = malloc(len);
+	snprintf(value, len, "%s:%s", lib, preload);
+	setenv("LD_PRELOAD", value, 1);
+	free(value);
+}
+
+int main(int argc, char *argv[])
+{
+	char alloc_out[] = "/tmp/bench_alloc.XXXXXX";
+	unsigned long allocs, alloc_bytes;
+	struct rusage ru;
+	int pfd[2], fd, status;
+	double t0, wall;
+	char *output;
+	pid_t pid;
+
+	if (argc < 3)
+		bench_fail("Usage: %s NAME COMMAND [ARGS...]", argv[0]);
+
+	if ((fd = mkstemp(alloc_out)) < 0)
+		bench_fail("mkstemp: %s", strerror(errno));
+
+	close(fd);
+
+	if (pipe(pfd) != 0)
+		bench_fail("pipe: %s", strerror(errno));
+
+	t0 = bench_now();
+
+	switch (pid = fork()) {
+	case -1:
+		bench_fail("fork: %s", strerror(errno));
+	case 0:
+		close(pfd[0]);
+
+		if (dup2(pfd[1], STDOUT_FILENO) != STDOUT_FILENO)
+			_exit(127);
+
+		close(pfd[1]);
+		bench_setup_env(alloc_out);
+		execvp(argv[2], argv + 2);
+		fprintf(stderr, "%s: %s\n", argv[2], strerror(errno));
+		_exit(127);
+	}
+
+	close(pfd[1]);
+	output = bench_read_all(pfd[0]);
+	close(pfd[0]);
+
+	while (wait4(pid, &status, 0, &ru) < 0) {
+		if (errno != EINTR)
+			bench_fail("wait4: %s", strerror(errno));
+	}
+
+	wall = bench_now() - t0;
+
+	bench_alloc_sum(alloc_out, &allocs, &alloc_bytes);
+	unlink(alloc_out);
+
+	printf("{\"name\": \"%s\", \"status\": %d, \"wall_s\": %.6f, \"user_s\": %.6f, \"sys_s\": %.6f, "
+	       "\"maxrss_kb\": %ld, \"allocs\": %lu, \"alloc_bytes\": %lu, \"result\": %s}\n",
+	       argv[1], WIFEXITED(status) ? WEXITSTATUS(status) : 128 + WTERMSIG(status),
+	       wall, ru.ru_utime.tv_sec + ru.ru_utime.tv_usec / 1e6,
+	       ru.ru_stime.tv_sec + ru.ru_stime.tv_usec / 1e6,
+	       ru.ru_maxrss, allocs, alloc_bytes, output[0] == '{' ? output : "null");
+
+	free(output);
+
+	return (WIFEXITED(status) && WEXITSTATUS(status) == 0 ? 0 : 1);
+}
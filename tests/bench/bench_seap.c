@@ -0,0 +1,140 @@
+/*
+ * Copyright 2026 Red Hat Inc., Durham, North Carolina.
+ * All Rights Reserved.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <limits.h>
+#include <seap.h>
+
+#include "bench.h"
+
+/*
+ * SEAP round-trip latency over the pipe scheme, the transport used
+ * between the library and the probes.
+ *
+ * Usage: bench_seap [round-trips] [payload items]
+ *
+ * The program connects to itself: the peer is started by the pipe
+ * scheme with BENCH_SEAP_PEER set and echoes every message back.
+ */
+#define BENCH_SEAP_PEER "BENCH_SEAP_PEER"
+
+static int bench_seap_peer(void)
+{
+	SEAP_CTX_t *ctx;
+	SEXP_t *sexp;
+	int sd;
+
+	ctx = SEAP_CTX_new();
+	sd  = SEAP_openfd2(ctx, STDIN_FILENO, STDOUT_FILENO, 0);
+
+	if (sd < 0)
+		return (1);
+
+	while (SEAP_recvsexp(ctx, sd, &sexp) == 0) {
+		if (SEAP_sendsexp(ctx, sd, sexp) != 0) {
+			SEXP_free(sexp);
+			break;
+		}
+		SEXP_free(sexp);
+	}
+
+	SEAP_close(ctx, sd);
+	SEAP_CTX_free(ctx);
+
+	return (0);
+}
+
+int main(int argc, char *argv[])
+{
+	SEAP_CTX_t *ctx;
+	SEXP_t *payload, *item, *reply;
+	unsigned long count, items, i;
+	char self[PATH_MAX], uri[PATH_MAX + 16];
+	double t0, t, t_min, t_max, t_total;
+	ssize_t len;
+	int sd;
+
+	if (getenv(BENCH_SEAP_PEER) != NULL)
+		return bench_seap_peer();
+
+	count = bench_arg(argc, argv, 1, 10000);
+	items = bench_arg(argc, argv, 2, 16);
+
+	if ((len = readlink("/proc/self/exe", self, sizeof self - 1)) < 0)
+		bench_fail("readlink(/proc/self/exe) failed");
+
+	self[len] = '\0';
+	snprintf(uri, sizeof uri, "pipe://%s", self);
+	setenv(BENCH_SEAP_PEER, "1", 1);
+
+	ctx = SEAP_CTX_new();
+	sd  = SEAP_connect(ctx, uri, 0);
+
+	if (sd < 0)
+		bench_fail("SEAP_connect(%s) failed", uri);
+
+	payload = SEXP_list_new(NULL);
+
+	for (i = 0; i < items; ++i) {
+		item = SEXP_string_newf("/usr/lib/bench/file%lu.conf", i);
+		SEXP_list_add(payload, item);
+		SEXP_free(item);
+	}
+
+	t_min   = 0.0;
+	t_max   = 0.0;
+	t_total = 0.0;
+
+	for (i = 0; i < count; ++i) {
+		t0 = bench_now();
+
+		if (SEAP_sendsexp(ctx, sd, payload) != 0)
+			bench_fail("SEAP_sendsexp failed");
+
+		if (SEAP_recvsexp(ctx, sd, &reply) != 0)
+			bench_fail("SEAP_recvsexp failed");
+
+		t = bench_now() - t0;
+		t_total += t;
+
+		if (i == 0 || t < t_min)
+			t_min = t;
+		if (t > t_max)
+			t_max = t;
+
+		SEXP_free(reply);
+	}
+
+	SEXP_free(payload);
+	SEAP_close(ctx, sd);
+	SEAP_CTX_free(ctx);
+
+	printf("{\"round_trips\": %lu, \"payload_items\": %lu, \"total_s\": %.6f, "
+	       "\"avg_us\": %.3f, \"min_us\": %.3f, \"max_us\": %.3f}\n",
+	       count, items, t_total, t_total / count * 1e6, t_min * 1e6, t_max * 1e6);
+
+	return (0);
+}
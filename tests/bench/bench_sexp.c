@@ -0,0 +1,127 @@
+/*
+ * Copyright 2026 Red Hat Inc., Durham, North Carolina.
+ * All Rights Reserved.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <stdio.h>
+#include <string.h>
+#include <sexp.h>
+#include <strbuf.h>
+
+#include "bench.h"
+
+/*
+ * S-exp parser and printer throughput.
+ *
+ * Usage: bench_sexp [items] [iterations]
+ *
+ * The input resembles the collected items sent by probes: a list of
+ * items, each with a few attributes and entities of mixed types.
+ */
+static char *bench_sexp_input(unsigned long items, size_t *len)
+{
+	strbuf_t *sb;
+	char buf[512], *input;
+	unsigned long i;
+	int n;
+
+	sb = strbuf_new(SEAP_STRBUF_MAX);
+	strbuf_add0(sb, "(");
+
+	for (i = 0; i < items; ++i) {
+		n = snprintf(buf, sizeof buf,
+			     "((file_item :id \"%lu\" :status 1) "
+			     "((filepath :datatype \"string\") \"/usr/lib/bench/dir%lu/file%lu.conf\") "
+			     "(size %lu) (mode 420) (uid 0) (gid 0) (mtime 1400000000.%lu) "
+			     "((hash :hash_type \"SHA-256\") |YmVuY2htYXJrIGRhdGEgZm9yIHRoZSBTLWV4cCBwYXJzZXI=|))",
+			     i, i % 128, i, i * 7, i % 1000);
+		strbuf_add(sb, buf, (size_t)n);
+	}
+
+	strbuf_add0(sb, ")");
+
+	*len  = strbuf_length(sb);
+	input = strbuf_cstr(sb);
+	strbuf_free(sb);
+
+	return (input);
+}
+
+int main(int argc, char *argv[])
+{
+	unsigned long items, iters, i;
+	SEXP_psetup_t *psetup;
+	SEXP_pstate_t *pstate;
+	SEXP_t *s_exp, *s_first;
+	strbuf_t *sb;
+	char *input;
+	size_t len, out_len;
+	double t0, t_parse, t_print;
+
+	items = bench_arg(argc, argv, 1, 10000);
+	iters = bench_arg(argc, argv, 2, 20);
+	input = bench_sexp_input(items, &len);
+
+	psetup  = SEXP_psetup_new();
+	t_parse = 0.0;
+	t_print = 0.0;
+	out_len = 0;
+
+	for (i = 0; i < iters; ++i) {
+		pstate = NULL;
+
+		t0 = bench_now();
+		s_exp = SEXP_parse(psetup, input, len, &pstate);
+		t_parse += bench_now() - t0;
+
+		if (s_exp == NULL)
+			bench_fail("SEXP_parse failed");
+
+		if (pstate != NULL)
+			SEXP_pstate_free(pstate);
+
+		s_first = SEXP_list_first(s_exp);
+
+		if (SEXP_list_length(s_first) != items)
+			bench_fail("unexpected item count: %zu", SEXP_list_length(s_first));
+
+		sb = strbuf_new(SEAP_STRBUF_MAX);
+
+		t0 = bench_now();
+		if (SEXP_sbprintf_t(s_first, sb) != 0)
+			bench_fail("SEXP_sbprintf_t failed");
+		t_print += bench_now() - t0;
+
+		out_len = strbuf_length(sb);
+		strbuf_free(sb);
+		SEXP_vfree(s_first, s_exp, NULL);
+	}
+
+	SEXP_psetup_free(psetup);
+	free(input);
+
+	printf("{\"items\": %lu, \"iterations\": %lu, \"input_bytes\": %zu, \"output_bytes\": %zu, "
+	       "\"parse_s\": %.6f, \"print_s\": %.6f, \"parse_mb_per_s\": %.3f, \"print_mb_per_s\": %.3f}\n",
+	       items, iters, len, out_len, t_parse, t_print,
+	       (double)len * iters / t_parse / 1e6, (double)out_len * iters / t_print / 1e6);
+
+	return (0);
+}
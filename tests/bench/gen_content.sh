@@ -0,0 +1,355 @@
+#!/usr/bin/env bash
+
+# Copyright 2026 Red Hat Inc., Durham, North Carolina.
+# All Rights Reserved.
+#
+# Generates synthetic content for the benchmark suite:
+#
+#   env-oval.xml     COUNT environmentvariable definitions
+#   env-syschar.xml  system characteristics matching env-oval.xml
+#   file-syschar.xml system characteristics with COUNT file items
+#   xccdf.xml        XCCDF 1.2 benchmark with a rule per definition
+#   values-xccdf.xml the same rules each exporting one of COUNT/2
+#                    Values, all of them tailored by a profile with
+#                    a set-value and a refine-value
+#   files/           DIRS directories with COUNT text files in total
+#   file-oval.xml    textfilecontent54 and filehash58 definitions
+#                    covering every directory in files/
+#   hash/            COUNT/8 small files mixed with a few 4MB ones
+#   hash-oval.xml    filehash58 definition hashing hash/ with all
+#                    the SHA algorithms in one pass
+#   xml/             a few large XML configuration documents
+#   xml-oval.xml     COUNT/50 xmlfilecontent objects, each querying
+#                    all the documents in xml/ with its own XPath
+#
+# The content is deterministic, so results of different runs can be
+# compared with each other.
+
+set -e -o pipefail
+
+DIR=$1
+COUNT=${2:-10000}
+DIRS=${3:-64}
+
+if [ -z "$DIR" ]; then
+	echo "Usage: $0 <dir> [count] [dirs]" >&2
+	exit 2
+fi
+
+mkdir -p "$DIR/files"
+
+OVAL_DEF_HEAD='<?xml version="1.0" encoding="UTF-8"?>
+<oval_definitions xmlns:oval="http://oval.mitre.org/XMLSchema/oval-common-5" xmlns:xsi="http://www.w3.org/2001/XMLSchema-instance" xmlns:ind-def="http://oval.mitre.org/XMLSchema/oval-definitions-5#independent" xmlns="http://oval.mitre.org/XMLSchema/oval-definitions-5" xsi:schemaLocation="http://oval.mitre.org/XMLSchema/oval-definitions-5#independent independent-definitions-schema.xsd http://oval.mitre.org/XMLSchema/oval-definitions-5 oval-definitions-schema.xsd http://oval.mitre.org/XMLSchema/oval-common-5 oval-common-schema.xsd">
+  <generator>
+    <oval:product_name>cpe:/a:open-scap:oscap</oval:product_name>
+    <oval:schema_version>5.10</oval:schema_version>
+    <oval:timestamp>2014-01-01T00:00:00</oval:timestamp>
+  </generator>'
+
+# environmentvariable definitions, every other one passes
+awk -v n="$COUNT" -v head="$OVAL_DEF_HEAD" 'BEGIN {
+	print head
+	print "  <definitions>"
+	for (i = 1; i <= n; i++) {
+		printf "    <definition id=\"oval:bench:def:%d\" version=\"1\" class=\"compliance\">\n", i
+		printf "      <metadata><title>Environment variable %d</title><description>Benchmark definition %d.</description></metadata>\n", i, i
+		printf "      <criteria><criterion test_ref=\"oval:bench:tst:%d\"/></criteria>\n", i
+		printf "    </definition>\n"
+	}
+	print "  </definitions>"
+	print "  <tests>"
+	for (i = 1; i <= n; i++) {
+		printf "    <ind-def:environmentvariable_test id=\"oval:bench:tst:%d\" version=\"1\" check=\"all\" comment=\"Test %d.\">\n", i, i
+		printf "      <ind-def:object object_ref=\"oval:bench:obj:%d\"/>\n", i
+		printf "      <ind-def:state state_ref=\"oval:bench:ste:%d\"/>\n", i
+		printf "    </ind-def:environmentvariable_test>\n"
+	}
+	print "  </tests>"
+	print "  <objects>"
+	for (i = 1; i <= n; i++) {
+		printf "    <ind-def:environmentvariable_object id=\"oval:bench:obj:%d\" version=\"1\">\n", i
+		printf "      <ind-def:name>BENCH_VAR_%d</ind-def:name>\n", i
+		printf "    </ind-def:environmentvariable_object>\n"
+	}
+	print "  </objects>"
+	print "  <states>"
+	for (i = 1; i <= n; i++) {
+		printf "    <ind-def:environmentvariable_state id=\"oval:bench:ste:%d\" version=\"1\">\n", i
+		printf "      <ind-def:value operation=\"pattern match\">^value%d$</ind-def:value>\n", i - i % 2
+		printf "    </ind-def:environmentvariable_state>\n"
+	}
+	print "  </states>"
+	print "</oval_definitions>"
+}' > "$DIR/env-oval.xml"
+
+awk -v n="$COUNT" 'BEGIN {
+	print "<?xml version=\"1.0\" encoding=\"UTF-8\"?>"
+	print "<oval_system_characteristics xmlns:oval=\"http://oval.mitre.org/XMLSchema/oval-common-5\" xmlns:xsi=\"http://www.w3.org/2001/XMLSchema-instance\" xmlns:ind-sys=\"http://oval.mitre.org/XMLSchema/oval-system-characteristics-5#independent\" xmlns=\"http://oval.mitre.org/XMLSchema/oval-system-characteristics-5\" xsi:schemaLocation=\"http://oval.mitre.org/XMLSchema/oval-system-characteristics-5 oval-system-characteristics-schema.xsd http://oval.mitre.org/XMLSchema/oval-system-characteristics-5#independent independent-system-characteristics-schema.xsd http://oval.mitre.org/XMLSchema/oval-common-5 oval-common-schema.xsd\">"
+	print "  <generator>"
+	print "    <oval:product_name>cpe:/a:open-scap:oscap</oval:product_name>"
+	print "    <oval:schema_version>5.10</oval:schema_version>"
+	print "    <oval:timestamp>2014-01-01T00:00:00</oval:timestamp>"
+	print "  </generator>"
+	print "  <system_info>"
+	print "    <os_name>Linux</os_name>"
+	print "    <os_version>bench</os_version>"
+	print "    <architecture>x86_64</architecture>"
+	print "    <primary_host_name>bench</primary_host_name>"
+	print "    <interfaces/>"
+	print "  </system_info>"
+	print "  <collected_objects>"
+	for (i = 1; i <= n; i++)
+		printf "    <object id=\"oval:bench:obj:%d\" version=\"1\" flag=\"complete\"><reference item_ref=\"%d\"/></object>\n", i, i
+	print "  </collected_objects>"
+	print "  <system_data>"
+	for (i = 1; i <= n; i++) {
+		printf "    <ind-sys:environmentvariable_item id=\"%d\" status=\"exists\">\n", i
+		printf "      <ind-sys:name>BENCH_VAR_%d</ind-sys:name>\n", i
+		printf "      <ind-sys:value>value%d</ind-sys:value>\n", i
+		printf "    </ind-sys:environmentvariable_item>\n"
+	}
+	print "  </system_data>"
+	print "</oval_system_characteristics>"
+}' > "$DIR/env-syschar.xml"
+
+# file items, most of the entity values repeat
+awk -v n="$COUNT" -v dirs="$DIRS" 'BEGIN {
+	print "<?xml version=\"1.0\" encoding=\"UTF-8\"?>"
+	print "<oval_system_characteristics xmlns:oval=\"http://oval.mitre.org/XMLSchema/oval-common-5\" xmlns:xsi=\"http://www.w3.org/2001/XMLSchema-instance\" xmlns:unix-sys=\"http://oval.mitre.org/XMLSchema/oval-system-characteristics-5#unix\" xmlns=\"http://oval.mitre.org/XMLSchema/oval-system-characteristics-5\" xsi:schemaLocation=\"http://oval.mitre.org/XMLSchema/oval-system-characteristics-5 oval-system-characteristics-schema.xsd http://oval.mitre.org/XMLSchema/oval-system-characteristics-5#unix unix-system-characteristics-schema.xsd http://oval.mitre.org/XMLSchema/oval-common-5 oval-common-schema.xsd\">"
+	print "  <generator>"
+	print "    <oval:product_name>cpe:/a:open-scap:oscap</oval:product_name>"
+	print "    <oval:schema_version>5.10</oval:schema_version>"
+	print "    <oval:timestamp>2014-01-01T00:00:00</oval:timestamp>"
+	print "  </generator>"
+	print "  <system_info>"
+	print "    <os_name>Linux</os_name>"
+	print "    <os_version>bench</os_version>"
+	print "    <architecture>x86_64</architecture>"
+	print "    <primary_host_name>bench</primary_host_name>"
+	print "    <interfaces/>"
+	print "  </system_info>"
+	print "  <system_data>"
+	split("uread uwrite uexec gread gwrite gexec oread owrite oexec suid sgid sticky", perms, " ")
+	for (i = 1; i <= n; i++) {
+		d = i % dirs
+		printf "    <unix-sys:file_item id=\"%d\" status=\"exists\">\n", i
+		printf "      <unix-sys:filepath>/usr/lib/bench/d%d/file%d.conf</unix-sys:filepath>\n", d, i
+		printf "      <unix-sys:path>/usr/lib/bench/d%d</unix-sys:path>\n", d
+		printf "      <unix-sys:filename>file%d.conf</unix-sys:filename>\n", i
+		printf "      <unix-sys:type>regular</unix-sys:type>\n"
+		printf "      <unix-sys:group_id datatype=\"int\">%d</unix-sys:group_id>\n", (i % 7 == 0) ? 10 : 0
+		printf "      <unix-sys:user_id datatype=\"int\">0</unix-sys:user_id>\n"
+		printf "      <unix-sys:a_time datatype=\"int\">1400000000</unix-sys:a_time>\n"
+		printf "      <unix-sys:c_time datatype=\"int\">1400000000</unix-sys:c_time>\n"
+		printf "      <unix-sys:m_time datatype=\"int\">%d</unix-sys:m_time>\n", 1400000000 + i % 100
+		printf "      <unix-sys:size datatype=\"int\">%d</unix-sys:size>\n", 512 + i % 64
+		for (p = 1; p <= 12; p++)
+			printf "      <unix-sys:%s datatype=\"boolean\">%s</unix-sys:%s>\n", perms[p], (p <= 4 || p == 7) ? "true" : "false", perms[p]
+		printf "    </unix-sys:file_item>\n"
+	}
+	print "  </system_data>"
+	print "</oval_system_characteristics>"
+}' > "$DIR/file-syschar.xml"
+
+awk -v n="$COUNT" 'BEGIN {
+	print "<?xml version=\"1.0\" encoding=\"UTF-8\"?>"
+	print "<xccdf:Benchmark xmlns:xccdf=\"http://checklists.nist.gov/xccdf/1.2\" id=\"xccdf_org.open-scap_benchmark_bench\" resolved=\"1\" style=\"SCAP_1.2\" xml:lang=\"en\">"
+	print "  <xccdf:status date=\"2014-01-01\">draft</xccdf:status>"
+	print "  <xccdf:title>Benchmark suite content</xccdf:title>"
+	print "  <xccdf:version>1.0</xccdf:version>"
+	print "  <xccdf:Profile id=\"xccdf_org.open-scap_profile_half\">"
+	print "    <xccdf:title>Every other rule</xccdf:title>"
+	for (i = 2; i <= n; i += 2)
+		printf "    <xccdf:select idref=\"xccdf_org.open-scap_rule_%d\" selected=\"false\"/>\n", i
+	print "  </xccdf:Profile>"
+	print "  <xccdf:Group id=\"xccdf_org.open-scap_group_bench\">"
+	print "    <xccdf:title>Environment</xccdf:title>"
+	for (i = 1; i <= n; i++) {
+		printf "    <xccdf:Rule id=\"xccdf_org.open-scap_rule_%d\" selected=\"true\">\n", i
+		printf "      <xccdf:title>Environment variable %d</xccdf:title>\n", i
+		printf "      <xccdf:check system=\"http://oval.mitre.org/XMLSchema/oval-definitions-5\">\n"
+		printf "        <xccdf:check-content-ref href=\"env-oval.xml\" name=\"oval:bench:def:%d\"/>\n", i
+		printf "      </xccdf:check>\n"
+		printf "    </xccdf:Rule>\n"
+	}
+	print "  </xccdf:Group>"
+	print "</xccdf:Benchmark>"
+}' > "$DIR/xccdf.xml"
+
+awk -v n="$COUNT" -v values="$((COUNT / 2))" 'BEGIN {
+	print "<?xml version=\"1.0\" encoding=\"UTF-8\"?>"
+	print "<xccdf:Benchmark xmlns:xccdf=\"http://checklists.nist.gov/xccdf/1.2\" id=\"xccdf_org.open-scap_benchmark_values\" resolved=\"1\" style=\"SCAP_1.2\" xml:lang=\"en\">"
+	print "  <xccdf:status date=\"2014-01-01\">draft</xccdf:status>"
+	print "  <xccdf:title>Benchmark suite content with values</xccdf:title>"
+	print "  <xccdf:version>1.0</xccdf:version>"
+	print "  <xccdf:Profile id=\"xccdf_org.open-scap_profile_values\">"
+	print "    <xccdf:title>Every value tailored</xccdf:title>"
+	for (i = 1; i <= values; i++) {
+		printf "    <xccdf:set-value idref=\"xccdf_org.open-scap_value_%d\">set%d</xccdf:set-value>\n", i, i
+		printf "    <xccdf:refine-value idref=\"xccdf_org.open-scap_value_%d\" selector=\"alt\"/>\n", i
+	}
+	print "  </xccdf:Profile>"
+	for (i = 1; i <= values; i++) {
+		printf "  <xccdf:Value id=\"xccdf_org.open-scap_value_%d\" type=\"string\">\n", i
+		printf "    <xccdf:title>Value %d</xccdf:title>\n", i
+		printf "    <xccdf:value>default%d</xccdf:value>\n", i
+		printf "    <xccdf:value selector=\"alt\">alt%d</xccdf:value>\n", i
+		printf "  </xccdf:Value>\n"
+	}
+	print "  <xccdf:Group id=\"xccdf_org.open-scap_group_bench\">"
+	print "    <xccdf:title>Environment</xccdf:title>"
+	for (i = 1; i <= n; i++) {
+		printf "    <xccdf:Rule id=\"xccdf_org.open-scap_rule_%d\" selected=\"true\">\n", i
+		printf "      <xccdf:title>Environment variable %d</xccdf:title>\n", i
+		printf "      <xccdf:check system=\"http://oval.mitre.org/XMLSchema/oval-definitions-5\">\n"
+		printf "        <xccdf:check-export export-name=\"oval:bench:var:%d\" value-id=\"xccdf_org.open-scap_value_%d\"/>\n", i, (i - 1) % values + 1
+		printf "        <xccdf:check-content-ref href=\"env-oval.xml\" name=\"oval:bench:def:%d\"/>\n", i
+		printf "      </xccdf:check>\n"
+		printf "    </xccdf:Rule>\n"
+	}
+	print "  </xccdf:Group>"
+	print "</xccdf:Benchmark>"
+}' > "$DIR/values-xccdf.xml"
+
+# text files spread over DIRS directories
+awk -v n="$COUNT" -v dirs="$DIRS" -v root="$DIR/files" 'BEGIN {
+	for (d = 0; d < dirs; d++)
+		system("mkdir -p " root "/d" d)
+	for (i = 0; i < n; i++) {
+		f = sprintf("%s/d%d/file%d.conf", root, i % dirs, i)
+		for (l = 0; l < 32; l++)
+			printf "key%d = value%d\n", l, (i + l) % 97 > f
+		close(f)
+	}
+}'
+
+# textfilecontent54 and filehash58 definitions, one of each per directory
+awk -v dirs="$DIRS" -v head="$OVAL_DEF_HEAD" -v root="$(cd "$DIR/files" && pwd)" 'BEGIN {
+	print head
+	print "  <definitions>"
+	for (d = 0; d < dirs; d++) {
+		printf "    <definition id=\"oval:bench:def:%d\" version=\"1\" class=\"compliance\">\n", d + 1
+		printf "      <metadata><title>Directory %d</title><description>Benchmark definition %d.</description></metadata>\n", d, d + 1
+		printf "      <criteria operator=\"AND\">\n"
+		printf "        <criterion test_ref=\"oval:bench:tst:%d\"/>\n", 2 * d + 1
+		printf "        <criterion test_ref=\"oval:bench:tst:%d\"/>\n", 2 * d + 2
+		printf "      </criteria>\n"
+		printf "    </definition>\n"
+	}
+	print "  </definitions>"
+	print "  <tests>"
+	for (d = 0; d < dirs; d++) {
+		printf "    <ind-def:textfilecontent54_test id=\"oval:bench:tst:%d\" version=\"1\" check=\"all\" comment=\"tfc54 %d\">\n", 2 * d + 1, d
+		printf "      <ind-def:object object_ref=\"oval:bench:obj:%d\"/>\n", 2 * d + 1
+		printf "    </ind-def:textfilecontent54_test>\n"
+		printf "    <ind-def:filehash58_test id=\"oval:bench:tst:%d\" version=\"1\" check=\"all\" comment=\"filehash58 %d\">\n", 2 * d + 2, d
+		printf "      <ind-def:object object_ref=\"oval:bench:obj:%d\"/>\n", 2 * d + 2
+		printf "    </ind-def:filehash58_test>\n"
+	}
+	print "  </tests>"
+	print "  <objects>"
+	for (d = 0; d < dirs; d++) {
+		printf "    <ind-def:textfilecontent54_object id=\"oval:bench:obj:%d\" version=\"1\">\n", 2 * d + 1
+		printf "      <ind-def:path>%s/d%d</ind-def:path>\n", root, d
+		printf "      <ind-def:filename operation=\"pattern match\">^file[0-9]+\\.conf$</ind-def:filename>\n"
+		printf "      <ind-def:pattern operation=\"pattern match\">^key1[0-9] = (\\w+)$</ind-def:pattern>\n"
+		printf "      <ind-def:instance operation=\"greater than or equal\" datatype=\"int\">1</ind-def:instance>\n"
+		printf "    </ind-def:textfilecontent54_object>\n"
+		printf "    <ind-def:filehash58_object id=\"oval:bench:obj:%d\" version=\"1\">\n", 2 * d + 2
+		printf "      <ind-def:path>%s/d%d</ind-def:path>\n", root, d
+		printf "      <ind-def:filename operation=\"pattern match\">^file[0-9]+\\.conf$</ind-def:filename>\n"
+		printf "      <ind-def:hash_type operation=\"equals\">SHA-256</ind-def:hash_type>\n"
+		printf "    </ind-def:filehash58_object>\n"
+	}
+	print "  </objects>"
+	print "</oval_definitions>"
+}' > "$DIR/file-oval.xml"
+
+# mixed-size files for filehash58, every 64th one is 4MB large
+mkdir -p "$DIR/hash"
+awk -v n="$((COUNT / 8))" -v root="$DIR/hash" 'BEGIN {
+	for (i = 0; i < n; i++) {
+		if (i % 64 == 0)
+			continue
+		f = sprintf("%s/file%d.bin", root, i)
+		for (l = 0; l <= i % 64; l++)
+			printf "line%d of file%d\n", l, i > f
+		close(f)
+	}
+}'
+for ((i = 0; i < COUNT / 8; i += 64)); do
+	head -c 4194304 /dev/zero | tr '\000' "\\$(printf '%03o' $((65 + i / 64 % 26)))" > "$DIR/hash/file$i.bin"
+done
+
+# filehash58 definition over hash/, a single object matching every SHA
+# algorithm, so each file is read once and hashed with all of them
+awk -v head="$OVAL_DEF_HEAD" -v root="$(cd "$DIR/hash" && pwd)" 'BEGIN {
+	print head
+	print "  <definitions>"
+	print "    <definition id=\"oval:bench:def:1\" version=\"1\" class=\"compliance\">"
+	print "      <metadata><title>Hashes</title><description>Benchmark definition.</description></metadata>"
+	print "      <criteria operator=\"AND\">"
+	print "        <criterion test_ref=\"oval:bench:tst:1\"/>"
+	print "      </criteria>"
+	print "    </definition>"
+	print "  </definitions>"
+	print "  <tests>"
+	print "    <ind-def:filehash58_test id=\"oval:bench:tst:1\" version=\"1\" check=\"all\" comment=\"filehash58 SHA\">"
+	print "      <ind-def:object object_ref=\"oval:bench:obj:1\"/>"
+	print "    </ind-def:filehash58_test>"
+	print "  </tests>"
+	print "  <objects>"
+	print "    <ind-def:filehash58_object id=\"oval:bench:obj:1\" version=\"1\">"
+	printf "      <ind-def:path>%s</ind-def:path>\n", root
+	printf "      <ind-def:filename operation=\"pattern match\">^file[0-9]+\\.bin$</ind-def:filename>\n"
+	print "      <ind-def:hash_type operation=\"not equal\">MD5</ind-def:hash_type>"
+	print "    </ind-def:filehash58_object>"
+	print "  </objects>"
+	print "</oval_definitions>"
+}' > "$DIR/hash-oval.xml"
+
+# a few configuration documents with many connectors each
+mkdir -p "$DIR/xml"
+awk -v root="$DIR/xml" 'BEGIN {
+	for (d = 0; d < 4; d++) {
+		f = sprintf("%s/server%d.xml", root, d)
+		printf "<?xml version=\"1.0\"?>\n<Server port=\"%d\" shutdown=\"SHUTDOWN\">\n", 8005 + d > f
+		printf "  <Service name=\"Catalina%d\">\n", d > f
+		for (c = 0; c < 2000; c++)
+			printf "    <Connector id=\"c%d\" port=\"%d\" protocol=\"HTTP/1.1\" secure=\"%s\"/>\n", c, 10000 + c, c % 2 ? "true" : "false" > f
+		printf "  </Service>\n</Server>\n" > f
+		close(f)
+	}
+}'
+
+# xmlfilecontent definitions, every object queries all the documents
+# with a different XPath
+awk -v n="$((COUNT / 50))" -v head="$OVAL_DEF_HEAD" -v root="$(cd "$DIR/xml" && pwd)" 'BEGIN {
+	print head
+	print "  <definitions>"
+	printf "    <definition id=\"oval:bench:def:1\" version=\"1\" class=\"compliance\">\n"
+	printf "      <metadata><title>XML</title><description>Benchmark definition.</description></metadata>\n"
+	printf "      <criteria operator=\"AND\">\n"
+	for (i = 1; i <= n; i++)
+		printf "        <criterion test_ref=\"oval:bench:tst:%d\"/>\n", i
+	printf "      </criteria>\n"
+	printf "    </definition>\n"
+	print "  </definitions>"
+	print "  <tests>"
+	for (i = 1; i <= n; i++) {
+		printf "    <ind-def:xmlfilecontent_test id=\"oval:bench:tst:%d\" version=\"1\" check=\"all\" comment=\"xmlfilecontent %d\">\n", i, i
+		printf "      <ind-def:object object_ref=\"oval:bench:obj:%d\"/>\n", i
+		printf "    </ind-def:xmlfilecontent_test>\n"
+	}
+	print "  </tests>"
+	print "  <objects>"
+	for (i = 1; i <= n; i++) {
+		printf "    <ind-def:xmlfilecontent_object id=\"oval:bench:obj:%d\" version=\"1\">\n", i
+		printf "      <ind-def:path>%s</ind-def:path>\n", root
+		printf "      <ind-def:filename operation=\"pattern match\">^server[0-9]+\\.xml$</ind-def:filename>\n"
+		printf "      <ind-def:xpath>/Server/Service/Connector[@id=\"c%d\"]/@port</ind-def:xpath>\n", i
+		printf "    </ind-def:xmlfilecontent_object>\n"
+	}
+	print "  </objects>"
+	print "</oval_definitions>"
+}' > "$DIR/xml-oval.xml"
@@ -0,0 +1,60 @@
+#!/usr/bin/env bash
+
+# Copyright 2026 Red Hat Inc., Durham, North Carolina.
+# All Rights Reserved.
+#
+# Traces an evaluation with OSCAP_TRACE_FILE set and checks that the
+# traces of the library and of the probes convert to valid JSON.
+
+set -e -o pipefail
+
+. ../test_common.sh
+
+function test_trace {
+	require "python3" || return 255
+	probecheck "environmentvariable" || return 255
+
+	local ret_val=0
+	local dir=$(mktemp -d -t test_trace.XXXXXX)
+
+	"$srcdir/gen_content.sh" "$dir" 20 2
+
+	pushd "$dir" >/dev/null
+	OSCAP_TRACE_FILE="$dir/trace" $OSCAP xccdf eval xccdf.xml >/dev/null || [ $? -eq 2 ]
+	popd >/dev/null
+
+	# one trace per process: oscap and the environmentvariable probe
+	[ $(ls "$dir"/trace.* | wc -l) -ge 2 ] || ret_val=1
+
+	./trace2json "$dir"/trace.* > "$dir/trace.json" || ret_val=1
+
+	python3 - "$dir/trace.json" <<'EOF' || ret_val=1
+import json, sys
+
+events = json.load(open(sys.argv[1]))["traceEvents"]
+names = set(ev["name"] for ev in events)
+expected = {"oval_load", "probe_query", "probe_eval", "seap_send", "seap_recv"}
+
+if not expected <= names:
+	sys.exit("missing events: %s" % ", ".join(sorted(expected - names)))
+for name in ("oval_load", "probe_query", "probe_eval"):
+	phases = [ev["ph"] for ev in events if ev["name"] == name]
+	if phases.count("B") != phases.count("E"):
+		sys.exit("unbalanced %s spans" % name)
+if len(set(ev["pid"] for ev in events)) < 2:
+	sys.exit("no events of the probe")
+EOF
+
+	# the converter refuses what isn't a trace file
+	./trace2json "$dir/xccdf.xml" > /dev/null && ret_val=1
+
+	rm -rf "$dir"
+
+	return $ret_val
+}
+
+test_init "test_trace.log"
+
+test_run "trace2json" test_trace
+
+test_exit
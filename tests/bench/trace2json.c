@@ -0,0 +1,121 @@
+/*
+ * Copyright 2026 Red Hat Inc., Durham, North Carolina.
+ * All Rights Reserved.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <stdio.h>
+#include <string.h>
+#include <common/trace_priv.h>
+
+/*
+ * Converts trace files written with OSCAP_TRACE_FILE set to the Chrome
+ * trace event format (chrome://tracing, Perfetto).
+ *
+ * Usage: trace2json TRACE... > trace.json
+ *
+ * Traces of the library and of the probes can be passed together,
+ * events are told apart by the process ID.
+ */
+static void json_string(FILE *out, const char *str)
+{
+	fputc('"', out);
+
+	for (; *str != '\0'; ++str) {
+		if (*str == '"' || *str == '\\')
+			fprintf(out, "\\%c", *str);
+		else if ((unsigned char)*str < 0x20)
+			fprintf(out, "\\u%04x", (unsigned char)*str);
+		else
+			fputc(*str, out);
+	}
+
+	fputc('"', out);
+}
+
+static int trace2json(const char *path, FILE *out, int *first)
+{
+	struct oscap_trace_header hdr;
+	struct oscap_trace_event ev;
+	FILE *fp;
+
+	if ((fp = fopen(path, "rb")) == NULL) {
+		perror(path);
+		return (-1);
+	}
+
+	if (fread(&hdr, sizeof hdr, 1, fp) != 1 ||
+	    memcmp(hdr.magic, OSCAP_TRACE_MAGIC, sizeof hdr.magic) != 0 ||
+	    hdr.event_size != sizeof ev) {
+		fprintf(stderr, "%s: not a trace file or an incompatible version\n", path);
+		fclose(fp);
+		return (-1);
+	}
+
+	while (fread(&ev, sizeof ev, 1, fp) == 1) {
+		ev.name[sizeof ev.name - 1] = '\0';
+		ev.arg[sizeof ev.arg - 1] = '\0';
+
+		fprintf(out, "%s\n{\"name\": ", *first ? "" : ",");
+		json_string(out, ev.name);
+		fprintf(out, ", \"ph\": \"%c\", \"ts\": %.3f, \"pid\": %u, \"tid\": %u",
+			ev.phase, ev.ts / 1000.0, ev.pid, ev.tid);
+
+		if (ev.phase == OSCAP_TRACE_INSTANT)
+			fprintf(out, ", \"s\": \"t\"");
+
+		fprintf(out, ", \"args\": {");
+
+		if (ev.arg[0] != '\0') {
+			fprintf(out, "\"id\": ");
+			json_string(out, ev.arg);
+			fprintf(out, ", ");
+		}
+
+		fprintf(out, "\"count\": %llu, \"bytes\": %llu}}",
+			(unsigned long long)ev.count, (unsigned long long)ev.bytes);
+		*first = 0;
+	}
+
+	fclose(fp);
+
+	return (0);
+}
+
+int main(int argc, char *argv[])
+{
+	int i, ret = 0, first = 1;
+
+	if (argc < 2) {
+		fprintf(stderr, "Usage: %s TRACE... > trace.json\n", argv[0]);
+		return (2);
+	}
+
+	printf("{\"traceEvents\": [");
+
+	for (i = 1; i < argc; ++i) {
+		if (trace2json(argv[i], stdout, &first) != 0)
+			ret = 1;
+	}
+
+	printf("\n], \"displayTimeUnit\": \"ms\"}\n");
+
+	return (ret);
+}
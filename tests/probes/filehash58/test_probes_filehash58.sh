@@ -43,10 +43,39 @@ function test_probes_filehash58 {
     return $ret_val
 }
 
+# One object matching five hash types, the probe computes all the digests
+# in one pass over the file.
+function test_probes_filehash58_multi {
+
+    probecheck "filehash58" || return 255
+    for type in 1 224 256 384 512; do
+	require "sha${type}sum" || return 255
+    done
+
+    local DF="test_probes_filehash58_multi.xml"
+    local RF="results_multi.xml"
+    local DIR=$(mktemp -d -t test_probes_filehash58.XXXXXX)
+    local SYSCHAR="/oval_results/results/system/oval_system_characteristics"
+
+    [ -f $RF ] && rm -f $RF
+
+    seq 1 200000 > $DIR/file
+
+    bash ${srcdir}/test_probes_filehash58_multi.xml.sh $DIR file > $DF
+    $OSCAP oval eval --results $RF $DF || return 1
+
+    [ "$($XPATH $RF 'string(/oval_results/results/system/definitions/definition[@definition_id="oval:x:def:1"]/@result)')" == "true" ] || return 1
+    [ "$($XPATH $RF "count($SYSCHAR/collected_objects/object[@id=\"oval:x:obj:1\"]/reference)")" == "5" ] || return 1
+    [ "$($XPATH $RF "count($SYSCHAR/system_data/*[@status=\"error\"])")" == "0" ] || return 1
+
+    rm -rf $DF $RF $DIR
+}
+
 # Testing.
 
 test_init "test_probes_filehash58.log"
 
 test_run "test_probes_filehash58" test_probes_filehash58
+test_run "test_probes_filehash58_multi" test_probes_filehash58_multi
 
 test_exit
@@ -0,0 +1,78 @@
+#!/usr/bin/env bash
+
+# One object matching every SHA hash type, one test with the expected
+# digest for each of them.
+
+FILE_PATH=$1
+FILE_NAME=$2
+
+cat <<EOF2
+<?xml version="1.0" encoding="UTF-8"?>
+<oval_definitions xmlns:oval-def="http://oval.mitre.org/XMLSchema/oval-definitions-5" xmlns:oval="http://oval.mitre.org/XMLSchema/oval-common-5" xmlns:xsi="http://www.w3.org/2001/XMLSchema-instance" xmlns:ind-def="http://oval.mitre.org/XMLSchema/oval-definitions-5#independent" xmlns="http://oval.mitre.org/XMLSchema/oval-definitions-5" xsi:schemaLocation="http://oval.mitre.org/XMLSchema/oval-definitions-5#independent independent-definitions-schema.xsd http://oval.mitre.org/XMLSchema/oval-definitions-5 oval-definitions-schema.xsd http://oval.mitre.org/XMLSchema/oval-common-5 oval-common-schema.xsd">
+  <generator>
+    <oval:schema_version>5.8</oval:schema_version>
+    <oval:timestamp>0001-01-01T00:00:00+00:00</oval:timestamp>
+  </generator>
+
+  <definitions>
+    <definition class="compliance" version="1" id="oval:x:def:1">
+      <metadata>
+        <title>x</title>
+        <description>x</description>
+      </metadata>
+      <criteria operator="AND">
+EOF2
+
+for i in 1 2 3 4 5; do
+	echo "        <criterion test_ref=\"oval:x:tst:$i\"/>"
+done
+
+cat <<EOF2
+      </criteria>
+    </definition>
+  </definitions>
+
+  <tests>
+EOF2
+
+i=1
+for type in SHA-1 SHA-224 SHA-256 SHA-384 SHA-512; do
+	cat <<EOF2
+    <ind-def:filehash58_test id="oval:x:tst:$i" version="1" comment="$type" check_existence="at_least_one_exists" check="at least one">
+      <ind-def:object object_ref="oval:x:obj:1"/>
+      <ind-def:state state_ref="oval:x:ste:$i"/>
+    </ind-def:filehash58_test>
+EOF2
+	i=$((i + 1))
+done
+
+cat <<EOF2
+  </tests>
+
+  <objects>
+    <ind-def:filehash58_object id="oval:x:obj:1" version="1">
+      <ind-def:path>$FILE_PATH</ind-def:path>
+      <ind-def:filename>$FILE_NAME</ind-def:filename>
+      <ind-def:hash_type operation="not equal">MD5</ind-def:hash_type>
+    </ind-def:filehash58_object>
+  </objects>
+
+  <states>
+EOF2
+
+i=1
+for type in SHA-1 SHA-224 SHA-256 SHA-384 SHA-512; do
+	sum=$(sha${type#SHA-}sum "$FILE_PATH/$FILE_NAME" | cut -d' ' -f1)
+	cat <<EOF2
+    <ind-def:filehash58_state id="oval:x:ste:$i" version="1">
+      <ind-def:hash_type>$type</ind-def:hash_type>
+      <ind-def:hash>$sum</ind-def:hash>
+    </ind-def:filehash58_state>
+EOF2
+	i=$((i + 1))
+done
+
+cat <<EOF2
+  </states>
+</oval_definitions>
+EOF2
@@ -43,10 +43,41 @@ function test_probes_rpminfo {
     return $ret_val
 }
 
+# The equals and not equal lookups are answered from the package index,
+# which is built on the first of them.
+function test_probes_rpminfo_index {
+
+    probecheck "rpminfo" || return 255
+    require "rpm" || return 255
+
+    local DF="test_rpminfo_index.xml"
+    local RF="results_index.xml"
+    local SYSCHAR="/oval_results/results/system/oval_system_characteristics/collected_objects"
+
+    [ -f $RF ] && rm -f $RF
+
+    local RPM_A_NAME=`rpm --qf "%{NAME}\n" -qa | sort | uniq -u | sed -n '1p'`
+    local RPM_B_NAME=`rpm --qf "%{NAME}\n" -qa | sort | uniq -u | sed -n '2p'`
+    local RPM_COUNT=`rpm -qa | wc -l`
+
+    bash ${srcdir}/test_rpminfo_index.xml.sh $RPM_A_NAME $RPM_B_NAME > $DF
+    $OSCAP oval eval --results $RF $DF || return 1
+
+    [ "$($XPATH $RF 'string(/oval_results/results/system/definitions/definition[@definition_id="oval:x:def:1"]/@result)')" == "true" ] || return 1
+    [ "$($XPATH $RF "count($SYSCHAR/object[@id=\"oval:x:obj:1\"]/reference)")" == "1" ] || return 1
+    [ "$($XPATH $RF "string($SYSCHAR/object[@id=\"oval:x:obj:2\"]/@flag)")" == "does not exist" ] || return 1
+    [ "$($XPATH $RF "count($SYSCHAR/object[@id=\"oval:x:obj:3\"]/reference)")" == "$((RPM_COUNT - 1))" ] || return 1
+    [ "$($XPATH $RF "count($SYSCHAR/object[@id=\"oval:x:obj:4\"]/reference)")" == "1" ] || return 1
+    [ "$($XPATH $RF "count($SYSCHAR/object[@id=\"oval:x:obj:5\"]/reference)")" == "$RPM_COUNT" ] || return 1
+
+    rm -f $DF $RF
+}
+
 # Testing.
 
 test_init "test_probes_rpminfo.log"
 
 test_run "test_probes_rpminfo" test_probes_rpminfo
+test_run "test_probes_rpminfo_index" test_probes_rpminfo_index
 
 test_exit
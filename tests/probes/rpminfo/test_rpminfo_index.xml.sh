@@ -0,0 +1,66 @@
+#!/usr/bin/env bash
+
+RPM_A_NAME=$1
+RPM_B_NAME=$2
+
+cat <<EOF2
+<?xml version="1.0" encoding="UTF-8"?>
+<oval_definitions xmlns:oval-def="http://oval.mitre.org/XMLSchema/oval-definitions-5" xmlns:oval="http://oval.mitre.org/XMLSchema/oval-common-5" xmlns:xsi="http://www.w3.org/2001/XMLSchema-instance" xmlns:lin-def="http://oval.mitre.org/XMLSchema/oval-definitions-5#linux" xmlns="http://oval.mitre.org/XMLSchema/oval-definitions-5" xsi:schemaLocation="http://oval.mitre.org/XMLSchema/oval-definitions-5#linux linux-definitions-schema.xsd http://oval.mitre.org/XMLSchema/oval-definitions-5 oval-definitions-schema.xsd http://oval.mitre.org/XMLSchema/oval-common-5 oval-common-schema.xsd">
+  <generator>
+    <oval:schema_version>5.10.1</oval:schema_version>
+    <oval:timestamp>0001-01-01T00:00:00+00:00</oval:timestamp>
+  </generator>
+
+  <definitions>
+    <definition class="compliance" version="1" id="oval:x:def:1">
+      <metadata>
+        <title>x</title>
+        <description>x</description>
+      </metadata>
+      <criteria operator="AND">
+        <criterion test_ref="oval:x:tst:1"/>
+        <criterion test_ref="oval:x:tst:2"/>
+        <criterion test_ref="oval:x:tst:3"/>
+        <criterion test_ref="oval:x:tst:4"/>
+        <criterion test_ref="oval:x:tst:5"/>
+      </criteria>
+    </definition>
+  </definitions>
+
+  <tests>
+    <rpminfo_test id="oval:x:tst:1" version="1" comment="first lookup, builds the index" check_existence="only_one_exists" check="all" xmlns="http://oval.mitre.org/XMLSchema/oval-definitions-5#linux">
+      <object object_ref="oval:x:obj:1"/>
+    </rpminfo_test>
+    <rpminfo_test id="oval:x:tst:2" version="1" comment="name missing in the index" check_existence="none_exist" check="all" xmlns="http://oval.mitre.org/XMLSchema/oval-definitions-5#linux">
+      <object object_ref="oval:x:obj:2"/>
+    </rpminfo_test>
+    <rpminfo_test id="oval:x:tst:3" version="1" comment="every package but one" check_existence="at_least_one_exists" check="all" xmlns="http://oval.mitre.org/XMLSchema/oval-definitions-5#linux">
+      <object object_ref="oval:x:obj:3"/>
+    </rpminfo_test>
+    <rpminfo_test id="oval:x:tst:4" version="1" comment="lookup in the built index" check_existence="only_one_exists" check="all" xmlns="http://oval.mitre.org/XMLSchema/oval-definitions-5#linux">
+      <object object_ref="oval:x:obj:4"/>
+    </rpminfo_test>
+    <rpminfo_test id="oval:x:tst:5" version="1" comment="every package" check_existence="at_least_one_exists" check="all" xmlns="http://oval.mitre.org/XMLSchema/oval-definitions-5#linux">
+      <object object_ref="oval:x:obj:5"/>
+    </rpminfo_test>
+  </tests>
+
+  <objects>
+    <rpminfo_object id="oval:x:obj:1" version="1" xmlns="http://oval.mitre.org/XMLSchema/oval-definitions-5#linux">
+      <name>${RPM_A_NAME}</name>
+    </rpminfo_object>
+    <rpminfo_object id="oval:x:obj:2" version="1" xmlns="http://oval.mitre.org/XMLSchema/oval-definitions-5#linux">
+      <name>oscap_missing_package</name>
+    </rpminfo_object>
+    <rpminfo_object id="oval:x:obj:3" version="1" xmlns="http://oval.mitre.org/XMLSchema/oval-definitions-5#linux">
+      <name operation="not equal">${RPM_A_NAME}</name>
+    </rpminfo_object>
+    <rpminfo_object id="oval:x:obj:4" version="1" xmlns="http://oval.mitre.org/XMLSchema/oval-definitions-5#linux">
+      <name>${RPM_B_NAME}</name>
+    </rpminfo_object>
+    <rpminfo_object id="oval:x:obj:5" version="1" xmlns="http://oval.mitre.org/XMLSchema/oval-definitions-5#linux">
+      <name operation="not equal">oscap_missing_package</name>
+    </rpminfo_object>
+  </objects>
+</oval_definitions>
+EOF2
@@ -4,4 +4,6 @@
 
 test_init "test_probes_systemdunitproperty.log"
 test_run "systemdunitproperty general functionality" $srcdir/test_probes_systemdunitproperty.sh
+test_run "systemdunitproperty offline mode" $srcdir/test_probes_systemdunitproperty_offline.sh
+test_run "systemdunitproperty with a mock systemd" $srcdir/test_probes_systemdunitproperty_mock.sh
 test_exit
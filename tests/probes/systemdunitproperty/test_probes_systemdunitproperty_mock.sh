@@ -0,0 +1,76 @@
+#!/usr/bin/env bash
+
+# Copyright 2026 Red Hat Inc., Durham, North Carolina.
+# All Rights Reserved.
+#
+# OpenScap Probes Test Suite.
+#
+# Evaluates the systemd probes against a private dbus-daemon on which
+# test_systemd_mock owns the systemd1 name, so no systemd is needed.
+
+. ../../test_common.sh
+
+function write_bus_config {
+    cat > "$1" <<EOF
+<!DOCTYPE busconfig PUBLIC "-//freedesktop//DTD D-Bus Bus Configuration 1.0//EN"
+ "http://www.freedesktop.org/standards/dbus/1.0/busconfig.dtd">
+<busconfig>
+  <type>system</type>
+  <listen>unix:path=$2</listen>
+  <auth>EXTERNAL</auth>
+  <policy context="default">
+    <allow send_destination="*" eavesdrop="true"/>
+    <allow eavesdrop="true"/>
+    <allow own="*"/>
+    <allow user="*"/>
+  </policy>
+</busconfig>
+EOF
+}
+
+function test_probes_systemdunitproperty_mock {
+    probecheck "systemdunitproperty" || return 255
+    probecheck "systemdunitdependency" || return 255
+    require "dbus-daemon" || return 255
+    [ -x ./test_systemd_mock ] || return 255
+
+    local ret_val=0
+    local DF="${srcdir}/test_probes_systemdunitproperty_mock.xml"
+    local RF="results_mock.xml"
+    local DIR=$(mktemp -d -t systemd_mock.XXXXXX)
+    local BUS_PID MOCK_PID LINE
+
+    [ -f $RF ] && rm -f $RF
+
+    write_bus_config "$DIR/bus.conf" "$DIR/bus"
+
+    if ! BUS_PID=$(dbus-daemon --config-file="$DIR/bus.conf" --fork --print-pid); then
+        rm -rf "$DIR"
+        return 1
+    fi
+
+    mkfifo "$DIR/ready"
+    DBUS_SYSTEM_BUS_ADDRESS="unix:path=$DIR/bus" ./test_systemd_mock > "$DIR/ready" &
+    MOCK_PID=$!
+
+    if read -t 10 LINE < "$DIR/ready" && [ "$LINE" == "ready" ]; then
+        DBUS_SYSTEM_BUS_ADDRESS="unix:path=$DIR/bus" $OSCAP oval eval --results $RF $DF
+
+        if [ -f $RF ]; then
+            verify_results "def" $DF $RF 2 && verify_results "tst" $DF $RF 7
+            ret_val=$?
+        else
+            ret_val=1
+        fi
+    else
+        ret_val=1
+    fi
+
+    kill $MOCK_PID $BUS_PID 2>/dev/null
+    wait $MOCK_PID 2>/dev/null
+    rm -rf "$DIR"
+
+    return $ret_val
+}
+
+test_probes_systemdunitproperty_mock
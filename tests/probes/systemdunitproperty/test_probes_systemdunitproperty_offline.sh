@@ -0,0 +1,167 @@
+#!/usr/bin/env bash
+
+# Copyright 2026 Red Hat Inc., Durham, North Carolina.
+# All Rights Reserved.
+#
+# OpenScap Probes Test Suite.
+#
+# Evaluates the unit files of a fixture tree in the offline mode.
+# The probe has to chroot to the tree, so that runs only as root;
+# otherwise test_systemd_offline resolves the tree without chroot.
+
+. ../../test_common.sh
+
+function make_fixture {
+    local ROOT="$1"
+    local U="$ROOT/usr/lib/systemd/system"
+    local E="$ROOT/etc/systemd/system"
+
+    mkdir -p "$U/multi-user.target.wants" "$E/multi-user.target.wants" \
+             "$E/getty.target.wants" "$E/sshd.service.d" \
+             "$ROOT/usr/lib/systemd/system-preset"
+
+    cat > "$U/multi-user.target" <<EOF
+[Unit]
+Description=Multi-User System
+Requires=basic.target
+After=basic.target
+AllowIsolate=yes
+EOF
+    cat > "$U/basic.target" <<EOF
+[Unit]
+Description=Basic System
+Requires=sysinit.target
+After=sysinit.target
+EOF
+    cat > "$U/sysinit.target" <<EOF
+[Unit]
+Description=System Initialization
+DefaultDependencies=no
+EOF
+    cat > "$U/getty.target" <<EOF
+[Unit]
+Description=Login Prompts
+EOF
+    cat > "$U/sshd.service" <<EOF
+# comment
+[Unit]
+Description=OpenSSH server daemon
+Documentation=man:sshd(8) \\
+  man:sshd_config(5)
+After=network.target
+
+[Service]
+ExecStart=/usr/sbin/sshd -D
+
+[Install]
+WantedBy=multi-user.target
+EOF
+    cat > "$U/crond.service" <<EOF
+[Unit]
+Description=Command Scheduler
+
+[Install]
+WantedBy=multi-user.target
+EOF
+    cat > "$U/getty@.service" <<EOF
+[Unit]
+Description=Getty on %i
+Before=getty.target
+
+[Install]
+WantedBy=getty.target
+EOF
+    cat > "$U/dbus.service" <<EOF
+[Unit]
+Description=D-Bus System Message Bus
+DefaultDependencies=false
+EOF
+    ln -s dbus.service "$U/messagebus.service"
+    ln -s ../getty.target "$U/multi-user.target.wants/getty.target"
+
+    ln -s /usr/lib/systemd/system/sshd.service "$E/multi-user.target.wants/sshd.service"
+    ln -s /usr/lib/systemd/system/getty@.service "$E/getty.target.wants/getty@tty1.service"
+    ln -s /dev/null "$E/ctrl-alt-del.target"
+
+    cat > "$E/sshd.service.d/override.conf" <<EOF
+[Unit]
+After=
+After=network-online.target
+EOF
+    cat > "$ROOT/usr/lib/systemd/system-preset/90-default.preset" <<EOF
+enable sshd.service
+disable *
+EOF
+}
+
+# Usage: assert_property ROOT UNIT PROPERTY VALUE
+# The property of the unit resolved from the tree has to include the value.
+function assert_property {
+    if ! ./test_systemd_offline "$1" "$2" "$3" | grep -qxF "$4"; then
+        echo "$2 $3 does not include '$4'"
+        return 1
+    fi
+    return 0
+}
+
+function test_systemd_offline_resolver {
+    local ROOT="$1"
+    local ret_val=0
+
+    assert_property "$ROOT" sshd.service UnitFileState enabled || ret_val=1
+    assert_property "$ROOT" crond.service UnitFileState disabled || ret_val=1
+    assert_property "$ROOT" ctrl-alt-del.target LoadState masked || ret_val=1
+    assert_property "$ROOT" sshd.service After network-online.target || ret_val=1
+    assert_property "$ROOT" getty@tty1.service Description "Getty on tty1" || ret_val=1
+    assert_property "$ROOT" crond.service UnitFilePreset disabled || ret_val=1
+    assert_property "$ROOT" multi-user.target Wants getty.target || ret_val=1
+    assert_property "$ROOT" dbus.service Names messagebus.service || ret_val=1
+    assert_property "$ROOT" sysinit.target RequiredBy sshd.service || ret_val=1
+
+    # reset by the drop-in
+    if assert_property "$ROOT" sshd.service After network.target > /dev/null; then
+        echo "sshd.service After still includes 'network.target'"
+        ret_val=1
+    fi
+
+    return $ret_val
+}
+
+function test_probes_systemdunitproperty_offline {
+    probecheck "systemdunitproperty" || return 255
+
+    local ret_val=0
+    local DF="${srcdir}/test_probes_systemdunitproperty_offline.xml"
+    local RF="results_offline.xml"
+    local ROOT=$(mktemp -d -t systemd_offline.XXXXXX)
+
+    [ -f $RF ] && rm -f $RF
+
+    make_fixture "$ROOT"
+
+    if [ "$(id -u)" -eq 0 ]; then
+        # system_info reports these in the offline mode
+        OSCAP_PROBE_ROOT="$ROOT" \
+        OSCAP_PROBE_OS_NAME="Linux" OSCAP_PROBE_OS_VERSION="fixture" \
+        OSCAP_PROBE_ARCHITECTURE="$(uname -m)" OSCAP_PROBE_PRIMARY_HOST_NAME="fixture" \
+        $OSCAP oval eval --results $RF $DF
+
+        if [ -f $RF ]; then
+            verify_results "def" $DF $RF 2 && verify_results "tst" $DF $RF 10
+            ret_val=$?
+        else
+            ret_val=1
+        fi
+    elif [ -x ./test_systemd_offline ]; then
+        test_systemd_offline_resolver "$ROOT"
+        ret_val=$?
+    else
+        ret_val=255
+    fi
+
+    rm -rf "$ROOT"
+
+    return $ret_val
+}
+
+test_probes_systemdunitproperty_offline
@@ -0,0 +1,242 @@
+/*
+ * Copyright 2026 Red Hat Inc., Durham, North Carolina.
+ * All Rights Reserved.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <dbus/dbus.h>
+
+/*
+ * A minimal systemd manager on the bus given by DBUS_SYSTEM_BUS_ADDRESS.
+ * It answers ListUnits, LoadUnit and GetAll of the units below, just the
+ * calls made by the systemd probes. Prints "ready" once the name is owned
+ * and exits when the bus goes away.
+ *
+ * Usage: test_systemd_mock
+ */
+
+#define SYSTEMD_NAME "org.freedesktop.systemd1"
+#define SYSTEMD_PATH "/org/freedesktop/systemd1"
+#define MANAGER_IFACE "org.freedesktop.systemd1.Manager"
+#define PROPERTIES_IFACE "org.freedesktop.DBus.Properties"
+
+struct mock_unit {
+	const char *name;
+	const char *path;
+	const char *description;
+	const char *active_state;
+	const char *sub_state;
+	const char *requires[4];
+	const char *wants[4];
+	const char *after[4];
+};
+
+static const struct mock_unit mock_units[] = {
+	{ "multi-user.target", SYSTEMD_PATH "/unit/multi_2duser_2etarget", "Multi-User System",
+	  "active", "active", { "basic.target", NULL }, { "sshd.service", "crond.service", NULL }, { "basic.target", NULL } },
+	{ "basic.target", SYSTEMD_PATH "/unit/basic_2etarget", "Basic System",
+	  "active", "active", { "sysinit.target", NULL }, { NULL }, { "sysinit.target", NULL } },
+	{ "sysinit.target", SYSTEMD_PATH "/unit/sysinit_2etarget", "System Initialization",
+	  "active", "active", { NULL }, { NULL }, { NULL } },
+	{ "sshd.service", SYSTEMD_PATH "/unit/sshd_2eservice", "OpenSSH server daemon",
+	  "active", "running", { "basic.target", NULL }, { NULL }, { "network.target", "basic.target", NULL } },
+	{ "crond.service", SYSTEMD_PATH "/unit/crond_2eservice", "Command Scheduler",
+	  "inactive", "dead", { NULL }, { NULL }, { "basic.target", NULL } }
+};
+
+#define MOCK_UNIT_COUNT (sizeof mock_units / sizeof mock_units[0])
+
+static const struct mock_unit *mock_unit_by_name(const char *name)
+{
+	size_t i;
+
+	for (i = 0; i < MOCK_UNIT_COUNT; ++i)
+		if (strcmp(mock_units[i].name, name) == 0)
+			return &mock_units[i];
+	return NULL;
+}
+
+static const struct mock_unit *mock_unit_by_path(const char *path)
+{
+	size_t i;
+
+	for (i = 0; i < MOCK_UNIT_COUNT; ++i)
+		if (strcmp(mock_units[i].path, path) == 0)
+			return &mock_units[i];
+	return NULL;
+}
+
+static DBusMessage *list_units(DBusMessage *call)
+{
+	DBusMessage *reply = dbus_message_new_method_return(call);
+	DBusMessageIter args, array, unit;
+	const char *loaded = "loaded", *empty = "", *root = "/";
+	dbus_uint32_t job = 0;
+	size_t i;
+
+	dbus_message_iter_init_append(reply, &args);
+	dbus_message_iter_open_container(&args, DBUS_TYPE_ARRAY, "(ssssssouso)", &array);
+
+	for (i = 0; i < MOCK_UNIT_COUNT; ++i) {
+		dbus_message_iter_open_container(&array, DBUS_TYPE_STRUCT, NULL, &unit);
+		dbus_message_iter_append_basic(&unit, DBUS_TYPE_STRING, &mock_units[i].name);
+		dbus_message_iter_append_basic(&unit, DBUS_TYPE_STRING, &mock_units[i].description);
+		dbus_message_iter_append_basic(&unit, DBUS_TYPE_STRING, &loaded);
+		dbus_message_iter_append_basic(&unit, DBUS_TYPE_STRING, &mock_units[i].active_state);
+		dbus_message_iter_append_basic(&unit, DBUS_TYPE_STRING, &mock_units[i].sub_state);
+		dbus_message_iter_append_basic(&unit, DBUS_TYPE_STRING, &empty);
+		dbus_message_iter_append_basic(&unit, DBUS_TYPE_OBJECT_PATH, &mock_units[i].path);
+		dbus_message_iter_append_basic(&unit, DBUS_TYPE_UINT32, &job);
+		dbus_message_iter_append_basic(&unit, DBUS_TYPE_STRING, &empty);
+		dbus_message_iter_append_basic(&unit, DBUS_TYPE_OBJECT_PATH, &root);
+		dbus_message_iter_close_container(&array, &unit);
+	}
+
+	dbus_message_iter_close_container(&args, &array);
+	return reply;
+}
+
+static DBusMessage *load_unit(DBusMessage *call)
+{
+	const struct mock_unit *unit;
+	const char *name = NULL;
+	DBusMessage *reply;
+
+	if (!dbus_message_get_args(call, NULL, DBUS_TYPE_STRING, &name, DBUS_TYPE_INVALID) ||
+	    (unit = mock_unit_by_name(name)) == NULL)
+		return dbus_message_new_error(call, "org.freedesktop.systemd1.NoSuchUnit", name);
+
+	reply = dbus_message_new_method_return(call);
+	dbus_message_append_args(reply, DBUS_TYPE_OBJECT_PATH, &unit->path, DBUS_TYPE_INVALID);
+	return reply;
+}
+
+static void append_string(DBusMessageIter *dict, const char *name, const char *value)
+{
+	DBusMessageIter entry, variant;
+
+	dbus_message_iter_open_container(dict, DBUS_TYPE_DICT_ENTRY, NULL, &entry);
+	dbus_message_iter_append_basic(&entry, DBUS_TYPE_STRING, &name);
+	dbus_message_iter_open_container(&entry, DBUS_TYPE_VARIANT, "s", &variant);
+	dbus_message_iter_append_basic(&variant, DBUS_TYPE_STRING, &value);
+	dbus_message_iter_close_container(&entry, &variant);
+	dbus_message_iter_close_container(dict, &entry);
+}
+
+static void append_strings(DBusMessageIter *dict, const char *name, const char *const *values)
+{
+	DBusMessageIter entry, variant, array;
+
+	dbus_message_iter_open_container(dict, DBUS_TYPE_DICT_ENTRY, NULL, &entry);
+	dbus_message_iter_append_basic(&entry, DBUS_TYPE_STRING, &name);
+	dbus_message_iter_open_container(&entry, DBUS_TYPE_VARIANT, "as", &variant);
+	dbus_message_iter_open_container(&variant, DBUS_TYPE_ARRAY, "s", &array);
+	for (; *values != NULL; ++values)
+		dbus_message_iter_append_basic(&array, DBUS_TYPE_STRING, values);
+	dbus_message_iter_close_container(&variant, &array);
+	dbus_message_iter_close_container(&entry, &variant);
+	dbus_message_iter_close_container(dict, &entry);
+}
+
+static void append_bool(DBusMessageIter *dict, const char *name, dbus_bool_t value)
+{
+	DBusMessageIter entry, variant;
+
+	dbus_message_iter_open_container(dict, DBUS_TYPE_DICT_ENTRY, NULL, &entry);
+	dbus_message_iter_append_basic(&entry, DBUS_TYPE_STRING, &name);
+	dbus_message_iter_open_container(&entry, DBUS_TYPE_VARIANT, "b", &variant);
+	dbus_message_iter_append_basic(&variant, DBUS_TYPE_BOOLEAN, &value);
+	dbus_message_iter_close_container(&entry, &variant);
+	dbus_message_iter_close_container(dict, &entry);
+}
+
+static DBusMessage *get_all(DBusMessage *call)
+{
+	const struct mock_unit *unit;
+	DBusMessage *reply;
+	DBusMessageIter args, dict;
+
+	if ((unit = mock_unit_by_path(dbus_message_get_path(call))) == NULL)
+		return dbus_message_new_error(call, DBUS_ERROR_UNKNOWN_OBJECT, dbus_message_get_path(call));
+
+	reply = dbus_message_new_method_return(call);
+	dbus_message_iter_init_append(reply, &args);
+	dbus_message_iter_open_container(&args, DBUS_TYPE_ARRAY, "{sv}", &dict);
+	append_string(&dict, "Id", unit->name);
+	append_string(&dict, "Description", unit->description);
+	append_string(&dict, "LoadState", "loaded");
+	append_string(&dict, "ActiveState", unit->active_state);
+	append_string(&dict, "SubState", unit->sub_state);
+	append_strings(&dict, "Requires", unit->requires);
+	append_strings(&dict, "Wants", unit->wants);
+	append_strings(&dict, "After", unit->after);
+	append_bool(&dict, "CanStart", TRUE);
+	dbus_message_iter_close_container(&args, &dict);
+	return reply;
+}
+
+int main(int argc, char *argv[])
+{
+	DBusConnection *conn;
+	DBusMessage *call, *reply;
+	DBusError err;
+
+	dbus_error_init(&err);
+
+	if ((conn = dbus_bus_get(DBUS_BUS_SYSTEM, &err)) == NULL) {
+		fprintf(stderr, "Cannot connect to the bus: %s\n", err.message);
+		return 1;
+	}
+
+	if (dbus_bus_request_name(conn, SYSTEMD_NAME, DBUS_NAME_FLAG_DO_NOT_QUEUE, &err) !=
+	    DBUS_REQUEST_NAME_REPLY_PRIMARY_OWNER) {
+		fprintf(stderr, "Cannot own %s: %s\n", SYSTEMD_NAME, dbus_error_is_set(&err) ? err.message : "in use");
+		return 1;
+	}
+
+	printf("ready\n");
+	fflush(stdout);
+
+	while (dbus_connection_read_write(conn, -1)) {
+		while ((call = dbus_connection_pop_message(conn)) != NULL) {
+			reply = NULL;
+
+			if (dbus_message_is_method_call(call, MANAGER_IFACE, "ListUnits"))
+				reply = list_units(call);
+			else if (dbus_message_is_method_call(call, MANAGER_IFACE, "LoadUnit"))
+				reply = load_unit(call);
+			else if (dbus_message_is_method_call(call, PROPERTIES_IFACE, "GetAll"))
+				reply = get_all(call);
+			else if (dbus_message_get_type(call) == DBUS_MESSAGE_TYPE_METHOD_CALL)
+				reply = dbus_message_new_error(call, DBUS_ERROR_UNKNOWN_METHOD, dbus_message_get_member(call));
+
+			if (reply != NULL) {
+				dbus_connection_send(conn, reply, NULL);
+				dbus_message_unref(reply);
+			}
+			dbus_message_unref(call);
+		}
+	}
+
+	return 0;
+}
@@ -0,0 +1,66 @@
+/*
+ * Copyright 2026 Red Hat Inc., Durham, North Carolina.
+ * All Rights Reserved.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include "../../../src/OVAL/probes/unix/linux/systemdoffline.c"
+
+/*
+ * Resolve the unit files below a root directory the way the systemd
+ * probes do in offline mode, but without chrooting to it, and print the
+ * values of one property of one unit, one per line.
+ *
+ * Usage: test_systemd_offline <root> <unit> <property>
+ */
+int main(int argc, char *argv[])
+{
+	struct systemd_snapshot *snap;
+	struct systemd_unit *unit;
+	struct systemd_property *prop;
+	size_t i;
+	int ret = 0;
+
+	if (argc != 4) {
+		fprintf(stderr, "Usage: %s <root> <unit> <property>\n", argv[0]);
+		return (1);
+	}
+
+	snap = systemd_snapshot_new();
+	snap->offline = true;
+
+	if (systemd_offline_take(snap, argv[1]) != 0) {
+		fprintf(stderr, "Cannot resolve the units.\n");
+		ret = 2;
+	} else if ((unit = systemd_snapshot_get(snap, argv[2])) == NULL) {
+		fprintf(stderr, "Unit not found.\n");
+		ret = 3;
+	} else if ((prop = systemd_unit_property(unit, argv[3])) == NULL) {
+		fprintf(stderr, "Property not found.\n");
+		ret = 4;
+	} else {
+		for (i = 0; i < prop->count; ++i)
+			printf("%s\n", prop->values[i] != NULL ? prop->values[i] : "");
+	}
+
+	systemd_snapshot_free(snap);
+
+	return (ret);
+}
@@ -0,0 +1,7 @@
+#!/bin/bash
+
+. ../../test_common.sh
+
+test_init "test_probes_xmlfilecontent.log"
+test_run "xmlfilecontent general functionality" $srcdir/test_probes_xmlfilecontent.sh
+test_exit
@@ -0,0 +1,45 @@
+#!/usr/bin/env bash
+
+# Copyright 2026 Red Hat Inc., Durham, North Carolina.
+# All Rights Reserved.
+#
+# OpenScap Probes Test Suite.
+
+. ../../test_common.sh
+
+function test_probes_xmlfilecontent {
+
+    probecheck "xmlfilecontent" || return 255
+
+    local ret_val=0;
+    local DF="${srcdir}/test_probes_xmlfilecontent.xml"
+    local RF="results.xml"
+    local FILE="/tmp/test_probes_xmlfilecontent.xml"
+
+    [ -f $RF ] && rm -f $RF
+
+    cat > "$FILE" <<XML
+<?xml version="1.0"?>
+<Server port="8005" shutdown="SHUTDOWN">
+  <Service name="Catalina">
+    <Connector port="8080" protocol="HTTP/1.1"/>
+    <Connector port="8009" protocol="AJP/1.3"/>
+  </Service>
+</Server>
+XML
+
+    $OSCAP oval eval --results $RF $DF
+
+    if [ -f $RF ]; then
+	verify_results "def" $DF $RF 2 && verify_results "tst" $DF $RF 5
+	ret_val=$?
+    else
+	ret_val=1
+    fi
+
+    rm -f "$FILE"
+
+    return $ret_val
+}
+
+test_probes_xmlfilecontent
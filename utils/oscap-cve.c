@@ -40,6 +40,7 @@
 static bool getopt_cve(int argc, char **argv, struct oscap_action *action);
 static int app_cve_validate(const struct oscap_action *action);
 static int app_cve_find(const struct oscap_action *action);
+static int app_cve_index(const struct oscap_action *action);
 
 static struct oscap_module* CVE_SUBMODULES[];
 
@@ -64,15 +65,29 @@ static struct oscap_module CVE_FIND_MODULE = {
     .name = "find",
     .parent = &OSCAP_CVE_MODULE,
     .summary = "Find particular CVE in CVE NVD feed",
-    .usage = "CVE nvd-feed.xml",
-    .help = "Find particular CVE in CVE NVD feed.",
+    .usage = "[options] CVE nvd-feed.xml",
+    .help = "Find particular CVE in CVE NVD feed.\n"
+            "\n"
+            "Options:\n"
+            "   --index <file>\r\t\t\t\t - Use index created by 'oscap cve index' to locate the CVE.\n",
     .opt_parser = getopt_cve,
     .func = app_cve_find
 };
 
+static struct oscap_module CVE_INDEX_MODULE = {
+    .name = "index",
+    .parent = &OSCAP_CVE_MODULE,
+    .summary = "Create index of CVE NVD feed",
+    .usage = "nvd-feed.xml index-file",
+    .help = "Create index of CVE NVD feed which speeds up subsequent look-ups.",
+    .opt_parser = getopt_cve,
+    .func = app_cve_index
+};
+
 static struct oscap_module* CVE_SUBMODULES[] = {
     &CVE_VALIDATE_MODULE,
     &CVE_FIND_MODULE,
+    &CVE_INDEX_MODULE,
     NULL
 };
 
@@ -102,11 +117,28 @@ cleanup:
         return result;
 }
 
+struct cve_find_ctx {
+	const char *id;
+	struct cve_entry *entry;
+};
+
+static int _cve_find_cb(struct cve_entry *entry, void *user)
+{
+	struct cve_find_ctx *ctx = (struct cve_find_ctx *) user;
+
+	if (strcmp(cve_entry_get_id(entry), ctx->id) != 0) {
+		cve_entry_free(entry);
+		return 0;
+	}
+
+	ctx->entry = entry;
+	return 1;
+}
+
 static int app_cve_find(const struct oscap_action *action)
 {
-        struct cve_model *model = NULL;
+        struct cve_index *index = NULL;
         struct cve_entry *entry = NULL;
-	struct cve_entry_iterator *entry_it;
 	const struct cvss_impact *cvss;
         struct cvss_metrics *metrics;
         float base_score;
@@ -115,21 +147,23 @@ static int app_cve_find(const struct oscap_action *action)
 	struct cve_product_iterator *prod_it;
 	struct cve_product *product;
 
-	model = cve_model_import(action->cve_action->file);
-	if(!model) {
-		result=OSCAP_ERROR;
-		goto cleanup;
+	if (action->cve_action->index) {
+		index = cve_index_load(action->cve_action->index, action->cve_action->file);
+		if (!index) {
+			result=OSCAP_ERROR;
+			goto cleanup;
+		}
+		entry = cve_index_find_entry(index, action->cve_action->cve);
+	} else {
+		/* stream the feed and stop at the first matching entry */
+		struct cve_find_ctx ctx = { .id = action->cve_action->cve, .entry = NULL };
+		if (cve_model_import_stream(action->cve_action->file, _cve_find_cb, &ctx) == -1) {
+			result=OSCAP_ERROR;
+			goto cleanup;
+		}
+		entry = ctx.entry;
 	}
 
-	entry_it = cve_model_get_entries(model);
-	while (cve_entry_iterator_has_more(entry_it)) {
-		entry = cve_entry_iterator_next(entry_it);
-		if (!strcmp(cve_entry_get_id(entry), action->cve_action->cve))
-			break;
-		entry = NULL;
-	}
-	cve_entry_iterator_free(entry_it);
-
 	if (!entry) {
 		result=OSCAP_FAIL;
 		goto cleanup;
@@ -163,8 +197,26 @@ cleanup:
         if (oscap_err())
                 fprintf(stderr, "%s %s\n", OSCAP_ERR_MSG, oscap_err_desc());
 
-        if (model)
-		cve_model_free(model);
+        if (entry)
+		cve_entry_free(entry);
+        if (index)
+		cve_index_free(index);
+        free(action->cve_action);
+        return result;
+}
+
+static int app_cve_index(const struct oscap_action *action)
+{
+	int result;
+
+	if (cve_index_build(action->cve_action->file, action->cve_action->index) == 0)
+		result=OSCAP_OK;
+	else
+		result=OSCAP_ERROR;
+
+        if (oscap_err())
+                fprintf(stderr, "%s %s\n", OSCAP_ERR_MSG, oscap_err_desc());
+
         free(action->cve_action);
         return result;
 }
@@ -179,16 +231,42 @@ bool getopt_cve(int argc, char **argv, struct oscap_action *action)
                 action->doctype = OSCAP_DOCUMENT_CVE_FEED;
                 action->cve_action = malloc(sizeof(struct cve_action));
                 action->cve_action->file=argv[3];
+                action->cve_action->index=NULL;
         }
 	else if (action->module == &CVE_FIND_MODULE) {
+		char *index = NULL;
+		struct option long_options[] = {
+			{ "index", required_argument, NULL, 'i' },
+			{ 0, 0, 0, 0 }
+		};
+
+		int c;
+		while ((c = getopt_long(argc, argv, "", long_options, NULL)) != -1) {
+			switch (c) {
+			case 'i': index = optarg; break;
+			default: return oscap_module_usage(action->module, stderr, NULL);
+			}
+		}
+
+	        if( argc - optind != 2 ) {
+                        oscap_module_usage(action->module, stderr, "Wrong number of parameters.\n");
+                        return false;
+                }
+		action->doctype = OSCAP_DOCUMENT_CVE_FEED;
+		action->cve_action = malloc(sizeof(struct cve_action));
+		action->cve_action->cve=argv[optind];
+		action->cve_action->file=argv[optind + 1];
+		action->cve_action->index=index;
+	}
+	else if (action->module == &CVE_INDEX_MODULE) {
 	        if( argc != 5 ) {
                         oscap_module_usage(action->module, stderr, "Wrong number of parameters.\n");
                         return false;
                 }
 		action->doctype = OSCAP_DOCUMENT_CVE_FEED;
 		action->cve_action = malloc(sizeof(struct cve_action));
-		action->cve_action->cve=argv[3];
-		action->cve_action->file=argv[4];
+		action->cve_action->file=argv[3];
+		action->cve_action->index=argv[4];
 	}
 
 	return true;
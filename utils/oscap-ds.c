@@ -25,6 +25,7 @@
 #include <stdlib.h>
 #include <string.h>
 #include <getopt.h>
+#include <inttypes.h>
 #include <unistd.h>
 
 #ifndef PATH_MAX
@@ -36,6 +37,7 @@
 #include <oscap_source.h>
 #include <ds_rds_session.h>
 #include <ds_sds_session.h>
+#include <ds_rds_store.h>
 
 #include "oscap-tool.h"
 
@@ -45,9 +47,14 @@ int app_ds_sds_split(const struct oscap_action *action);
 int app_ds_sds_compose(const struct oscap_action *action);
 int app_ds_sds_add(const struct oscap_action *action);
 int app_ds_sds_validate(const struct oscap_action *action);
+int app_ds_sds_image(const struct oscap_action *action);
 int app_ds_rds_split(const struct oscap_action *action);
 int app_ds_rds_create(const struct oscap_action *action);
 int app_ds_rds_validate(const struct oscap_action *action);
+int app_ds_rds_store_import(const struct oscap_action *action);
+int app_ds_rds_store_export(const struct oscap_action *action);
+int app_ds_rds_store_list(const struct oscap_action *action);
+int app_ds_rds_store_info(const struct oscap_action *action);
 
 struct oscap_module OSCAP_DS_MODULE = {
 	.name = "ds",
@@ -106,6 +113,24 @@ static struct oscap_module DS_SDS_VALIDATE_MODULE = {
 	.func = app_ds_sds_validate
 };
 
+static struct oscap_module DS_SDS_IMAGE_MODULE = {
+	.name = "sds-image",
+	.parent = &OSCAP_DS_MODULE,
+	.summary = "Extract a checklist from given SourceDataStream into an image for faster loading",
+	.usage = "[options] SDS TARGET_IMAGE",
+	.help =
+		"SDS - Source data stream to extract the checklist from.\n"
+		"TARGET_IMAGE - Path of the resulting image, it can be passed to 'oscap xccdf eval' instead of the SDS.\n"
+		"\n"
+		"Options:\n"
+		"   --datastream-id <id> \r\t\t\t\t - ID of the datastream in the collection to use.\n"
+		"   --xccdf-id <id> \r\t\t\t\t - ID of XCCDF in the datastream that should be evaluated.\n"
+		"   --benchmark-id <id> \r\t\t\t\t - ID of XCCDF Benchmark in some component in the datastream that should be evaluated.\n"
+		"   --skip-valid \r\t\t\t\t - Skips validating of given SDS.\n",
+	.opt_parser = getopt_ds,
+	.func = app_ds_sds_image
+};
+
 static struct oscap_module DS_RDS_SPLIT_MODULE = {
 	.name = "rds-split",
 	.parent = &OSCAP_DS_MODULE,
@@ -139,14 +164,65 @@ static struct oscap_module DS_RDS_VALIDATE_MODULE = {
 	.func = app_ds_rds_validate
 };
 
+static struct oscap_module DS_RDS_STORE_IMPORT_MODULE = {
+	.name = "rds-store-import",
+	.parent = &OSCAP_DS_MODULE,
+	.summary = "Import ResultDataStreams into a results store, deduplicating the content they share",
+	.usage = "STORE arf.xml [arf.xml ...]",
+	.help =
+		"STORE - Directory of the store, it is created if it doesn't exist.\n"
+		"\n"
+		"The ID of each imported ResultDataStream is printed.\n",
+	.opt_parser = getopt_ds,
+	.func = app_ds_rds_store_import
+};
+
+static struct oscap_module DS_RDS_STORE_EXPORT_MODULE = {
+	.name = "rds-store-export",
+	.parent = &OSCAP_DS_MODULE,
+	.summary = "Export a ResultDataStream from a results store, exactly as it was imported",
+	.usage = "STORE ARF_ID target-arf.xml",
+	.help = NULL,
+	.opt_parser = getopt_ds,
+	.func = app_ds_rds_store_export
+};
+
+static struct oscap_module DS_RDS_STORE_LIST_MODULE = {
+	.name = "rds-store-list",
+	.parent = &OSCAP_DS_MODULE,
+	.summary = "List ResultDataStreams of a results store with their hosts and profiles",
+	.usage = "[options] STORE",
+	.help =	"Options:\n"
+		"   --host <name> \r\t\t\t\t - List only results of the host with given hostname or FQDN.\n"
+		"   --profile <id> \r\t\t\t\t - List only results of given XCCDF profile.\n"
+		"   --rule <id> \r\t\t\t\t - List only results with a result of given rule and print the result.\n",
+	.opt_parser = getopt_ds,
+	.func = app_ds_rds_store_list
+};
+
+static struct oscap_module DS_RDS_STORE_INFO_MODULE = {
+	.name = "rds-store-info",
+	.parent = &OSCAP_DS_MODULE,
+	.summary = "Print the number and size of ResultDataStreams in a results store and the size of their blobs",
+	.usage = "STORE",
+	.help = NULL,
+	.opt_parser = getopt_ds,
+	.func = app_ds_rds_store_info
+};
+
 static struct oscap_module* DS_SUBMODULES[] = {
 	&DS_SDS_SPLIT_MODULE,
 	&DS_SDS_COMPOSE_MODULE,
 	&DS_SDS_ADD_MODULE,
 	&DS_SDS_VALIDATE_MODULE,
+	&DS_SDS_IMAGE_MODULE,
 	&DS_RDS_SPLIT_MODULE,
 	&DS_RDS_CREATE_MODULE,
 	&DS_RDS_VALIDATE_MODULE,
+	&DS_RDS_STORE_IMPORT_MODULE,
+	&DS_RDS_STORE_EXPORT_MODULE,
+	&DS_RDS_STORE_LIST_MODULE,
+	&DS_RDS_STORE_INFO_MODULE,
 	NULL
 };
 
@@ -154,6 +230,10 @@ enum ds_opt {
 	DS_OPT_DATASTREAM_ID = 1,
 	DS_OPT_XCCDF_ID,
 	DS_OPT_REPORT_ID,
+	DS_OPT_BENCHMARK_ID,
+	DS_OPT_HOST,
+	DS_OPT_PROFILE,
+	DS_OPT_RULE,
 };
 
 bool getopt_ds(int argc, char **argv, struct oscap_action *action) {
@@ -166,10 +246,15 @@ bool getopt_ds(int argc, char **argv, struct oscap_action *action) {
 		{"datastream-id",		required_argument, NULL, DS_OPT_DATASTREAM_ID},
 		{"xccdf-id",		required_argument, NULL, DS_OPT_XCCDF_ID},
 		{"report-id",		required_argument, NULL, DS_OPT_REPORT_ID},
+		{"benchmark-id",	required_argument, NULL, DS_OPT_BENCHMARK_ID},
+		{"host",		required_argument, NULL, DS_OPT_HOST},
+		{"profile",		required_argument, NULL, DS_OPT_PROFILE},
+		{"rule",		required_argument, NULL, DS_OPT_RULE},
 	// end
 		{0, 0, 0, 0}
 	};
 
+	char *host = NULL, *profile = NULL, *rule = NULL;
 	int c;
 	while ((c = getopt_long(argc, argv, "o:i:", long_options, NULL)) != -1) {
 
@@ -177,6 +262,10 @@ bool getopt_ds(int argc, char **argv, struct oscap_action *action) {
 		case DS_OPT_DATASTREAM_ID:	action->f_datastream_id = optarg;	break;
 		case DS_OPT_XCCDF_ID:	action->f_xccdf_id = optarg; break;
 		case DS_OPT_REPORT_ID:	action->f_report_id = optarg; break;
+		case DS_OPT_BENCHMARK_ID:	action->f_benchmark_id = optarg; break;
+		case DS_OPT_HOST:	host = optarg; break;
+		case DS_OPT_PROFILE:	profile = optarg; break;
+		case DS_OPT_RULE:	rule = optarg; break;
 		case 0: break;
 		default: return oscap_module_usage(action->module, stderr, NULL);
 		}
@@ -217,6 +306,15 @@ bool getopt_ds(int argc, char **argv, struct oscap_action *action) {
 		action->ds_action = malloc(sizeof(struct ds_action));
 		action->ds_action->file = argv[3];
 	}
+	else if (action->module == &DS_SDS_IMAGE_MODULE) {
+		if (optind + 2 != argc) {
+			oscap_module_usage(action->module, stderr, "Wrong number of parameters.\n");
+			return false;
+		}
+		action->ds_action = malloc(sizeof(struct ds_action));
+		action->ds_action->file = argv[optind];
+		action->ds_action->target = argv[optind + 1];
+	}
 	else if (action->module == &DS_RDS_SPLIT_MODULE) {
 		if (optind + 2 != argc) {
 			oscap_module_usage(action->module, stderr, "Wrong number of parameters.\n");
@@ -246,6 +344,37 @@ bool getopt_ds(int argc, char **argv, struct oscap_action *action) {
 		action->ds_action = malloc(sizeof(struct ds_action));
 		action->ds_action->file = argv[3];
 	}
+	else if (action->module == &DS_RDS_STORE_IMPORT_MODULE) {
+		if (argc - optind < 2) {
+			oscap_module_usage(action->module, stderr, "Wrong number of parameters.\n");
+			return false;
+		}
+		action->ds_action = malloc(sizeof(struct ds_action));
+		action->ds_action->file = argv[optind];
+		action->ds_action->arf_files = &argv[optind + 1];
+		action->ds_action->arf_file_count = argc - optind - 1;
+	}
+	else if (action->module == &DS_RDS_STORE_EXPORT_MODULE) {
+		if (optind + 3 != argc) {
+			oscap_module_usage(action->module, stderr, "Wrong number of parameters.\n");
+			return false;
+		}
+		action->ds_action = malloc(sizeof(struct ds_action));
+		action->ds_action->file = argv[optind];
+		action->ds_action->arf_id = argv[optind + 1];
+		action->ds_action->target = argv[optind + 2];
+	}
+	else if (action->module == &DS_RDS_STORE_LIST_MODULE || action->module == &DS_RDS_STORE_INFO_MODULE) {
+		if (optind + 1 != argc) {
+			oscap_module_usage(action->module, stderr, "Wrong number of parameters.\n");
+			return false;
+		}
+		action->ds_action = malloc(sizeof(struct ds_action));
+		action->ds_action->file = argv[optind];
+		action->ds_action->host = host;
+		action->ds_action->profile = profile;
+		action->ds_action->rule = rule;
+	}
 	return true;
 }
 
@@ -308,6 +437,40 @@ cleanup:
 	return ret;
 }
 
+int app_ds_sds_image(const struct oscap_action *action) {
+	int ret = OSCAP_ERROR;
+	struct ds_sds_session *session = NULL;
+
+	struct oscap_source *source = oscap_source_new_from_file(action->ds_action->file);
+	/* Validate */
+	if (action->validate)
+	{
+		if (oscap_source_validate(source, reporter, (void *) action) != 0) {
+			goto cleanup;
+		}
+	}
+
+	session = ds_sds_session_new_from_source(source);
+	if (session == NULL) {
+		goto cleanup;
+	}
+	if (ds_sds_session_write_image(session, action->f_datastream_id, action->f_xccdf_id,
+			action->f_benchmark_id, action->ds_action->target) != 0) {
+		goto cleanup;
+	}
+
+	ret = OSCAP_OK;
+
+cleanup:
+	oscap_print_error();
+
+	ds_sds_session_free(session);
+	oscap_source_free(source);
+	free(action->ds_action);
+
+	return ret;
+}
+
 int app_ds_sds_compose(const struct oscap_action *action) {
 	int ret = OSCAP_ERROR;
 
@@ -522,3 +685,127 @@ cleanup:
 	free(action->ds_action);
 	return ret;
 }
+
+int app_ds_rds_store_import(const struct oscap_action *action) {
+	int ret = OSCAP_ERROR;
+	size_t i;
+
+	struct ds_rds_store *store = ds_rds_store_open(action->ds_action->file);
+	if (store == NULL)
+		goto cleanup;
+
+	for (i = 0; i < action->ds_action->arf_file_count; ++i) {
+		char *id = ds_rds_store_import(store, action->ds_action->arf_files[i]);
+		if (id == NULL) {
+			fprintf(stdout, "Failed to import result datastream '%s'.\n", action->ds_action->arf_files[i]);
+			goto cleanup;
+		}
+		printf("%s\n", id);
+		free(id);
+	}
+
+	ret = OSCAP_OK;
+
+cleanup:
+	oscap_print_error();
+
+	ds_rds_store_free(store);
+	free(action->ds_action);
+	return ret;
+}
+
+int app_ds_rds_store_export(const struct oscap_action *action) {
+	int ret = OSCAP_ERROR;
+
+	struct ds_rds_store *store = ds_rds_store_open(action->ds_action->file);
+	if (store == NULL)
+		goto cleanup;
+
+	if (ds_rds_store_export(store, action->ds_action->arf_id, action->ds_action->target) != 0) {
+		fprintf(stdout, "Failed to export result datastream '%s'.\n", action->ds_action->arf_id);
+		goto cleanup;
+	}
+
+	ret = OSCAP_OK;
+
+cleanup:
+	oscap_print_error();
+
+	ds_rds_store_free(store);
+	free(action->ds_action);
+	return ret;
+}
+
+static void _print_strings(struct oscap_string_iterator *it)
+{
+	const char *sep = "";
+
+	while (oscap_string_iterator_has_more(it)) {
+		printf("%s%s", sep, oscap_string_iterator_next(it));
+		sep = ",";
+	}
+	oscap_string_iterator_free(it);
+}
+
+int app_ds_rds_store_list(const struct oscap_action *action) {
+	int ret = OSCAP_ERROR;
+	struct oscap_stringlist *ids = NULL;
+	struct oscap_string_iterator *it;
+
+	struct ds_rds_store *store = ds_rds_store_open(action->ds_action->file);
+	if (store == NULL)
+		goto cleanup;
+
+	ids = ds_rds_store_search(store, action->ds_action->host, action->ds_action->profile, action->ds_action->rule);
+
+	// ID, hosts, profiles and the result of the rule separated by tabs
+	it = oscap_stringlist_get_strings(ids);
+	while (oscap_string_iterator_has_more(it)) {
+		const char *id = oscap_string_iterator_next(it);
+
+		printf("%s\t", id);
+		_print_strings(ds_rds_store_get_hosts(store, id));
+		printf("\t");
+		_print_strings(ds_rds_store_get_profiles(store, id));
+		if (action->ds_action->rule != NULL)
+			printf("\t%s", ds_rds_store_get_rule_result(store, id, action->ds_action->rule));
+		printf("\n");
+	}
+	oscap_string_iterator_free(it);
+
+	ret = OSCAP_OK;
+
+cleanup:
+	oscap_print_error();
+
+	oscap_stringlist_free(ids);
+	ds_rds_store_free(store);
+	free(action->ds_action);
+	return ret;
+}
+
+int app_ds_rds_store_info(const struct oscap_action *action) {
+	int ret = OSCAP_ERROR;
+	uint64_t arf_bytes, blob_bytes;
+	size_t arf_count;
+
+	struct ds_rds_store *store = ds_rds_store_open(action->ds_action->file);
+	if (store == NULL)
+		goto cleanup;
+
+	ds_rds_store_get_usage(store, &arf_count, &arf_bytes, &blob_bytes);
+
+	printf("Result datastreams: %zu\n", arf_count);
+	printf("Size of result datastreams: %" PRIu64 " bytes\n", arf_bytes);
+	printf("Size of blobs: %" PRIu64 " bytes\n", blob_bytes);
+	printf("Deduplication ratio: %.2f\n", blob_bytes > 0 ? (double)arf_bytes / blob_bytes : 1.0);
+
+	ret = OSCAP_OK;
+
+cleanup:
+	oscap_print_error();
+
+	ds_rds_store_free(store);
+	free(action->ds_action);
+	return ret;
+}
@@ -27,6 +27,7 @@
 
 /* OVAL & OSCAP common */
 #include "oscap_source.h"
+#include "oscap_metrics.h"
 #include <oval_probe.h>
 #include <oval_agent_api.h>
 #include <oval_results.h>
@@ -109,6 +110,10 @@ static struct oscap_module OVAL_EVAL = {
         "   --directives <file>\r\t\t\t\t - Use OVAL Directives content to specify desired results content.\n"
         "   --results <file>\r\t\t\t\t - Write OVAL Results into file.\n"
         "   --report <file>\r\t\t\t\t - Create human readable (HTML) report from OVAL Results.\n"
+        "   --profile-report <file>\r\t\t\t\t - Write time and resources spent on each OVAL definition, test\n"
+        "                          \r\t\t\t\t   object, the startup of each probe and the load of the\n"
+        "                          \r\t\t\t\t   definitions into file\n"
+        "                          \r\t\t\t\t   (CSV if the name ends with .csv, JSON otherwise).\n"
         "   --skip-valid\r\t\t\t\t - Skip validation.\n"
         "   --datastream-id <id> \r\t\t\t\t - ID of the datastream in the collection to use.\n"
         "                        \r\t\t\t\t   (only applicable for source datastreams)\n"
@@ -380,6 +385,10 @@ int app_evaluate_oval(const struct oscap_action *action)
 		oval_source = main_source;
 	}
 
+	/* the profile covers the load of the OVAL definitions */
+	if (action->f_profile_report != NULL)
+		oscap_metrics_enable();
+
 	/* import OVAL Definitions */
 	def_model = oval_definition_model_import_source(oval_source);
 	if (def_model == NULL) {
@@ -415,6 +424,9 @@ int app_evaluate_oval(const struct oscap_action *action)
 	/* set product name */
 	oval_agent_set_product_name(sess, OSCAP_PRODUCTNAME);
 
+	if (action->f_profile_report != NULL)
+		oval_agent_set_probe_startup_reporter(sess, oscap_metrics_add_probe_startup, NULL);
+
 	/* Evaluation */
 	if (action->id) {
 		oval_agent_eval_definition(sess, action->id);
@@ -429,6 +441,9 @@ int app_evaluate_oval(const struct oscap_action *action)
 
 	printf("Evaluation done.\n");
 
+	if (action->f_profile_report != NULL && oscap_metrics_export(action->f_profile_report) != 0)
+		goto cleanup;
+
 	/* export results to file */
 	if (action->f_results != NULL) {
 		/* get result model */
@@ -613,7 +628,8 @@ enum oval_opt {
     OVAL_OPT_DATASTREAM_ID,
     OVAL_OPT_OVAL_ID,
     OVAL_OPT_OUTPUT = 'o',
-    OVAL_OPT_PROBE_ROOT
+    OVAL_OPT_PROBE_ROOT,
+    OVAL_OPT_PROFILE_REPORT
 };
 
 bool getopt_oval_eval(int argc, char **argv, struct oscap_action *action)
@@ -632,6 +648,7 @@ bool getopt_oval_eval(int argc, char **argv, struct oscap_action *action)
 		{ "oval-id",    required_argument, NULL, OVAL_OPT_OVAL_ID},
 		{ "skip-valid",	no_argument, &action->validate, 0 },
 		{ "probe-root", required_argument, NULL, OVAL_OPT_PROBE_ROOT},
+		{ "profile-report", required_argument, NULL, OVAL_OPT_PROFILE_REPORT},
 		{ 0, 0, 0, 0 }
 	};
 
@@ -646,6 +663,7 @@ bool getopt_oval_eval(int argc, char **argv, struct oscap_action *action)
 		case OVAL_OPT_DATASTREAM_ID: action->f_datastream_id = optarg;	break;
 		case OVAL_OPT_OVAL_ID: action->f_oval_id = optarg;	break;
 		case OVAL_OPT_PROBE_ROOT: action->probe_root = optarg; break;
+		case OVAL_OPT_PROFILE_REPORT: action->f_profile_report = optarg; break;
 		case 0: break;
 		default: return oscap_module_usage(action->module, stderr, NULL);
 		}
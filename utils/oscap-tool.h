@@ -86,6 +86,12 @@ struct ds_action {
 	char* xccdf_result;
 	char** oval_results;
 	size_t oval_result_count;
+	char* arf_id;
+	char** arf_files;
+	size_t arf_file_count;
+	char* host;
+	char* profile;
+	char* rule;
 };
 
 struct cpe_action {
@@ -96,6 +102,7 @@ struct cpe_action {
 struct cve_action {
         char * file;
         char * cve;
+        char * index;
 };
 
 struct oscap_action {
@@ -141,6 +148,7 @@ struct oscap_action {
 	int validate;
 	int schematron;
 	int remote_resources;
+	int lazy_oval;
 	int progress;
 	int oval_results;
 	int remediate;
@@ -149,6 +157,9 @@ struct oscap_action {
 	int export_variables;
         int list_dynamic;
 	char *probe_root;
+	char *f_targets;
+	int jobs;
+	char *f_profile_report;
 };
 
 int app_xslt(const char *infile, const char *xsltfile, const char *outfile, const char **params);
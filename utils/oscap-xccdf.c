@@ -37,6 +37,7 @@
 
 #include <sys/types.h>
 #include <sys/stat.h>
+#include <sys/wait.h>
 #include <fcntl.h>
 #include <errno.h>
 #include <assert.h>
@@ -47,6 +48,7 @@
 #include "oscap-tool.h"
 #include "oscap.h"
 #include "oscap_source.h"
+#include "oscap_metrics.h"
 
 static int app_evaluate_xccdf(const struct oscap_action *action);
 static int app_xccdf_validate(const struct oscap_action *action);
@@ -148,8 +150,14 @@ static struct oscap_module XCCDF_EVAL = {
         "   --results <file>\r\t\t\t\t - Write XCCDF Results into file.\n"
         "   --results-arf <file>\r\t\t\t\t - Write ARF (result data stream) into file.\n"
         "   --report <file>\r\t\t\t\t - Write HTML report into file.\n"
+        "   --profile-report <file>\r\t\t\t\t - Write time and resources spent on each rule, OVAL definition,\n"
+        "                          \r\t\t\t\t   test, object, the startup of each probe and the load\n"
+        "                          \r\t\t\t\t   of each OVAL file into file\n"
+        "                          \r\t\t\t\t   (CSV if the name ends with .csv, JSON otherwise).\n"
         "   --skip-valid \r\t\t\t\t - Skip validation.\n"
 	"   --fetch-remote-resources \r\t\t\t\t - Download remote content referenced by XCCDF.\n"
+	"   --lazy-oval \r\t\t\t\t - Load only OVAL definitions referenced by the selected profile.\n"
+	"               \r\t\t\t\t   OVAL results then contain only these definitions.\n"
 	"   --progress \r\t\t\t\t - Switch to sparse output suitable for progress reporting.\n"
 	"              \r\t\t\t\t   Format is \"$rule_id:$result\\n\".\n"
 	"   --datastream-id <id> \r\t\t\t\t - ID of the datastream in the collection to use.\n"
@@ -160,7 +168,12 @@ static struct oscap_module XCCDF_EVAL = {
 	"                   \r\t\t\t\t   (only applicable for source datastreams)\n"
 	"                   \r\t\t\t\t   (only applicable when datastream-id AND xccdf-id are not specified)\n"
 	"   --remediate \r\t\t\t\t - Automatically execute XCCDF fix elements for failed rules.\n"
-	"               \r\t\t\t\t   Use of this option is always at your own risk.",
+	"               \r\t\t\t\t   Use of this option is always at your own risk.\n"
+	"   --targets <file>\r\t\t\t\t - Evaluate offline targets listed in the file, one \"ROOT_DIR ARF_FILE\"\n"
+	"                   \r\t\t\t\t   pair per line. The content is loaded only once and an ARF is written\n"
+	"                   \r\t\t\t\t   for each mounted root directory (chroot, container image).\n"
+	"   --jobs <n>\r\t\t\t\t - Number of targets evaluated concurrently (with --targets)\n"
+	"             \r\t\t\t\t   or of fixes executed concurrently (with --remediate).",
     .opt_parser = getopt_xccdf,
     .func = app_evaluate_xccdf
 };
@@ -186,6 +199,7 @@ static struct oscap_module XCCDF_REMEDIATE = {
 			"  --check-engine-results\r\t\t\t\t - Save results from check engines loaded from plugins as well.\n"
 			"  --progress \r\t\t\t\t - Switch to sparse output suitable for progress reporting.\n"
 			"             \r\t\t\t\t   Format is \"$rule_id:$result\\n\".\n"
+			"  --jobs <n>\r\t\t\t\t - Number of fixes executed concurrently.\n"
 	,
 	.opt_parser = getopt_xccdf,
 	.func = app_xccdf_remediate
@@ -440,6 +454,166 @@ static void report_missing_profile(const struct oscap_action *action)
 		"$ oscap info \"%s\"\n", action->profile, action->f_xccdf);
 }
 
+struct xccdf_target {
+	char *root;
+	char *arf;
+	pid_t pid;
+};
+
+static int _xccdf_targets_load(const char *filename, struct xccdf_target **targets)
+{
+	FILE *fp;
+	char *line = NULL;
+	size_t line_size = 0;
+	int count = 0, alloc = 0;
+
+	fp = fopen(filename, "r");
+	if (fp == NULL) {
+		fprintf(stderr, "Unable to open targets file '%s': %s\n", filename, strerror(errno));
+		return -1;
+	}
+
+	*targets = NULL;
+	while (getline(&line, &line_size, fp) != -1) {
+		char *saveptr;
+		char *root = strtok_r(line, " \t\n", &saveptr);
+		char *arf = strtok_r(NULL, " \t\n", &saveptr);
+
+		if (root == NULL || root[0] == '#')
+			continue;
+		if (arf == NULL) {
+			fprintf(stderr, "No ARF file given for target '%s' in '%s'.\n", root, filename);
+			count = -1;
+			break;
+		}
+		if (count == alloc) {
+			alloc = alloc ? 2 * alloc : 16;
+			*targets = realloc(*targets, alloc * sizeof(struct xccdf_target));
+		}
+		(*targets)[count].root = strdup(root);
+		(*targets)[count].arf = strdup(arf);
+		(*targets)[count].pid = -1;
+		count++;
+	}
+
+	free(line);
+	fclose(fp);
+	return count;
+}
+
+static void _xccdf_targets_free(struct xccdf_target *targets, int count)
+{
+	for (int i = 0; i < count; i++) {
+		free(targets[i].root);
+		free(targets[i].arf);
+	}
+	free(targets);
+}
+
+/*
+ * Runs in a forked child: the loaded and resolved content is shared with
+ * the parent, only the probes are started anew for the target root. The
+ * parent has stopped its probes, the system information and the CPE
+ * platforms are thus queried here, once OSCAP_PROBE_ROOT points to the
+ * target.
+ */
+static int _xccdf_evaluate_target(struct xccdf_session *session, const struct xccdf_target *target)
+{
+	if (setenv("OSCAP_PROBE_ROOT", target->root, 1) != 0) {
+		fprintf(stderr, "Failed to set the OSCAP_PROBE_ROOT environment variable.\n");
+		return OSCAP_ERROR;
+	}
+
+	if (xccdf_session_evaluate(session) != 0)
+		return OSCAP_ERROR;
+
+	xccdf_session_set_arf_export(session, target->arf);
+	if (xccdf_session_export_oval(session) != 0)
+		return OSCAP_ERROR;
+	if (xccdf_session_export_xccdf(session) != 0)
+		return OSCAP_ERROR;
+	if (xccdf_session_export_arf(session) != 0)
+		return OSCAP_ERROR;
+
+	return xccdf_session_contains_fail_result(session) ? OSCAP_FAIL : OSCAP_OK;
+}
+
+static int _xccdf_targets_wait(struct xccdf_target *targets, int count)
+{
+	int status, ret;
+	pid_t pid;
+
+	do {
+		pid = wait(&status);
+	} while (pid == -1 && errno == EINTR);
+	if (pid == -1)
+		return -1;
+
+	ret = (WIFEXITED(status) && WEXITSTATUS(status) <= OSCAP_FAIL) ? WEXITSTATUS(status) : OSCAP_ERROR;
+	for (int i = 0; i < count; i++) {
+		if (targets[i].pid == pid) {
+			targets[i].pid = -1;
+			printf("Target %s: %s\n", targets[i].root,
+				ret == OSCAP_OK ? "pass" : (ret == OSCAP_FAIL ? "fail" : "error"));
+			fflush(stdout);
+			break;
+		}
+	}
+	return ret;
+}
+
+static int _xccdf_evaluate_targets(struct xccdf_session *session, const struct oscap_action *action)
+{
+	struct xccdf_target *targets = NULL;
+	int count, running = 0, ret, result = OSCAP_OK;
+
+	count = _xccdf_targets_load(action->f_targets, &targets);
+	if (count < 0) {
+		_xccdf_targets_free(targets, 0);
+		return OSCAP_ERROR;
+	}
+
+	/* The probes started so far ran on the host, the children must neither share nor reuse them */
+	if (xccdf_session_reset_probes(session) != 0) {
+		_xccdf_targets_free(targets, count);
+		return OSCAP_ERROR;
+	}
+
+	for (int i = 0; i < count || running > 0; ) {
+		if (i < count && running < action->jobs) {
+			fflush(stdout);
+			fflush(stderr);
+			targets[i].pid = fork();
+			if (targets[i].pid == 0) {
+				ret = _xccdf_evaluate_target(session, &targets[i]);
+				if (ret == OSCAP_ERROR)
+					oscap_print_error();
+				fflush(stdout);
+				fflush(stderr);
+				_exit(ret);
+			} else if (targets[i].pid == -1) {
+				fprintf(stderr, "Failed to start evaluation of target '%s': %s\n",
+					targets[i].root, strerror(errno));
+				result = OSCAP_ERROR;
+			} else {
+				running++;
+			}
+			i++;
+			continue;
+		}
+
+		ret = _xccdf_targets_wait(targets, count);
+		if (ret == -1)
+			break;
+		running--;
+		if (ret > result)
+			result = ret;
+	}
+
+	_xccdf_targets_free(targets, count);
+	return result;
+}
+
 /**
  * XCCDF Processing fucntion
  * @param action OSCAP Action structure
@@ -473,8 +647,15 @@ int app_evaluate_xccdf(const struct oscap_action *action)
 	xccdf_session_set_user_tailoring_cid(session, action->tailoring_id);
 	xccdf_session_set_remote_resources(session, action->remote_resources, _download_reporting_callback);
 	xccdf_session_set_custom_oval_files(session, action->f_ovals);
+	xccdf_session_set_oval_lazy_loading(session, action->lazy_oval);
 	xccdf_session_set_product_cpe(session, OSCAP_PRODUCTNAME);
 
+	/* the profile covers the load of the OVAL definitions */
+	if (action->f_profile_report != NULL) {
+		oscap_metrics_enable();
+		xccdf_session_set_probe_startup_reporter(session, oscap_metrics_add_probe_startup, NULL);
+	}
+
 	if (xccdf_session_load(session) != 0)
 		goto cleanup;
 
@@ -487,12 +668,25 @@ int app_evaluate_xccdf(const struct oscap_action *action)
 		goto cleanup;
 	}
 
+	if (action->f_targets != NULL) {
+		/* concurrent evaluations would interleave the per-rule output */
+		if (action->jobs == 1)
+			_register_progress_callback(session, action->progress);
+		result = _xccdf_evaluate_targets(session, action);
+		goto cleanup;
+	}
+
 	_register_progress_callback(session, action->progress);
 
 	/* Perform evaluation */
 	if (xccdf_session_evaluate(session) != 0)
 		goto cleanup;
 
+	/* The profile of a remediating scan covers the fixes as well. */
+	if (action->f_profile_report != NULL && !action->remediate &&
+			oscap_metrics_export(action->f_profile_report) != 0)
+		goto cleanup;
+
 	xccdf_session_set_oval_results_export(session, action->oval_results);
 	xccdf_session_set_oval_variables_export(session, action->export_variables);
 	xccdf_session_set_arf_export(session, action->f_results_arf);
@@ -510,7 +704,11 @@ int app_evaluate_xccdf(const struct oscap_action *action)
 	if (action->remediate) {
 		if (!action->progress)
 			printf("\n --- Starting Remediation ---\n");
+		xccdf_session_set_remediation_jobs(session, action->jobs);
 		xccdf_session_remediate(session);
+
+		if (action->f_profile_report != NULL && oscap_metrics_export(action->f_profile_report) != 0)
+			goto cleanup;
 	}
 
 	xccdf_session_set_xccdf_export(session, action->f_results);
@@ -625,6 +823,7 @@ int app_xccdf_remediate(const struct oscap_action *action)
 
 	_register_progress_callback(session, action->progress);
 
+	xccdf_session_set_remediation_jobs(session, action->jobs);
 	xccdf_session_remediate(session);
 
 	xccdf_session_set_oval_results_export(session, action->oval_results);
@@ -899,6 +1098,9 @@ enum oval_opt {
 	XCCDF_OPT_TAILORING_ID,
     XCCDF_OPT_CPE,
     XCCDF_OPT_CPE_DICT,
+    XCCDF_OPT_TARGETS,
+    XCCDF_OPT_JOBS,
+    XCCDF_OPT_PROFILE_REPORT,
     XCCDF_OPT_OUTPUT = 'o',
     XCCDF_OPT_RESULT_ID = 'i'
 };
@@ -930,6 +1132,9 @@ bool getopt_xccdf(int argc, char **argv, struct oscap_action *action)
 		{"cpe",	required_argument, NULL, XCCDF_OPT_CPE},
 		{"cpe-dict",	required_argument, NULL, XCCDF_OPT_CPE_DICT}, // DEPRECATED!
 		{"sce-template", 	required_argument, NULL, XCCDF_OPT_SCE_TEMPLATE},
+		{"targets",		required_argument, NULL, XCCDF_OPT_TARGETS},
+		{"jobs",		required_argument, NULL, XCCDF_OPT_JOBS},
+		{"profile-report",	required_argument, NULL, XCCDF_OPT_PROFILE_REPORT},
 	// flags
 		{"force",		no_argument, &action->force, 1},
 		{"oval-results",	no_argument, &action->oval_results, 1},
@@ -937,6 +1142,7 @@ bool getopt_xccdf(int argc, char **argv, struct oscap_action *action)
 		{"check-engine-results", no_argument, &action->check_engine_results, 1},
 		{"skip-valid",		no_argument, &action->validate, 0},
 		{"fetch-remote-resources", no_argument, &action->remote_resources, 1},
+		{"lazy-oval",		no_argument, &action->lazy_oval, 1},
 		{"progress", no_argument, &action->progress, 1},
 		{"remediate", no_argument, &action->remediate, 1},
 		{"hide-profile-info",	no_argument, &action->hide_profile_info, 1},
@@ -974,11 +1180,35 @@ bool getopt_xccdf(int argc, char **argv, struct oscap_action *action)
 				action->cpe = optarg; break;
 			}
 		case XCCDF_OPT_SCE_TEMPLATE:	action->sce_template = optarg; break;
+		case XCCDF_OPT_TARGETS:		action->f_targets = optarg; break;
+		case XCCDF_OPT_JOBS:
+			{
+				char *end;
+				errno = 0;
+				long jobs = strtol(optarg, &end, 10);
+				if (errno != 0 || end == optarg || *end != '\0' || jobs < 1 || jobs > INT_MAX)
+					return oscap_module_usage(action->module, stderr, "The --jobs option requires a positive number.");
+				action->jobs = jobs;
+				break;
+			}
+		case XCCDF_OPT_PROFILE_REPORT:	action->f_profile_report = optarg; break;
 		case 0: break;
 		default: return oscap_module_usage(action->module, stderr, NULL);
 		}
 	}
 
+	if (action->jobs != 0 && action->f_targets == NULL && !action->remediate && action->module != &XCCDF_REMEDIATE)
+		return oscap_module_usage(action->module, stderr, "The --jobs option requires --targets or --remediate.");
+	if (action->jobs == 0)
+		action->jobs = 1;
+	if (action->f_targets != NULL) {
+		if (action->f_results || action->f_results_arf || action->f_report || action->oval_results ||
+		    action->check_engine_results || action->export_variables || action->remediate ||
+		    action->f_profile_report)
+			return oscap_module_usage(action->module, stderr,
+				"Only per-target ARF results given in the targets file are supported with --targets.");
+	}
+
 	if (action->module == &XCCDF_EVAL) {
 		/* We should have XCCDF file here */
 		if (optind >= argc) {